@@ -58,6 +58,17 @@ static void benchmark_fp16_alt_to_fp32_value(std::vector<float16>& fp16,
     print_result(result);
 }
 
+// fp16_alt_to_fp32_array 벤치마크 함수
+static void benchmark_fp16_alt_to_fp32_array(std::vector<float16>& fp16,
+    std::vector<float>& fp32, size_t size) {
+
+    auto result = run_benchmark("fp16_alt_to_fp32_array", size, sizeof(float), [&]() {
+        fp16_alt_to_fp32_array(fp16.data(), fp32.data(), size);
+    });
+
+    print_result(result);
+}
+
 int main() {
     std::cout << "FP16 to FP32 Alternative Format Conversion Benchmarks" << std::endl;
     std::cout << "=====================================" << std::endl;
@@ -84,6 +95,9 @@ int main() {
         
         // fp16_alt_to_fp32_value 벤치마크
         benchmark_fp16_alt_to_fp32_value(fp16, fp32, size);
+
+        // fp16_alt_to_fp32_array 벤치마크
+        benchmark_fp16_alt_to_fp32_array(fp16, fp32, size);
         
         std::cout << std::endl;
     }
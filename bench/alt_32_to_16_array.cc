@@ -45,6 +45,17 @@ static void benchmark_fp32v_to_fp16_alt_value_array(std::vector<float> &fp32,
   print_result(result);
 }
 
+// fp32_alt_to_fp16_array 벤치마크 함수
+static void benchmark_fp32_alt_to_fp16_array(std::vector<float> &fp32,
+    std::vector<float16> &fp16,
+    size_t size) {
+    auto result = run_benchmark("fp32_alt_to_fp16_array", size, sizeof(float16), [&]() {
+                fp32_alt_to_fp16_array(fp32.data(), fp16.data(), size);
+            });
+
+  print_result(result);
+}
+
 int main() {
   std::cout << "FP32 to FP16 Alternative Format Conversion Benchmarks" << std::endl;
   std::cout << "=====================================" << std::endl;
@@ -66,6 +77,9 @@ int main() {
     // fp16_alt_to_fp32_bits 벤치마크
     benchmark_fp32v_to_fp16_alt_value_array(fp32, fp16, size);
 
+    // fp32_alt_to_fp16_array 벤치마크
+    benchmark_fp32_alt_to_fp16_array(fp32, fp16, size);
+
     std::cout << std::endl;
   }
 
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/arena.h>
+#include <fp16/array.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 20;
+// FP32 출력 버퍼 크기 (4 MiB, 64 MiB, 256 MiB)
+static const size_t kSizes[] = { 1 << 20, 1 << 24, 1 << 26 };
+// 무작위 읽기 횟수 (TLB 미스 비교)
+static const size_t kRandomReads = 1 << 20;
+
+// 테스트 데이터 생성 함수: [-1, 1] 범위의 FP16 값
+static std::vector<float16> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
+    std::vector<float16> fp16(size);
+    std::generate(fp16.begin(), fp16.end(), [&]() { return fp32_ieee_to_fp16_value(rng()); });
+
+    return fp16;
+}
+
+// 프로세스에 실제로 할당된 투명 huge page 크기 (Linux의 /proc/self/smaps_rollup)
+static std::string anon_huge_pages() {
+    std::ifstream smaps("/proc/self/smaps_rollup");
+    std::string line;
+    while (std::getline(smaps, line)) {
+        if (line.compare(0, 14, "AnonHugePages:") == 0) {
+            return line.substr(14);
+        }
+    }
+    return " (unknown)";
+}
+
+int main() {
+    std::cout << "FP16 Page and Arena Allocator Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << "Base page: " << fp16_pages_base_size() << " bytes, huge page: " << FP16_HUGE_PAGE_SIZE << " bytes" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    volatile float sink = 0.0f;
+    for (size_t size : kSizes) {
+        const size_t bytes = size * sizeof(float);
+        std::cout << "N = " << size << " (FP32 buffer: " << bytes / 1048576 << " MiB)" << std::endl;
+        const std::vector<float16> x = generate_test_data(size);
+
+        // 호출마다 새 std::vector: 0으로 채우기와 4K 페이지 폴트
+        auto result = run_benchmark("fresh vector", kIterations, size * sizeof(float16), [&]() {
+            std::vector<float> y(size);
+            fp16_ieee_to_fp32_array(x.data(), y.data(), size);
+            sink = y[size - 1];
+        });
+        print_result(result);
+
+        // 호출마다 새 매핑: 4K 페이지와 2M 페이지의 페이지 폴트 비용 비교
+        result = run_benchmark("fresh 4K pages", kIterations, size * sizeof(float16), [&]() {
+            float* y = (float*) fp16_pages_allocate(bytes, 0);
+            fp16_ieee_to_fp32_array(x.data(), y, size);
+            sink = y[size - 1];
+            fp16_pages_free(y, bytes, 0);
+        });
+        print_result(result);
+
+        result = run_benchmark("fresh 2M pages", kIterations, size * sizeof(float16), [&]() {
+            float* y = (float*) fp16_pages_allocate(bytes, FP16_PAGES_HUGE);
+            fp16_ieee_to_fp32_array(x.data(), y, size);
+            sink = y[size - 1];
+            fp16_pages_free(y, bytes, FP16_PAGES_HUGE);
+        });
+        print_result(result);
+
+        // 미리 폴트한 아레나를 재사용: 시스템 호출과 페이지 폴트 없음
+        for (unsigned flags : { 0u, (unsigned) FP16_PAGES_HUGE }) {
+            struct fp16_arena arena;
+            fp16_arena_init(&arena, bytes, flags | FP16_PAGES_PREFAULT);
+            const std::string pages = flags != 0 ? "2M" : "4K";
+            if (flags != 0) {
+                std::cout << "AnonHugePages:" << anon_huge_pages() << std::endl;
+            }
+
+            result = run_benchmark("arena " + pages + " prefaulted", kIterations, size * sizeof(float16), [&]() {
+                float* y = fp16_arena_allocate_fp32(&arena, size);
+                fp16_ieee_to_fp32_array(x.data(), y, size);
+                sink = y[size - 1];
+                fp16_arena_reset(&arena);
+            });
+            print_result(result);
+
+            // 의존적인 무작위 읽기: 다음 위치가 읽은 값에 의존하므로 TLB 미스 지연이 그대로 드러남
+            float* y = fp16_arena_allocate_fp32(&arena, size);
+            fp16_ieee_to_fp32_array(x.data(), y, size);
+            result = run_benchmark("random reads " + pages, kIterations, kRandomReads * sizeof(float), [&]() {
+                uint32_t state = 1;
+                for (size_t i = 0; i < kRandomReads; i++) {
+                    const float f = y[(size_t) (state >> 6) % size];
+                    state = state * 1664525u + 1013904223u + (fp32v_to_fp32b(f) & 1);
+                }
+                sink = (float) state;
+            });
+            print_result(result);
+            fp16_arena_destroy(&arena);
+        }
+    }
+
+    return 0;
+}
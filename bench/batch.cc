@@ -0,0 +1,109 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/batch.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 5;
+
+// 축소한 LLaMA 형태 체크포인트의 텐서 크기 분포: 임베딩, 층마다 정규화 가중치와 어텐션/MLP 행렬,
+// 그리고 양자화 스케일처럼 수십~수백 바이트인 작은 텐서 다수
+static std::vector<size_t> checkpoint_tensor_sizes() {
+    const size_t hidden = 1024, ffn = 2816, vocab = 32000, layers = 8, small_per_layer = 200;
+    std::mt19937 rng(42);
+    std::vector<size_t> sizes;
+    sizes.push_back(vocab * hidden);
+    for (size_t layer = 0; layer < layers; layer++) {
+        sizes.push_back(hidden);
+        for (int i = 0; i < 4; i++) {
+            sizes.push_back(hidden * hidden);
+        }
+        sizes.push_back(hidden);
+        for (int i = 0; i < 3; i++) {
+            sizes.push_back(hidden * ffn);
+        }
+        for (size_t i = 0; i < small_per_layer; i++) {
+            sizes.push_back(32 + rng() % 224);
+        }
+    }
+    sizes.push_back(hidden);
+    sizes.push_back(vocab * hidden);
+    // 파일 안의 텐서 순서는 이름 순이므로 크기 순서가 섞여 있음
+    std::shuffle(sizes.begin() + 1, sizes.end(), rng);
+    return sizes;
+}
+
+int main() {
+    std::cout << "FP16 Batched Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    const std::vector<size_t> sizes = checkpoint_tensor_sizes();
+    size_t total = 0;
+    for (size_t size : sizes) {
+        total += (size + 63) / 64 * 64;
+    }
+    std::cout << sizes.size() << " tensors, " << total << " elements ("
+              << total * sizeof(float16) / 1048576 << " MiB FP16)" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    // 텐서들은 하나의 큰 FP16/FP32 버퍼를 64개 요소 단위로 나눠 가짐
+    std::vector<float16> fp16_data(total);
+    for (size_t i = 0; i < total; i++) {
+        fp16_data[i] = (float16) (i * 40503 % 0x7BFF);
+    }
+    std::vector<float> fp32_data(total);
+    std::vector<fp16::conversion_job> jobs;
+    size_t offset = 0;
+    for (size_t size : sizes) {
+        const fp16::conversion_job job = { fp16_data.data() + offset, fp32_data.data() + offset, size, FP16_CONVERSION_IEEE_TO_FP32 };
+        jobs.push_back(job);
+        offset += (size + 63) / 64 * 64;
+    }
+
+    // 텐서마다 배열 변환을 호출 (단일 스레드)
+    auto result = run_benchmark("per tensor, 1 thread", kIterations, total * sizeof(float16), [&]() {
+        for (const fp16::conversion_job& job : jobs) {
+            fp16_ieee_to_fp32_array((const float16*) job.input, (float*) job.output, job.count);
+        }
+    });
+    print_result(result);
+
+    fp16::batch_converter converter;
+    std::cout << "Threads: " << converter.threads() << std::endl;
+
+    // 텐서마다 병렬 변환기를 호출: 큰 텐서는 나뉘지만 작은 텐서마다 동기화 비용
+    result = run_benchmark("per tensor, pool", kIterations, total * sizeof(float16), [&]() {
+        for (const fp16::conversion_job& job : jobs) {
+            converter.convert(&job, 1);
+        }
+    });
+    print_result(result);
+
+    // 전체 목록을 한 번에: 큰 텐서 분할, 작은 텐서 병합, 작업 훔치기
+    size_t steals = 0;
+    result = run_benchmark("batch", kIterations, total * sizeof(float16), [&]() {
+        converter.convert(jobs);
+        steals += converter.steals();
+    });
+    print_result(result);
+    std::cout << "Steals per batch: " << steals / kIterations << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/bf16.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기
+static const size_t kSize = 1 << 16;
+
+// 테스트 데이터 생성 함수
+static std::vector<float> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
+    std::vector<float> fp32(size);
+    std::generate(fp32.begin(), fp32.end(), std::ref(rng));
+
+    return fp32;
+}
+
+int main() {
+    std::cout << "bfloat16 Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<float> fp32_input = generate_test_data(kSize);
+    std::vector<bfloat16> bf16_input(kSize);
+    std::vector<float16> fp16_input(kSize);
+    fp32_to_bf16_array(fp32_input.data(), bf16_input.data(), kSize);
+    fp32_ieee_to_fp16_array(fp32_input.data(), fp16_input.data(), kSize);
+
+    std::vector<float> fp32_output(kSize);
+    std::vector<uint16_t> output(kSize);
+
+    // FP32 → BF16
+    auto result = run_benchmark("fp32_to_bf16_value", kIterations, kSize * sizeof(bfloat16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            output[i] = fp32_to_bf16_value(fp32_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("fp32_to_bf16_array", kIterations, kSize * sizeof(bfloat16), [&]() {
+        fp32_to_bf16_array(fp32_input.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp32_to_bf16 truncate", kIterations, kSize * sizeof(bfloat16), [&]() {
+        fp32_to_bf16_array_truncate(fp32_input.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    // BF16 → FP32
+    result = run_benchmark("bf16_to_fp32_array", kIterations, kSize * sizeof(float), [&]() {
+        bf16_to_fp32_array(bf16_input.data(), fp32_output.data(), kSize);
+    });
+    print_result(result);
+
+    // BF16 → FP16: FP32 버퍼를 거치는 두 패스 방식과 레지스터 안에서 끝나는 직접 변환 비교
+    result = run_benchmark("bf16->fp32->fp16 2 pass", kIterations, kSize * sizeof(float16), [&]() {
+        bf16_to_fp32_array(bf16_input.data(), fp32_output.data(), kSize);
+        fp32_ieee_to_fp16_array(fp32_output.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("bf16_to_fp16_ieee_array", kIterations, kSize * sizeof(float16), [&]() {
+        bf16_to_fp16_ieee_array(bf16_input.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    // FP16 → BF16
+    result = run_benchmark("fp16->fp32->bf16 2 pass", kIterations, kSize * sizeof(bfloat16), [&]() {
+        fp16_ieee_to_fp32_array(fp16_input.data(), fp32_output.data(), kSize);
+        fp32_to_bf16_array(fp32_output.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp16_ieee_to_bf16_array", kIterations, kSize * sizeof(bfloat16), [&]() {
+        fp16_ieee_to_bf16_array(fp16_input.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/checkpoint.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 3;
+// 체크포인트: 2M개 FP32 텐서 32개 = 256 MiB, 작은 노름 벡터 32개
+static const size_t kTensors = 32;
+static const size_t kTensorElements = 2 << 20;
+static const size_t kNormElements = 4096;
+
+// 페이지 캐시에서 파일을 내보내 매번 디스크에서 읽는 변환을 측정 (tmpfs에서는 효과 없음)
+static void drop_cache(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+static std::string tensor_name(size_t i) {
+    return "model.layers." + std::to_string(i) + ".mlp.weight";
+}
+
+static std::string norm_name(size_t i) {
+    return "model.layers." + std::to_string(i) + ".norm.weight";
+}
+
+// 레이어마다 행렬 하나와 노름 벡터 하나를 가진 safetensors 파일
+static void write_checkpoint(const std::string& path) {
+    std::string json = "{\"__metadata__\":{\"format\":\"pt\"}";
+    uint64_t offset = 0;
+    for (size_t i = 0; i < kTensors; i++) {
+        json += ",\"" + tensor_name(i) + "\":{\"dtype\":\"F32\",\"shape\":[2048," + std::to_string(kTensorElements / 2048) +
+            "],\"data_offsets\":[" + std::to_string(offset) + "," + std::to_string(offset + kTensorElements * 4) + "]}";
+        offset += kTensorElements * 4;
+        json += ",\"" + norm_name(i) + "\":{\"dtype\":\"F32\",\"shape\":[" + std::to_string(kNormElements) +
+            "],\"data_offsets\":[" + std::to_string(offset) + "," + std::to_string(offset + kNormElements * 4) + "]}";
+        offset += kNormElements * 4;
+    }
+    json += "}";
+    json.append((8 - json.size() % 8) % 8, ' ');
+
+    std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+    unsigned char size[8];
+    fp16::npy_store_le64(size, json.size());
+    file.write((const char*) size, 8);
+    file.write(json.data(), (std::streamsize) json.size());
+    std::mt19937 rng(42);
+    std::normal_distribution<float> dist(0.0f, 0.02f);
+    std::vector<float> weights(kTensorElements);
+    for (size_t i = 0; i < kTensors; i++) {
+        std::generate(weights.begin(), weights.end(), [&]() { return dist(rng); });
+        file.write((const char*) weights.data(), (std::streamsize) (kTensorElements * 4));
+        file.write((const char*) weights.data(), (std::streamsize) (kNormElements * 4));
+    }
+}
+
+// 기준 방식: 파일 전체를 읽고, 텐서를 하나씩 변환한 출력 전체를 메모리에 모은 뒤 한 번에 씀
+static void convert_serial(const std::string& input_path, const std::string& output_path) {
+    std::ifstream input(input_path.c_str(), std::ios::binary | std::ios::ate);
+    std::vector<char> bytes((size_t) input.tellg());
+    input.seekg(0);
+    input.read(bytes.data(), (std::streamsize) bytes.size());
+    const size_t header_size = (size_t) fp16::npy_load_le64((const unsigned char*) bytes.data());
+
+    // 헤더는 변환된 버전과 크기가 같다고 가정하고 그대로 복사 (기준 측정용)
+    std::vector<char> output(8 + header_size);
+    memcpy(output.data(), bytes.data(), output.size());
+    const char* data = bytes.data() + 8 + header_size;
+    std::vector<float16> half(kTensorElements);
+    for (size_t i = 0; i < kTensors; i++) {
+        fp32_ieee_to_fp16_array((const float*) data, half.data(), kTensorElements);
+        output.insert(output.end(), (const char*) half.data(), (const char*) (half.data() + kTensorElements));
+        data += kTensorElements * 4;
+        output.insert(output.end(), data, data + kNormElements * 4);
+        data += kNormElements * 4;
+    }
+    std::ofstream file(output_path.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(output.data(), (std::streamsize) output.size());
+}
+
+int main() {
+    std::cout << "FP16 Checkpoint Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    const char* tmpdir = getenv("TMPDIR");
+    const std::string directory = tmpdir != NULL && tmpdir[0] != '\0' ? tmpdir : "/var/tmp";
+    const std::string input_path = directory + "/fp16-checkpoint-bench.safetensors";
+    const std::string output_path = directory + "/fp16-checkpoint-bench-f16.safetensors";
+    write_checkpoint(input_path);
+    {
+        const int fd = open(input_path.c_str(), O_RDONLY);
+        fsync(fd);
+        close(fd);
+    }
+    const size_t input_bytes = kTensors * (kTensorElements + kNormElements) * sizeof(float);
+    std::cout << kTensors << " float32 matrices and norms, " << input_bytes / 1048576 << " MiB ("
+              << input_path << "), " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << "Throughput counts the bytes read" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    auto result = run_benchmark("read all, serial", kIterations, input_bytes, [&]() {
+        drop_cache(input_path);
+        convert_serial(input_path, output_path);
+    });
+    print_result(result);
+
+    // mmap 입력, 텐서 단위 병렬 변환, pwrite로 흘려 쓰는 출력
+    std::vector<size_t> thread_counts = { 1, 2, 4 };
+    if (std::thread::hardware_concurrency() > 4) {
+        thread_counts.push_back(std::thread::hardware_concurrency());
+    }
+    for (size_t threads : thread_counts) {
+        fp16::checkpoint_options options;
+        options.threads = threads;
+        result = run_benchmark("convert, " + std::to_string(threads) + " threads", kIterations, input_bytes, [&]() {
+            drop_cache(input_path);
+            fp16::convert_checkpoint(input_path.c_str(), output_path.c_str(), options);
+        });
+        print_result(result);
+    }
+
+    // 페이지 캐시에 이미 있는 입력 (변환과 쓰기만의 비용)
+    fp16::checkpoint_options options;
+    result = run_benchmark("convert, cached input", kIterations, input_bytes, [&]() {
+        fp16::convert_checkpoint(input_path.c_str(), output_path.c_str(), options);
+    });
+    print_result(result);
+
+    remove(input_path.c_str());
+    remove(output_path.c_str());
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/chunked.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 3;
+// 시계열: FP16 64M개 = 128 MiB, 청크당 32K개
+static const size_t kElements = 64 << 20;
+// 임의 위치 구간 읽기: 4096개 구간 1000번
+static const size_t kReads = 1000;
+static const size_t kReadElements = 4096;
+
+// 페이지 캐시에서 파일을 내보내 매번 디스크에서 읽는 질의를 측정 (tmpfs에서는 효과 없음)
+static void drop_cache(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// 하루 주기로 오르내리며 천천히 변하는 온도 센서 값
+static void write_series(const std::string& path) {
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::vector<float> block(1 << 20);
+    fp16::chunked_writer writer(path.c_str());
+    float drift = 0.0f;
+    for (size_t i = 0; i < kElements; i += block.size()) {
+        for (size_t j = 0; j < block.size(); j++) {
+            drift += noise(rng) * 0.01f;
+            block[j] = 20.0f + 10.0f * std::sin((float) (i + j) / 4000000.0f) + drift + noise(rng);
+        }
+        writer.append(block.data(), block.size());
+    }
+    writer.close();
+}
+
+static std::vector<char> read_whole_file(const std::string& path) {
+    std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+    std::vector<char> bytes((size_t) file.tellg());
+    file.seekg(0);
+    file.read(bytes.data(), (std::streamsize) bytes.size());
+    return bytes;
+}
+
+int main() {
+    std::cout << "FP16 Chunked File Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    const char* tmpdir = getenv("TMPDIR");
+    const std::string path = std::string(tmpdir != NULL && tmpdir[0] != '\0' ? tmpdir : "/var/tmp") + "/fp16-chunked-bench.f16c";
+    write_series(path);
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        fsync(fd);
+        close(fd);
+    }
+    const size_t bytes = kElements * sizeof(float16);
+    const float lo = 29.5f, hi = 30.0f;
+    std::cout << kElements << " float16 numbers, " << bytes / 1048576 << " MiB in chunks of "
+              << (size_t) fp16::chunked_writer::default_chunk_elements << " (" << path << ")" << std::endl;
+    std::cout << "Query: count of values in [" << lo << ", " << hi << "]; throughput counts the whole series" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    uint64_t matches = 0;
+    std::vector<float> fp32(fp16::chunked_writer::default_chunk_elements);
+
+    // 기준 방식: 파일 전체를 읽어 전부 디코드하고 걸러냄
+    auto result = run_benchmark("read all, decode all", kIterations, bytes, [&]() {
+        drop_cache(path);
+        const std::vector<char> file = read_whole_file(path);
+        const float16* data = (const float16*) (file.data() + 64);
+        uint64_t count = 0;
+        for (size_t i = 0; i < kElements; i += fp32.size()) {
+            fp16_ieee_to_fp32_array(data + i, fp32.data(), fp32.size());
+            for (float x : fp32) {
+                count += lo <= x && x <= hi;
+            }
+        }
+        matches = count;
+    });
+    print_result(result);
+
+    result = run_benchmark("mmap, decode all", kIterations, bytes, [&]() {
+        drop_cache(path);
+        fp16::chunked_file file(path.c_str(), fp16::npy_advice::sequential);
+        uint64_t count = 0;
+        for (uint64_t i = 0; i < file.size(); i += fp32.size()) {
+            file.decode(i, fp32.size(), fp32.data());
+            for (float x : fp32) {
+                count += lo <= x && x <= hi;
+            }
+        }
+        matches = count;
+    });
+    print_result(result);
+
+    // 존 맵: 범위를 벗어난 청크는 건너뛰고, 범위 안에 완전히 든 청크는 인덱스만으로 셈
+    size_t selected = 0, chunks = 0;
+    result = run_benchmark("zone map count", kIterations, bytes, [&]() {
+        drop_cache(path);
+        fp16::chunked_file file(path.c_str());
+        if (file.count(lo, hi) != matches) {
+            std::cerr << "zone map count mismatch" << std::endl;
+        }
+        selected = file.select(lo, hi).size();
+        chunks = file.chunks().size();
+    });
+    print_result(result);
+    std::cout << "  " << matches << " matches, " << selected << " of " << chunks << " chunks selected" << std::endl;
+
+    // 임의 위치의 짧은 구간: 필요한 청크의 페이지만 읽음
+    std::vector<uint64_t> starts(kReads);
+    std::mt19937_64 rng(7);
+    for (uint64_t& start : starts) {
+        start = rng() % (kElements - kReadElements);
+    }
+    std::vector<float> window(kReadElements);
+    result = run_benchmark("random ranges, mmap", kIterations, kReads * kReadElements * sizeof(float16), [&]() {
+        drop_cache(path);
+        fp16::chunked_file file(path.c_str());
+        for (uint64_t start : starts) {
+            file.decode(start, kReadElements, window.data());
+        }
+    });
+    print_result(result);
+
+    remove(path.c_str());
+    return 0;
+}
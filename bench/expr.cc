@@ -0,0 +1,110 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/expr.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기 (L2 캐시를 넘는 크기에서 메모리 패스 수의 차이가 드러남)
+static const size_t kSizes[] = { 1 << 12, 1 << 16, 1 << 22 };
+
+// 테스트 데이터 생성 함수: [-8, 8] 범위의 FP16 값
+static std::vector<float16> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-8.0f, 8.0f), std::mt19937(seed));
+
+    std::vector<float16> fp16(size);
+    std::generate(fp16.begin(), fp16.end(), [&]() { return fp32_ieee_to_fp16_value(rng()); });
+
+    return fp16;
+}
+
+int main() {
+    std::cout << "FP16 Expression Template Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const float a = 0.75f, b = 0.5f;
+    for (size_t size : kSizes) {
+        std::cout << "N = " << size << std::endl;
+        const std::vector<float16> x = generate_test_data(size);
+        std::vector<float16> y(size);
+        std::vector<float> fp32_buffer(size), fp32_x(size);
+
+        // y = a * x + b: 디코드, 계산, 인코드를 각각 한 패스로 수행
+        auto result = run_benchmark("axpb three passes", kIterations, size * sizeof(float16), [&]() {
+            fp16_ieee_to_fp32_array(x.data(), fp32_buffer.data(), size);
+            for (size_t i = 0; i < size; i++) {
+                fp32_buffer[i] = a * fp32_buffer[i] + b;
+            }
+            fp32_ieee_to_fp16_array(fp32_buffer.data(), y.data(), size);
+        });
+        print_result(result);
+
+        // 스칼라 변환을 요소마다 호출
+        result = run_benchmark("axpb scalar", kIterations, size * sizeof(float16), [&]() {
+            for (size_t i = 0; i < size; i++) {
+                y[i] = fp32_ieee_to_fp16_value(a * fp16_ieee_to_fp32_value(x[i]) + b);
+            }
+        });
+        print_result(result);
+
+        // 표현식 템플릿: 한 패스로 융합
+        result = run_benchmark("axpb expression", kIterations, size * sizeof(float16), [&]() {
+            fp16::fp16_array(y.data(), size) = a * fp16::fp16_array(x.data(), size) + b;
+        });
+        print_result(result);
+
+        // ReLU6(a * x + b) 활성화 함수
+        result = run_benchmark("relu6 three passes", kIterations, size * sizeof(float16), [&]() {
+            fp16_ieee_to_fp32_array(x.data(), fp32_buffer.data(), size);
+            for (size_t i = 0; i < size; i++) {
+                fp32_buffer[i] = std::max(std::min(a * fp32_buffer[i] + b, 6.0f), 0.0f);
+            }
+            fp32_ieee_to_fp16_array(fp32_buffer.data(), y.data(), size);
+        });
+        print_result(result);
+
+        result = run_benchmark("relu6 expression", kIterations, size * sizeof(float16), [&]() {
+            fp16::fp16_array(y.data(), size) = fp16::max(fp16::min(a * fp16::fp16_array(x.data(), size) + b, 6.0f), 0.0f);
+        });
+        print_result(result);
+
+        // 제자리 갱신: y = y * a + x (두 입력 디코드, 계산, 인코드)
+        std::copy(x.begin(), x.end(), y.begin());
+        result = run_benchmark("in-place three passes", kIterations, size * sizeof(float16), [&]() {
+            fp16_ieee_to_fp32_array(y.data(), fp32_buffer.data(), size);
+            fp16_ieee_to_fp32_array(x.data(), fp32_x.data(), size);
+            for (size_t i = 0; i < size; i++) {
+                fp32_buffer[i] = fp32_buffer[i] * a + fp32_x[i];
+            }
+            fp32_ieee_to_fp16_array(fp32_buffer.data(), y.data(), size);
+        });
+        print_result(result);
+
+        std::copy(x.begin(), x.end(), y.begin());
+        result = run_benchmark("in-place expression", kIterations, size * sizeof(float16), [&]() {
+            fp16::fp16_array(y.data(), size) = fp16::fp16_array(y.data(), size) * a + fp16::fp16_array(x.data(), size);
+        });
+        print_result(result);
+    }
+
+    return 0;
+}
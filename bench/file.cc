@@ -0,0 +1,164 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/file.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 3;
+// 입력 파일 크기: FP32 64M개 = 256 MiB
+static const size_t kElements = 64 << 20;
+// 직렬 변환과 cat 복사의 버퍼 크기
+static const size_t kChunkElements = 1 << 20;
+static const size_t kCatBufferSize = 128 << 10;
+
+// 입력 FP32 파일 생성 후 디스크에 내려 쓰기
+static void write_input(const std::string& path) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> chunk(kChunkElements);
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    for (size_t i = 0; i < kElements; i += kChunkElements) {
+        std::generate(chunk.begin(), chunk.end(), [&]() { return dist(rng); });
+        if (write(fd, chunk.data(), chunk.size() * sizeof(float)) != (ssize_t) (chunk.size() * sizeof(float))) {
+            perror("write");
+            exit(1);
+        }
+    }
+    fsync(fd);
+    close(fd);
+}
+
+// 입력 파일을 페이지 캐시에서 내보내 매번 실제 읽기를 측정 (tmpfs에서는 효과 없음)
+static void drop_cache(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// 기준: cat과 같은 128 KiB read/write 복사 (변환 없이 같은 바이트 수)
+static void cat_copy(const std::string& input, const std::string& output) {
+    std::vector<char> buffer(kCatBufferSize);
+    const int in = open(input.c_str(), O_RDONLY);
+    const int out = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ssize_t n;
+    while ((n = read(in, buffer.data(), buffer.size())) > 0) {
+        if (write(out, buffer.data(), (size_t) n) != n) {
+            perror("write");
+            exit(1);
+        }
+    }
+    close(in);
+    close(out);
+}
+
+// 기준: 한 청크씩 읽기 -> 변환 -> 쓰기를 차례로
+static void serial_convert(const std::string& input, const std::string& output) {
+    std::vector<float> fp32_chunk(kChunkElements);
+    std::vector<float16> fp16_chunk(kChunkElements);
+    const int in = open(input.c_str(), O_RDONLY);
+    const int out = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ssize_t n;
+    while ((n = read(in, fp32_chunk.data(), kChunkElements * sizeof(float))) > 0) {
+        const size_t count = (size_t) n / sizeof(float);
+        fp32_ieee_to_fp16_array(fp32_chunk.data(), fp16_chunk.data(), count);
+        if (write(out, fp16_chunk.data(), count * sizeof(float16)) != (ssize_t) (count * sizeof(float16))) {
+            perror("write");
+            exit(1);
+        }
+    }
+    close(in);
+    close(out);
+}
+
+static void run_location(const std::string& directory, const std::string& label) {
+    const std::string input = directory + "/fp16-file-bench.f32";
+    const std::string output = directory + "/fp16-file-bench.out";
+    write_input(input);
+    std::cout << label << " (" << directory << ")" << std::endl;
+
+    const size_t bytes = kElements * sizeof(float);
+    auto result = run_benchmark("cat (read/write)", kIterations, bytes, [&]() {
+        drop_cache(input);
+        cat_copy(input, output);
+    });
+    print_result(result);
+
+    result = run_benchmark("serial", kIterations, bytes, [&]() {
+        drop_cache(input);
+        serial_convert(input, output);
+    });
+    print_result(result);
+
+    struct variant {
+        const char* name;
+        fp16::file_io io;
+        size_t buffers;
+        bool direct;
+    };
+    const variant variants[] = {
+        { "threads, 2 buffers", fp16::file_io::threads, 2, false },
+        { "threads, 3 buffers", fp16::file_io::threads, 3, false },
+        { "io_uring, 2 buffers", fp16::file_io::io_uring, 2, false },
+        { "io_uring, 3 buffers", fp16::file_io::io_uring, 3, false },
+        { "io_uring, O_DIRECT", fp16::file_io::io_uring, 3, true },
+        { "threads, O_DIRECT", fp16::file_io::threads, 3, true },
+    };
+    for (const variant& v : variants) {
+        fp16::file_conversion_options options;
+        options.io = v.io;
+        options.buffers = v.buffers;
+        options.direct = v.direct;
+        fp16::file_conversion_stats stats = {};
+        result = run_benchmark(v.name, kIterations, bytes, [&]() {
+            drop_cache(input);
+            stats = fp16::convert_file(FP16_CONVERSION_FP32_TO_IEEE, input.c_str(), output.c_str(), options);
+        });
+        print_result(result);
+        if (v.direct && !stats.direct) {
+            std::cout << "  (O_DIRECT not supported, buffered I/O)" << std::endl;
+        }
+        if (v.io == fp16::file_io::io_uring && stats.io != fp16::file_io::io_uring) {
+            std::cout << "  (io_uring not available, threads)" << std::endl;
+        }
+    }
+
+    remove(input.c_str());
+    remove(output.c_str());
+}
+
+int main() {
+    std::cout << "FP16 File Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << "FP32 -> FP16, " << kElements * sizeof(float) / 1048576 << " MiB input" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    // tmpfs: 메모리 대역폭과 시스템 호출 비용만 남음
+    run_location("/dev/shm", "tmpfs");
+    // 로컬 디스크: TMPDIR 또는 /var/tmp
+    const char* tmpdir = getenv("TMPDIR");
+    run_location(tmpdir != NULL && tmpdir[0] != '\0' ? tmpdir : "/var/tmp", "local disk");
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/fp8.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 크기마다 변환하는 총 요소 수 (반복 횟수 = kElements / size)
+static const size_t kElements = 1 << 24;
+
+// 테스트 데이터 생성 함수: E4M3 범위를 넘는 값도 포함
+static std::vector<float> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-512.0f, 512.0f), std::mt19937(seed));
+
+    std::vector<float> fp32(size);
+    std::generate(fp32.begin(), fp32.end(), std::ref(rng));
+
+    return fp32;
+}
+
+// fp32_to_fp8_e4m3_value 벤치마크 함수
+static void benchmark_fp32_to_fp8_e4m3_value(std::vector<float>& fp32,
+    std::vector<float8>& fp8, size_t size) {
+
+    auto result = run_benchmark("fp32_to_fp8_e4m3_value", kElements / size, size * sizeof(float8), [&]() {
+        const float* input = fp32.data();
+        float8* output = fp8.data();
+        for (size_t i = 0; i < size; i++) {
+            output[i] = fp32_to_fp8_e4m3_value(input[i], FP8_SATURATE);
+        }
+    });
+
+    print_result(result);
+}
+
+// fp32_to_fp8_e4m3_array 벤치마크 함수
+static void benchmark_fp32_to_fp8_e4m3_array(std::vector<float>& fp32,
+    std::vector<float8>& fp8, size_t size) {
+
+    auto result = run_benchmark("fp32_to_fp8_e4m3_array", kElements / size, size * sizeof(float8), [&]() {
+        fp32_to_fp8_e4m3_array(fp32.data(), fp8.data(), size, FP8_SATURATE);
+    });
+
+    print_result(result);
+}
+
+// fp32_to_fp8_e5m2_value 벤치마크 함수
+static void benchmark_fp32_to_fp8_e5m2_value(std::vector<float>& fp32,
+    std::vector<float8>& fp8, size_t size) {
+
+    auto result = run_benchmark("fp32_to_fp8_e5m2_value", kElements / size, size * sizeof(float8), [&]() {
+        const float* input = fp32.data();
+        float8* output = fp8.data();
+        for (size_t i = 0; i < size; i++) {
+            output[i] = fp32_to_fp8_e5m2_value(input[i], FP8_NO_SATURATION);
+        }
+    });
+
+    print_result(result);
+}
+
+// fp32_to_fp8_e5m2_array 벤치마크 함수
+static void benchmark_fp32_to_fp8_e5m2_array(std::vector<float>& fp32,
+    std::vector<float8>& fp8, size_t size) {
+
+    auto result = run_benchmark("fp32_to_fp8_e5m2_array", kElements / size, size * sizeof(float8), [&]() {
+        fp32_to_fp8_e5m2_array(fp32.data(), fp8.data(), size, FP8_NO_SATURATION);
+    });
+
+    print_result(result);
+}
+
+// fp16_ieee_to_fp8_e4m3_array 벤치마크 함수
+static void benchmark_fp16_ieee_to_fp8_e4m3_array(std::vector<float16>& fp16,
+    std::vector<float8>& fp8, size_t size) {
+
+    auto result = run_benchmark("fp16_to_fp8_e4m3_array", kElements / size, size * sizeof(float8), [&]() {
+        fp16_ieee_to_fp8_e4m3_array(fp16.data(), fp8.data(), size, FP8_SATURATE);
+    });
+
+    print_result(result);
+}
+
+// fp16_ieee_to_fp8_e5m2_array 벤치마크 함수
+static void benchmark_fp16_ieee_to_fp8_e5m2_array(std::vector<float16>& fp16,
+    std::vector<float8>& fp8, size_t size) {
+
+    auto result = run_benchmark("fp16_to_fp8_e5m2_array", kElements / size, size * sizeof(float8), [&]() {
+        fp16_ieee_to_fp8_e5m2_array(fp16.data(), fp8.data(), size, FP8_SATURATE);
+    });
+
+    print_result(result);
+}
+
+int main() {
+    std::cout << "FP32/FP16 to FP8 Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    // 4의 거듭제곱으로 1<<10부터 1<<22까지
+    std::vector<size_t> sizes;
+    for (size_t size = 1 << 10; size <= 1 << 22; size *= 4) {
+        sizes.push_back(size);
+    }
+
+    for (size_t size : sizes) {
+        std::vector<float> fp32 = generate_test_data(size);
+        std::vector<float16> fp16(size);
+        std::vector<float8> fp8(size);
+        fp32_ieee_to_fp16_array(fp32.data(), fp16.data(), size);
+
+        benchmark_fp32_to_fp8_e4m3_value(fp32, fp8, size);
+        benchmark_fp32_to_fp8_e4m3_array(fp32, fp8, size);
+        benchmark_fp32_to_fp8_e5m2_value(fp32, fp8, size);
+        benchmark_fp32_to_fp8_e5m2_array(fp32, fp8, size);
+        benchmark_fp16_ieee_to_fp8_e4m3_array(fp16, fp8, size);
+        benchmark_fp16_ieee_to_fp8_e5m2_array(fp16, fp8, size);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
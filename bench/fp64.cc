@@ -0,0 +1,101 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/fp64.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기
+static const size_t kSize = 1 << 16;
+
+// 테스트 데이터 생성 함수
+static std::vector<double> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<double>(-1.0, 1.0), std::mt19937(seed));
+
+    std::vector<double> fp64(size);
+    std::generate(fp64.begin(), fp64.end(), std::ref(rng));
+
+    return fp64;
+}
+
+int main() {
+    std::cout << "FP64 <-> FP16 Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<double> fp64_input = generate_test_data(kSize);
+    std::vector<float16> fp16_input(kSize);
+    fp64_ieee_to_fp16_array(fp64_input.data(), fp16_input.data(), kSize);
+
+    std::vector<double> fp64_output(kSize);
+    std::vector<float> fp32_buffer(kSize);
+    std::vector<float16> fp16_output(kSize);
+
+    // fp16 -> fp64: 단정밀도를 거치는 변환도 정확하므로 속도만 비교
+    auto result = run_benchmark("fp16_ieee_to_fp64_value", kIterations, kSize * sizeof(double), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp64_output[i] = fp16_ieee_to_fp64_value(fp16_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("  (double) fp16->fp32", kIterations, kSize * sizeof(double), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp64_output[i] = (double) fp16_ieee_to_fp32_value(fp16_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("fp16_ieee_to_fp64_array", kIterations, kSize * sizeof(double), [&]() {
+        fp16_ieee_to_fp64_array(fp16_input.data(), fp64_output.data(), kSize);
+    });
+    print_result(result);
+
+    // fp64 -> fp16: 한 번 반올림 vs 단정밀도를 거치는 이중 반올림
+    result = run_benchmark("fp64_ieee_to_fp16_value", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp16_output[i] = fp64_ieee_to_fp16_value(fp64_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("  via (float) (이중 반올림)", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp16_output[i] = fp32_ieee_to_fp16_value((float) fp64_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("fp64_ieee_to_fp16_array", kIterations, kSize * sizeof(float16), [&]() {
+        fp64_ieee_to_fp16_array(fp64_input.data(), fp16_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("  via fp32 array", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp32_buffer[i] = (float) fp64_input[i];
+        }
+        fp32_ieee_to_fp16_array(fp32_buffer.data(), fp16_output.data(), kSize);
+    });
+    print_result(result);
+
+    return 0;
+}
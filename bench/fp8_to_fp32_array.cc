@@ -0,0 +1,139 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/fp8.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+typedef uint32_t float32_b;
+
+// 크기마다 변환하는 총 요소 수 (반복 횟수 = kElements / size)
+static const size_t kElements = 1 << 24;
+
+// 테스트 데이터 생성 함수: NaN을 제외한 E4M3/E5M2 값
+static std::vector<float8> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_int_distribution<uint32_t>(0, 0x7B), std::mt19937(seed));
+
+    std::vector<float8> fp8(size);
+    std::generate(fp8.begin(), fp8.end(), [&]() { return (float8) rng(); });
+
+    return fp8;
+}
+
+// fp8_e4m3_to_fp32_bits 벤치마크 함수 (256개 항목 테이블 조회)
+static void benchmark_fp8_e4m3_to_fp32_bits(std::vector<float8>& fp8,
+    std::vector<float32_b>& fp32, size_t size) {
+
+    auto result = run_benchmark("fp8_e4m3_to_fp32_bits", kElements / size, size * sizeof(float32_b), [&]() {
+        const float8* input = fp8.data();
+        float32_b* output = fp32.data();
+        for (size_t i = 0; i < size; i++) {
+            output[i] = fp8_e4m3_to_fp32_bits(input[i]);
+        }
+    });
+
+    print_result(result);
+}
+
+// fp8_e4m3_to_fp32_array 벤치마크 함수
+static void benchmark_fp8_e4m3_to_fp32_array(std::vector<float8>& fp8,
+    std::vector<float>& fp32, size_t size) {
+
+    auto result = run_benchmark("fp8_e4m3_to_fp32_array", kElements / size, size * sizeof(float), [&]() {
+        fp8_e4m3_to_fp32_array(fp8.data(), fp32.data(), size);
+    });
+
+    print_result(result);
+}
+
+// fp8_e5m2_to_fp32_bits 벤치마크 함수 (256개 항목 테이블 조회)
+static void benchmark_fp8_e5m2_to_fp32_bits(std::vector<float8>& fp8,
+    std::vector<float32_b>& fp32, size_t size) {
+
+    auto result = run_benchmark("fp8_e5m2_to_fp32_bits", kElements / size, size * sizeof(float32_b), [&]() {
+        const float8* input = fp8.data();
+        float32_b* output = fp32.data();
+        for (size_t i = 0; i < size; i++) {
+            output[i] = fp8_e5m2_to_fp32_bits(input[i]);
+        }
+    });
+
+    print_result(result);
+}
+
+// fp8_e5m2_to_fp32_array 벤치마크 함수
+static void benchmark_fp8_e5m2_to_fp32_array(std::vector<float8>& fp8,
+    std::vector<float>& fp32, size_t size) {
+
+    auto result = run_benchmark("fp8_e5m2_to_fp32_array", kElements / size, size * sizeof(float), [&]() {
+        fp8_e5m2_to_fp32_array(fp8.data(), fp32.data(), size);
+    });
+
+    print_result(result);
+}
+
+// fp8_e4m3_to_fp16_ieee_array 벤치마크 함수
+static void benchmark_fp8_e4m3_to_fp16_ieee_array(std::vector<float8>& fp8,
+    std::vector<float16>& fp16, size_t size) {
+
+    auto result = run_benchmark("fp8_e4m3_to_fp16_array", kElements / size, size * sizeof(float16), [&]() {
+        fp8_e4m3_to_fp16_ieee_array(fp8.data(), fp16.data(), size);
+    });
+
+    print_result(result);
+}
+
+// fp8_e5m2_to_fp16_ieee_array 벤치마크 함수
+static void benchmark_fp8_e5m2_to_fp16_ieee_array(std::vector<float8>& fp8,
+    std::vector<float16>& fp16, size_t size) {
+
+    auto result = run_benchmark("fp8_e5m2_to_fp16_array", kElements / size, size * sizeof(float16), [&]() {
+        fp8_e5m2_to_fp16_ieee_array(fp8.data(), fp16.data(), size);
+    });
+
+    print_result(result);
+}
+
+int main() {
+    std::cout << "FP8 to FP32/FP16 Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    // 4의 거듭제곱으로 1<<10부터 1<<22까지
+    std::vector<size_t> sizes;
+    for (size_t size = 1 << 10; size <= 1 << 22; size *= 4) {
+        sizes.push_back(size);
+    }
+
+    for (size_t size : sizes) {
+        std::vector<float8> fp8 = generate_test_data(size);
+        std::vector<float32_b> fp32_b(size);
+        std::vector<float> fp32(size);
+        std::vector<float16> fp16(size);
+
+        benchmark_fp8_e4m3_to_fp32_bits(fp8, fp32_b, size);
+        benchmark_fp8_e4m3_to_fp32_array(fp8, fp32, size);
+        benchmark_fp8_e5m2_to_fp32_bits(fp8, fp32_b, size);
+        benchmark_fp8_e5m2_to_fp32_array(fp8, fp32, size);
+        benchmark_fp8_e4m3_to_fp16_ieee_array(fp8, fp16, size);
+        benchmark_fp8_e5m2_to_fp16_ieee_array(fp8, fp16, size);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/half.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+#ifdef FP16_COMPARATIVE_BENCHMARKS
+	// half.hpp 기본값(0 방향 버림) 대신 최근접 짝수 반올림으로 비교
+	#define HALF_ROUND_STYLE 1
+	#include <third-party/eigen-half.h>
+	#include <third-party/half.hpp>
+
+	// third-party/eigen-half.h 에는 변환 함수만 있으므로, Eigen::half 와 같이 연산자마다 float 로 계산하고
+	// half 로 되돌리는 타입을 같은 변환 함수로 구성
+	struct eigen_half {
+		Eigen::half_impl::__half raw;
+
+		eigen_half() {}
+		explicit eigen_half(float f) : raw(Eigen::half_impl::float_to_half_rtne(f)) {}
+		explicit operator float() const { return Eigen::half_impl::half_to_float(raw); }
+	};
+
+	static inline eigen_half operator+(eigen_half a, eigen_half b) { return eigen_half(float(a) + float(b)); }
+	static inline eigen_half operator*(eigen_half a, eigen_half b) { return eigen_half(float(a) * float(b)); }
+#endif
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기
+static const size_t kSize = 1 << 16;
+
+// 사용자 코드에서 흔히 보이는 래퍼: 연산자마다 float 로 변환하고 결과를 다시 반올림
+struct adhoc_half {
+    float16 bits;
+
+    adhoc_half() {}
+    explicit adhoc_half(float f) : bits(fp32_ieee_to_fp16_value(f)) {}
+    explicit operator float() const { return fp16_ieee_to_fp32_value(bits); }
+};
+
+static inline adhoc_half operator+(adhoc_half a, adhoc_half b) { return adhoc_half(float(a) + float(b)); }
+static inline adhoc_half operator*(adhoc_half a, adhoc_half b) { return adhoc_half(float(a) * float(b)); }
+
+// 테스트 데이터 생성 함수: [-1, 1] 범위의 값
+static std::vector<float> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
+    std::vector<float> fp32(size);
+    std::generate(fp32.begin(), fp32.end(), std::ref(rng));
+
+    return fp32;
+}
+
+// y = a * x + y 와 y = ((c3 * x + c2) * x + c1) * x + c0 을 각 타입으로 측정
+template<typename Half>
+static void benchmark_type(const std::string& name, const std::vector<float>& x32, const std::vector<float>& y32) {
+    std::vector<Half> x(kSize), y(kSize);
+    for (size_t i = 0; i < kSize; i++) {
+        x[i] = Half(x32[i]);
+        y[i] = Half(y32[i]);
+    }
+    const Half a(0.75f), c0(0.5f), c1(-0.25f), c2(0.125f), c3(-0.0625f);
+
+    auto result = run_benchmark(name + " axpy", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            y[i] = Half(a * x[i] + y[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark(name + " poly3", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            y[i] = Half(((c3 * x[i] + c2) * x[i] + c1) * x[i] + c0);
+        }
+    });
+    print_result(result);
+}
+
+int main() {
+    std::cout << "Half-Precision Value Type Arithmetic Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<float> x32 = generate_test_data(kSize);
+    const std::vector<float> y32 = generate_test_data(kSize);
+
+    // 기준: 단정밀도 배열
+    benchmark_type<float>("float", x32, y32);
+    // 연산자마다 반올림하는 래퍼
+    benchmark_type<adhoc_half>("adhoc", x32, y32);
+    // fp16::half: 대입할 때 한 번만 반올림
+    benchmark_type<fp16::half>("fp16::half", x32, y32);
+    benchmark_type<fp16::strict_half>("fp16::strict_half", x32, y32);
+
+#ifdef FP16_COMPARATIVE_BENCHMARKS
+    benchmark_type<eigen_half>("Eigen::half", x32, y32);
+    benchmark_type<half_float::half>("half_float::half", x32, y32);
+#endif
+
+    return 0;
+}
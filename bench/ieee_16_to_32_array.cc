@@ -66,6 +66,17 @@ static void benchmark_fp16_alt_to_fp32_value(std::vector<float16>& fp16,
     print_result(result);
 }
 
+// fp16_ieee_to_fp32_array 벤치마크 함수
+static void benchmark_fp16_ieee_to_fp32_array(std::vector<float16>& fp16,
+    std::vector<float>& fp32, size_t size) {
+
+    auto result = run_benchmark("fp16_ieee_to_fp32_array", size, sizeof(float), [&]() {
+        fp16_ieee_to_fp32_array(fp16.data(), fp32.data(), size);
+    });
+
+    print_result(result);
+}
+
 
 #ifdef FP16_COMPARATIVE_BENCHMARKS
 	static void TH_halfbits2float(std::vector<float16>& fp16, std::vector<float>& fp32, size_t size) {
@@ -173,6 +184,9 @@ int main() {
         
         // fp16_alt_to_fp32_value 벤치마크
         benchmark_fp16_alt_to_fp32_value(fp16, fp32, size);
+
+        // fp16_ieee_to_fp32_array 벤치마크
+        benchmark_fp16_ieee_to_fp32_array(fp16, fp32, size);
 #ifdef FP16_COMPARATIVE_BENCHMARKS
         TH_halfbits2float(fp16, fp32, size);
         npy_halfbits_to_floatbits(fp16, fp32_b, size);
@@ -48,6 +48,14 @@ static void benchmark_fp32v_to_fp16_ieee_value_array(std::vector<float> &fp32, s
 
 }
 
+static void benchmark_fp32_ieee_to_fp16_array(std::vector<float> &fp32, std::vector<float16> &fp16, size_t size)
+{
+    auto result = run_benchmark("fp32_ieee_to_fp16_array", size, sizeof(uint16_t), [&]() {
+        fp32_ieee_to_fp16_array(fp32.data(), fp16.data(), size);
+    });
+    print_result(result);
+}
+
 #ifdef FP16_COMPARATIVE_BENCHMARKS
 	static void TH_float2halfbits(std::vector<float> &fp32, std::vector<float16> &fp16, size_t size) {
         float* input = fp32.data();
@@ -140,6 +148,7 @@ int main() {
         std::vector<float16> fp16(size);
 
         benchmark_fp32v_to_fp16_ieee_value_array(fp32, fp16, size);
+        benchmark_fp32_ieee_to_fp16_array(fp32, fp16, size);
 
 #ifdef FP16_COMPARATIVE_BENCHMARKS
     TH_float2halfbits(fp32, fp16, size);
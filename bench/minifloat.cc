@@ -0,0 +1,201 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/minifloat.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기
+static const size_t kSize = 1 << 16;
+
+// 테스트 데이터 생성 함수
+static std::vector<float> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
+    std::vector<float> fp32(size);
+    std::generate(fp32.begin(), fp32.end(), std::ref(rng));
+
+    return fp32;
+}
+
+int main() {
+    std::cout << "Minifloat Template Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<float> fp32_input = generate_test_data(kSize);
+    std::vector<float16> ieee_input(kSize);
+    std::vector<float16> alt_input(kSize);
+    std::vector<uint8_t> e4m3_input(kSize);
+    std::vector<uint32_t> tf32_input(kSize);
+    std::vector<uint32_t> fp24_input(kSize);
+    fp32_ieee_to_fp16_array(fp32_input.data(), ieee_input.data(), kSize);
+    fp32_alt_to_fp16_array(fp32_input.data(), alt_input.data(), kSize);
+    fp32_to_fp8_e4m3_array(fp32_input.data(), e4m3_input.data(), kSize, FP8_NO_SATURATION);
+    minifloat_tf32::from_fp32_array(fp32_input.data(), tf32_input.data(), kSize);
+    minifloat_fp24::from_fp32_array(fp32_input.data(), fp24_input.data(), kSize);
+
+    std::vector<float> fp32_output(kSize);
+    std::vector<float16> fp16_output(kSize);
+    std::vector<uint8_t> fp8_output(kSize);
+    std::vector<uint32_t> u32_output(kSize);
+
+    // 스칼라: fp16.h 함수와 minifloat<5, 10> 인스턴스는 같은 연산으로 컴파일되어야 함
+    auto result = run_benchmark("fp16_ieee_to_fp32_value", kIterations, kSize * sizeof(float), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp32_output[i] = fp16_ieee_to_fp32_value(ieee_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat<5,10>", kIterations, kSize * sizeof(float), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp32_output[i] = minifloat_fp16_ieee::to_fp32_value(ieee_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("fp32_ieee_to_fp16_value", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp16_output[i] = fp32_ieee_to_fp16_value(fp32_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat<5,10>", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp16_output[i] = minifloat_fp16_ieee::from_fp32_value(fp32_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("fp16_alt_to_fp32_value", kIterations, kSize * sizeof(float), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp32_output[i] = fp16_alt_to_fp32_value(alt_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat alt", kIterations, kSize * sizeof(float), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp32_output[i] = minifloat_fp16_alt::to_fp32_value(alt_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("fp32_alt_to_fp16_value", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp16_output[i] = fp32_alt_to_fp16_value(fp32_input[i]);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat alt", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            fp16_output[i] = minifloat_fp16_alt::from_fp32_value(fp32_input[i]);
+        }
+    });
+    print_result(result);
+
+    // 배열: array.h의 ARM 형식 커널은 같은 알고리즘, IEEE 커널은 F16C 명령어 사용
+    result = run_benchmark("fp16_alt_to_fp32_array", kIterations, kSize * sizeof(float), [&]() {
+        fp16_alt_to_fp32_array(alt_input.data(), fp32_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat alt", kIterations, kSize * sizeof(float), [&]() {
+        minifloat_fp16_alt::to_fp32_array(alt_input.data(), fp32_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp32_alt_to_fp16_array", kIterations, kSize * sizeof(float16), [&]() {
+        fp32_alt_to_fp16_array(fp32_input.data(), fp16_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat alt", kIterations, kSize * sizeof(float16), [&]() {
+        minifloat_fp16_alt::from_fp32_array(fp32_input.data(), fp16_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp16_ieee_to_fp32_array", kIterations, kSize * sizeof(float), [&]() {
+        fp16_ieee_to_fp32_array(ieee_input.data(), fp32_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat<5,10>", kIterations, kSize * sizeof(float), [&]() {
+        minifloat_fp16_ieee::to_fp32_array(ieee_input.data(), fp32_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp32_ieee_to_fp16_array", kIterations, kSize * sizeof(float16), [&]() {
+        fp32_ieee_to_fp16_array(fp32_input.data(), fp16_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat<5,10>", kIterations, kSize * sizeof(float16), [&]() {
+        minifloat_fp16_ieee::from_fp32_array(fp32_input.data(), fp16_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp8_e4m3_to_fp32_array", kIterations, kSize * sizeof(float), [&]() {
+        fp8_e4m3_to_fp32_array(e4m3_input.data(), fp32_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat<4,3>", kIterations, kSize * sizeof(float), [&]() {
+        minifloat_fp8_e4m3::to_fp32_array(e4m3_input.data(), fp32_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp32_to_fp8_e4m3_array", kIterations, kSize * sizeof(uint8_t), [&]() {
+        fp32_to_fp8_e4m3_array(fp32_input.data(), fp8_output.data(), kSize, FP8_NO_SATURATION);
+    });
+    print_result(result);
+
+    result = run_benchmark("  minifloat<4,3>", kIterations, kSize * sizeof(uint8_t), [&]() {
+        minifloat_fp8_e4m3::from_fp32_array(fp32_input.data(), fp8_output.data(), kSize);
+    });
+    print_result(result);
+
+    // 기존 함수가 없는 형식
+    result = run_benchmark("tf32_to_fp32_array", kIterations, kSize * sizeof(float), [&]() {
+        minifloat_tf32::to_fp32_array(tf32_input.data(), fp32_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp32_to_tf32_array", kIterations, kSize * sizeof(uint32_t), [&]() {
+        minifloat_tf32::from_fp32_array(fp32_input.data(), u32_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp24_to_fp32_array", kIterations, kSize * sizeof(float), [&]() {
+        minifloat_fp24::to_fp32_array(fp24_input.data(), fp32_output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp32_to_fp24_array", kIterations, kSize * sizeof(uint32_t), [&]() {
+        minifloat_fp24::from_fp32_array(fp32_input.data(), u32_output.data(), kSize);
+    });
+    print_result(result);
+
+    return 0;
+}
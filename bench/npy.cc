@@ -0,0 +1,172 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/npy.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 3;
+// 체크포인트: 4M개 FP16 텐서 24개 = 192 MiB
+static const size_t kTensors = 24;
+static const size_t kTensorElements = 4 << 20;
+
+// 페이지 캐시에서 파일을 내보내 매번 디스크에서 읽는 로딩을 측정 (tmpfs에서는 효과 없음)
+static void drop_cache(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+static std::string tensor_name(size_t i) {
+    return "layers." + std::to_string(i) + ".weight";
+}
+
+// 기준 방식: 파일 전체를 메모리로 읽은 뒤 헤더를 직접 파싱
+static std::vector<char> read_whole_file(const std::string& path) {
+    std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+    std::vector<char> bytes((size_t) file.tellg());
+    file.seekg(0);
+    file.read(bytes.data(), (std::streamsize) bytes.size());
+    return bytes;
+}
+
+// 읽어 둔 .npz를 로컬 헤더를 따라가며 직접 파싱해 멤버 .npy 파일의 시작 위치를 찾음
+static std::vector<const char*> walk_members(const std::vector<char>& bytes) {
+    std::vector<const char*> members;
+    size_t position = 0;
+    while (position + 30 <= bytes.size() && fp16::npy_load_le32((const unsigned char*) &bytes[position]) == 0x04034B50) {
+        const unsigned char* local = (const unsigned char*) &bytes[position];
+        const size_t npy = position + 30 + fp16::npy_load_le16(local + 26) + fp16::npy_load_le16(local + 28);
+        members.push_back(&bytes[npy]);
+        position = npy + fp16::npy_load_le32(local + 18);
+    }
+    return members;
+}
+
+int main() {
+    std::cout << "FP16 NPY Loading Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    const char* tmpdir = getenv("TMPDIR");
+    const std::string path = std::string(tmpdir != NULL && tmpdir[0] != '\0' ? tmpdir : "/var/tmp") + "/fp16-npy-bench.npz";
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<float> weights(kTensorElements);
+        fp16::npz_writer writer(path.c_str());
+        for (size_t i = 0; i < kTensors; i++) {
+            std::generate(weights.begin(), weights.end(), [&]() { return dist(rng); });
+            writer.add(tensor_name(i), weights.data(), { 2048, kTensorElements / 2048 }, fp16::npy_dtype::float16);
+        }
+        writer.close();
+        const int fd = open(path.c_str(), O_RDONLY);
+        fsync(fd);
+        close(fd);
+    }
+    const size_t file_bytes = kTensors * kTensorElements * sizeof(float16);
+    std::cout << kTensors << " float16 tensors, " << file_bytes / 1048576 << " MiB (" << path << ")" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    std::vector<float> fp32(kTensorElements);
+    float checksum = 0.0f;
+
+    // 첫 텐서를 쓸 수 있을 때까지의 시간: 전체 읽기 vs mmap
+    auto result = run_benchmark("first tensor, read all", kIterations, kTensorElements * sizeof(float16), [&]() {
+        drop_cache(path);
+        const std::vector<char> bytes = read_whole_file(path);
+        const char* npy = walk_members(bytes)[0];
+        const fp16::npy_header header = fp16::npy_parse_header(npy, bytes.size() - (size_t) (npy - bytes.data()));
+        fp16_ieee_to_fp32_array((const float16*) (npy + header.data_offset), fp32.data(), kTensorElements);
+        checksum += fp32[0];
+    });
+    print_result(result);
+
+    result = run_benchmark("first tensor, mmap", kIterations, kTensorElements * sizeof(float16), [&]() {
+        drop_cache(path);
+        fp16::npz_file file(path.c_str());
+        file[tensor_name(0)].decode(0, kTensorElements, fp32.data());
+        checksum += fp32[0];
+    });
+    print_result(result);
+
+    // 모든 텐서를 FP32로 디코드 (텐서마다 같은 버퍼를 재사용해 장치로 올리는 상황을 흉내)
+    result = run_benchmark("all tensors, read all", kIterations, file_bytes, [&]() {
+        drop_cache(path);
+        const std::vector<char> bytes = read_whole_file(path);
+        for (const char* npy : walk_members(bytes)) {
+            const fp16::npy_header header = fp16::npy_parse_header(npy, bytes.size() - (size_t) (npy - bytes.data()));
+            fp16_ieee_to_fp32_array((const float16*) (npy + header.data_offset), fp32.data(), kTensorElements);
+            checksum += fp32[0];
+        }
+    });
+    print_result(result);
+
+    const fp16::npy_advice advices[] = { fp16::npy_advice::normal, fp16::npy_advice::sequential };
+    const char* advice_names[] = { "all tensors, mmap", "all tensors, SEQUENTIAL" };
+    for (size_t a = 0; a < 2; a++) {
+        result = run_benchmark(advice_names[a], kIterations, file_bytes, [&]() {
+            drop_cache(path);
+            fp16::npz_file file(path.c_str(), advices[a]);
+            for (size_t i = 0; i < kTensors; i++) {
+                file[tensor_name(i)].decode(0, kTensorElements, fp32.data());
+                checksum += fp32[0];
+            }
+        });
+        print_result(result);
+    }
+
+    // 현재 텐서를 디코드하는 동안 다음 텐서를 미리 읽도록 MADV_WILLNEED
+    result = run_benchmark("all tensors, WILLNEED", kIterations, file_bytes, [&]() {
+        drop_cache(path);
+        fp16::npz_file file(path.c_str(), fp16::npy_advice::sequential);
+        file[tensor_name(0)].advise(fp16::npy_advice::willneed);
+        for (size_t i = 0; i < kTensors; i++) {
+            if (i + 1 < kTensors) {
+                file[tensor_name(i + 1)].advise(fp16::npy_advice::willneed);
+            }
+            file[tensor_name(i)].decode(0, kTensorElements, fp32.data());
+            checksum += fp32[0];
+        }
+    });
+    print_result(result);
+
+    // FP32 버퍼 없이 지연 변환 뷰로 순회 (합계)
+    result = run_benchmark("all tensors, lazy view", kIterations, file_bytes, [&]() {
+        drop_cache(path);
+        fp16::npz_file file(path.c_str(), fp16::npy_advice::sequential);
+        for (size_t i = 0; i < kTensors; i++) {
+            float sum = 0.0f;
+            for (float x : file[tensor_name(i)].fp32()) {
+                sum += x;
+            }
+            checksum += sum;
+        }
+    });
+    print_result(result);
+
+    std::cout << "Checksum: " << checksum << std::endl;
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/policy.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기
+static const size_t kSize = 1 << 16;
+
+// 테스트 데이터 생성 함수: 오버플로, 무한대, NaN, 비정규 값이 섞인 입력
+static std::vector<float> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-100000.0f, 100000.0f), std::mt19937(seed));
+
+    std::vector<float> fp32(size);
+    std::generate(fp32.begin(), fp32.end(), std::ref(rng));
+    for (size_t i = 0; i < size; i += 7) {
+        fp32[i] = std::nanf("");
+    }
+    for (size_t i = 3; i < size; i += 11) {
+        fp32[i] *= 1.0e-10f;
+    }
+
+    return fp32;
+}
+
+int main() {
+    std::cout << "FP32 to FP16 Encode Policy Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<float> input = generate_test_data(kSize);
+    std::vector<float16> output(kSize);
+    const unsigned flags = FP16_ENCODE_SATURATE | FP16_ENCODE_NAN_TO_VALUE | FP16_ENCODE_FLUSH_DENORMALS;
+
+    // 기준: 정책 없는 벌크 변환
+    auto result = run_benchmark("array", kIterations, kSize * sizeof(float16), [&]() {
+        fp32_ieee_to_fp16_array(input.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    // 기존 방식: 벌크 변환 후 출력을 다시 훑으며 정책 적용
+    result = run_benchmark("array + fixup pass", kIterations, kSize * sizeof(float16), [&]() {
+        fp32_ieee_to_fp16_array(input.data(), output.data(), kSize);
+        for (size_t i = 0; i < kSize; i++) {
+            output[i] = fp16_apply_encode_policy(output[i], (output[i] & 0x7FFF) > 0x7C00, flags, 0);
+        }
+    });
+    print_result(result);
+
+    // 요소별 스칼라 정책 변환
+    result = run_benchmark("value_policy", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            output[i] = fp32_ieee_to_fp16_value_policy(input[i], flags, 0);
+        }
+    });
+    print_result(result);
+
+    // 커널에 정책을 합친 벌크 변환
+    result = run_benchmark("array_policy", kIterations, kSize * sizeof(float16), [&]() {
+        fp32_ieee_to_fp16_array_policy(input.data(), output.data(), kSize, flags, 0);
+    });
+    print_result(result);
+
+    result = run_benchmark("alt array_policy", kIterations, kSize * sizeof(float16), [&]() {
+        fp32_alt_to_fp16_array_policy(input.data(), output.data(), kSize, flags, 0);
+    });
+    print_result(result);
+
+    return 0;
+}
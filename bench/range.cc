@@ -0,0 +1,97 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/range.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기
+static const size_t kSize = 1 << 16;
+
+// 테스트 데이터 생성 함수: [-1, 1] 범위의 FP16 값
+static std::vector<float16> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
+    std::vector<float16> fp16(size);
+    std::generate(fp16.begin(), fp16.end(), [&]() { return fp32_ieee_to_fp16_value(rng()); });
+
+    return fp16;
+}
+
+int main() {
+    std::cout << "FP16 Converting Range Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<float16> input = generate_test_data(kSize);
+    std::vector<float16> output(kSize);
+    volatile float sink = 0.0f;
+
+    // 합계: 요소마다 스칼라 변환
+    auto result = run_benchmark("sum scalar", kIterations, kSize * sizeof(float16), [&]() {
+        float sum = 0.0f;
+        for (size_t i = 0; i < kSize; i++) {
+            sum += fp16_ieee_to_fp32_value(input[i]);
+        }
+        sink = sum;
+    });
+    print_result(result);
+
+    // 합계: FP32 사본을 할당하고 배열 변환 후 합산
+    result = run_benchmark("sum fp32 copy", kIterations, kSize * sizeof(float16), [&]() {
+        std::vector<float> fp32(kSize);
+        fp16_ieee_to_fp32_array(input.data(), fp32.data(), kSize);
+        sink = std::accumulate(fp32.begin(), fp32.end(), 0.0f);
+    });
+    print_result(result);
+
+    // 합계: 할당 없이 변환 범위를 순회
+    result = run_benchmark("sum as_fp32", kIterations, kSize * sizeof(float16), [&]() {
+        const fp16::fp32_range view = fp16::as_fp32(input);
+        sink = std::accumulate(view.begin(), view.end(), 0.0f);
+    });
+    print_result(result);
+
+    // 변환 후 기록: 스칼라 루프, 요소마다 인코드하는 출력 반복자, 청크 단위로 인코드하는 fp16_writer 비교
+    result = run_benchmark("transform scalar", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            output[i] = fp32_ieee_to_fp16_value(fp16_ieee_to_fp32_value(input[i]) * 0.5f);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("transform as_fp32", kIterations, kSize * sizeof(float16), [&]() {
+        const fp16::fp32_range view = fp16::as_fp32(input);
+        std::transform(view.begin(), view.end(), fp16::fp16_encoder(output.data()), [](float f) { return f * 0.5f; });
+    });
+    print_result(result);
+
+    result = run_benchmark("transform fp16_writer", kIterations, kSize * sizeof(float16), [&]() {
+        const fp16::fp32_range view = fp16::as_fp32(input);
+        fp16::fp16_writer writer(output.data());
+        std::transform(view.begin(), view.end(), writer.begin(), [](float f) { return f * 0.5f; });
+    });
+    print_result(result);
+
+    (void) sink;
+    return 0;
+}
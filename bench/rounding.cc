@@ -0,0 +1,92 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <cfenv>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/rounding.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기
+static const size_t kSize = 1 << 16;
+
+// 테스트 데이터 생성 함수
+static std::vector<float> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-65504.0f, 65504.0f), std::mt19937(seed));
+
+    std::vector<float> fp32(size);
+    std::generate(fp32.begin(), fp32.end(), std::ref(rng));
+
+    return fp32;
+}
+
+static const fp16_rounding_mode kModes[] = {
+    FP16_ROUND_NEAREST_EVEN, FP16_ROUND_TOWARD_ZERO, FP16_ROUND_UP, FP16_ROUND_DOWN, FP16_ROUND_NEAREST_AWAY,
+};
+static const char* const kModeNames[] = { "RNE", "RTZ", "RU", "RD", "RNA" };
+// fesetround로 전역 반올림 모드를 바꾸는 기존 방식에 대응하는 모드 (RNA는 대응 모드 없음)
+static const int kFenvModes[] = { FE_TONEAREST, FE_TOWARDZERO, FE_UPWARD, FE_DOWNWARD, -1 };
+
+int main() {
+    std::cout << "FP32 to FP16 Rounding Mode Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<float> input = generate_test_data(kSize);
+    std::vector<float16> output(kSize);
+
+    for (size_t m = 0; m < sizeof(kModes) / sizeof(kModes[0]); m++) {
+        const fp16_rounding_mode mode = kModes[m];
+        std::cout << kModeNames[m] << std::endl;
+
+        // 스칼라 정수 구현
+        auto result = run_benchmark("ieee value_rounded", kIterations, kSize * sizeof(float16), [&]() {
+            for (size_t i = 0; i < kSize; i++) {
+                output[i] = fp32_ieee_to_fp16_value_rounded(input[i], mode);
+            }
+        });
+        print_result(result);
+
+        // 벌크 변환 (F16C 즉시값 또는 정수 SIMD 커널)
+        result = run_benchmark("ieee array_rounded", kIterations, kSize * sizeof(float16), [&]() {
+            fp32_ieee_to_fp16_array_rounded(input.data(), output.data(), kSize, mode);
+        });
+        print_result(result);
+
+        result = run_benchmark("alt array_rounded", kIterations, kSize * sizeof(float16), [&]() {
+            fp32_alt_to_fp16_array_rounded(input.data(), output.data(), kSize, mode);
+        });
+        print_result(result);
+
+        // 호출마다 전역 반올림 모드를 바꾸고 되돌리는 방식
+        if (kFenvModes[m] >= 0) {
+            result = run_benchmark("fesetround+array", kIterations, kSize * sizeof(float16), [&]() {
+                const int saved = std::fegetround();
+                std::fesetround(kFenvModes[m]);
+                fp32_ieee_to_fp16_array(input.data(), output.data(), kSize);
+                std::fesetround(saved);
+            });
+            print_result(result);
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 요소 수마다 변환 함수를 호출하는 횟수
+static const size_t kCalls = 200000;
+static const size_t kMaxElements = 256;
+
+// 테스트 데이터 생성 함수
+static std::vector<float16> generate_fp16_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_int_distribution<float16>(0, 0x7BFF), std::mt19937(seed));
+
+    std::vector<float16> fp16(size);
+    std::generate(fp16.begin(), fp16.end(), std::ref(rng));
+
+    return fp16;
+}
+
+static std::vector<float> generate_fp32_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
+    std::vector<float> fp32(size);
+    std::generate(fp32.begin(), fp32.end(), std::ref(rng));
+
+    return fp32;
+}
+
+// 호출 한 번당 평균 시간(ns)
+template<typename Func>
+static double nanoseconds_per_call(const std::string& name, size_t n, size_t type_size, Func func) {
+    const BenchmarkResult result = run_benchmark(name, kCalls, n * type_size, func);
+    return result.avg_time_per_iteration_sec * 1000.0;
+}
+
+int main() {
+    std::cout << "Small Array Conversion Benchmarks (ns per call)" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::right << std::setw(5) << "N"
+              << std::setw(14) << "ieee16 loop" << std::setw(14) << "ieee16 array"
+              << std::setw(14) << "ieee32 loop" << std::setw(14) << "ieee32 array"
+              << std::setw(14) << "alt16 array" << std::setw(14) << "alt32 array"
+              << std::endl;
+    std::cout << std::string(89, '-') << std::endl;
+
+    const std::vector<float16> fp16_input = generate_fp16_data(kMaxElements);
+    const std::vector<float> fp32_input = generate_fp32_data(kMaxElements);
+    std::vector<float> fp32_output(kMaxElements);
+    std::vector<float16> fp16_output(kMaxElements);
+
+    // 1부터 256까지 모든 요소 수
+    for (size_t n = 1; n <= kMaxElements; n++) {
+        const float16* h = fp16_input.data();
+        const float* f = fp32_input.data();
+        float* f_out = fp32_output.data();
+        float16* h_out = fp16_output.data();
+
+        const double ieee16_loop = nanoseconds_per_call("fp16_ieee_to_fp32_value", n, sizeof(float), [&]() {
+            for (size_t i = 0; i < n; i++) {
+                f_out[i] = fp16_ieee_to_fp32_value(h[i]);
+            }
+        });
+        const double ieee16_array = nanoseconds_per_call("fp16_ieee_to_fp32_array", n, sizeof(float), [&]() {
+            fp16_ieee_to_fp32_array(h, f_out, n);
+        });
+        const double ieee32_loop = nanoseconds_per_call("fp32_ieee_to_fp16_value", n, sizeof(float16), [&]() {
+            for (size_t i = 0; i < n; i++) {
+                h_out[i] = fp32_ieee_to_fp16_value(f[i]);
+            }
+        });
+        const double ieee32_array = nanoseconds_per_call("fp32_ieee_to_fp16_array", n, sizeof(float16), [&]() {
+            fp32_ieee_to_fp16_array(f, h_out, n);
+        });
+        const double alt16_array = nanoseconds_per_call("fp16_alt_to_fp32_array", n, sizeof(float), [&]() {
+            fp16_alt_to_fp32_array(h, f_out, n);
+        });
+        const double alt32_array = nanoseconds_per_call("fp32_alt_to_fp16_array", n, sizeof(float16), [&]() {
+            fp32_alt_to_fp16_array(f, h_out, n);
+        });
+
+        std::cout << std::right << std::setw(5) << n << std::fixed << std::setprecision(2)
+                  << std::setw(14) << ieee16_loop << std::setw(14) << ieee16_array
+                  << std::setw(14) << ieee32_loop << std::setw(14) << ieee32_array
+                  << std::setw(14) << alt16_array << std::setw(14) << alt32_array
+                  << std::endl;
+    }
+
+    return 0;
+}
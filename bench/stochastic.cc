@@ -0,0 +1,87 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/rounding.h>
+#include <fp16/stochastic.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기
+static const size_t kSize = 1 << 16;
+
+// 테스트 데이터 생성 함수
+static std::vector<float> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
+    std::vector<float> fp32(size);
+    std::generate(fp32.begin(), fp32.end(), std::ref(rng));
+
+    return fp32;
+}
+
+int main() {
+    std::cout << "FP32 to FP16 Stochastic Rounding Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<float> input = generate_test_data(kSize);
+    std::vector<float16> output(kSize);
+
+    // 기준: 최근접 짝수 반올림 벌크 변환
+    auto result = run_benchmark("RNE array", kIterations, kSize * sizeof(float16), [&]() {
+        fp32_ieee_to_fp16_array(input.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    // 기존 방식: 요소마다 std::mt19937 난수를 버려지는 가수 비트에 더한 뒤 0 방향 반올림
+    std::mt19937 mt(42);
+    result = run_benchmark("mt19937 per element", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            const uint32_t noisy = fp32v_to_fp32b(input[i]) + (mt() >> 19);
+            output[i] = fp32_ieee_to_fp16_value_rounded(fp32b_to_fp32v(noisy), FP16_ROUND_TOWARD_ZERO);
+        }
+    });
+    print_result(result);
+
+    // 카운터 기반 난수를 쓰는 스칼라 확률적 반올림
+    result = run_benchmark("value_stochastic", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            output[i] = fp32_ieee_to_fp16_value_stochastic(input[i], 42, i);
+        }
+    });
+    print_result(result);
+
+    // 레지스터 내 SIMD 난수 생성을 쓰는 벌크 확률적 반올림
+    uint64_t offset = 0;
+    result = run_benchmark("array_stochastic", kIterations, kSize * sizeof(float16), [&]() {
+        fp32_ieee_to_fp16_array_stochastic(input.data(), output.data(), kSize, 42, offset);
+        offset += kSize;
+    });
+    print_result(result);
+
+    result = run_benchmark("alt array_stochastic", kIterations, kSize * sizeof(float16), [&]() {
+        fp32_alt_to_fp16_array_stochastic(input.data(), output.data(), kSize, 42, offset);
+        offset += kSize;
+    });
+    print_result(result);
+
+    return 0;
+}
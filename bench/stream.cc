@@ -0,0 +1,190 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <thread>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/stream.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 센서 프레임 크기 (FP32 4096개 = 16 KiB)와 스트림 길이
+static const size_t kFrameElements = 4096;
+static const size_t kFrames = 20000;
+// 센서가 순환하며 내보내는 원본 프레임 수
+static const size_t kSourceFrames = 64;
+// 링 슬롯 수
+static const size_t kSlots = 64;
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 센서 신호: 잡음이 섞인 사인파
+static std::vector<float> generate_sensor_frames() {
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    std::vector<float> frames(kSourceFrames * kFrameElements);
+    for (size_t i = 0; i < frames.size(); i++) {
+        frames[i] = std::sin((float) i / 64.0f) + noise(rng);
+    }
+    return frames;
+}
+
+// 소비자(저장 단계)가 FP16 청크를 복사 없이 읽음
+static uint32_t store_chunk(const float16* data, size_t count) {
+    uint32_t checksum = 0;
+    for (size_t i = 0; i < count; i++) {
+        checksum = checksum * 31 + data[i];
+    }
+    return checksum;
+}
+
+// 제출(생산 완료)부터 소비자가 꺼낼 때까지의 지연 백분위와, 저장한 데이터의 체크섬 출력 (저장 작업이 최적화로 사라지지 않도록)
+static void print_latency(std::vector<int64_t>& latencies, uint32_t checksum) {
+    std::sort(latencies.begin(), latencies.end());
+    const size_t n = latencies.size();
+    std::cout << std::left << std::setw(25) << "  latency"
+              << std::right << std::fixed << std::setprecision(1)
+              << "p50 " << latencies[n / 2] / 1000.0 << " us, "
+              << "p99 " << latencies[n * 99 / 100] / 1000.0 << " us, "
+              << "p99.9 " << latencies[n * 999 / 1000] / 1000.0 << " us, "
+              << "max " << latencies[n - 1] / 1000.0 << " us, "
+              << "checksum " << std::hex << checksum << std::dec
+              << std::endl;
+}
+
+// 생산자 스레드들 -> 변환 스테이지 -> 소비자(호출 스레드)
+static void run_stage(const std::vector<float>& source, size_t producers, size_t workers, const std::string& name) {
+    std::vector<int64_t> latencies;
+    latencies.reserve(kFrames);
+    uint32_t checksum = 0;
+    auto result = run_benchmark(name, 1, kFrames * kFrameElements * sizeof(float), [&]() {
+        fp16::stream_converter stage(FP16_CONVERSION_FP32_TO_IEEE, kFrameElements, kSlots, workers);
+        std::vector<int64_t> submitted(kSlots);
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; p++) {
+            threads.push_back(std::thread([&, p]() {
+                for (size_t frame = p; frame < kFrames; frame += producers) {
+                    fp16::stream_converter::input_chunk chunk = stage.acquire();
+                    memcpy(chunk.data, &source[(frame % kSourceFrames) * kFrameElements], kFrameElements * sizeof(float));
+                    submitted[chunk.slot] = now_ns();
+                    stage.submit(chunk, kFrameElements);
+                }
+            }));
+        }
+        std::thread closer([&]() {
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            stage.close();
+        });
+        fp16::stream_converter::output_chunk chunk;
+        while (stage.pop(chunk)) {
+            latencies.push_back(now_ns() - submitted[chunk.slot]);
+            checksum ^= store_chunk((const float16*) chunk.data, chunk.count);
+            stage.release(chunk);
+        }
+        closer.join();
+    });
+    print_result(result);
+    print_latency(latencies, checksum);
+}
+
+int main() {
+    std::cout << "FP16 Streaming Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << kFrames << " frames of " << kFrameElements << " FP32 elements ("
+              << kFrames * kFrameElements * sizeof(float) / 1048576 << " MiB), "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<float> source = generate_sensor_frames();
+    const size_t bytes = kFrames * kFrameElements * sizeof(float);
+
+    // 기준: 한 스레드에서 프레임 수신, 변환, 저장을 차례로
+    {
+        std::vector<float> frame(kFrameElements);
+        std::vector<float16> encoded(kFrameElements);
+        std::vector<int64_t> latencies;
+        latencies.reserve(kFrames);
+        uint32_t checksum = 0;
+        auto result = run_benchmark("serial", 1, bytes, [&]() {
+            for (size_t i = 0; i < kFrames; i++) {
+                memcpy(frame.data(), &source[(i % kSourceFrames) * kFrameElements], kFrameElements * sizeof(float));
+                const int64_t start = now_ns();
+                fp32_ieee_to_fp16_array(frame.data(), encoded.data(), kFrameElements);
+                checksum ^= store_chunk(encoded.data(), kFrameElements);
+                latencies.push_back(now_ns() - start);
+            }
+        });
+        print_result(result);
+        print_latency(latencies, checksum);
+    }
+
+    // SPSC 링 두 개: 생산자가 직접 인코딩해 FP16 버퍼 번호를 넘기고, 소비자는 빈 버퍼 번호를 돌려줌
+    {
+        std::vector<float> frame(kFrameElements);
+        std::vector<float16> buffers(kSlots * kFrameElements);
+        std::vector<int64_t> submitted(kSlots);
+        std::vector<int64_t> latencies;
+        latencies.reserve(kFrames);
+        uint32_t checksum = 0;
+        auto result = run_benchmark("spsc ring", 1, bytes, [&]() {
+            fp16::spsc_ring<uint32_t> ready(kSlots), free_buffers(kSlots);
+            for (uint32_t i = 0; i < kSlots; i++) {
+                free_buffers.try_push(i);
+            }
+            std::thread producer([&]() {
+                for (size_t i = 0; i < kFrames; i++) {
+                    uint32_t buffer;
+                    fp16::stream_backoff backoff;
+                    while (!free_buffers.try_pop(buffer)) {
+                        backoff.wait();
+                    }
+                    memcpy(frame.data(), &source[(i % kSourceFrames) * kFrameElements], kFrameElements * sizeof(float));
+                    submitted[buffer] = now_ns();
+                    fp32_ieee_to_fp16_array(frame.data(), &buffers[buffer * kFrameElements], kFrameElements);
+                    ready.try_push(buffer);
+                }
+            });
+            for (size_t i = 0; i < kFrames; i++) {
+                uint32_t buffer;
+                fp16::stream_backoff backoff;
+                while (!ready.try_pop(buffer)) {
+                    backoff.wait();
+                }
+                latencies.push_back(now_ns() - submitted[buffer]);
+                checksum ^= store_chunk(&buffers[buffer * kFrameElements], kFrameElements);
+                free_buffers.try_push(buffer);
+            }
+            producer.join();
+        });
+        print_result(result);
+        print_latency(latencies, checksum);
+    }
+
+    // 변환 스테이지: 변환 전용 작업 스레드, 복사 없는 슬롯 전달
+    run_stage(source, 1, 1, "stage, 1 worker");
+    run_stage(source, 1, 2, "stage, 2 workers");
+    // MPSC: 여러 센서 생산자가 하나의 스테이지로
+    run_stage(source, 4, 2, "stage, 4 producers");
+
+    return 0;
+}
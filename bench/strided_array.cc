@@ -0,0 +1,106 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/strided.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 100;
+
+// 테스트 데이터 생성 함수
+static std::vector<float16> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_int_distribution<float16>(0, 0x7BFF), std::mt19937(seed));
+
+    std::vector<float16> fp16(size);
+    std::generate(fp16.begin(), fp16.end(), std::ref(rng));
+
+    return fp16;
+}
+
+// 임시 버퍼로 모은(gather) 뒤 연속 배열로 변환하는 기존 방식
+static void benchmark_gather_then_convert(const std::vector<float16>& matrix, size_t rows, size_t columns,
+    size_t row_pitch, size_t column_step, std::vector<float>& output)
+{
+    const size_t n = rows * columns;
+    std::vector<float16> temporary(n);
+    auto result = run_benchmark("gather+array", kIterations, n * sizeof(float), [&]() {
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < columns; j++) {
+                temporary[i * columns + j] = matrix[i * row_pitch + j * column_step];
+            }
+        }
+        fp16_ieee_to_fp32_array(temporary.data(), output.data(), n);
+    });
+    print_result(result);
+}
+
+// 스칼라 변환 루프
+static void benchmark_scalar_strided(const std::vector<float16>& matrix, size_t rows, size_t columns,
+    size_t row_pitch, size_t column_step, std::vector<float>& output)
+{
+    const size_t n = rows * columns;
+    auto result = run_benchmark("scalar loop", kIterations, n * sizeof(float), [&]() {
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < columns; j++) {
+                output[i * columns + j] = fp16_ieee_to_fp32_value(matrix[i * row_pitch + j * column_step]);
+            }
+        }
+    });
+    print_result(result);
+}
+
+// 임시 버퍼 없는 2D 스트라이드 변환
+static void benchmark_convert_2d(const std::vector<float16>& matrix, size_t rows, size_t columns,
+    size_t row_pitch, size_t column_step, std::vector<float>& output)
+{
+    const size_t n = rows * columns;
+    auto result = run_benchmark("fp16_convert_2d", kIterations, n * sizeof(float), [&]() {
+        fp16_convert_2d(FP16_CONVERSION_IEEE_TO_FP32, rows, columns,
+            matrix.data(), (ptrdiff_t) row_pitch, (ptrdiff_t) column_step,
+            output.data(), (ptrdiff_t) columns, 1);
+    });
+    print_result(result);
+}
+
+int main() {
+    std::cout << "Strided FP16 to FP32 Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const size_t rows = 1024;
+    const size_t columns = 1024;
+    // 행 피치(row pitch)와 열 간격: 연속 행, 패딩된 행, 두 번째 열마다, 채널 4개 중 하나
+    const size_t layouts[][2] = { { 1024, 1 }, { 1088, 1 }, { 2048, 2 }, { 4096, 4 } };
+
+    for (const auto& layout : layouts) {
+        const size_t row_pitch = layout[0];
+        const size_t column_step = layout[1];
+        std::vector<float16> matrix = generate_test_data(rows * row_pitch);
+        std::vector<float> output(rows * columns);
+
+        std::cout << "row pitch " << row_pitch << ", column step " << column_step << std::endl;
+        benchmark_scalar_strided(matrix, rows, columns, row_pitch, column_step, output);
+        benchmark_gather_then_convert(matrix, rows, columns, row_pitch, column_step, output);
+        benchmark_convert_2d(matrix, rows, columns, row_pitch, column_step, output);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
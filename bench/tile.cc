@@ -0,0 +1,132 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/tile.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 100;
+// 배열 크기 (L2 캐시를 넘는 크기에서 FP32 전체 버퍼의 메모리 트래픽이 드러남)
+static const size_t kSizes[] = { 1 << 16, 1 << 22, 1 << 24 };
+
+// 테스트 데이터 생성 함수: [-1, 1] 범위의 FP16 값
+static std::vector<float16> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
+    std::vector<float16> fp16(size);
+    std::generate(fp16.begin(), fp16.end(), [&]() { return fp32_ieee_to_fp16_value(rng()); });
+
+    return fp16;
+}
+
+// 소비 연산: 제곱합
+static float sum_of_squares(const float* x, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        sum += x[i] * x[i];
+    }
+    return sum;
+}
+
+static int consume_tile(float* tile, size_t, size_t count, void* context) {
+    *(float*) context += sum_of_squares(tile, count);
+    return 0;
+}
+
+// 생성 연산: 위치에 따른 램프 값
+static void ramp(float* y, size_t offset, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] = (float) (offset + i) / 1048576.0f - 8.0f;
+    }
+}
+
+static int produce_tile(float* tile, size_t offset, size_t count, void*) {
+    ramp(tile, offset, count);
+    return 0;
+}
+
+int main() {
+    std::cout << "FP16 Tiled Conversion Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    const size_t l1_tile = fp16_tile_elements(fp16_cache_size(1));
+    const size_t l2_tile = fp16_tile_elements(fp16_cache_size(2));
+    std::cout << "L1 tile: " << l1_tile << " elements, L2 tile: " << l2_tile << " elements" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    std::vector<float> l2_scratch(l2_tile);
+    volatile float sink = 0.0f;
+    for (size_t size : kSizes) {
+        std::cout << "N = " << size << " (FP32 buffer: " << size * sizeof(float) / 1024 << " KiB)" << std::endl;
+        const std::vector<float16> x = generate_test_data(size);
+        std::vector<float16> y(size);
+        std::vector<float> fp32_buffer(size);
+
+        // 소비: 호출마다 FP32 전체 버퍼를 할당하고 디코드한 뒤 소비
+        auto result = run_benchmark("consume fp32 alloc", kIterations, size * sizeof(float16), [&]() {
+            std::vector<float> buffer(size);
+            fp16_ieee_to_fp32_array(x.data(), buffer.data(), size);
+            sink = sum_of_squares(buffer.data(), size);
+        });
+        print_result(result);
+
+        // 소비: 미리 할당한 FP32 전체 버퍼를 재사용
+        result = run_benchmark("consume fp32 buffer", kIterations, size * sizeof(float16), [&]() {
+            fp16_ieee_to_fp32_array(x.data(), fp32_buffer.data(), size);
+            sink = sum_of_squares(fp32_buffer.data(), size);
+        });
+        print_result(result);
+
+        // 소비: L1 크기 스택 타일마다 콜백
+        result = run_benchmark("consume L1 tiles", kIterations, size * sizeof(float16), [&]() {
+            float sum = 0.0f;
+            fp16_ieee_to_fp32_tiled(x.data(), size, NULL, 0, consume_tile, &sum);
+            sink = sum;
+        });
+        print_result(result);
+
+        // 소비: L2 크기 스크래치 타일마다 콜백
+        result = run_benchmark("consume L2 tiles", kIterations, size * sizeof(float16), [&]() {
+            float sum = 0.0f;
+            fp16_ieee_to_fp32_tiled(x.data(), size, l2_scratch.data(), l2_tile, consume_tile, &sum);
+            sink = sum;
+        });
+        print_result(result);
+
+        // 생성: FP32 전체 버퍼를 채운 뒤 인코드
+        result = run_benchmark("produce fp32 buffer", kIterations, size * sizeof(float16), [&]() {
+            ramp(fp32_buffer.data(), 0, size);
+            fp32_ieee_to_fp16_array(fp32_buffer.data(), y.data(), size);
+        });
+        print_result(result);
+
+        // 생성: L1 크기 스택 타일을 채우고 바로 인코드
+        result = run_benchmark("produce L1 tiles", kIterations, size * sizeof(float16), [&]() {
+            fp32_ieee_to_fp16_tiled(y.data(), size, NULL, 0, produce_tile, NULL);
+        });
+        print_result(result);
+
+        result = run_benchmark("produce L2 tiles", kIterations, size * sizeof(float16), [&]() {
+            fp32_ieee_to_fp16_tiled(y.data(), size, l2_scratch.data(), l2_tile, produce_tile, NULL);
+        });
+        print_result(result);
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/transcode.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 200;
+// 배열 크기
+static const size_t kSize = 1 << 16;
+
+// 테스트 데이터 생성 함수: 모든 16비트 패턴 (무한대/NaN, 65536 이상의 ARM 형식 값 포함)
+static std::vector<float16> generate_test_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_int_distribution<uint32_t>(0, 0xFFFF), std::mt19937(seed));
+
+    std::vector<float16> fp16(size);
+    std::generate(fp16.begin(), fp16.end(), [&]() { return (float16) rng(); });
+
+    return fp16;
+}
+
+int main() {
+    std::cout << "IEEE <-> ARM Alternative FP16 Transcoding Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    const std::vector<float16> input = generate_test_data(kSize);
+    std::vector<float> fp32_buffer(kSize);
+    std::vector<float16> output(kSize);
+
+    // ARM 형식 -> IEEE: FP32를 거치는 두 단계 방식과 직접 변환 비교
+    auto result = run_benchmark("alt->fp32->ieee value", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            output[i] = fp32_ieee_to_fp16_value(fp16_alt_to_fp32_value(input[i]));
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("alt->fp32->ieee array", kIterations, kSize * sizeof(float16), [&]() {
+        fp16_alt_to_fp32_array(input.data(), fp32_buffer.data(), kSize);
+        fp32_ieee_to_fp16_array(fp32_buffer.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp16_alt_to_fp16_ieee_value", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            output[i] = fp16_alt_to_fp16_ieee_value(input[i], 0);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("fp16_alt_to_fp16_ieee_array", kIterations, kSize * sizeof(float16), [&]() {
+        fp16_alt_to_fp16_ieee_array(input.data(), output.data(), kSize, 0);
+    });
+    print_result(result);
+
+    result = run_benchmark("  (saturate)", kIterations, kSize * sizeof(float16), [&]() {
+        fp16_alt_to_fp16_ieee_array(input.data(), output.data(), kSize, FP16_ENCODE_SATURATE);
+    });
+    print_result(result);
+
+    // IEEE -> ARM 형식
+    result = run_benchmark("ieee->fp32->alt value", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            output[i] = fp32_alt_to_fp16_value(fp16_ieee_to_fp32_value(input[i]));
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("ieee->fp32->alt array", kIterations, kSize * sizeof(float16), [&]() {
+        fp16_ieee_to_fp32_array(input.data(), fp32_buffer.data(), kSize);
+        fp32_alt_to_fp16_array(fp32_buffer.data(), output.data(), kSize);
+    });
+    print_result(result);
+
+    result = run_benchmark("fp16_ieee_to_fp16_alt_value", kIterations, kSize * sizeof(float16), [&]() {
+        for (size_t i = 0; i < kSize; i++) {
+            output[i] = fp16_ieee_to_fp16_alt_value(input[i], 0, 0);
+        }
+    });
+    print_result(result);
+
+    result = run_benchmark("fp16_ieee_to_fp16_alt_array", kIterations, kSize * sizeof(float16), [&]() {
+        fp16_ieee_to_fp16_alt_array(input.data(), output.data(), kSize, 0, 0);
+    });
+    print_result(result);
+
+    result = run_benchmark("  (NaN -> 0)", kIterations, kSize * sizeof(float16), [&]() {
+        fp16_ieee_to_fp16_alt_array(input.data(), output.data(), kSize, FP16_ENCODE_NAN_TO_VALUE, 0);
+    });
+    print_result(result);
+
+    return 0;
+}
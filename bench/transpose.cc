@@ -0,0 +1,126 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/transpose.h>
+#include "benchmark.h"
+
+typedef uint16_t float16;
+
+// 반복 횟수
+static const size_t kIterations = 20;
+
+// 테스트 데이터 생성 함수
+static std::vector<float16> generate_fp16_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_int_distribution<float16>(0, 0x7BFF), std::mt19937(seed));
+
+    std::vector<float16> fp16(size);
+    std::generate(fp16.begin(), fp16.end(), std::ref(rng));
+
+    return fp16;
+}
+
+static std::vector<float> generate_fp32_data(size_t size) {
+    const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+    auto rng = std::bind(std::uniform_real_distribution<float>(-65504.0f, 65504.0f), std::mt19937(seed));
+
+    std::vector<float> fp32(size);
+    std::generate(fp32.begin(), fp32.end(), std::ref(rng));
+
+    return fp32;
+}
+
+// 단순 전치 (분리된 패스에서 사용)
+template <typename T>
+static void transpose(size_t rows, size_t columns, const T* input, T* output) {
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < columns; j++) {
+            output[j * rows + i] = input[i * columns + j];
+        }
+    }
+}
+
+// FP32 → FP16: 전치 후 배열 변환, 배열 변환 후 전치, 융합 커널 비교
+static void benchmark_fp32_to_fp16(size_t rows, size_t columns) {
+    const size_t n = rows * columns;
+    const std::vector<float> input = generate_fp32_data(n);
+    std::vector<float> temporary_fp32(n);
+    std::vector<float16> temporary_fp16(n);
+    std::vector<float16> output(n);
+
+    auto result = run_benchmark("transpose+array", kIterations, n * sizeof(float16), [&]() {
+        transpose(rows, columns, input.data(), temporary_fp32.data());
+        fp32_ieee_to_fp16_array(temporary_fp32.data(), output.data(), n);
+    });
+    print_result(result);
+
+    result = run_benchmark("array+transpose", kIterations, n * sizeof(float16), [&]() {
+        fp32_ieee_to_fp16_array(input.data(), temporary_fp16.data(), n);
+        transpose(rows, columns, temporary_fp16.data(), output.data());
+    });
+    print_result(result);
+
+    result = run_benchmark("fused transpose", kIterations, n * sizeof(float16), [&]() {
+        fp32_ieee_to_fp16_transpose(rows, columns, input.data(), columns, output.data(), rows);
+    });
+    print_result(result);
+}
+
+// FP16 → FP32: 같은 세 가지 방식 비교
+static void benchmark_fp16_to_fp32(size_t rows, size_t columns) {
+    const size_t n = rows * columns;
+    const std::vector<float16> input = generate_fp16_data(n);
+    std::vector<float16> temporary_fp16(n);
+    std::vector<float> temporary_fp32(n);
+    std::vector<float> output(n);
+
+    auto result = run_benchmark("transpose+array", kIterations, n * sizeof(float), [&]() {
+        transpose(rows, columns, input.data(), temporary_fp16.data());
+        fp16_ieee_to_fp32_array(temporary_fp16.data(), output.data(), n);
+    });
+    print_result(result);
+
+    result = run_benchmark("array+transpose", kIterations, n * sizeof(float), [&]() {
+        fp16_ieee_to_fp32_array(input.data(), temporary_fp32.data(), n);
+        transpose(rows, columns, temporary_fp32.data(), output.data());
+    });
+    print_result(result);
+
+    result = run_benchmark("fused transpose", kIterations, n * sizeof(float), [&]() {
+        fp16_ieee_to_fp32_transpose(rows, columns, input.data(), columns, output.data(), rows);
+    });
+    print_result(result);
+}
+
+int main() {
+    std::cout << "FP16 Transpose-and-Convert Benchmarks" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << std::left << std::setw(25) << "Function"
+              << std::right << std::setw(10) << "Items"
+              << std::setw(15) << "Avg Time"
+              << std::setw(15) << "Throughput"
+              << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    // 행렬 크기 (행 x 열): 캐시에 들어가는 크기부터 LLC를 넘는 크기까지
+    const size_t shapes[][2] = { { 256, 256 }, { 1024, 1024 }, { 4096, 1024 }, { 2048, 2048 } };
+
+    for (const auto& shape : shapes) {
+        std::cout << "FP32 -> FP16, " << shape[0] << " x " << shape[1] << std::endl;
+        benchmark_fp32_to_fp16(shape[0], shape[1]);
+        std::cout << "FP16 -> FP32, " << shape[0] << " x " << shape[1] << std::endl;
+        benchmark_fp16_to_fp32(shape[0], shape[1]);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -44,7 +44,7 @@ static BenchmarkResult run_benchmark(const std::string& name, size_t iterations,
 }
 
 // 결과 출력 함수
-static void print_result(const BenchmarkResult& result) {
+static inline void print_result(const BenchmarkResult& result) {
     std::cout << std::left << std::setw(25) << result.name
               << std::right << std::setw(10) << result.iterations
               << std::setw(15) << std::fixed << std::setprecision(3) << result.avg_time_per_iteration_sec << " sec"
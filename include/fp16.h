@@ -3,5 +3,15 @@
 #define FP16_H
 
 #include <fp16/fp16.h>
+#include <fp16/array.h>
+#include <fp16/strided.h>
+#include <fp16/transpose.h>
+#include <fp16/rounding.h>
+#include <fp16/stochastic.h>
+#include <fp16/policy.h>
+#include <fp16/bf16.h>
+#include <fp16/fp8.h>
+#include <fp16/fp64.h>
+#include <fp16/transcode.h>
 
 #endif /* FP16_H */
@@ -0,0 +1,262 @@
+#pragma once
+#ifndef FP16_ARENA_H
+#define FP16_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+/*
+ * Page-backed buffers and a bump-pointer arena for conversion buffers and scratch space.
+ *
+ * Multi-megabyte buffers that are allocated per call pay a page fault for every 4 KiB page on first touch and, once
+ * mapped, a TLB miss for every page they stream through. fp16_pages_allocate maps buffers directly from the operating
+ * system, with optional huge pages and pre-faulting:
+ *   FP16_PAGES_HUGE     - align the mapping to FP16_HUGE_PAGE_SIZE and request transparent huge pages for it with
+ *                         madvise(MADV_HUGEPAGE), so that every 2 MiB of the buffer takes one page fault and one
+ *                         TLB entry. The kernel may still back the mapping with small pages.
+ *   FP16_PAGES_HUGETLB  - map huge pages from the hugetlbfs pool reserved in /proc/sys/vm/nr_hugepages
+ *                         (MAP_HUGETLB). When the pool is exhausted, the mapping falls back to FP16_PAGES_HUGE.
+ *   FP16_PAGES_PREFAULT - fault every page in at allocation, so that later conversions into the buffer take no
+ *                         page faults.
+ * Huge pages are Linux features; elsewhere the flags only align the mapping and the buffer has small pages.
+ *
+ * struct fp16_arena hands out aligned pieces of one such mapping by bumping an offset, so scratch buffers for a
+ * request cost no system calls once the arena exists. fp16_arena_mark and fp16_arena_release free everything
+ * allocated after a mark at once; fp16_arena_reset frees everything. An arena is not thread-safe: give every thread
+ * its own arena.
+ *
+ * fp16/pmr.h wraps both as std::pmr memory resources for C++17 containers.
+ */
+
+#define FP16_PAGES_HUGE     0x1
+#define FP16_PAGES_HUGETLB  0x2
+#define FP16_PAGES_PREFAULT 0x4
+
+/* Size of the huge pages requested with FP16_PAGES_HUGE and FP16_PAGES_HUGETLB: PMD-sized pages of x86-64 and of
+ * AArch64 with a 4 KiB granule */
+#ifndef FP16_HUGE_PAGE_SIZE
+	#define FP16_HUGE_PAGE_SIZE 2097152
+#endif
+
+/* Default alignment of arena allocations: a cache line, and a full AVX-512 vector */
+#define FP16_ARENA_ALIGNMENT 64
+
+/*
+ * Size of the small pages of the system, in bytes.
+ */
+static inline size_t fp16_pages_base_size(void) {
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (size_t) info.dwPageSize;
+#else
+	const long size = sysconf(_SC_PAGESIZE);
+	return size > 0 ? (size_t) size : 4096;
+#endif
+}
+
+/*
+ * Size of the mapping that fp16_pages_allocate makes for a buffer of the given size: a whole number of huge pages
+ * with FP16_PAGES_HUGE or FP16_PAGES_HUGETLB, and of small pages otherwise. Returns 0 if the size does not fit in
+ * size_t when rounded up to whole pages.
+ */
+static inline size_t fp16_pages_mapped_size(size_t size, unsigned flags) {
+	const size_t page = (flags & (FP16_PAGES_HUGE | FP16_PAGES_HUGETLB)) != 0 ? FP16_HUGE_PAGE_SIZE : fp16_pages_base_size();
+	if (size == 0) {
+		size = 1;
+	}
+	if (size > SIZE_MAX - (page - 1)) {
+		return 0;
+	}
+	return (size + page - 1) / page * page;
+}
+
+/*
+ * Touch every small page of a fresh mapping, so that the kernel maps it now rather than on first use. Writing into
+ * one small page of a transparent huge page maps the whole huge page.
+ */
+static inline void fp16_pages_prefault(void* pages, size_t size) {
+	const size_t page = fp16_pages_base_size();
+	volatile unsigned char* bytes = (volatile unsigned char*) pages;
+	for (size_t offset = 0; offset < size; offset += page) {
+		bytes[offset] = 0;
+	}
+}
+
+/*
+ * Map a buffer of at least size bytes with the FP16_PAGES_* flags. The buffer is aligned to the page size, zero-filled,
+ * and must be freed with fp16_pages_free and the same size and flags. Returns NULL if the system has no memory for it.
+ */
+static inline void* fp16_pages_allocate(size_t size, unsigned flags) {
+	const size_t mapped_size = fp16_pages_mapped_size(size, flags);
+	/* Sizes near SIZE_MAX would wrap around in the page rounding or in the over-mapping for huge page alignment */
+	if (mapped_size == 0 || mapped_size > SIZE_MAX - FP16_HUGE_PAGE_SIZE) {
+		return NULL;
+	}
+#if defined(_WIN32)
+	void* pages = VirtualAlloc(NULL, mapped_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (pages != NULL && (flags & FP16_PAGES_PREFAULT) != 0) {
+		fp16_pages_prefault(pages, mapped_size);
+	}
+	return pages;
+#else
+	#if defined(MAP_HUGETLB)
+	if ((flags & FP16_PAGES_HUGETLB) != 0) {
+		int mmap_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+		#if defined(MAP_POPULATE)
+		if ((flags & FP16_PAGES_PREFAULT) != 0) {
+			mmap_flags |= MAP_POPULATE;
+		}
+		#endif
+		void* pages = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+		if (pages != MAP_FAILED) {
+			return pages;
+		}
+		/* No reserved huge pages are left: fall back to transparent huge pages */
+	}
+	#endif
+	if ((flags & (FP16_PAGES_HUGE | FP16_PAGES_HUGETLB)) == 0) {
+		int mmap_flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	#if defined(MAP_POPULATE)
+		if ((flags & FP16_PAGES_PREFAULT) != 0) {
+			mmap_flags |= MAP_POPULATE;
+		}
+	#endif
+		void* pages = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+		if (pages == MAP_FAILED) {
+			return NULL;
+		}
+	#if !defined(MAP_POPULATE)
+		if ((flags & FP16_PAGES_PREFAULT) != 0) {
+			fp16_pages_prefault(pages, mapped_size);
+		}
+	#endif
+		return pages;
+	}
+
+	/* Over-map by one huge page and trim both ends, so that the mapping starts on a huge page boundary */
+	unsigned char* region = (unsigned char*) mmap(NULL, mapped_size + FP16_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if ((void*) region == MAP_FAILED) {
+		return NULL;
+	}
+	const size_t head = (FP16_HUGE_PAGE_SIZE - (size_t) ((uintptr_t) region % FP16_HUGE_PAGE_SIZE)) % FP16_HUGE_PAGE_SIZE;
+	if (head != 0) {
+		munmap(region, head);
+	}
+	munmap(region + head + mapped_size, FP16_HUGE_PAGE_SIZE - head);
+	unsigned char* pages = region + head;
+	#if defined(MADV_HUGEPAGE)
+	madvise(pages, mapped_size, MADV_HUGEPAGE);
+	#endif
+	if ((flags & FP16_PAGES_PREFAULT) != 0) {
+		fp16_pages_prefault(pages, mapped_size);
+	}
+	return pages;
+#endif
+}
+
+/*
+ * Unmap a buffer from fp16_pages_allocate. size and flags must be the ones it was allocated with.
+ */
+static inline void fp16_pages_free(void* pages, size_t size, unsigned flags) {
+	if (pages == NULL) {
+		return;
+	}
+#if defined(_WIN32)
+	(void) size;
+	(void) flags;
+	VirtualFree(pages, 0, MEM_RELEASE);
+#else
+	munmap(pages, fp16_pages_mapped_size(size, flags));
+#endif
+}
+
+struct fp16_arena {
+	unsigned char* base;
+	size_t capacity;
+	size_t offset;
+	unsigned flags;
+};
+
+/*
+ * Map an arena of at least capacity bytes with the FP16_PAGES_* flags; the capacity is rounded up to whole pages.
+ * Returns 0 on success and -1 if the mapping fails, in which case the arena is empty and every allocation from it fails.
+ */
+static inline int fp16_arena_init(struct fp16_arena* arena, size_t capacity, unsigned flags) {
+	arena->base = (unsigned char*) fp16_pages_allocate(capacity, flags);
+	arena->capacity = arena->base != NULL ? fp16_pages_mapped_size(capacity, flags) : 0;
+	arena->offset = 0;
+	arena->flags = flags;
+	return arena->base != NULL ? 0 : -1;
+}
+
+/*
+ * Unmap the arena and everything allocated from it.
+ */
+static inline void fp16_arena_destroy(struct fp16_arena* arena) {
+	fp16_pages_free(arena->base, arena->capacity, arena->flags);
+	arena->base = NULL;
+	arena->capacity = 0;
+	arena->offset = 0;
+}
+
+/*
+ * Allocate size bytes aligned to alignment bytes (a power of two; 0 means FP16_ARENA_ALIGNMENT). Returns NULL if the
+ * rest of the arena is too small.
+ */
+static inline void* fp16_arena_allocate(struct fp16_arena* arena, size_t size, size_t alignment) {
+	if (arena->base == NULL) {
+		return NULL;
+	}
+	if (alignment < FP16_ARENA_ALIGNMENT) {
+		alignment = FP16_ARENA_ALIGNMENT;
+	}
+	const size_t misalignment = (size_t) ((uintptr_t) (arena->base + arena->offset) & (alignment - 1));
+	const size_t start = arena->offset + (misalignment != 0 ? alignment - misalignment : 0);
+	if (start > arena->capacity || size > arena->capacity - start) {
+		return NULL;
+	}
+	arena->offset = start + size;
+	return arena->base + start;
+}
+
+/*
+ * Allocate an array of n single-precision numbers, or of n half-precision numbers.
+ */
+static inline float* fp16_arena_allocate_fp32(struct fp16_arena* arena, size_t n) {
+	return n <= SIZE_MAX / sizeof(float) ? (float*) fp16_arena_allocate(arena, n * sizeof(float), 0) : NULL;
+}
+
+static inline uint16_t* fp16_arena_allocate_fp16(struct fp16_arena* arena, size_t n) {
+	return n <= SIZE_MAX / sizeof(uint16_t) ? (uint16_t*) fp16_arena_allocate(arena, n * sizeof(uint16_t), 0) : NULL;
+}
+
+/*
+ * A mark records how much of the arena is in use; releasing it frees everything allocated after the mark.
+ */
+static inline size_t fp16_arena_mark(const struct fp16_arena* arena) {
+	return arena->offset;
+}
+
+static inline void fp16_arena_release(struct fp16_arena* arena, size_t mark) {
+	if (mark < arena->offset) {
+		arena->offset = mark;
+	}
+}
+
+static inline void fp16_arena_reset(struct fp16_arena* arena) {
+	arena->offset = 0;
+}
+
+#endif /* FP16_ARENA_H */
@@ -0,0 +1,547 @@
+#pragma once
+#ifndef FP16_ARRAY_H
+#define FP16_ARRAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fp16.h"
+#include "simd.h"
+
+/*
+ * Bulk conversions between arrays of half-precision and single-precision numbers.
+ *
+ * Every conversion is available in two forms:
+ * - The *_array function, which handles arrays of any length with unrolled vector loops and finishes the
+ *   remaining elements with the small-array kernel.
+ * - The *_array_small function, which is tuned for arrays of up to 64 elements: it has no unrolled loop and no
+ *   scalar tail. Lengths that are not a multiple of the vector width are handled with one overlapping vector
+ *   (re-converting a few elements of the previous vector) or, for arrays shorter than one vector, with masked loads
+ *   and stores (vpmaskmov on AVX2, mask registers on AVX-512). Longer arrays are supported, but not unrolled.
+ *
+ * The input and output arrays must not overlap. Results are the same as from the scalar functions in fp16.h with the
+ * default rounding mode, except that NaN inputs convert to NaN outputs with the payload bits kept by the hardware.
+ */
+
+#if FP16_SIMD_AVX2
+/*
+ * Convert eight ARM alternative half-precision numbers in the 16-bit lanes of a vector to single-precision.
+ * This is a vector transcription of fp16_alt_to_fp32_value.
+ */
+static inline __m256 fp16_simd_avx2_alt_to_fp32(__m128i h) {
+	const __m256i w = _mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16);
+	const __m256i sign = _mm256_and_si256(w, _mm256_set1_epi32((int) UINT32_C(0x80000000)));
+	const __m256i two_w = _mm256_add_epi32(w, w);
+
+	const __m256i normalized_value = _mm256_add_epi32(_mm256_srli_epi32(two_w, 4), _mm256_set1_epi32(0x70 << 23));
+	const __m256 denormalized_value = _mm256_sub_ps(
+		_mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(two_w, 17), _mm256_set1_epi32(126 << 23))),
+		_mm256_set1_ps(0.5f));
+
+	const __m256i denormalized_mask = _mm256_cmpeq_epi32(_mm256_srli_epi32(two_w, 27), _mm256_setzero_si256());
+	const __m256i nonsign = _mm256_blendv_epi8(normalized_value, _mm256_castps_si256(denormalized_value), denormalized_mask);
+	return _mm256_castsi256_ps(_mm256_or_si256(sign, nonsign));
+}
+
+/*
+ * Convert eight single-precision numbers to ARM alternative half-precision numbers in 32-bit lanes.
+ * This is a vector transcription of fp32_alt_to_fp16_value.
+ */
+static inline __m256i fp16_simd_avx2_fp32_to_alt_u32(__m256 f) {
+	const __m256i w = _mm256_castps_si256(f);
+	const __m256i sign = _mm256_and_si256(w, _mm256_set1_epi32((int) UINT32_C(0x80000000)));
+	const __m256i shl1_w = _mm256_add_epi32(w, w);
+
+	const __m256i shl1_base = _mm256_min_epu32(shl1_w, _mm256_set1_epi32((int) UINT32_C(0x8FFFC000)));
+	const __m256i shl1_bias = _mm256_max_epu32(
+		_mm256_and_si256(shl1_base, _mm256_set1_epi32((int) UINT32_C(0xFF000000))),
+		_mm256_set1_epi32((127 - 1 - 13) << 24));
+
+	const __m256 bias = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_srli_epi32(shl1_bias, 1), _mm256_set1_epi32((13 + 2) << 23)));
+	const __m256 base = _mm256_add_ps(
+		_mm256_castsi256_ps(_mm256_add_epi32(_mm256_srli_epi32(shl1_base, 1), _mm256_set1_epi32(2 << 23))), bias);
+
+	const __m256i base_bits = _mm256_castps_si256(base);
+	const __m256i exp_bits = _mm256_and_si256(_mm256_srli_epi32(base_bits, 13), _mm256_set1_epi32(0x00007C00));
+	const __m256i mantissa_bits = _mm256_and_si256(base_bits, _mm256_set1_epi32(0x00000FFF));
+	return _mm256_or_si256(_mm256_srli_epi32(sign, 16), _mm256_add_epi32(exp_bits, mantissa_bits));
+}
+#endif /* FP16_SIMD_AVX2 */
+
+#if FP16_SIMD_AVX512
+static inline __m512 fp16_simd_avx512_alt_to_fp32(__m256i h) {
+	const __m512i w = _mm512_slli_epi32(_mm512_cvtepu16_epi32(h), 16);
+	const __m512i sign = _mm512_and_si512(w, _mm512_set1_epi32((int) UINT32_C(0x80000000)));
+	const __m512i two_w = _mm512_add_epi32(w, w);
+
+	const __m512i normalized_value = _mm512_add_epi32(_mm512_srli_epi32(two_w, 4), _mm512_set1_epi32(0x70 << 23));
+	const __m512 denormalized_value = _mm512_sub_ps(
+		_mm512_castsi512_ps(_mm512_or_si512(_mm512_srli_epi32(two_w, 17), _mm512_set1_epi32(126 << 23))),
+		_mm512_set1_ps(0.5f));
+
+	const __mmask16 denormalized_mask = _mm512_cmplt_epu32_mask(two_w, _mm512_set1_epi32(1 << 27));
+	const __m512i nonsign = _mm512_mask_blend_epi32(denormalized_mask, normalized_value, _mm512_castps_si512(denormalized_value));
+	return _mm512_castsi512_ps(_mm512_or_si512(sign, nonsign));
+}
+
+static inline __m256i fp16_simd_avx512_fp32_to_alt(__m512 f) {
+	const __m512i w = _mm512_castps_si512(f);
+	const __m512i sign = _mm512_and_si512(w, _mm512_set1_epi32((int) UINT32_C(0x80000000)));
+	const __m512i shl1_w = _mm512_add_epi32(w, w);
+
+	const __m512i shl1_base = _mm512_min_epu32(shl1_w, _mm512_set1_epi32((int) UINT32_C(0x8FFFC000)));
+	const __m512i shl1_bias = _mm512_max_epu32(
+		_mm512_and_si512(shl1_base, _mm512_set1_epi32((int) UINT32_C(0xFF000000))),
+		_mm512_set1_epi32((127 - 1 - 13) << 24));
+
+	const __m512 bias = _mm512_castsi512_ps(_mm512_add_epi32(_mm512_srli_epi32(shl1_bias, 1), _mm512_set1_epi32((13 + 2) << 23)));
+	const __m512 base = _mm512_add_ps(
+		_mm512_castsi512_ps(_mm512_add_epi32(_mm512_srli_epi32(shl1_base, 1), _mm512_set1_epi32(2 << 23))), bias);
+
+	const __m512i base_bits = _mm512_castps_si512(base);
+	const __m512i exp_bits = _mm512_and_si512(_mm512_srli_epi32(base_bits, 13), _mm512_set1_epi32(0x00007C00));
+	const __m512i mantissa_bits = _mm512_and_si512(base_bits, _mm512_set1_epi32(0x00000FFF));
+	return _mm512_cvtepi32_epi16(_mm512_or_si512(_mm512_srli_epi32(sign, 16), _mm512_add_epi32(exp_bits, mantissa_bits)));
+}
+#endif /* FP16_SIMD_AVX512 */
+
+/*
+ * Convert n IEEE half-precision numbers to single-precision, optimized for n <= 64.
+ */
+static inline void fp16_ieee_to_fp32_array_small(const float16* input, float* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n > 16; n -= 16) {
+		_mm512_storeu_ps(output, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) input)));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm512_mask_storeu_ps(output, mask, _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(mask, input)));
+#elif FP16_SIMD_AVX2
+	if (n >= 8) {
+		const size_t last = n - 8;
+		for (size_t i = 0; i < last; i += 8) {
+			_mm256_storeu_ps(output + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (input + i))));
+		}
+		_mm256_storeu_ps(output + last, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (input + last))));
+	} else if (n != 0) {
+		const __m256 f = _mm256_cvtph_ps(fp16_simd_avx2_load_u16x8_partial(input, n));
+		_mm256_maskstore_ps(output, fp16_simd_avx2_mask_u32x8(n), f);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp16_ieee_to_fp32_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n single-precision numbers to IEEE half-precision, optimized for n <= 64.
+ * Vector kernels always round to nearest-even, independent of the MXCSR rounding mode.
+ */
+static inline void fp32_ieee_to_fp16_array_small(const float* input, float16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n > 16; n -= 16) {
+		_mm256_storeu_si256((__m256i*) output, _mm512_cvtps_ph(_mm512_loadu_ps(input), _MM_FROUND_TO_NEAREST_INT));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm256_mask_storeu_epi16(output, mask, _mm512_cvtps_ph(_mm512_maskz_loadu_ps(mask, input), _MM_FROUND_TO_NEAREST_INT));
+#elif FP16_SIMD_AVX2
+	if (n >= 8) {
+		const size_t last = n - 8;
+		for (size_t i = 0; i < last; i += 8) {
+			_mm_storeu_si128((__m128i*) (output + i), _mm256_cvtps_ph(_mm256_loadu_ps(input + i), _MM_FROUND_TO_NEAREST_INT));
+		}
+		_mm_storeu_si128((__m128i*) (output + last), _mm256_cvtps_ph(_mm256_loadu_ps(input + last), _MM_FROUND_TO_NEAREST_INT));
+	} else if (n != 0) {
+		const __m256 f = _mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n));
+		fp16_simd_avx2_store_u16x8_partial(output, _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_ieee_to_fp16_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n ARM alternative half-precision numbers to single-precision, optimized for n <= 64.
+ */
+static inline void fp16_alt_to_fp32_array_small(const float16* input, float* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n > 16; n -= 16) {
+		_mm512_storeu_ps(output, fp16_simd_avx512_alt_to_fp32(_mm256_loadu_si256((const __m256i*) input)));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm512_mask_storeu_ps(output, mask, fp16_simd_avx512_alt_to_fp32(_mm256_maskz_loadu_epi16(mask, input)));
+#elif FP16_SIMD_AVX2
+	if (n >= 8) {
+		const size_t last = n - 8;
+		for (size_t i = 0; i < last; i += 8) {
+			_mm256_storeu_ps(output + i, fp16_simd_avx2_alt_to_fp32(_mm_loadu_si128((const __m128i*) (input + i))));
+		}
+		_mm256_storeu_ps(output + last, fp16_simd_avx2_alt_to_fp32(_mm_loadu_si128((const __m128i*) (input + last))));
+	} else if (n != 0) {
+		const __m256 f = fp16_simd_avx2_alt_to_fp32(fp16_simd_avx2_load_u16x8_partial(input, n));
+		_mm256_maskstore_ps(output, fp16_simd_avx2_mask_u32x8(n), f);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp16_alt_to_fp32_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n single-precision numbers to ARM alternative half-precision, optimized for n <= 64.
+ */
+static inline void fp32_alt_to_fp16_array_small(const float* input, float16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n > 16; n -= 16) {
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx512_fp32_to_alt(_mm512_loadu_ps(input)));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm256_mask_storeu_epi16(output, mask, fp16_simd_avx512_fp32_to_alt(_mm512_maskz_loadu_ps(mask, input)));
+#elif FP16_SIMD_AVX2
+	if (n >= 8) {
+		const size_t last = n - 8;
+		for (size_t i = 0; i < last; i += 8) {
+			_mm_storeu_si128((__m128i*) (output + i),
+				fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(_mm256_loadu_ps(input + i))));
+		}
+		_mm_storeu_si128((__m128i*) (output + last),
+			fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(_mm256_loadu_ps(input + last))));
+	} else if (n != 0) {
+		const __m256 f = _mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n));
+		fp16_simd_avx2_store_u16x8_partial(output, fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(f)), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_alt_to_fp16_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n IEEE half-precision numbers to single-precision.
+ */
+static inline void fp16_ieee_to_fp32_array(const float16* input, float* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 64; n -= 64) {
+		const __m512 f0 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) input));
+		const __m512 f1 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (input + 16)));
+		const __m512 f2 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (input + 32)));
+		const __m512 f3 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (input + 48)));
+		_mm512_storeu_ps(output, f0);
+		_mm512_storeu_ps(output + 16, f1);
+		_mm512_storeu_ps(output + 32, f2);
+		_mm512_storeu_ps(output + 48, f3);
+		input += 64;
+		output += 64;
+	}
+#elif FP16_SIMD_AVX2
+	for (; n >= 32; n -= 32) {
+		const __m256 f0 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) input));
+		const __m256 f1 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (input + 8)));
+		const __m256 f2 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (input + 16)));
+		const __m256 f3 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (input + 24)));
+		_mm256_storeu_ps(output, f0);
+		_mm256_storeu_ps(output + 8, f1);
+		_mm256_storeu_ps(output + 16, f2);
+		_mm256_storeu_ps(output + 24, f3);
+		input += 32;
+		output += 32;
+	}
+#endif
+	fp16_ieee_to_fp32_array_small(input, output, n);
+}
+
+/*
+ * Convert n single-precision numbers to IEEE half-precision.
+ * Vector kernels always round to nearest-even, independent of the MXCSR rounding mode.
+ */
+static inline void fp32_ieee_to_fp16_array(const float* input, float16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 64; n -= 64) {
+		const __m256i h0 = _mm512_cvtps_ph(_mm512_loadu_ps(input), _MM_FROUND_TO_NEAREST_INT);
+		const __m256i h1 = _mm512_cvtps_ph(_mm512_loadu_ps(input + 16), _MM_FROUND_TO_NEAREST_INT);
+		const __m256i h2 = _mm512_cvtps_ph(_mm512_loadu_ps(input + 32), _MM_FROUND_TO_NEAREST_INT);
+		const __m256i h3 = _mm512_cvtps_ph(_mm512_loadu_ps(input + 48), _MM_FROUND_TO_NEAREST_INT);
+		_mm256_storeu_si256((__m256i*) output, h0);
+		_mm256_storeu_si256((__m256i*) (output + 16), h1);
+		_mm256_storeu_si256((__m256i*) (output + 32), h2);
+		_mm256_storeu_si256((__m256i*) (output + 48), h3);
+		input += 64;
+		output += 64;
+	}
+#elif FP16_SIMD_AVX2
+	for (; n >= 32; n -= 32) {
+		const __m128i h0 = _mm256_cvtps_ph(_mm256_loadu_ps(input), _MM_FROUND_TO_NEAREST_INT);
+		const __m128i h1 = _mm256_cvtps_ph(_mm256_loadu_ps(input + 8), _MM_FROUND_TO_NEAREST_INT);
+		const __m128i h2 = _mm256_cvtps_ph(_mm256_loadu_ps(input + 16), _MM_FROUND_TO_NEAREST_INT);
+		const __m128i h3 = _mm256_cvtps_ph(_mm256_loadu_ps(input + 24), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128((__m128i*) output, h0);
+		_mm_storeu_si128((__m128i*) (output + 8), h1);
+		_mm_storeu_si128((__m128i*) (output + 16), h2);
+		_mm_storeu_si128((__m128i*) (output + 24), h3);
+		input += 32;
+		output += 32;
+	}
+#endif
+	fp32_ieee_to_fp16_array_small(input, output, n);
+}
+
+/*
+ * Convert n ARM alternative half-precision numbers to single-precision.
+ */
+static inline void fp16_alt_to_fp32_array(const float16* input, float* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 64; n -= 64) {
+		const __m512 f0 = fp16_simd_avx512_alt_to_fp32(_mm256_loadu_si256((const __m256i*) input));
+		const __m512 f1 = fp16_simd_avx512_alt_to_fp32(_mm256_loadu_si256((const __m256i*) (input + 16)));
+		const __m512 f2 = fp16_simd_avx512_alt_to_fp32(_mm256_loadu_si256((const __m256i*) (input + 32)));
+		const __m512 f3 = fp16_simd_avx512_alt_to_fp32(_mm256_loadu_si256((const __m256i*) (input + 48)));
+		_mm512_storeu_ps(output, f0);
+		_mm512_storeu_ps(output + 16, f1);
+		_mm512_storeu_ps(output + 32, f2);
+		_mm512_storeu_ps(output + 48, f3);
+		input += 64;
+		output += 64;
+	}
+#elif FP16_SIMD_AVX2
+	for (; n >= 32; n -= 32) {
+		const __m256 f0 = fp16_simd_avx2_alt_to_fp32(_mm_loadu_si128((const __m128i*) input));
+		const __m256 f1 = fp16_simd_avx2_alt_to_fp32(_mm_loadu_si128((const __m128i*) (input + 8)));
+		const __m256 f2 = fp16_simd_avx2_alt_to_fp32(_mm_loadu_si128((const __m128i*) (input + 16)));
+		const __m256 f3 = fp16_simd_avx2_alt_to_fp32(_mm_loadu_si128((const __m128i*) (input + 24)));
+		_mm256_storeu_ps(output, f0);
+		_mm256_storeu_ps(output + 8, f1);
+		_mm256_storeu_ps(output + 16, f2);
+		_mm256_storeu_ps(output + 24, f3);
+		input += 32;
+		output += 32;
+	}
+#endif
+	fp16_alt_to_fp32_array_small(input, output, n);
+}
+
+/*
+ * Convert n single-precision numbers to ARM alternative half-precision.
+ */
+static inline void fp32_alt_to_fp16_array(const float* input, float16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 64; n -= 64) {
+		const __m256i h0 = fp16_simd_avx512_fp32_to_alt(_mm512_loadu_ps(input));
+		const __m256i h1 = fp16_simd_avx512_fp32_to_alt(_mm512_loadu_ps(input + 16));
+		const __m256i h2 = fp16_simd_avx512_fp32_to_alt(_mm512_loadu_ps(input + 32));
+		const __m256i h3 = fp16_simd_avx512_fp32_to_alt(_mm512_loadu_ps(input + 48));
+		_mm256_storeu_si256((__m256i*) output, h0);
+		_mm256_storeu_si256((__m256i*) (output + 16), h1);
+		_mm256_storeu_si256((__m256i*) (output + 32), h2);
+		_mm256_storeu_si256((__m256i*) (output + 48), h3);
+		input += 64;
+		output += 64;
+	}
+#elif FP16_SIMD_AVX2
+	for (; n >= 32; n -= 32) {
+		const __m128i h0 = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(_mm256_loadu_ps(input)));
+		const __m128i h1 = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(_mm256_loadu_ps(input + 8)));
+		const __m128i h2 = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(_mm256_loadu_ps(input + 16)));
+		const __m128i h3 = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(_mm256_loadu_ps(input + 24)));
+		_mm_storeu_si128((__m128i*) output, h0);
+		_mm_storeu_si128((__m128i*) (output + 8), h1);
+		_mm_storeu_si128((__m128i*) (output + 16), h2);
+		_mm_storeu_si128((__m128i*) (output + 24), h3);
+		input += 32;
+		output += 32;
+	}
+#endif
+	fp32_alt_to_fp16_array_small(input, output, n);
+}
+
+/*
+ * In-place conversions. The buffer holds n single-precision numbers on input of the *_to_fp16 functions, and is
+ * compacted front-to-back into n half-precision numbers at the start of the same buffer. The *_to_fp32 functions
+ * take n half-precision numbers at the start of a buffer of at least 4 * n bytes, and expand them back-to-front into
+ * n single-precision numbers. In both directions every vector is loaded before any store that could overlap it, so
+ * no element is overwritten before it is converted. The functions return the buffer reinterpreted as the output type.
+ */
+
+/*
+ * Compact n single-precision numbers into IEEE half-precision numbers in the same buffer.
+ */
+static inline float16* fp32_ieee_to_fp16_array_inplace(void* buffer, size_t n) {
+	unsigned char* bytes = (unsigned char*) buffer;
+	size_t i = 0;
+#if FP16_SIMD_AVX512
+	for (; i + 64 <= n; i += 64) {
+		const __m512 f0 = _mm512_loadu_ps((const float*) (bytes + 4 * i));
+		const __m512 f1 = _mm512_loadu_ps((const float*) (bytes + 4 * i + 64));
+		const __m512 f2 = _mm512_loadu_ps((const float*) (bytes + 4 * i + 128));
+		const __m512 f3 = _mm512_loadu_ps((const float*) (bytes + 4 * i + 192));
+		_mm256_storeu_si256((__m256i*) (bytes + 2 * i), _mm512_cvtps_ph(f0, _MM_FROUND_TO_NEAREST_INT));
+		_mm256_storeu_si256((__m256i*) (bytes + 2 * i + 32), _mm512_cvtps_ph(f1, _MM_FROUND_TO_NEAREST_INT));
+		_mm256_storeu_si256((__m256i*) (bytes + 2 * i + 64), _mm512_cvtps_ph(f2, _MM_FROUND_TO_NEAREST_INT));
+		_mm256_storeu_si256((__m256i*) (bytes + 2 * i + 96), _mm512_cvtps_ph(f3, _MM_FROUND_TO_NEAREST_INT));
+	}
+	for (; i + 16 <= n; i += 16) {
+		const __m512 f = _mm512_loadu_ps((const float*) (bytes + 4 * i));
+		_mm256_storeu_si256((__m256i*) (bytes + 2 * i), _mm512_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+	}
+	/* Fewer than 16 elements remain: the small-array kernel converts them with one masked load and store */
+	fp32_ieee_to_fp16_array_small((const float*) (bytes + 4 * i), (float16*) (bytes + 2 * i), n - i);
+#elif FP16_SIMD_AVX2
+	for (; i + 32 <= n; i += 32) {
+		const __m256 f0 = _mm256_loadu_ps((const float*) (bytes + 4 * i));
+		const __m256 f1 = _mm256_loadu_ps((const float*) (bytes + 4 * i + 32));
+		const __m256 f2 = _mm256_loadu_ps((const float*) (bytes + 4 * i + 64));
+		const __m256 f3 = _mm256_loadu_ps((const float*) (bytes + 4 * i + 96));
+		_mm_storeu_si128((__m128i*) (bytes + 2 * i), _mm256_cvtps_ph(f0, _MM_FROUND_TO_NEAREST_INT));
+		_mm_storeu_si128((__m128i*) (bytes + 2 * i + 16), _mm256_cvtps_ph(f1, _MM_FROUND_TO_NEAREST_INT));
+		_mm_storeu_si128((__m128i*) (bytes + 2 * i + 32), _mm256_cvtps_ph(f2, _MM_FROUND_TO_NEAREST_INT));
+		_mm_storeu_si128((__m128i*) (bytes + 2 * i + 48), _mm256_cvtps_ph(f3, _MM_FROUND_TO_NEAREST_INT));
+	}
+	for (; i + 8 <= n; i += 8) {
+		const __m256 f = _mm256_loadu_ps((const float*) (bytes + 4 * i));
+		_mm_storeu_si128((__m128i*) (bytes + 2 * i), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+	}
+	/* Fewer than 8 elements remain: the small-array kernel converts them with one masked load and store */
+	fp32_ieee_to_fp16_array_small((const float*) (bytes + 4 * i), (float16*) (bytes + 2 * i), n - i);
+#else
+	for (; i < n; i++) {
+		float f;
+		memcpy(&f, bytes + 4 * i, sizeof(f));
+		const float16 h = fp32_ieee_to_fp16_value(f);
+		memcpy(bytes + 2 * i, &h, sizeof(h));
+	}
+#endif
+	return (float16*) buffer;
+}
+
+/*
+ * Expand n IEEE half-precision numbers at the start of a buffer of at least 4 * n bytes into single-precision
+ * numbers in the same buffer.
+ */
+static inline float* fp16_ieee_to_fp32_array_inplace(void* buffer, size_t n) {
+	unsigned char* bytes = (unsigned char*) buffer;
+	size_t i = n;
+#if FP16_SIMD_AVX512
+	for (; i >= 64; i -= 64) {
+		const size_t j = i - 64;
+		const __m512 f0 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (bytes + 2 * j)));
+		const __m512 f1 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (bytes + 2 * j + 32)));
+		const __m512 f2 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (bytes + 2 * j + 64)));
+		const __m512 f3 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (bytes + 2 * j + 96)));
+		_mm512_storeu_ps((float*) (bytes + 4 * j + 192), f3);
+		_mm512_storeu_ps((float*) (bytes + 4 * j + 128), f2);
+		_mm512_storeu_ps((float*) (bytes + 4 * j + 64), f1);
+		_mm512_storeu_ps((float*) (bytes + 4 * j), f0);
+	}
+	for (; i >= 16; i -= 16) {
+		const size_t j = i - 16;
+		const __m512 f = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (bytes + 2 * j)));
+		_mm512_storeu_ps((float*) (bytes + 4 * j), f);
+	}
+	/* Fewer than 16 elements remain at the start: convert them with one masked load and store */
+	fp16_ieee_to_fp32_array_small((const float16*) bytes, (float*) bytes, i);
+#elif FP16_SIMD_AVX2
+	for (; i >= 32; i -= 32) {
+		const size_t j = i - 32;
+		const __m256 f0 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (bytes + 2 * j)));
+		const __m256 f1 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (bytes + 2 * j + 16)));
+		const __m256 f2 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (bytes + 2 * j + 32)));
+		const __m256 f3 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (bytes + 2 * j + 48)));
+		_mm256_storeu_ps((float*) (bytes + 4 * j + 96), f3);
+		_mm256_storeu_ps((float*) (bytes + 4 * j + 64), f2);
+		_mm256_storeu_ps((float*) (bytes + 4 * j + 32), f1);
+		_mm256_storeu_ps((float*) (bytes + 4 * j), f0);
+	}
+	for (; i >= 8; i -= 8) {
+		const size_t j = i - 8;
+		const __m256 f = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (bytes + 2 * j)));
+		_mm256_storeu_ps((float*) (bytes + 4 * j), f);
+	}
+	/* Fewer than 8 elements remain at the start: convert them with one masked load and store */
+	fp16_ieee_to_fp32_array_small((const float16*) bytes, (float*) bytes, i);
+#else
+	while (i != 0) {
+		i -= 1;
+		float16 h;
+		memcpy(&h, bytes + 2 * i, sizeof(h));
+		const float f = fp16_ieee_to_fp32_value(h);
+		memcpy(bytes + 4 * i, &f, sizeof(f));
+	}
+#endif
+	return (float*) buffer;
+}
+
+/*
+ * Compact n single-precision numbers into ARM alternative half-precision numbers in the same buffer.
+ */
+static inline float16* fp32_alt_to_fp16_array_inplace(void* buffer, size_t n) {
+	unsigned char* bytes = (unsigned char*) buffer;
+	size_t i = 0;
+#if FP16_SIMD_AVX512
+	for (; i + 16 <= n; i += 16) {
+		const __m512 f = _mm512_loadu_ps((const float*) (bytes + 4 * i));
+		_mm256_storeu_si256((__m256i*) (bytes + 2 * i), fp16_simd_avx512_fp32_to_alt(f));
+	}
+	fp32_alt_to_fp16_array_small((const float*) (bytes + 4 * i), (float16*) (bytes + 2 * i), n - i);
+#elif FP16_SIMD_AVX2
+	for (; i + 8 <= n; i += 8) {
+		const __m256 f = _mm256_loadu_ps((const float*) (bytes + 4 * i));
+		_mm_storeu_si128((__m128i*) (bytes + 2 * i), fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(f)));
+	}
+	fp32_alt_to_fp16_array_small((const float*) (bytes + 4 * i), (float16*) (bytes + 2 * i), n - i);
+#else
+	for (; i < n; i++) {
+		float f;
+		memcpy(&f, bytes + 4 * i, sizeof(f));
+		const float16 h = fp32_alt_to_fp16_value(f);
+		memcpy(bytes + 2 * i, &h, sizeof(h));
+	}
+#endif
+	return (float16*) buffer;
+}
+
+/*
+ * Expand n ARM alternative half-precision numbers at the start of a buffer of at least 4 * n bytes into
+ * single-precision numbers in the same buffer.
+ */
+static inline float* fp16_alt_to_fp32_array_inplace(void* buffer, size_t n) {
+	unsigned char* bytes = (unsigned char*) buffer;
+	size_t i = n;
+#if FP16_SIMD_AVX512
+	for (; i >= 16; i -= 16) {
+		const size_t j = i - 16;
+		const __m512 f = fp16_simd_avx512_alt_to_fp32(_mm256_loadu_si256((const __m256i*) (bytes + 2 * j)));
+		_mm512_storeu_ps((float*) (bytes + 4 * j), f);
+	}
+	fp16_alt_to_fp32_array_small((const float16*) bytes, (float*) bytes, i);
+#elif FP16_SIMD_AVX2
+	for (; i >= 8; i -= 8) {
+		const size_t j = i - 8;
+		const __m256 f = fp16_simd_avx2_alt_to_fp32(_mm_loadu_si128((const __m128i*) (bytes + 2 * j)));
+		_mm256_storeu_ps((float*) (bytes + 4 * j), f);
+	}
+	fp16_alt_to_fp32_array_small((const float16*) bytes, (float*) bytes, i);
+#else
+	while (i != 0) {
+		i -= 1;
+		float16 h;
+		memcpy(&h, bytes + 2 * i, sizeof(h));
+		const float f = fp16_alt_to_fp32_value(h);
+		memcpy(bytes + 4 * i, &f, sizeof(f));
+	}
+#endif
+	return (float*) buffer;
+}
+
+#endif /* FP16_ARRAY_H */
@@ -0,0 +1,279 @@
+#pragma once
+#ifndef FP16_BATCH_H
+#define FP16_BATCH_H
+
+#ifndef __cplusplus
+	#error "fp16/batch.h requires a C++11 compiler"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "fp16.h"
+#include "strided.h"
+
+/*
+ * Conversion of many arrays at once on a work-stealing thread pool, e.g. every tensor of a checkpoint:
+ *
+ *   std::vector<fp16::conversion_job> jobs;
+ *   for (const tensor& t : checkpoint) {
+ *     jobs.push_back({ t.fp16_data, t.fp32_data, t.elements, FP16_CONVERSION_IEEE_TO_FP32 });
+ *   }
+ *   fp16::batch_converter converter;
+ *   converter.convert(jobs.data(), jobs.size());
+ *
+ * The jobs are laid end to end and the concatenation is cut into tasks of `grain` elements, so a task covers a piece
+ * of one large array or several small arrays at once: arrays of a few elements cost no more scheduling than arrays
+ * of thousands, and arrays of billions of elements keep every thread busy. Every task converts its pieces with the
+ * contiguous kernels of array.h (through fp16_convert_strided with unit strides).
+ *
+ * Each thread starts with an equal, contiguous share of the tasks and takes them from the front of its share. A
+ * thread whose share is exhausted steals the back half of the share of another thread, so threads that fall behind,
+ * e.g. when the operating system preempts them, do not delay the batch. The calling thread works as one of the
+ * threads; the others wait on a condition variable between batches, and convert() returns only after each of them has
+ * finished with the batch.
+ *
+ * The grain is reduced for small batches so that every thread gets at least four tasks, but not below
+ * batch_converter::min_grain. Batches of a single task are converted on the calling thread without waking the pool.
+ * Inputs and outputs of different jobs must not overlap. A batch_converter converts one batch at a time.
+ */
+namespace fp16 {
+
+struct conversion_job {
+	const void* input;
+	void* output;
+	size_t count;
+	fp16_conversion_kind kind;
+};
+
+class batch_converter {
+public:
+	/* Elements per task: 128 KiB of half-precision and 256 KiB of single-precision numbers, which stay in L2 */
+	static const size_t default_grain = 65536;
+	static const size_t min_grain = 4096;
+
+	/* threads == 0 means std::thread::hardware_concurrency(); the calling thread counts as one of the threads */
+	explicit batch_converter(size_t threads = 0, size_t grain = default_grain) :
+		grain_(std::max<size_t>(grain / 64 * 64, 64)),
+		shares_(threads != 0 ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1)),
+		jobs_(nullptr),
+		total_(0),
+		grain_used_(0),
+		remaining_(0),
+		steals_(0),
+		generation_(0),
+		finished_(0),
+		stop_(false)
+	{
+		for (size_t i = 1; i < shares_.size(); i++) {
+			workers_.push_back(std::thread(&batch_converter::worker, this, i));
+		}
+	}
+
+	batch_converter(const batch_converter&) = delete;
+	batch_converter& operator=(const batch_converter&) = delete;
+
+	~batch_converter() {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		wake_.notify_all();
+		for (std::thread& worker : workers_) {
+			worker.join();
+		}
+	}
+
+	size_t threads() const {
+		return shares_.size();
+	}
+
+	/* Number of steals in the last batch */
+	size_t steals() const {
+		return steals_.load(std::memory_order_relaxed);
+	}
+
+	void convert(const std::vector<conversion_job>& jobs) {
+		convert(jobs.data(), jobs.size());
+	}
+
+	void convert(const conversion_job* jobs, size_t count) {
+		offsets_.resize(count + 1);
+		offsets_[0] = 0;
+		for (size_t i = 0; i < count; i++) {
+			offsets_[i + 1] = offsets_[i] + jobs[i].count;
+		}
+		const size_t total = offsets_[count];
+		steals_.store(0, std::memory_order_relaxed);
+		if (total == 0) {
+			return;
+		}
+		jobs_ = jobs;
+
+		const size_t threads = shares_.size();
+		size_t grain = grain_;
+		const size_t balanced_grain = ((total + 4 * threads - 1) / (4 * threads) + 63) / 64 * 64;
+		if (balanced_grain < grain) {
+			const size_t floor_grain = grain < (size_t) min_grain ? grain : (size_t) min_grain;
+			grain = balanced_grain > floor_grain ? balanced_grain : floor_grain;
+		}
+		grain_used_ = grain;
+		const size_t tasks = (total + grain - 1) / grain;
+		total_ = total;
+		if (tasks == 1 || threads == 1) {
+			run_tasks(0, tasks);
+			return;
+		}
+
+		/* Publish the batch: equal shares of the tasks, and the number of tasks left to convert */
+		remaining_.store(tasks, std::memory_order_relaxed);
+		for (size_t i = 0; i < threads; i++) {
+			std::lock_guard<std::mutex> lock(shares_[i].mutex);
+			shares_[i].head = tasks * i / threads;
+			shares_[i].tail = tasks * (i + 1) / threads;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			finished_ = 0;
+			generation_++;
+		}
+		wake_.notify_all();
+
+		work(0);
+		/*
+		 * Wait for the workers to leave the batch as well: a worker still stealing when the next batch publishes its
+		 * shares would overwrite its new share and lose those tasks.
+		 */
+		std::unique_lock<std::mutex> lock(mutex_);
+		done_.wait(lock, [this]() {
+			return remaining_.load(std::memory_order_acquire) == 0 && finished_ == workers_.size();
+		});
+	}
+
+private:
+	/* The tasks a thread has yet to convert, [head, tail) */
+	struct share {
+		share() : head(0), tail(0) {}
+
+		std::mutex mutex;
+		size_t head;
+		size_t tail;
+	};
+
+	/* Convert the elements [begin, end) of the concatenated jobs */
+	void run_task(size_t begin, size_t end) const {
+		size_t job = (size_t) (std::upper_bound(offsets_.begin(), offsets_.end(), begin) - offsets_.begin()) - 1;
+		while (begin < end) {
+			const conversion_job& j = jobs_[job];
+			const size_t piece_end = std::min(end, offsets_[job + 1]);
+			const size_t first = begin - offsets_[job];
+			fp16_convert_strided(j.kind,
+				static_cast<const unsigned char*>(j.input) + first * fp16_conversion_input_size(j.kind), 1,
+				static_cast<unsigned char*>(j.output) + first * fp16_conversion_output_size(j.kind), 1,
+				piece_end - begin);
+			begin = piece_end;
+			job++;
+		}
+	}
+
+	void run_tasks(size_t first, size_t last) const {
+		for (size_t task = first; task < last; task++) {
+			run_task(task * grain_used_, std::min(total_, (task + 1) * grain_used_));
+		}
+	}
+
+	/* Take the next task of a share, or steal half of another share; returns false when no task is left */
+	bool next_task(size_t self, size_t& task) {
+		share& own = shares_[self];
+		{
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (own.head < own.tail) {
+				task = own.head++;
+				return true;
+			}
+		}
+		const size_t threads = shares_.size();
+		for (size_t i = 1; i < threads; i++) {
+			share& victim = shares_[(self + i) % threads];
+			size_t first, last;
+			{
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (victim.head == victim.tail) {
+					continue;
+				}
+				last = victim.tail;
+				first = last - (last - victim.head + 1) / 2;
+				victim.tail = first;
+			}
+			steals_.fetch_add(1, std::memory_order_relaxed);
+			std::lock_guard<std::mutex> lock(own.mutex);
+			own.head = first + 1;
+			own.tail = last;
+			task = first;
+			return true;
+		}
+		return false;
+	}
+
+	void work(size_t self) {
+		size_t task;
+		while (next_task(self, task)) {
+			run_task(task * grain_used_, std::min(total_, (task + 1) * grain_used_));
+			if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				done_.notify_all();
+			}
+		}
+	}
+
+	void worker(size_t self) {
+		uint64_t generation = 0;
+		for (;;) {
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				wake_.wait(lock, [&]() { return stop_ || generation_ != generation; });
+				if (stop_) {
+					return;
+				}
+				generation = generation_;
+			}
+			work(self);
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				finished_++;
+			}
+			done_.notify_all();
+		}
+	}
+
+	const size_t grain_;
+	std::vector<share> shares_;
+	std::vector<std::thread> workers_;
+
+	/* The batch being converted */
+	const conversion_job* jobs_;
+	std::vector<size_t> offsets_;
+	size_t total_;
+	size_t grain_used_;
+	std::atomic<size_t> remaining_;
+	std::atomic<size_t> steals_;
+
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable done_;
+	uint64_t generation_;
+	/* Workers done with the current generation */
+	size_t finished_;
+	bool stop_;
+};
+
+} /* namespace fp16 */
+
+#endif /* FP16_BATCH_H */
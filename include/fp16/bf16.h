@@ -0,0 +1,309 @@
+#pragma once
+#ifndef FP16_BF16_H
+#define FP16_BF16_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fp16.h"
+#include "simd.h"
+#include "array.h"
+
+/*
+ * Conversions for the bfloat16 format: the upper 16 bits of an IEEE single-precision number (1 sign bit, 8 exponent
+ * bits, 7 mantissa bits). Widening to single-precision is exact and amounts to a shift. Narrowing either rounds to
+ * nearest-even or truncates toward zero. Both narrowings keep NaN inputs as NaN, with the quiet bit set, so that
+ * NaN payloads confined to the discarded bits don't turn into infinities.
+ *
+ * Direct conversions between bfloat16 and IEEE half-precision round once, like a conversion through single-precision,
+ * but the vector kernels keep the intermediate single-precision numbers in registers. With FP16_SIMD_AVX512_BF16 the
+ * AVX-512 kernels round with vcvtneps2bf16 and give the same results as the scalar functions.
+ */
+typedef uint16_t bfloat16;
+
+/*
+ * Convert a 16-bit floating-point number in bfloat16 format, in bit representation, to a 32-bit floating-point
+ * number in IEEE single-precision format, in bit representation.
+ */
+static inline float32_b bf16_to_fp32_bits(bfloat16 h) {
+	return (float32_b) h << 16;
+}
+
+/*
+ * Convert a 16-bit floating-point number in bfloat16 format, in bit representation, to a 32-bit floating-point
+ * number in IEEE single-precision format.
+ */
+static inline float bf16_to_fp32_value(bfloat16 h) {
+	return fp32b_to_fp32v(bf16_to_fp32_bits(h));
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * bfloat16 format, in bit representation, rounding to nearest-even.
+ *
+ * @note The implementation doesn't use any floating-point operations.
+ */
+static inline bfloat16 fp32_to_bf16_value(float f) {
+	const uint32_t w = fp32v_to_fp32b(f);
+	if ((w & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000)) {
+		return (bfloat16) ((w >> 16) | UINT32_C(0x0040));
+	}
+	/*
+	 * Adding 0x7FFF carries into the upper half when the discarded bits are above the halfway point; adding the
+	 * lowest kept bit as well carries at exactly halfway if that bit is odd. Finite numbers carry into infinity.
+	 */
+	return (bfloat16) ((w + UINT32_C(0x7FFF) + ((w >> 16) & UINT32_C(1))) >> 16);
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * bfloat16 format, in bit representation, rounding toward zero.
+ */
+static inline bfloat16 fp32_to_bf16_value_truncate(float f) {
+	const uint32_t w = fp32v_to_fp32b(f);
+	const uint32_t quiet = (w & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000) ? UINT32_C(0x0040) : 0;
+	return (bfloat16) ((w >> 16) | quiet);
+}
+
+/*
+ * Convert a 16-bit floating-point number in bfloat16 format to a 16-bit floating-point number in IEEE half-precision
+ * format, in bit representation. Numbers beyond the half-precision range become infinities or (signed) zeroes.
+ */
+static inline float16 bf16_to_fp16_ieee_value(bfloat16 h) {
+	return fp32_ieee_to_fp16_value(bf16_to_fp32_value(h));
+}
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format to a 16-bit floating-point number in bfloat16
+ * format, in bit representation, rounding to nearest-even.
+ */
+static inline bfloat16 fp16_ieee_to_bf16_value(float16 h) {
+	return fp32_to_bf16_value(fp16_ieee_to_fp32_value(h));
+}
+
+#if FP16_SIMD_AVX2
+/*
+ * Convert eight bfloat16 numbers in the 16-bit lanes of a vector to single-precision.
+ */
+static inline __m256 fp16_simd_avx2_bf16_to_fp32(__m128i h) {
+	return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+}
+
+/*
+ * Convert eight single-precision numbers to bfloat16 in the low halves of 32-bit lanes.
+ * This is a vector transcription of fp32_to_bf16_value.
+ */
+static inline __m256i fp16_simd_avx2_fp32_to_bf16_u32(__m256 f) {
+	const __m256i w = _mm256_castps_si256(f);
+	const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(w, 16), _mm256_set1_epi32(1));
+	const __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(w, _mm256_set1_epi32(0x7FFF)), lsb), 16);
+	const __m256i quiet_nan = _mm256_or_si256(_mm256_srli_epi32(w, 16), _mm256_set1_epi32(0x0040));
+	const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+	return _mm256_blendv_epi8(rounded, quiet_nan, nan);
+}
+
+/*
+ * Convert eight single-precision numbers to bfloat16 in the low halves of 32-bit lanes, rounding toward zero.
+ * This is a vector transcription of fp32_to_bf16_value_truncate.
+ */
+static inline __m256i fp16_simd_avx2_fp32_to_bf16_truncate_u32(__m256 f) {
+	const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+	return _mm256_or_si256(_mm256_srli_epi32(_mm256_castps_si256(f), 16), _mm256_and_si256(nan, _mm256_set1_epi32(0x0040)));
+}
+#endif /* FP16_SIMD_AVX2 */
+
+#if FP16_SIMD_AVX512
+static inline __m512 fp16_simd_avx512_bf16_to_fp32(__m256i h) {
+	return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(h), 16));
+}
+
+/*
+ * Round the bit representations of sixteen non-NaN single-precision numbers to nearest-even bfloat16.
+ */
+static inline __m256i fp16_simd_avx512_round_to_bf16(__m512i w) {
+	const __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(w, 16), _mm512_set1_epi32(1));
+	return _mm512_cvtepi32_epi16(_mm512_srli_epi32(_mm512_add_epi32(_mm512_add_epi32(w, _mm512_set1_epi32(0x7FFF)), lsb), 16));
+}
+
+static inline __m256i fp16_simd_avx512_fp32_to_bf16(__m512 f) {
+	const __m512i w = _mm512_castps_si512(f);
+#if FP16_SIMD_AVX512_BF16
+	/*
+	 * vcvtneps2bf16 treats denormalized inputs as zeroes. Such inputs are rare, so their lanes are rounded again
+	 * with integer operations only when a vector contains any.
+	 */
+	const __m256i h = (__m256i) _mm512_cvtneps_pbh(f);
+	const __mmask16 denormal = _mm512_testn_epi32_mask(w, _mm512_set1_epi32(0x7F800000)) &
+		_mm512_test_epi32_mask(w, _mm512_set1_epi32(0x007FFFFF));
+	if (denormal != 0) {
+		return _mm256_mask_mov_epi16(h, denormal, fp16_simd_avx512_round_to_bf16(w));
+	}
+	return h;
+#else
+	const __mmask16 nan = _mm512_cmp_ps_mask(f, f, _CMP_UNORD_Q);
+	const __m256i quiet_nan = _mm512_cvtepi32_epi16(_mm512_or_si512(_mm512_srli_epi32(w, 16), _mm512_set1_epi32(0x0040)));
+	return _mm256_mask_mov_epi16(fp16_simd_avx512_round_to_bf16(w), nan, quiet_nan);
+#endif
+}
+
+static inline __m256i fp16_simd_avx512_fp32_to_bf16_truncate(__m512 f) {
+	const __mmask16 nan = _mm512_cmp_ps_mask(f, f, _CMP_UNORD_Q);
+	const __m512i h = _mm512_srli_epi32(_mm512_castps_si512(f), 16);
+	return _mm512_cvtepi32_epi16(_mm512_mask_or_epi32(h, nan, h, _mm512_set1_epi32(0x0040)));
+}
+#endif /* FP16_SIMD_AVX512 */
+
+/*
+ * Convert n bfloat16 numbers to single-precision.
+ */
+static inline void bf16_to_fp32_array(const bfloat16* input, float* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 16; n -= 16) {
+		_mm512_storeu_ps(output, fp16_simd_avx512_bf16_to_fp32(_mm256_loadu_si256((const __m256i*) input)));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm512_mask_storeu_ps(output, mask, fp16_simd_avx512_bf16_to_fp32(_mm256_maskz_loadu_epi16(mask, input)));
+#elif FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		_mm256_storeu_ps(output, fp16_simd_avx2_bf16_to_fp32(_mm_loadu_si128((const __m128i*) input)));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		_mm256_maskstore_ps(output, fp16_simd_avx2_mask_u32x8(n),
+			fp16_simd_avx2_bf16_to_fp32(fp16_simd_avx2_load_u16x8_partial(input, n)));
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = bf16_to_fp32_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n single-precision numbers to bfloat16, rounding to nearest-even.
+ */
+static inline void fp32_to_bf16_array(const float* input, bfloat16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 16; n -= 16) {
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx512_fp32_to_bf16(_mm512_loadu_ps(input)));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm256_mask_storeu_epi16(output, mask, fp16_simd_avx512_fp32_to_bf16(_mm512_maskz_loadu_ps(mask, input)));
+#elif FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_bf16_u32(_mm256_loadu_ps(input))));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		const __m256 f = _mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n));
+		fp16_simd_avx2_store_u16x8_partial(output, fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_bf16_u32(f)), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_to_bf16_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n single-precision numbers to bfloat16, rounding toward zero.
+ */
+static inline void fp32_to_bf16_array_truncate(const float* input, bfloat16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 16; n -= 16) {
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx512_fp32_to_bf16_truncate(_mm512_loadu_ps(input)));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm256_mask_storeu_epi16(output, mask, fp16_simd_avx512_fp32_to_bf16_truncate(_mm512_maskz_loadu_ps(mask, input)));
+#elif FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		_mm_storeu_si128((__m128i*) output,
+			fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_bf16_truncate_u32(_mm256_loadu_ps(input))));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		const __m256 f = _mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n));
+		fp16_simd_avx2_store_u16x8_partial(output, fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_bf16_truncate_u32(f)), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_to_bf16_value_truncate(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n bfloat16 numbers to IEEE half-precision.
+ * As in array.h, NaN inputs convert to NaN outputs with the payload bits kept by the hardware.
+ */
+static inline void bf16_to_fp16_ieee_array(const bfloat16* input, float16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 16; n -= 16) {
+		const __m512 f = fp16_simd_avx512_bf16_to_fp32(_mm256_loadu_si256((const __m256i*) input));
+		_mm256_storeu_si256((__m256i*) output, _mm512_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	const __m512 f = fp16_simd_avx512_bf16_to_fp32(_mm256_maskz_loadu_epi16(mask, input));
+	_mm256_mask_storeu_epi16(output, mask, _mm512_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+#elif FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		const __m256 f = fp16_simd_avx2_bf16_to_fp32(_mm_loadu_si128((const __m128i*) input));
+		_mm_storeu_si128((__m128i*) output, _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		const __m256 f = fp16_simd_avx2_bf16_to_fp32(fp16_simd_avx2_load_u16x8_partial(input, n));
+		fp16_simd_avx2_store_u16x8_partial(output, _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = bf16_to_fp16_ieee_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n IEEE half-precision numbers to bfloat16, rounding to nearest-even.
+ */
+static inline void fp16_ieee_to_bf16_array(const float16* input, bfloat16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 16; n -= 16) {
+		const __m512 f = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) input));
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx512_fp32_to_bf16(f));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	const __m512 f = _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(mask, input));
+	_mm256_mask_storeu_epi16(output, mask, fp16_simd_avx512_fp32_to_bf16(f));
+#elif FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		const __m256 f = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) input));
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_bf16_u32(f)));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		const __m256 f = _mm256_cvtph_ps(fp16_simd_avx2_load_u16x8_partial(input, n));
+		fp16_simd_avx2_store_u16x8_partial(output, fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_bf16_u32(f)), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp16_ieee_to_bf16_value(input[i]);
+	}
+#endif
+}
+
+#endif /* FP16_BF16_H */
@@ -0,0 +1,994 @@
+#pragma once
+#ifndef FP16_CHECKPOINT_H
+#define FP16_CHECKPOINT_H
+
+#ifndef __cplusplus
+	#error "fp16/checkpoint.h requires a C++11 compiler"
+#endif
+#if defined(_WIN32)
+	#error "fp16/checkpoint.h requires POSIX memory mapping"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "fp16.h"
+#include "array.h"
+#include "bf16.h"
+#include "file.h"
+#include "npy.h"
+
+/*
+ * Precision conversion of whole model checkpoints in the safetensors and GGUF formats:
+ *
+ *   fp16::checkpoint_options options;
+ *   options.dtype = fp16::checkpoint_dtype::bfloat16;
+ *   const fp16::checkpoint_stats stats = fp16::convert_checkpoint("model.safetensors", "model-bf16.safetensors", options);
+ *
+ * Narrowing to float16 or bfloat16 rewrites the float32 tensors; widening to float32 rewrites the float16 and bfloat16
+ * tensors. Other tensors (integers, GGUF quantized types) and all metadata are copied unchanged. As in the llama.cpp
+ * converters, one-dimensional tensors (norms, biases) stay in float32 when narrowing unless keep_vectors is false.
+ * The GGUF general.file_type key is updated when it describes an unquantized model.
+ *
+ * The input is memory-mapped with MADV_SEQUENTIAL and only its header is parsed up front. The output header is written
+ * first, with the new types, sizes and offsets, and the tensors are then cut into tasks of chunk_elements numbers, in
+ * the order of the input file. Threads take tasks from a shared counter, convert them with the array kernels into a
+ * buffer of their own and pwrite it at its final offset, so every tensor, large or small, is converted by several
+ * threads at once and the output is streamed to the file without being held in memory. The calling thread works as
+ * one of the threads.
+ *
+ * A checkpoint_file can also be opened on its own to list the tensors of a checkpoint and view their mapped data.
+ *
+ * Malformed files throw std::runtime_error, and failed system calls std::system_error with their errno. When the
+ * conversion fails the partial output file is removed.
+ */
+namespace fp16 {
+
+enum class checkpoint_format {
+	automatic,
+	safetensors,
+	gguf,
+};
+
+enum class checkpoint_dtype {
+	float32,
+	float16,
+	bfloat16,
+	other,
+};
+
+struct checkpoint_tensor {
+	std::string name;
+	checkpoint_dtype dtype;
+	/* Type as the file spells it: the safetensors dtype ("F32", "I64", ...) or the GGML type ("F16", "type 12", ...) */
+	std::string type;
+	/* GGML type number, for GGUF files */
+	uint32_t ggml_type;
+	std::vector<uint64_t> shape;
+	uint64_t elements;
+	/* Offset of the data from the start of the file, and the mapped data */
+	uint64_t offset;
+	uint64_t bytes;
+	const unsigned char* data;
+};
+
+struct checkpoint_options {
+	/* Numbers per task: 4 MiB of single-precision and 2 MiB of half-precision numbers */
+	static const size_t default_chunk_elements = 1048576;
+
+	checkpoint_options() :
+		dtype(checkpoint_dtype::float16),
+		threads(0),
+		chunk_elements(default_chunk_elements),
+		keep_vectors(true)
+	{
+	}
+
+	/* Precision of the floating-point tensors of the output */
+	checkpoint_dtype dtype;
+	/* threads == 0 means std::thread::hardware_concurrency(); the calling thread counts as one of the threads */
+	size_t threads;
+	size_t chunk_elements;
+	/* Keep one-dimensional tensors in float32 when narrowing */
+	bool keep_vectors;
+};
+
+struct checkpoint_stats {
+	checkpoint_format format;
+	size_t tensors;
+	/* Tensors whose precision changed, and their numbers */
+	size_t converted;
+	uint64_t elements;
+	uint64_t bytes_read;
+	uint64_t bytes_written;
+	size_t threads;
+};
+
+static inline std::runtime_error checkpoint_format_error(const std::string& message) {
+	return std::runtime_error("fp16::checkpoint: " + message);
+}
+
+static inline std::system_error checkpoint_system_error(const std::string& operation) {
+	return std::system_error(errno, std::generic_category(), "fp16::checkpoint: " + operation);
+}
+
+static inline size_t checkpoint_dtype_size(checkpoint_dtype dtype) {
+	return dtype == checkpoint_dtype::float32 ? sizeof(float) : sizeof(uint16_t);
+}
+
+/* Product of the dimensions, or throws when it overflows */
+static inline uint64_t checkpoint_shape_size(const std::vector<uint64_t>& shape) {
+	uint64_t elements = 1;
+	for (uint64_t dimension : shape) {
+		if (dimension != 0 && elements > UINT64_MAX / dimension) {
+			throw checkpoint_format_error("tensor shape overflows");
+		}
+		elements *= dimension;
+	}
+	return elements;
+}
+
+/* Minimal JSON scanner for the safetensors header: strings, unsigned integers, and skipping of any other value */
+class checkpoint_json {
+public:
+	checkpoint_json(const char* begin, const char* end) : p_(begin), end_(end) {}
+
+	const char* position() {
+		skip_space();
+		return p_;
+	}
+
+	bool consume(char c) {
+		skip_space();
+		if (p_ != end_ && *p_ == c) {
+			p_++;
+			return true;
+		}
+		return false;
+	}
+
+	void expect(char c) {
+		if (!consume(c)) {
+			throw checkpoint_format_error(std::string("malformed safetensors header: expected '") + c + "'");
+		}
+	}
+
+	std::string parse_string() {
+		expect('"');
+		std::string result;
+		for (;;) {
+			if (p_ == end_) {
+				throw checkpoint_format_error("malformed safetensors header: unterminated string");
+			}
+			const char c = *p_++;
+			if (c == '"') {
+				return result;
+			}
+			if (c != '\\') {
+				result += c;
+				continue;
+			}
+			if (p_ == end_) {
+				throw checkpoint_format_error("malformed safetensors header: unterminated string");
+			}
+			switch (*p_++) {
+				case '"': result += '"'; break;
+				case '\\': result += '\\'; break;
+				case '/': result += '/'; break;
+				case 'b': result += '\b'; break;
+				case 'f': result += '\f'; break;
+				case 'n': result += '\n'; break;
+				case 'r': result += '\r'; break;
+				case 't': result += '\t'; break;
+				case 'u': {
+					uint32_t code = parse_hex4();
+					if (code >= 0xD800 && code < 0xDC00 && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+						p_ += 2;
+						const uint32_t low = parse_hex4();
+						if (low < 0xDC00 || low >= 0xE000) {
+							throw checkpoint_format_error("malformed safetensors header: bad surrogate pair");
+						}
+						code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					}
+					append_utf8(result, code);
+					break;
+				}
+				default:
+					throw checkpoint_format_error("malformed safetensors header: bad escape");
+			}
+		}
+	}
+
+	uint64_t parse_uint() {
+		skip_space();
+		if (p_ == end_ || *p_ < '0' || *p_ > '9') {
+			throw checkpoint_format_error("malformed safetensors header: expected an unsigned integer");
+		}
+		uint64_t value = 0;
+		while (p_ != end_ && *p_ >= '0' && *p_ <= '9') {
+			const uint64_t digit = (uint64_t) (*p_++ - '0');
+			if (value > (UINT64_MAX - digit) / 10) {
+				throw checkpoint_format_error("malformed safetensors header: integer overflows");
+			}
+			value = value * 10 + digit;
+		}
+		return value;
+	}
+
+	std::vector<uint64_t> parse_uint_array() {
+		std::vector<uint64_t> values;
+		expect('[');
+		if (consume(']')) {
+			return values;
+		}
+		do {
+			values.push_back(parse_uint());
+		} while (consume(','));
+		expect(']');
+		return values;
+	}
+
+	void skip_value() {
+		skip_space();
+		if (p_ == end_) {
+			throw checkpoint_format_error("malformed safetensors header: expected a value");
+		}
+		if (*p_ == '"') {
+			parse_string();
+		} else if (*p_ == '{' || *p_ == '[') {
+			const char close = *p_ == '{' ? '}' : ']';
+			p_++;
+			if (consume(close)) {
+				return;
+			}
+			do {
+				if (close == '}') {
+					parse_string();
+					expect(':');
+				}
+				skip_value();
+			} while (consume(','));
+			expect(close);
+		} else {
+			const char* start = p_;
+			while (p_ != end_ && (isalnum((unsigned char) *p_) || *p_ == '-' || *p_ == '+' || *p_ == '.')) {
+				p_++;
+			}
+			if (p_ == start) {
+				throw checkpoint_format_error("malformed safetensors header: unexpected character");
+			}
+		}
+	}
+
+private:
+	void skip_space() {
+		while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+			p_++;
+		}
+	}
+
+	uint32_t parse_hex4() {
+		if (end_ - p_ < 4) {
+			throw checkpoint_format_error("malformed safetensors header: bad escape");
+		}
+		uint32_t code = 0;
+		for (int i = 0; i < 4; i++) {
+			const char c = *p_++;
+			code <<= 4;
+			if (c >= '0' && c <= '9') {
+				code |= (uint32_t) (c - '0');
+			} else if (c >= 'a' && c <= 'f') {
+				code |= (uint32_t) (c - 'a' + 10);
+			} else if (c >= 'A' && c <= 'F') {
+				code |= (uint32_t) (c - 'A' + 10);
+			} else {
+				throw checkpoint_format_error("malformed safetensors header: bad escape");
+			}
+		}
+		return code;
+	}
+
+	static void append_utf8(std::string& s, uint32_t code) {
+		if (code < 0x80) {
+			s += (char) code;
+		} else if (code < 0x800) {
+			s += (char) (0xC0 | code >> 6);
+			s += (char) (0x80 | (code & 0x3F));
+		} else if (code < 0x10000) {
+			s += (char) (0xE0 | code >> 12);
+			s += (char) (0x80 | (code >> 6 & 0x3F));
+			s += (char) (0x80 | (code & 0x3F));
+		} else {
+			s += (char) (0xF0 | code >> 18);
+			s += (char) (0x80 | (code >> 12 & 0x3F));
+			s += (char) (0x80 | (code >> 6 & 0x3F));
+			s += (char) (0x80 | (code & 0x3F));
+		}
+	}
+
+	const char* p_;
+	const char* end_;
+};
+
+/* JSON string literal for a UTF-8 string */
+static inline std::string checkpoint_json_string(const std::string& s) {
+	static const char hex[] = "0123456789abcdef";
+	std::string result = "\"";
+	for (char c : s) {
+		if (c == '"' || c == '\\') {
+			result += '\\';
+			result += c;
+		} else if ((unsigned char) c < 0x20) {
+			result += "\\u00";
+			result += hex[(unsigned char) c >> 4];
+			result += hex[(unsigned char) c & 15];
+		} else {
+			result += c;
+		}
+	}
+	return result + "\"";
+}
+
+/* Bounds-checked little-endian reader for the GGUF header */
+class checkpoint_reader {
+public:
+	checkpoint_reader(const unsigned char* data, size_t size, size_t position) : data_(data), size_(size), position_(position) {}
+
+	size_t position() const {
+		return position_;
+	}
+
+	void skip(uint64_t bytes) {
+		if (bytes > size_ - position_) {
+			throw checkpoint_format_error("truncated GGUF header");
+		}
+		position_ += (size_t) bytes;
+	}
+
+	uint32_t u32() {
+		const size_t at = position_;
+		skip(4);
+		return npy_load_le32(data_ + at);
+	}
+
+	uint64_t u64() {
+		const size_t at = position_;
+		skip(8);
+		return npy_load_le64(data_ + at);
+	}
+
+	std::string string() {
+		const uint64_t length = u64();
+		const size_t at = position_;
+		skip(length);
+		return std::string((const char*) data_ + at, (size_t) length);
+	}
+
+	/* Skip a metadata value of a GGUF value type */
+	void skip_value(uint32_t type, int depth = 0) {
+		const uint64_t size = value_size(type);
+		if (size != 0) {
+			skip(size);
+		} else if (type == gguf_string) {
+			skip(u64());
+		} else if (type == gguf_array && depth < 8) {
+			const uint32_t element_type = u32();
+			const uint64_t count = u64();
+			const uint64_t element_size = value_size(element_type);
+			if (element_size != 0) {
+				if (count > (uint64_t) (size_ - position_) / element_size) {
+					throw checkpoint_format_error("truncated GGUF header");
+				}
+				skip(count * element_size);
+			} else {
+				for (uint64_t i = 0; i < count; i++) {
+					skip_value(element_type, depth + 1);
+				}
+			}
+		} else {
+			throw checkpoint_format_error("unknown GGUF metadata type " + std::to_string(type));
+		}
+	}
+
+	static const uint32_t gguf_uint32 = 4;
+	static const uint32_t gguf_string = 8;
+	static const uint32_t gguf_array = 9;
+
+private:
+	/* Size of the fixed-size value types, 0 for strings and arrays */
+	static uint64_t value_size(uint32_t type) {
+		switch (type) {
+			case 0: case 1: case 7:  /* UINT8, INT8, BOOL */
+				return 1;
+			case 2: case 3:          /* UINT16, INT16 */
+				return 2;
+			case 4: case 5: case 6:  /* UINT32, INT32, FLOAT32 */
+				return 4;
+			case 10: case 11: case 12:  /* UINT64, INT64, FLOAT64 */
+				return 8;
+			default:
+				return 0;
+		}
+	}
+
+	const unsigned char* data_;
+	size_t size_;
+	size_t position_;
+};
+
+/* GGML types with one element per block, and their element sizes */
+static inline size_t checkpoint_ggml_type_size(uint32_t type) {
+	switch (type) {
+		case 0:  /* F32 */
+		case 26: /* I32 */
+			return 4;
+		case 1:  /* F16 */
+		case 25: /* I16 */
+		case 30: /* BF16 */
+			return 2;
+		case 24: /* I8 */
+			return 1;
+		case 27: /* I64 */
+		case 28: /* F64 */
+			return 8;
+		default:
+			return 0;
+	}
+}
+
+static inline uint32_t checkpoint_ggml_type(checkpoint_dtype dtype) {
+	return dtype == checkpoint_dtype::float32 ? 0 : dtype == checkpoint_dtype::float16 ? 1 : 30;
+}
+
+static inline const char* checkpoint_dtype_name(checkpoint_dtype dtype) {
+	return dtype == checkpoint_dtype::float32 ? "F32" : dtype == checkpoint_dtype::float16 ? "F16" : "BF16";
+}
+
+class checkpoint_file {
+public:
+	explicit checkpoint_file(const char* path, checkpoint_format format = checkpoint_format::automatic) :
+		mapping_(path, npy_advice::sequential),
+		format_(format),
+		header_end_(0),
+		alignment_(32),
+		file_type_offset_(0)
+	{
+		const unsigned char* data = mapping_.data();
+		const size_t size = mapping_.size();
+		if (format_ == checkpoint_format::automatic) {
+			format_ = size >= 4 && memcmp(data, "GGUF", 4) == 0 ? checkpoint_format::gguf : checkpoint_format::safetensors;
+		}
+		if (format_ == checkpoint_format::gguf) {
+			parse_gguf(data, size);
+		} else {
+			parse_safetensors(data, size);
+		}
+		for (size_t i = 0; i < tensors_.size(); i++) {
+			if (!index_.insert(std::make_pair(tensors_[i].name, i)).second) {
+				throw checkpoint_format_error("duplicate tensor '" + tensors_[i].name + "'");
+			}
+		}
+	}
+
+	checkpoint_format format() const {
+		return format_;
+	}
+
+	const std::vector<checkpoint_tensor>& tensors() const {
+		return tensors_;
+	}
+
+	/* The tensor with the given name, or nullptr */
+	const checkpoint_tensor* find(const std::string& name) const {
+		const std::map<std::string, size_t>::const_iterator it = index_.find(name);
+		return it != index_.end() ? &tensors_[it->second] : nullptr;
+	}
+
+	uint64_t file_size() const {
+		return mapping_.size();
+	}
+
+private:
+	friend class checkpoint_conversion;
+
+	void parse_safetensors(const unsigned char* data, size_t size) {
+		if (size < 8) {
+			throw checkpoint_format_error("not a safetensors file");
+		}
+		const uint64_t header_size = npy_load_le64(data);
+		if (header_size > size - 8) {
+			throw checkpoint_format_error("truncated safetensors header");
+		}
+		const char* header = (const char*) data + 8;
+		const uint64_t base = 8 + header_size;
+		checkpoint_json json(header, header + header_size);
+		json.expect('{');
+		if (json.consume('}')) {
+			return;
+		}
+		do {
+			const std::string key = json.parse_string();
+			json.expect(':');
+			if (key == "__metadata__") {
+				const char* start = json.position();
+				json.skip_value();
+				metadata_.assign(start, json.position());
+				continue;
+			}
+			checkpoint_tensor tensor;
+			tensor.name = key;
+			tensor.ggml_type = 0;
+			bool has_offsets = false;
+			uint64_t begin = 0, end = 0;
+			json.expect('{');
+			if (!json.consume('}')) {
+				do {
+					const std::string field = json.parse_string();
+					json.expect(':');
+					if (field == "dtype") {
+						tensor.type = json.parse_string();
+					} else if (field == "shape") {
+						tensor.shape = json.parse_uint_array();
+					} else if (field == "data_offsets") {
+						const std::vector<uint64_t> offsets = json.parse_uint_array();
+						if (offsets.size() != 2) {
+							throw checkpoint_format_error("tensor '" + key + "' has malformed data_offsets");
+						}
+						begin = offsets[0];
+						end = offsets[1];
+						has_offsets = true;
+					} else {
+						json.skip_value();
+					}
+				} while (json.consume(','));
+				json.expect('}');
+			}
+			if (tensor.type.empty() || !has_offsets) {
+				throw checkpoint_format_error("tensor '" + key + "' has no dtype or data_offsets");
+			}
+			if (begin > end || end > size - base) {
+				throw checkpoint_format_error("tensor '" + key + "' is out of the file");
+			}
+			tensor.dtype =
+				tensor.type == "F32" ? checkpoint_dtype::float32 :
+				tensor.type == "F16" ? checkpoint_dtype::float16 :
+				tensor.type == "BF16" ? checkpoint_dtype::bfloat16 : checkpoint_dtype::other;
+			tensor.elements = checkpoint_shape_size(tensor.shape);
+			tensor.offset = base + begin;
+			tensor.bytes = end - begin;
+			tensor.data = data + tensor.offset;
+			/* Compare elements * size with the byte count without overflowing the product */
+			if (tensor.dtype != checkpoint_dtype::other &&
+				(tensor.elements > tensor.bytes / checkpoint_dtype_size(tensor.dtype) ||
+					tensor.elements * checkpoint_dtype_size(tensor.dtype) != tensor.bytes))
+			{
+				throw checkpoint_format_error("tensor '" + key + "' size does not match its shape");
+			}
+			tensors_.push_back(tensor);
+		} while (json.consume(','));
+		json.expect('}');
+	}
+
+	void parse_gguf(const unsigned char* data, size_t size) {
+		checkpoint_reader reader(data, size, 0);
+		if (size < 4 || memcmp(data, "GGUF", 4) != 0) {
+			throw checkpoint_format_error("not a GGUF file");
+		}
+		reader.skip(4);
+		const uint32_t version = reader.u32();
+		if (version != 2 && version != 3) {
+			throw checkpoint_format_error("unsupported GGUF version " + std::to_string(version));
+		}
+		const uint64_t tensor_count = reader.u64();
+		const uint64_t kv_count = reader.u64();
+		for (uint64_t i = 0; i < kv_count; i++) {
+			const std::string key = reader.string();
+			const uint32_t type = reader.u32();
+			if (type == checkpoint_reader::gguf_uint32 && key == "general.alignment") {
+				alignment_ = reader.u32();
+				if (alignment_ == 0 || (alignment_ & (alignment_ - 1)) != 0) {
+					throw checkpoint_format_error("GGUF alignment is not a power of 2");
+				}
+			} else {
+				if (type == checkpoint_reader::gguf_uint32 && key == "general.file_type") {
+					file_type_offset_ = reader.position();
+				}
+				reader.skip_value(type);
+			}
+		}
+		header_end_ = reader.position();
+
+		/* Each tensor info takes at least 24 bytes, which bounds the reservation for corrupt counts */
+		if (tensor_count > (size - reader.position()) / 24) {
+			throw checkpoint_format_error("truncated GGUF header");
+		}
+		tensors_.reserve((size_t) tensor_count);
+		std::vector<uint64_t> offsets;
+		for (uint64_t i = 0; i < tensor_count; i++) {
+			checkpoint_tensor tensor;
+			tensor.name = reader.string();
+			const uint32_t dimensions = reader.u32();
+			if (dimensions > 16) {
+				throw checkpoint_format_error("tensor '" + tensor.name + "' has too many dimensions");
+			}
+			for (uint32_t d = 0; d < dimensions; d++) {
+				tensor.shape.push_back(reader.u64());
+			}
+			tensor.ggml_type = reader.u32();
+			tensor.offset = reader.u64();
+			tensor.elements = checkpoint_shape_size(tensor.shape);
+			tensor.dtype =
+				tensor.ggml_type == 0 ? checkpoint_dtype::float32 :
+				tensor.ggml_type == 1 ? checkpoint_dtype::float16 :
+				tensor.ggml_type == 30 ? checkpoint_dtype::bfloat16 : checkpoint_dtype::other;
+			tensor.type = tensor.dtype != checkpoint_dtype::other ?
+				std::string(checkpoint_dtype_name(tensor.dtype)) : "type " + std::to_string(tensor.ggml_type);
+			if (tensor.offset % alignment_ != 0) {
+				throw checkpoint_format_error("tensor '" + tensor.name + "' is not aligned");
+			}
+			offsets.push_back(tensor.offset);
+			tensors_.push_back(tensor);
+		}
+		const uint64_t data_start = (reader.position() + alignment_ - 1) / alignment_ * alignment_;
+		if (data_start > size) {
+			throw checkpoint_format_error("truncated GGUF file");
+		}
+		const uint64_t data_size = size - data_start;
+
+		/*
+		 * Types with one element per block have a known size; the size of quantized tensors is taken up to the next
+		 * tensor or the end of the file, which may include the alignment padding after them.
+		 */
+		std::sort(offsets.begin(), offsets.end());
+		for (checkpoint_tensor& tensor : tensors_) {
+			const size_t element_size = checkpoint_ggml_type_size(tensor.ggml_type);
+			if (tensor.offset > data_size) {
+				throw checkpoint_format_error("tensor '" + tensor.name + "' is out of the file");
+			}
+			if (element_size != 0) {
+				if (tensor.elements > (data_size - tensor.offset) / element_size) {
+					throw checkpoint_format_error("tensor '" + tensor.name + "' is out of the file");
+				}
+				tensor.bytes = tensor.elements * element_size;
+			} else {
+				const std::vector<uint64_t>::const_iterator next = std::upper_bound(offsets.begin(), offsets.end(), tensor.offset);
+				tensor.bytes = (next != offsets.end() ? *next : data_size) - tensor.offset;
+			}
+			tensor.offset += data_start;
+			tensor.data = data + tensor.offset;
+		}
+	}
+
+	npy_mapping mapping_;
+	checkpoint_format format_;
+	std::vector<checkpoint_tensor> tensors_;
+	std::map<std::string, size_t> index_;
+	/* safetensors: the JSON text of __metadata__, or empty */
+	std::string metadata_;
+	/* GGUF: the end of the key-value metadata, the data alignment, and the offset of a UINT32 general.file_type */
+	size_t header_end_;
+	uint64_t alignment_;
+	size_t file_type_offset_;
+};
+
+/* The output layout of a conversion: its header, the types and offsets of its tensors, and the tasks */
+class checkpoint_conversion {
+public:
+	struct output_tensor {
+		checkpoint_dtype dtype;
+		uint64_t offset;
+		uint64_t bytes;
+	};
+
+	/* Elements [begin, begin + count) of a converted tensor, or bytes of a copied one */
+	struct task {
+		size_t tensor;
+		uint64_t begin;
+		uint64_t count;
+	};
+
+	checkpoint_conversion(const checkpoint_file& input, const checkpoint_options& options) : input_(input), size_(0) {
+		const std::vector<checkpoint_tensor>& tensors = input.tensors();
+		outputs_.resize(tensors.size());
+		for (size_t i = 0; i < tensors.size(); i++) {
+			const checkpoint_tensor& tensor = tensors[i];
+			checkpoint_dtype dtype = tensor.dtype;
+			if (tensor.dtype == checkpoint_dtype::float32 && options.dtype != checkpoint_dtype::float32 &&
+				!(options.keep_vectors && tensor.shape.size() <= 1))
+			{
+				dtype = options.dtype;
+			} else if ((tensor.dtype == checkpoint_dtype::float16 || tensor.dtype == checkpoint_dtype::bfloat16) &&
+				options.dtype == checkpoint_dtype::float32)
+			{
+				dtype = checkpoint_dtype::float32;
+			}
+			outputs_[i].dtype = dtype;
+			outputs_[i].bytes = dtype != tensor.dtype ? tensor.elements * checkpoint_dtype_size(dtype) : tensor.bytes;
+		}
+
+		/* Tensors keep the order they have in the input file */
+		std::vector<size_t> order(tensors.size());
+		for (size_t i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return tensors[a].offset < tensors[b].offset; });
+		if (input.format() == checkpoint_format::gguf) {
+			layout_gguf(order, options.dtype);
+		} else {
+			layout_safetensors(order);
+		}
+
+		const uint64_t chunk = std::max<uint64_t>(options.chunk_elements, 64);
+		for (size_t i : order) {
+			const bool convert = outputs_[i].dtype != tensors[i].dtype;
+			const uint64_t total = convert ? tensors[i].elements : tensors[i].bytes;
+			const uint64_t step = convert ? chunk : chunk * sizeof(float);
+			for (uint64_t begin = 0; begin < total; begin += step) {
+				const task t = { i, begin, std::min(step, total - begin) };
+				tasks_.push_back(t);
+			}
+		}
+	}
+
+	const std::string& header() const {
+		return header_;
+	}
+
+	const std::vector<output_tensor>& outputs() const {
+		return outputs_;
+	}
+
+	const std::vector<task>& tasks() const {
+		return tasks_;
+	}
+
+	uint64_t size() const {
+		return size_;
+	}
+
+private:
+	void layout_safetensors(const std::vector<size_t>& order) {
+		const std::vector<checkpoint_tensor>& tensors = input_.tensors();
+		std::vector<uint64_t> offsets(tensors.size());
+		uint64_t offset = 0;
+		for (size_t i : order) {
+			offsets[i] = offset;
+			offset += outputs_[i].bytes;
+		}
+		std::string json = "{";
+		if (!input_.metadata_.empty()) {
+			json += "\"__metadata__\":" + input_.metadata_;
+		}
+		for (size_t i = 0; i < tensors.size(); i++) {
+			const checkpoint_tensor& tensor = tensors[i];
+			if (json.size() != 1) {
+				json += ',';
+			}
+			json += checkpoint_json_string(tensor.name) + ":{\"dtype\":\"";
+			json += outputs_[i].dtype != tensor.dtype ? checkpoint_dtype_name(outputs_[i].dtype) : tensor.type.c_str();
+			json += "\",\"shape\":[";
+			for (size_t d = 0; d < tensor.shape.size(); d++) {
+				json += (d != 0 ? "," : "") + std::to_string(tensor.shape[d]);
+			}
+			json += "],\"data_offsets\":[" + std::to_string(offsets[i]) + "," + std::to_string(offsets[i] + outputs_[i].bytes) + "]}";
+		}
+		json += '}';
+		/* The data starts at a multiple of 8 bytes, padded with spaces like the reference implementation does */
+		json.append((8 - json.size() % 8) % 8, ' ');
+
+		header_.assign(8, '\0');
+		npy_store_le64((unsigned char*) &header_[0], (uint64_t) json.size());
+		header_ += json;
+		for (size_t i = 0; i < tensors.size(); i++) {
+			outputs_[i].offset = header_.size() + offsets[i];
+		}
+		size_ = header_.size() + offset;
+	}
+
+	void layout_gguf(const std::vector<size_t>& order, checkpoint_dtype dtype) {
+		const std::vector<checkpoint_tensor>& tensors = input_.tensors();
+		const uint64_t alignment = input_.alignment_;
+		std::vector<uint64_t> offsets(tensors.size());
+		uint64_t offset = 0;
+		for (size_t i : order) {
+			offsets[i] = offset;
+			offset = (offset + outputs_[i].bytes + alignment - 1) / alignment * alignment;
+		}
+
+		header_.assign((const char*) input_.mapping_.data(), input_.header_end_);
+		if (input_.file_type_offset_ != 0) {
+			/* LLAMA_FTYPE_ALL_F32, LLAMA_FTYPE_MOSTLY_F16 and LLAMA_FTYPE_MOSTLY_BF16 describe unquantized models */
+			unsigned char* file_type = (unsigned char*) &header_[input_.file_type_offset_];
+			const uint32_t value = npy_load_le32(file_type);
+			if (value == 0 || value == 1 || value == 32) {
+				npy_store_le32(file_type, dtype == checkpoint_dtype::float32 ? 0 : dtype == checkpoint_dtype::float16 ? 1 : 32);
+			}
+		}
+		unsigned char buffer[8];
+		for (size_t i = 0; i < tensors.size(); i++) {
+			const checkpoint_tensor& tensor = tensors[i];
+			npy_store_le64(buffer, (uint64_t) tensor.name.size());
+			header_.append((const char*) buffer, 8);
+			header_ += tensor.name;
+			npy_store_le32(buffer, (uint32_t) tensor.shape.size());
+			header_.append((const char*) buffer, 4);
+			for (uint64_t dimension : tensor.shape) {
+				npy_store_le64(buffer, dimension);
+				header_.append((const char*) buffer, 8);
+			}
+			npy_store_le32(buffer, outputs_[i].dtype != tensor.dtype ? checkpoint_ggml_type(outputs_[i].dtype) : tensor.ggml_type);
+			header_.append((const char*) buffer, 4);
+			npy_store_le64(buffer, offsets[i]);
+			header_.append((const char*) buffer, 8);
+		}
+		header_.append((size_t) ((alignment - header_.size() % alignment) % alignment), '\0');
+		for (size_t i = 0; i < tensors.size(); i++) {
+			outputs_[i].offset = header_.size() + offsets[i];
+		}
+		size_ = header_.size() + offset;
+	}
+
+	const checkpoint_file& input_;
+	std::string header_;
+	std::vector<output_tensor> outputs_;
+	std::vector<task> tasks_;
+	uint64_t size_;
+};
+
+/* Convert n numbers between float32 and float16 or bfloat16 with the array kernels */
+static inline void checkpoint_convert(checkpoint_dtype from, checkpoint_dtype to, const void* input, void* output, size_t n) {
+	if (from == checkpoint_dtype::float32) {
+		if (to == checkpoint_dtype::float16) {
+			fp32_ieee_to_fp16_array(static_cast<const float*>(input), static_cast<float16*>(output), n);
+		} else {
+			fp32_to_bf16_array(static_cast<const float*>(input), static_cast<bfloat16*>(output), n);
+		}
+	} else if (from == checkpoint_dtype::float16) {
+		fp16_ieee_to_fp32_array(static_cast<const float16*>(input), static_cast<float*>(output), n);
+	} else {
+		bf16_to_fp32_array(static_cast<const bfloat16*>(input), static_cast<float*>(output), n);
+	}
+}
+
+static inline void checkpoint_pwrite(int fd, const void* data, size_t size, uint64_t offset) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	while (size != 0) {
+		const ssize_t result = pwrite(fd, bytes, size, (off_t) offset);
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw checkpoint_system_error("write");
+		}
+		bytes += result;
+		size -= (size_t) result;
+		offset += (uint64_t) result;
+	}
+}
+
+static inline checkpoint_stats convert_checkpoint(const char* input_path, const char* output_path,
+	const checkpoint_options& options = checkpoint_options(), checkpoint_format format = checkpoint_format::automatic)
+{
+	/* Truncating the input while it is mapped would fault on the next read */
+	struct stat input_stat, output_stat;
+	if (stat(input_path, &input_stat) == 0 && stat(output_path, &output_stat) == 0 &&
+		input_stat.st_dev == output_stat.st_dev && input_stat.st_ino == output_stat.st_ino)
+	{
+		throw std::invalid_argument("fp16::convert_checkpoint: the output is the input file");
+	}
+	if (options.dtype == checkpoint_dtype::other) {
+		throw std::invalid_argument("fp16::convert_checkpoint: the output precision must be float32, float16 or bfloat16");
+	}
+
+	const checkpoint_file input(input_path, format);
+	const checkpoint_conversion conversion(input, options);
+	const std::vector<checkpoint_tensor>& tensors = input.tensors();
+	const std::vector<checkpoint_conversion::output_tensor>& outputs = conversion.outputs();
+	const std::vector<checkpoint_conversion::task>& tasks = conversion.tasks();
+
+	checkpoint_stats stats;
+	stats.format = input.format();
+	stats.tensors = tensors.size();
+	stats.converted = 0;
+	stats.elements = 0;
+	for (size_t i = 0; i < tensors.size(); i++) {
+		if (outputs[i].dtype != tensors[i].dtype) {
+			stats.converted++;
+			stats.elements += tensors[i].elements;
+		}
+	}
+	stats.bytes_read = input.file_size();
+	stats.bytes_written = conversion.size();
+	const size_t threads = options.threads != 0 ? options.threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	stats.threads = std::max<size_t>(std::min(threads, tasks.size()), 1);
+
+	const file_descriptor output(open(output_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+	if (output.get() < 0) {
+		throw checkpoint_system_error(std::string("open ") + output_path);
+	}
+	try {
+		checkpoint_pwrite(output.get(), conversion.header().data(), conversion.header().size(), 0);
+
+		const size_t chunk = std::max<size_t>(options.chunk_elements, 64);
+		std::atomic<size_t> next(0);
+		std::atomic<bool> failed(false);
+		std::mutex error_mutex;
+		std::exception_ptr error;
+		auto work = [&]() {
+			/* Output of a task, and a copy of its input when the input is not aligned to its numbers */
+			std::vector<float> buffer, staging;
+			try {
+				for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < tasks.size() && !failed.load(std::memory_order_relaxed);
+					i = next.fetch_add(1, std::memory_order_relaxed))
+				{
+					const checkpoint_conversion::task& t = tasks[i];
+					const checkpoint_tensor& tensor = tensors[t.tensor];
+					const checkpoint_conversion::output_tensor& out = outputs[t.tensor];
+					if (out.dtype == tensor.dtype) {
+						checkpoint_pwrite(output.get(), tensor.data + t.begin, (size_t) t.count, out.offset + t.begin);
+						continue;
+					}
+					const size_t input_size = checkpoint_dtype_size(tensor.dtype), output_size = checkpoint_dtype_size(out.dtype);
+					const unsigned char* source = tensor.data + t.begin * input_size;
+					if ((uintptr_t) source % input_size != 0) {
+						staging.resize(chunk);
+						memcpy(staging.data(), source, (size_t) t.count * input_size);
+						source = (const unsigned char*) staging.data();
+					}
+					buffer.resize(chunk);
+					checkpoint_convert(tensor.dtype, out.dtype, source, buffer.data(), (size_t) t.count);
+					checkpoint_pwrite(output.get(), buffer.data(), (size_t) t.count * output_size, out.offset + t.begin * output_size);
+				}
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(error_mutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+				failed.store(true, std::memory_order_relaxed);
+			}
+		};
+		std::vector<std::thread> workers;
+		for (size_t i = 1; i < stats.threads; i++) {
+			workers.push_back(std::thread(work));
+		}
+		work();
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		/* GGUF data ends with the padding of the last tensor, which no task writes */
+		if (ftruncate(output.get(), (off_t) conversion.size()) != 0) {
+			throw checkpoint_system_error("ftruncate");
+		}
+	} catch (...) {
+		unlink(output_path);
+		throw;
+	}
+	return stats;
+}
+
+} /* namespace fp16 */
+
+#endif /* FP16_CHECKPOINT_H */
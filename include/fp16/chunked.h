@@ -0,0 +1,362 @@
+#pragma once
+#ifndef FP16_CHUNKED_H
+#define FP16_CHUNKED_H
+
+#ifndef __cplusplus
+	#error "fp16/chunked.h requires a C++11 compiler"
+#endif
+#if defined(_WIN32)
+	#error "fp16/chunked.h requires POSIX memory mapping"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "fp16.h"
+#include "array.h"
+#include "npy.h"
+
+/*
+ * Chunked files of half-precision numbers, e.g. long sensor time series, with a footer index that holds the minimum,
+ * maximum and NaN count of every chunk (a zone map):
+ *
+ *   fp16::chunked_writer writer("temperature.f16c");
+ *   writer.append(samples, n);                  // float or float16; statistics are gathered while encoding
+ *   writer.close();                             // writes the index
+ *
+ *   fp16::chunked_file series("temperature.f16c");
+ *   series.decode(begin, count, buffer);        // touches only the chunks of [begin, begin + count)
+ *   const uint64_t hot = series.count(30.0f, 40.0f);
+ *   series.scan(30.0f, 40.0f, [](uint64_t first, const float* values, size_t count) { ... });
+ *
+ * Layout, all little-endian: a 64-byte header ("FP16CHNK", version, numbers per chunk), the chunks back to back, and the
+ * index of 24-byte entries (offset, count, NaN count, minimum and maximum as half-precision numbers) followed by a
+ * 32-byte trailer (index offset, chunk count, number count, CRC-32 of the index, "CIDX"). The number of elements per
+ * chunk is a multiple of 32, so every chunk starts at a multiple of 64 bytes and the data is one contiguous array.
+ * The minimum and maximum ignore NaNs; a chunk of NaNs only has the empty range [+inf, -inf].
+ *
+ * The reader maps the file (with MADV_RANDOM by default) and reads the header and the index only. A range query
+ * (count, scan, select) skips the chunks whose range misses the query, counts the chunks whose range lies within the
+ * query from the index alone, and decodes only the remaining chunks to single precision with the array kernels.
+ *
+ * Malformed files throw std::runtime_error, and failed system calls std::system_error with their errno.
+ */
+namespace fp16 {
+
+/* Statistics of a chunk, with the position of its first number in the series */
+struct chunked_chunk {
+	uint64_t first;
+	uint64_t offset;
+	uint32_t count;
+	uint32_t nan_count;
+	float min;
+	float max;
+};
+
+static inline std::runtime_error chunked_format_error(const std::string& message) {
+	return std::runtime_error("fp16::chunked: " + message);
+}
+
+/*
+ * Minimum, maximum and NaN count of n half-precision numbers. Numbers are compared through a 16-bit key that orders
+ * them like their values (the sign bit flipped for positive numbers, all bits for negative numbers), so the loop
+ * vectorizes into integer min/max instructions. -0 orders before +0.
+ */
+static inline void chunked_statistics(const float16* data, size_t n, uint32_t& nan_count, float16& min, float16& max) {
+	uint16_t min_key = UINT16_C(0xFFFF), max_key = 0;
+	uint32_t nans = 0;
+	for (size_t i = 0; i < n; i++) {
+		const uint16_t h = data[i];
+		const uint16_t key = (uint16_t) (h ^ (uint16_t) ((uint16_t) -(int16_t) (h >> 15) | UINT16_C(0x8000)));
+		const bool nan = (h & UINT16_C(0x7FFF)) > UINT16_C(0x7C00);
+		nans += nan;
+		const uint16_t low = nan ? UINT16_C(0xFFFF) : key, high = nan ? 0 : key;
+		min_key = low < min_key ? low : min_key;
+		max_key = high > max_key ? high : max_key;
+	}
+	nan_count = nans;
+	if (nans == n) {
+		min = UINT16_C(0x7C00);
+		max = UINT16_C(0xFC00);
+		return;
+	}
+	min = (min_key & UINT16_C(0x8000)) != 0 ? (uint16_t) (min_key ^ UINT16_C(0x8000)) : (uint16_t) ~min_key;
+	max = (max_key & UINT16_C(0x8000)) != 0 ? (uint16_t) (max_key ^ UINT16_C(0x8000)) : (uint16_t) ~max_key;
+}
+
+/* Writer of chunked files; the file is complete only after close() */
+class chunked_writer {
+public:
+	/* Numbers per chunk: 64 KiB of half-precision numbers */
+	static const size_t default_chunk_elements = 32768;
+	static const uint32_t version = 1;
+
+	explicit chunked_writer(const char* path, size_t chunk_elements = default_chunk_elements) :
+		output_(path, false),
+		chunk_elements_(chunk_elements),
+		fill_(0),
+		elements_(0),
+		closed_(false)
+	{
+		if (chunk_elements == 0 || chunk_elements % 32 != 0 || chunk_elements > UINT32_MAX) {
+			throw std::invalid_argument("fp16::chunked_writer: chunk_elements must be a positive multiple of 32");
+		}
+		buffer_.resize(chunk_elements);
+		unsigned char header[64] = { 0 };
+		memcpy(header, "FP16CHNK", 8);
+		npy_store_le32(header + 8, version);
+		npy_store_le32(header + 12, (uint32_t) chunk_elements);
+		output_.write(header, sizeof(header));
+	}
+
+	chunked_writer(const chunked_writer&) = delete;
+	chunked_writer& operator=(const chunked_writer&) = delete;
+
+	/* Append n single-precision numbers, rounded to half precision */
+	void append(const float* data, size_t n) {
+		while (n != 0) {
+			const size_t count = std::min(n, chunk_elements_ - fill_);
+			fp32_ieee_to_fp16_array(data, &buffer_[fill_], count);
+			advance(count);
+			data += count;
+			n -= count;
+		}
+	}
+
+	void append(const float16* data, size_t n) {
+		while (n != 0) {
+			const size_t count = std::min(n, chunk_elements_ - fill_);
+			memcpy(&buffer_[fill_], data, count * sizeof(float16));
+			advance(count);
+			data += count;
+			n -= count;
+		}
+	}
+
+	/* Numbers appended so far */
+	uint64_t size() const {
+		return elements_ + fill_;
+	}
+
+	/* Write the last, partial chunk and the index */
+	void close() {
+		if (closed_) {
+			return;
+		}
+		if (fill_ != 0) {
+			flush();
+		}
+		const uint64_t index_offset = output_.offset();
+		std::vector<unsigned char> index(entries_.size() * 24);
+		for (size_t i = 0; i < entries_.size(); i++) {
+			unsigned char* entry = &index[i * 24];
+			npy_store_le64(entry, entries_[i].offset);
+			npy_store_le32(entry + 8, entries_[i].count);
+			npy_store_le32(entry + 12, entries_[i].nan_count);
+			npy_store_le16(entry + 16, entries_[i].min);
+			npy_store_le16(entry + 18, entries_[i].max);
+			npy_store_le32(entry + 20, 0);
+		}
+		output_.write(index.data(), index.size());
+		unsigned char trailer[32];
+		npy_store_le64(trailer, index_offset);
+		npy_store_le64(trailer + 8, (uint64_t) entries_.size());
+		npy_store_le64(trailer + 16, elements_);
+		npy_store_le32(trailer + 24, npy_crc32(0, index.data(), index.size()));
+		memcpy(trailer + 28, "CIDX", 4);
+		output_.write(trailer, sizeof(trailer));
+		output_.close();
+		closed_ = true;
+	}
+
+private:
+	struct entry {
+		uint64_t offset;
+		uint32_t count;
+		uint32_t nan_count;
+		float16 min;
+		float16 max;
+	};
+
+	void advance(size_t count) {
+		fill_ += count;
+		if (fill_ == chunk_elements_) {
+			flush();
+		}
+	}
+
+	/* Gather the statistics of the buffered chunk while it is still in cache, and write it */
+	void flush() {
+		entry e;
+		e.offset = output_.offset();
+		e.count = (uint32_t) fill_;
+		chunked_statistics(buffer_.data(), fill_, e.nan_count, e.min, e.max);
+		output_.write(buffer_.data(), fill_ * sizeof(float16));
+		entries_.push_back(e);
+		elements_ += fill_;
+		fill_ = 0;
+	}
+
+	npy_output output_;
+	const size_t chunk_elements_;
+	std::vector<float16> buffer_;
+	size_t fill_;
+	std::vector<entry> entries_;
+	uint64_t elements_;
+	bool closed_;
+};
+
+class chunked_file {
+public:
+	explicit chunked_file(const char* path, npy_advice advice = npy_advice::random) : mapping_(path, advice), elements_(0) {
+		const unsigned char* data = mapping_.data();
+		const size_t size = mapping_.size();
+		if (size < 64 + 32 || memcmp(data, "FP16CHNK", 8) != 0) {
+			throw chunked_format_error("not a chunked file");
+		}
+		if (npy_load_le32(data + 8) != chunked_writer::version) {
+			throw chunked_format_error("unsupported version " + std::to_string(npy_load_le32(data + 8)));
+		}
+		chunk_elements_ = npy_load_le32(data + 12);
+		if (chunk_elements_ == 0 || chunk_elements_ % 32 != 0) {
+			throw chunked_format_error("bad chunk size");
+		}
+
+		const unsigned char* trailer = data + size - 32;
+		const uint64_t index_offset = npy_load_le64(trailer);
+		const uint64_t chunks = npy_load_le64(trailer + 8);
+		elements_ = npy_load_le64(trailer + 16);
+		if (memcmp(trailer + 28, "CIDX", 4) != 0 || index_offset < 64 || index_offset > size - 32 ||
+			chunks != (size - 32 - index_offset) / 24 || (size - 32 - index_offset) % 24 != 0)
+		{
+			throw chunked_format_error("bad index");
+		}
+		const unsigned char* index = data + index_offset;
+		if (npy_crc32(0, index, (size_t) chunks * 24) != npy_load_le32(trailer + 24)) {
+			throw chunked_format_error("index checksum mismatch");
+		}
+
+		/* The chunks must tile the data: full chunks back to back, only the last one partial */
+		chunks_.resize((size_t) chunks);
+		uint64_t first = 0;
+		for (size_t i = 0; i < chunks_.size(); i++) {
+			const unsigned char* entry = index + i * 24;
+			chunked_chunk& chunk = chunks_[i];
+			chunk.first = first;
+			chunk.offset = npy_load_le64(entry);
+			chunk.count = npy_load_le32(entry + 8);
+			chunk.nan_count = npy_load_le32(entry + 12);
+			chunk.min = fp16_ieee_to_fp32_value(npy_load_le16(entry + 16));
+			chunk.max = fp16_ieee_to_fp32_value(npy_load_le16(entry + 18));
+			if (chunk.offset != 64 + first * sizeof(float16) || chunk.count == 0 || chunk.count > chunk_elements_ ||
+				(chunk.count != chunk_elements_ && i + 1 != chunks_.size()) || chunk.nan_count > chunk.count)
+			{
+				throw chunked_format_error("bad index entry " + std::to_string(i));
+			}
+			first += chunk.count;
+		}
+		if (first != elements_ || 64 + elements_ * sizeof(float16) > index_offset) {
+			throw chunked_format_error("index does not match the data");
+		}
+		scratch_.resize(chunk_elements_);
+	}
+
+	/* Numbers in the series */
+	uint64_t size() const {
+		return elements_;
+	}
+
+	size_t chunk_elements() const {
+		return chunk_elements_;
+	}
+
+	const std::vector<chunked_chunk>& chunks() const {
+		return chunks_;
+	}
+
+	/* Zero-copy view of the whole series */
+	const float16* fp16_data() const {
+		return reinterpret_cast<const float16*>(mapping_.data() + 64);
+	}
+
+	/* Decode the numbers [begin, begin + count) to single precision */
+	void decode(uint64_t begin, size_t count, float* output) const {
+		if (begin > elements_ || count > elements_ - begin) {
+			throw std::out_of_range("fp16::chunked_file::decode: range is out of the series");
+		}
+		fp16_ieee_to_fp32_array(fp16_data() + begin, output, count);
+	}
+
+	/* Chunks that overlap [begin, end) and may hold numbers in [lo, hi], by the index alone */
+	std::vector<size_t> select(float lo, float hi, uint64_t begin = 0, uint64_t end = UINT64_MAX) const {
+		std::vector<size_t> selected;
+		end = std::min(end, elements_);
+		if (begin >= end) {
+			return selected;
+		}
+		const size_t first = (size_t) (begin / chunk_elements_), last = (size_t) ((end - 1) / chunk_elements_);
+		for (size_t i = first; i <= last; i++) {
+			if (may_contain(chunks_[i], lo, hi)) {
+				selected.push_back(i);
+			}
+		}
+		return selected;
+	}
+
+	/*
+	 * Call f(first, values, count) with every chunk that may hold numbers in [lo, hi], decoded to single precision;
+	 * values[j] is number first + j of the series. Returns the number of chunks decoded.
+	 */
+	template <typename F>
+	size_t scan(float lo, float hi, F f) {
+		size_t decoded = 0;
+		for (const chunked_chunk& chunk : chunks_) {
+			if (may_contain(chunk, lo, hi)) {
+				decode(chunk.first, chunk.count, scratch_.data());
+				f(chunk.first, (const float*) scratch_.data(), (size_t) chunk.count);
+				decoded++;
+			}
+		}
+		return decoded;
+	}
+
+	/* Number of values in [lo, hi]; chunks entirely within the range are counted without decoding them */
+	uint64_t count(float lo, float hi) {
+		uint64_t total = 0;
+		for (const chunked_chunk& chunk : chunks_) {
+			if (!may_contain(chunk, lo, hi)) {
+				continue;
+			}
+			if (chunk.nan_count == 0 && lo <= chunk.min && chunk.max <= hi) {
+				total += chunk.count;
+				continue;
+			}
+			decode(chunk.first, chunk.count, scratch_.data());
+			for (uint32_t i = 0; i < chunk.count; i++) {
+				total += lo <= scratch_[i] && scratch_[i] <= hi;
+			}
+		}
+		return total;
+	}
+
+private:
+	static bool may_contain(const chunked_chunk& chunk, float lo, float hi) {
+		return chunk.nan_count != chunk.count && chunk.min <= hi && lo <= chunk.max;
+	}
+
+	npy_mapping mapping_;
+	size_t chunk_elements_;
+	uint64_t elements_;
+	std::vector<chunked_chunk> chunks_;
+	std::vector<float> scratch_;
+};
+
+} /* namespace fp16 */
+
+#endif /* FP16_CHUNKED_H */
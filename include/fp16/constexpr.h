@@ -0,0 +1,332 @@
+#pragma once
+#ifndef FP16_CONSTEXPR_H
+#define FP16_CONSTEXPR_H
+
+#if !defined(__cplusplus) || ((defined(_MSVC_LANG) ? _MSVC_LANG : __cplusplus) < 201402L)
+	#error "fp16/constexpr.h requires a C++14 compiler"
+#endif
+
+#include <stdint.h>
+
+#include <limits>
+#if (defined(_MSVC_LANG) ? _MSVC_LANG : __cplusplus) >= 202002L && defined(__has_include)
+	#if __has_include(<bit>)
+		#include <bit>
+	#endif
+#endif
+
+/*
+ * constexpr versions of the scalar conversions in fp16.h, fp16/bitcasts.h and fp16/fp64.h, for half-precision
+ * constants and lookup tables that are computed at compile time:
+ *
+ *   static constexpr uint16_t kOneTenth = fp32_ieee_to_fp16_value_constexpr(0.1f);
+ *
+ * Each function is named after its fp16.h counterpart with a _constexpr suffix and returns the same bits for every
+ * input, including NaN payloads for the _bits functions. The conversions use integer operations on the bit
+ * representations, so they are also usable at run time, but the fp16.h functions are faster there.
+ *
+ * Floating-point numbers are reinterpreted as bits with std::bit_cast in C++20 or the __builtin_bit_cast extension of
+ * GCC 11, Clang 9 and MSVC 19.27. Without either (or with FP16_CONSTEXPR_BIT_CAST defined to 0), the bit casts are
+ * computed with floating-point arithmetic, which cannot tell -0.0 from +0.0 or see NaN payloads: negative zero
+ * converts as positive zero and NaN as the canonical quiet NaN 0x7FC00000 (0x7FF8000000000000 in double-precision).
+ */
+#ifndef FP16_CONSTEXPR_BIT_CAST
+	#if defined(__cpp_lib_bit_cast)
+		#define FP16_CONSTEXPR_BIT_CAST 1
+		#define FP16_CONSTEXPR_BIT_CAST_IMPL(type, value) std::bit_cast<type>(value)
+	#elif defined(__has_builtin)
+		#if __has_builtin(__builtin_bit_cast)
+			#define FP16_CONSTEXPR_BIT_CAST 1
+		#else
+			#define FP16_CONSTEXPR_BIT_CAST 0
+		#endif
+	#elif defined(_MSC_VER) && _MSC_VER >= 1927
+		#define FP16_CONSTEXPR_BIT_CAST 1
+	#else
+		#define FP16_CONSTEXPR_BIT_CAST 0
+	#endif
+#endif
+#if FP16_CONSTEXPR_BIT_CAST && !defined(FP16_CONSTEXPR_BIT_CAST_IMPL)
+	#define FP16_CONSTEXPR_BIT_CAST_IMPL(type, value) __builtin_bit_cast(type, value)
+#endif
+
+#if !FP16_CONSTEXPR_BIT_CAST
+/*
+ * 2**e for -1074 <= e <= 1023, by binary exponentiation. The partial results approach 2**e monotonically, so they
+ * are exact, and the base is only squared while it is still needed, so it neither overflows nor underflows.
+ */
+static inline constexpr double fp16_constexpr_exp2(int e) {
+	double result = 1.0;
+	double base = e < 0 ? 0.5 : 2.0;
+	for (unsigned int n = (unsigned int) (e < 0 ? -e : e); n != 0; ) {
+		if (n & 1) {
+			result *= base;
+		}
+		n >>= 1;
+		if (n != 0) {
+			base *= base;
+		}
+	}
+	return result;
+}
+
+/*
+ * Exponent e of a positive normalized number, 2**e <= a < 2**(e + 1), by binary search over [min, max].
+ */
+static inline constexpr int fp16_constexpr_ilogb(double a, int min, int max) {
+	while (min < max) {
+		const int mid = min + (max - min + 1) / 2;
+		if (a >= fp16_constexpr_exp2(mid)) {
+			min = mid;
+		} else {
+			max = mid - 1;
+		}
+	}
+	return min;
+}
+#endif /* !FP16_CONSTEXPR_BIT_CAST */
+
+static inline constexpr float fp32b_to_fp32v_constexpr(uint32_t w) {
+#if FP16_CONSTEXPR_BIT_CAST
+	return FP16_CONSTEXPR_BIT_CAST_IMPL(float, w);
+#else
+	const uint32_t exponent = (w >> 23) & UINT32_C(0xFF);
+	const uint32_t mantissa = w & UINT32_C(0x007FFFFF);
+	float magnitude = 0.0f;
+	if (exponent == 0xFF) {
+		magnitude = mantissa != 0 ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+	} else if (exponent == 0) {
+		magnitude = (float) ((double) mantissa * fp16_constexpr_exp2(-149));
+	} else {
+		magnitude = (float) ((double) (mantissa | UINT32_C(0x00800000)) * fp16_constexpr_exp2((int) exponent - 150));
+	}
+	return (w & UINT32_C(0x80000000)) ? -magnitude : magnitude;
+#endif
+}
+
+static inline constexpr uint32_t fp32v_to_fp32b_constexpr(float f) {
+#if FP16_CONSTEXPR_BIT_CAST
+	return FP16_CONSTEXPR_BIT_CAST_IMPL(uint32_t, f);
+#else
+	if (f != f) {
+		return UINT32_C(0x7FC00000);
+	}
+	const uint32_t sign = f < 0.0f ? UINT32_C(0x80000000) : 0;
+	const double magnitude = f < 0.0f ? -(double) f : (double) f;
+	if (magnitude > (double) std::numeric_limits<float>::max()) {
+		return sign | UINT32_C(0x7F800000);
+	}
+	if (magnitude < fp16_constexpr_exp2(-126)) {
+		return sign | (uint32_t) (magnitude * fp16_constexpr_exp2(149));
+	}
+	const int exponent = fp16_constexpr_ilogb(magnitude, -126, 127);
+	const uint32_t significand = (uint32_t) (magnitude * fp16_constexpr_exp2(23 - exponent));
+	return sign | ((uint32_t) (exponent + 127) << 23) | (significand & UINT32_C(0x007FFFFF));
+#endif
+}
+
+static inline constexpr double fp64b_to_fp64v_constexpr(uint64_t w) {
+#if FP16_CONSTEXPR_BIT_CAST
+	return FP16_CONSTEXPR_BIT_CAST_IMPL(double, w);
+#else
+	const uint32_t exponent = (uint32_t) (w >> 52) & UINT32_C(0x7FF);
+	const uint64_t mantissa = w & UINT64_C(0x000FFFFFFFFFFFFF);
+	double magnitude = 0.0;
+	if (exponent == 0x7FF) {
+		magnitude = mantissa != 0 ? std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::infinity();
+	} else if (exponent == 0) {
+		magnitude = (double) mantissa * fp16_constexpr_exp2(-1000) * fp16_constexpr_exp2(-74);
+	} else {
+		magnitude = (double) (mantissa | UINT64_C(0x0010000000000000)) * fp16_constexpr_exp2((int) exponent - 1075);
+	}
+	return (w & UINT64_C(0x8000000000000000)) ? -magnitude : magnitude;
+#endif
+}
+
+static inline constexpr uint64_t fp64v_to_fp64b_constexpr(double f) {
+#if FP16_CONSTEXPR_BIT_CAST
+	return FP16_CONSTEXPR_BIT_CAST_IMPL(uint64_t, f);
+#else
+	if (f != f) {
+		return UINT64_C(0x7FF8000000000000);
+	}
+	const uint64_t sign = f < 0.0 ? UINT64_C(0x8000000000000000) : 0;
+	const double magnitude = f < 0.0 ? -f : f;
+	if (magnitude > std::numeric_limits<double>::max()) {
+		return sign | UINT64_C(0x7FF0000000000000);
+	}
+	if (magnitude < fp16_constexpr_exp2(-1022)) {
+		return sign | (uint64_t) (magnitude * fp16_constexpr_exp2(1000) * fp16_constexpr_exp2(74));
+	}
+	const int exponent = fp16_constexpr_ilogb(magnitude, -1022, 1023);
+	/* Scale in two steps: 2**(52 - exponent) overflows for exponents below -971 */
+	const int scale = 52 - exponent;
+	const uint64_t significand = (uint64_t) (magnitude * fp16_constexpr_exp2(scale / 2) * fp16_constexpr_exp2(scale - scale / 2));
+	return sign | ((uint64_t) (exponent + 1023) << 52) | (significand & UINT64_C(0x000FFFFFFFFFFFFF));
+#endif
+}
+
+/*
+ * Decode the magnitude of a half-precision number in bit representation to single-precision bits. Exponent 31
+ * encodes infinities and NaN (keeping the payload) in IEEE format and the numbers from 65536 in the alternative format.
+ */
+static inline constexpr uint32_t fp16_constexpr_decode_nonsign(uint32_t nonsign, bool ieee) {
+	if (nonsign == 0) {
+		return 0;
+	}
+	if (ieee && nonsign >= UINT32_C(0x7C00)) {
+		return UINT32_C(0x7F800000) | ((nonsign & UINT32_C(0x03FF)) << 13);
+	}
+	if (nonsign < UINT32_C(0x0400)) {
+		/* Denormalized number: shift the leading 1 into the implicit position, decrementing the exponent of 2**-14 */
+		uint32_t exponent = 113;
+		uint32_t mantissa = nonsign;
+		while (mantissa < UINT32_C(0x0400)) {
+			mantissa <<= 1;
+			exponent -= 1;
+		}
+		return (exponent << 23) | ((mantissa & UINT32_C(0x03FF)) << 13);
+	}
+	/* Normalized number: rebias the exponent by 127 - 15 = 112 */
+	return (nonsign << 13) + (UINT32_C(112) << 23);
+}
+
+/*
+ * Round the magnitude of a finite single-precision number in bit representation to nearest-even in half-precision.
+ * The result must not overflow: the callers handle numbers from 65520 (IEEE format) or above 131008 (alternative format).
+ */
+static inline constexpr uint32_t fp16_constexpr_round_nonsign(uint32_t nonsign) {
+	if (nonsign >= UINT32_C(0x38800000)) {
+		/* Normalized result: round off the low 13 mantissa bits, carrying into the exponent, and rebias by 112 */
+		const uint32_t rounded = nonsign + UINT32_C(0x0FFF) + ((nonsign >> 13) & UINT32_C(1));
+		return (rounded >> 13) - (UINT32_C(112) << 10);
+	}
+	/* Denormalized result: shift the significand down to units of 2**-24; shifts beyond 25 bits round to zero */
+	const uint32_t exponent = nonsign >> 23;
+	const uint32_t significand = exponent != 0 ? (nonsign & UINT32_C(0x007FFFFF)) | UINT32_C(0x00800000) : nonsign;
+	uint32_t shift = 126 - (exponent != 0 ? exponent : 1);
+	if (shift > 25) {
+		shift = 25;
+	}
+	return (significand + ((UINT32_C(1) << (shift - 1)) - 1) + ((significand >> shift) & UINT32_C(1))) >> shift;
+}
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format, in bit representation, to
+ * a 32-bit floating-point number in IEEE single-precision format, in bit representation.
+ */
+static inline constexpr uint32_t fp16_ieee_to_fp32_bits_constexpr(uint16_t h) {
+	return ((uint32_t) (h & UINT16_C(0x8000)) << 16) | fp16_constexpr_decode_nonsign(h & UINT16_C(0x7FFF), true);
+}
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format, in bit representation, to
+ * a 32-bit floating-point number in IEEE single-precision format.
+ */
+static inline constexpr float fp16_ieee_to_fp32_value_constexpr(uint16_t h) {
+	return fp32b_to_fp32v_constexpr(fp16_ieee_to_fp32_bits_constexpr(h));
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * IEEE half-precision format, in bit representation.
+ */
+static inline constexpr uint16_t fp32_ieee_to_fp16_value_constexpr(float f) {
+	const uint32_t w = fp32v_to_fp32b_constexpr(f);
+	const uint32_t sign = (w >> 16) & UINT32_C(0x8000);
+	const uint32_t nonsign = w & UINT32_C(0x7FFFFFFF);
+	if (nonsign > UINT32_C(0x7F800000)) {
+		return (uint16_t) (sign | UINT32_C(0x7E00));
+	}
+	/* Numbers from 65520, halfway between 65504 and 65536, overflow to infinity */
+	if (nonsign >= UINT32_C(0x477FF000)) {
+		return (uint16_t) (sign | UINT32_C(0x7C00));
+	}
+	return (uint16_t) (sign | fp16_constexpr_round_nonsign(nonsign));
+}
+
+/*
+ * Convert a 16-bit floating-point number in ARM alternative half-precision format, in bit representation, to
+ * a 32-bit floating-point number in IEEE single-precision format, in bit representation.
+ */
+static inline constexpr uint32_t fp16_alt_to_fp32_bits_constexpr(uint16_t h) {
+	return ((uint32_t) (h & UINT16_C(0x8000)) << 16) | fp16_constexpr_decode_nonsign(h & UINT16_C(0x7FFF), false);
+}
+
+/*
+ * Convert a 16-bit floating-point number in ARM alternative half-precision format, in bit representation, to
+ * a 32-bit floating-point number in IEEE single-precision format.
+ */
+static inline constexpr float fp16_alt_to_fp32_value_constexpr(uint16_t h) {
+	return fp32b_to_fp32v_constexpr(fp16_alt_to_fp32_bits_constexpr(h));
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * ARM alternative half-precision format, in bit representation.
+ */
+static inline constexpr uint16_t fp32_alt_to_fp16_value_constexpr(float f) {
+	const uint32_t w = fp32v_to_fp32b_constexpr(f);
+	const uint32_t sign = (w >> 16) & UINT32_C(0x8000);
+	const uint32_t nonsign = w & UINT32_C(0x7FFFFFFF);
+	/* Numbers above 131008, infinities, and NaN saturate to the largest number */
+	if (nonsign > UINT32_C(0x47FFE000)) {
+		return (uint16_t) (sign | UINT32_C(0x7FFF));
+	}
+	return (uint16_t) (sign | fp16_constexpr_round_nonsign(nonsign));
+}
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format, in bit representation, to
+ * a 64-bit floating-point number in IEEE double-precision format, in bit representation.
+ */
+static inline constexpr uint64_t fp16_ieee_to_fp64_bits_constexpr(uint16_t h) {
+	const uint32_t f = fp16_constexpr_decode_nonsign(h & UINT16_C(0x7FFF), true);
+	const uint32_t exponent = f >> 23;
+	const uint64_t sign = (uint64_t) (h & UINT16_C(0x8000)) << 48;
+	const uint64_t mantissa = (uint64_t) (f & UINT32_C(0x007FFFFF)) << 29;
+	if (exponent == 0) {
+		return sign;
+	}
+	/* Rebias the exponent by 1023 - 127 = 896; infinities and NaN keep the all-ones exponent */
+	return sign | ((uint64_t) (exponent == 0xFF ? 0x7FF : exponent + 896) << 52) | mantissa;
+}
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format, in bit representation, to
+ * a 64-bit floating-point number in IEEE double-precision format.
+ */
+static inline constexpr double fp16_ieee_to_fp64_value_constexpr(uint16_t h) {
+	return fp64b_to_fp64v_constexpr(fp16_ieee_to_fp64_bits_constexpr(h));
+}
+
+/*
+ * Convert a 64-bit floating-point number in IEEE double-precision format to a 16-bit floating-point number in
+ * IEEE half-precision format, in bit representation, rounding to nearest-even once.
+ */
+static inline constexpr uint16_t fp64_ieee_to_fp16_value_constexpr(double d) {
+	const uint64_t w = fp64v_to_fp64b_constexpr(d);
+	const uint32_t sign = (uint32_t) (w >> 48) & UINT32_C(0x8000);
+	const uint64_t nonsign = w & UINT64_C(0x7FFFFFFFFFFFFFFF);
+	if (nonsign > UINT64_C(0x7FF0000000000000)) {
+		return (uint16_t) (sign | UINT32_C(0x7E00));
+	}
+	if (nonsign >= UINT64_C(0x40EFFE0000000000)) {
+		return (uint16_t) (sign | UINT32_C(0x7C00));
+	}
+	if (nonsign >= UINT64_C(1009) << 52) {
+		const uint64_t rounded = nonsign + UINT64_C(0x000001FFFFFFFFFF) + ((nonsign >> 42) & UINT64_C(1));
+		return (uint16_t) (sign | (uint32_t) ((rounded >> 42) - (UINT64_C(1008) << 10)));
+	}
+	const uint32_t exponent = (uint32_t) (nonsign >> 52);
+	const uint64_t significand = exponent != 0 ?
+		(nonsign & UINT64_C(0x000FFFFFFFFFFFFF)) | UINT64_C(0x0010000000000000) : nonsign;
+	uint32_t shift = 1051 - (exponent != 0 ? exponent : 1);
+	if (shift > 54) {
+		shift = 54;
+	}
+	const uint64_t rounded = significand + ((UINT64_C(1) << (shift - 1)) - 1) + ((significand >> shift) & UINT64_C(1));
+	return (uint16_t) (sign | (uint32_t) (rounded >> shift));
+}
+
+#endif /* FP16_CONSTEXPR_H */
@@ -0,0 +1,527 @@
+#pragma once
+#ifndef FP16_EXPR_H
+#define FP16_EXPR_H
+
+#ifndef __cplusplus
+	#error "fp16/expr.h requires a C++11 compiler"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <type_traits>
+
+#include "fp16.h"
+#include "simd.h"
+
+/*
+ * Lazy elementwise expressions over half-precision and single-precision arrays, evaluated in a single pass.
+ *
+ * fp16::fp16_array(p, n) and fp16::fp32_array(p, n) are views of n IEEE half-precision or single-precision numbers.
+ * Arithmetic on views and float scalars does not compute anything; it builds an expression that is evaluated when
+ * assigned to a view:
+ *
+ *   fp16::fp16_array(y, n) = a * fp16::fp16_array(x, n) + b;
+ *
+ * decodes a vector of x, multiplies and adds in single-precision registers, and encodes the result to y, one vector
+ * at a time, where the unfused form (fp16_ieee_to_fp32_array, a loop, fp32_ieee_to_fp16_array) makes three passes and
+ * writes and reads back two single-precision temporaries. Intermediate results stay in single-precision, so the
+ * result is rounded to half-precision once.
+ *
+ * Expressions support +, -, *, / and unary -, and the elementwise functions min, max, abs, sqrt, fma and map. map
+ * applies a user function from fp16::packet to fp16::packet, which may use the packet operators and functions above or
+ * the native vector in packet::v, for operations this header does not provide.
+ *
+ * Vectors are fp16::packet: 16 lanes of __m512 with FP16_SIMD_AVX512, 8 lanes of __m256 with FP16_SIMD_AVX2, and a
+ * single float otherwise, with the loads, stores and masked tails of the array.h kernels. Results are the same on
+ * all paths, except for NaN payloads (kept by F16C, as in array.h) and that fma rounds once only with hardware FMA.
+ *
+ * The number of elements evaluated is the size of the destination view; source views must have at least as many.
+ * The destination may be one of the source arrays (y = 2 * y), but must not partially overlap a source.
+ */
+namespace fp16 {
+
+struct packet {
+#if FP16_SIMD_AVX512
+	typedef __m512 native;
+	static const size_t width = 16;
+#elif FP16_SIMD_AVX2
+	typedef __m256 native;
+	static const size_t width = 8;
+#else
+	typedef float native;
+	static const size_t width = 1;
+#endif
+
+	native v;
+
+	static packet broadcast(float value) {
+#if FP16_SIMD_AVX512
+		const packet result = { _mm512_set1_ps(value) };
+#elif FP16_SIMD_AVX2
+		const packet result = { _mm256_set1_ps(value) };
+#else
+		const packet result = { value };
+#endif
+		return result;
+	}
+};
+
+static inline packet make_packet(packet::native v) {
+	const packet result = { v };
+	return result;
+}
+
+#if FP16_SIMD_AVX512
+static inline packet operator+(packet a, packet b) { return make_packet(_mm512_add_ps(a.v, b.v)); }
+static inline packet operator-(packet a, packet b) { return make_packet(_mm512_sub_ps(a.v, b.v)); }
+static inline packet operator*(packet a, packet b) { return make_packet(_mm512_mul_ps(a.v, b.v)); }
+static inline packet operator/(packet a, packet b) { return make_packet(_mm512_div_ps(a.v, b.v)); }
+static inline packet operator-(packet a) {
+	return make_packet(_mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(INT32_MIN))));
+}
+static inline packet min(packet a, packet b) { return make_packet(_mm512_min_ps(a.v, b.v)); }
+static inline packet max(packet a, packet b) { return make_packet(_mm512_max_ps(a.v, b.v)); }
+static inline packet abs(packet a) {
+	return make_packet(_mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(INT32_MAX))));
+}
+static inline packet sqrt(packet a) { return make_packet(_mm512_sqrt_ps(a.v)); }
+static inline packet fma(packet a, packet b, packet c) { return make_packet(_mm512_fmadd_ps(a.v, b.v, c.v)); }
+#elif FP16_SIMD_AVX2
+static inline packet operator+(packet a, packet b) { return make_packet(_mm256_add_ps(a.v, b.v)); }
+static inline packet operator-(packet a, packet b) { return make_packet(_mm256_sub_ps(a.v, b.v)); }
+static inline packet operator*(packet a, packet b) { return make_packet(_mm256_mul_ps(a.v, b.v)); }
+static inline packet operator/(packet a, packet b) { return make_packet(_mm256_div_ps(a.v, b.v)); }
+static inline packet operator-(packet a) { return make_packet(_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f))); }
+static inline packet min(packet a, packet b) { return make_packet(_mm256_min_ps(a.v, b.v)); }
+static inline packet max(packet a, packet b) { return make_packet(_mm256_max_ps(a.v, b.v)); }
+static inline packet abs(packet a) { return make_packet(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)); }
+static inline packet sqrt(packet a) { return make_packet(_mm256_sqrt_ps(a.v)); }
+static inline packet fma(packet a, packet b, packet c) {
+	#if defined(__FMA__)
+		return make_packet(_mm256_fmadd_ps(a.v, b.v, c.v));
+	#else
+		return make_packet(_mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v));
+	#endif
+}
+#else
+static inline packet operator+(packet a, packet b) { return make_packet(a.v + b.v); }
+static inline packet operator-(packet a, packet b) { return make_packet(a.v - b.v); }
+static inline packet operator*(packet a, packet b) { return make_packet(a.v * b.v); }
+static inline packet operator/(packet a, packet b) { return make_packet(a.v / b.v); }
+static inline packet operator-(packet a) { return make_packet(-a.v); }
+/* Same results as minps/maxps: the second operand if either is NaN */
+static inline packet min(packet a, packet b) { return make_packet(a.v < b.v ? a.v : b.v); }
+static inline packet max(packet a, packet b) { return make_packet(a.v > b.v ? a.v : b.v); }
+static inline packet abs(packet a) { return make_packet(fabsf(a.v)); }
+static inline packet sqrt(packet a) { return make_packet(sqrtf(a.v)); }
+static inline packet fma(packet a, packet b, packet c) {
+	#if defined(FP_FAST_FMAF)
+		return make_packet(fmaf(a.v, b.v, c.v));
+	#else
+		return make_packet(a.v * b.v + c.v);
+	#endif
+}
+#endif
+
+/*
+ * Base of all expressions. Derived classes provide
+ *   packet load(size_t i) const                      elements [i, i + packet::width)
+ *   packet load_partial(size_t i, size_t n) const    elements [i, i + n) for n < packet::width, other lanes unspecified
+ */
+template <typename Derived>
+struct expression {
+	const Derived& self() const {
+		return static_cast<const Derived&>(*this);
+	}
+};
+
+template <typename T>
+struct is_expression : std::is_base_of<expression<T>, T> {};
+
+class scalar_expression : public expression<scalar_expression> {
+public:
+	explicit scalar_expression(float value) : value(packet::broadcast(value)) {}
+
+	packet load(size_t) const {
+		return value;
+	}
+
+	packet load_partial(size_t, size_t) const {
+		return value;
+	}
+
+private:
+	packet value;
+};
+
+/*
+ * Operands are stored by value: views and scalars are small, and expressions are built from temporaries.
+ */
+template <typename Op, typename E>
+class unary_expression : public expression<unary_expression<Op, E>> {
+public:
+	unary_expression(const E& operand, Op op) : operand(operand), op(op) {}
+
+	packet load(size_t i) const {
+		return op(operand.load(i));
+	}
+
+	packet load_partial(size_t i, size_t n) const {
+		return op(operand.load_partial(i, n));
+	}
+
+private:
+	E operand;
+	Op op;
+};
+
+template <typename Op, typename L, typename R>
+class binary_expression : public expression<binary_expression<Op, L, R>> {
+public:
+	binary_expression(const L& left, const R& right) : left(left), right(right) {}
+
+	packet load(size_t i) const {
+		return Op::apply(left.load(i), right.load(i));
+	}
+
+	packet load_partial(size_t i, size_t n) const {
+		return Op::apply(left.load_partial(i, n), right.load_partial(i, n));
+	}
+
+private:
+	L left;
+	R right;
+};
+
+template <typename A, typename B, typename C>
+class fma_expression : public expression<fma_expression<A, B, C>> {
+public:
+	fma_expression(const A& a, const B& b, const C& c) : a(a), b(b), c(c) {}
+
+	packet load(size_t i) const {
+		return fma(a.load(i), b.load(i), c.load(i));
+	}
+
+	packet load_partial(size_t i, size_t n) const {
+		return fma(a.load_partial(i, n), b.load_partial(i, n), c.load_partial(i, n));
+	}
+
+private:
+	A a;
+	B b;
+	C c;
+};
+
+struct add_op { static packet apply(packet a, packet b) { return a + b; } };
+struct sub_op { static packet apply(packet a, packet b) { return a - b; } };
+struct mul_op { static packet apply(packet a, packet b) { return a * b; } };
+struct div_op { static packet apply(packet a, packet b) { return a / b; } };
+struct min_op { static packet apply(packet a, packet b) { return min(a, b); } };
+struct max_op { static packet apply(packet a, packet b) { return max(a, b); } };
+struct neg_op { packet operator()(packet a) const { return -a; } };
+struct abs_op { packet operator()(packet a) const { return abs(a); } };
+struct sqrt_op { packet operator()(packet a) const { return sqrt(a); } };
+
+/*
+ * Operands of the expression operators and functions: expressions are kept, numbers (including fp16::half) are
+ * converted to float and broadcast.
+ */
+template <typename T, typename Enable = void>
+struct operand_traits {};
+
+template <typename T>
+struct operand_traits<T, typename std::enable_if<is_expression<T>::value>::type> {
+	typedef T type;
+	static const T& wrap(const T& e) { return e; }
+};
+
+template <typename T>
+struct operand_traits<T, typename std::enable_if<!is_expression<T>::value && std::is_convertible<T, float>::value>::type> {
+	typedef scalar_expression type;
+	static scalar_expression wrap(const T& value) { return scalar_expression((float) value); }
+};
+
+/* At least one operand must be an expression, so that arithmetic on numbers is left alone */
+template <typename L, typename R, typename Op, bool = is_expression<L>::value || is_expression<R>::value>
+struct binary_result_if {};
+
+template <typename L, typename R, typename Op>
+struct binary_result_if<L, R, Op, true> {
+	typedef binary_expression<Op, typename operand_traits<L>::type, typename operand_traits<R>::type> type;
+};
+
+template <typename Op, typename L, typename R>
+static inline typename binary_result_if<L, R, Op>::type make_binary(const L& left, const R& right) {
+	return typename binary_result_if<L, R, Op>::type(operand_traits<L>::wrap(left), operand_traits<R>::wrap(right));
+}
+
+template <typename L, typename R>
+static inline typename binary_result_if<L, R, add_op>::type operator+(const L& left, const R& right) {
+	return make_binary<add_op>(left, right);
+}
+
+template <typename L, typename R>
+static inline typename binary_result_if<L, R, sub_op>::type operator-(const L& left, const R& right) {
+	return make_binary<sub_op>(left, right);
+}
+
+template <typename L, typename R>
+static inline typename binary_result_if<L, R, mul_op>::type operator*(const L& left, const R& right) {
+	return make_binary<mul_op>(left, right);
+}
+
+template <typename L, typename R>
+static inline typename binary_result_if<L, R, div_op>::type operator/(const L& left, const R& right) {
+	return make_binary<div_op>(left, right);
+}
+
+template <typename L, typename R>
+static inline typename binary_result_if<L, R, min_op>::type min(const L& left, const R& right) {
+	return make_binary<min_op>(left, right);
+}
+
+template <typename L, typename R>
+static inline typename binary_result_if<L, R, max_op>::type max(const L& left, const R& right) {
+	return make_binary<max_op>(left, right);
+}
+
+template <typename E>
+static inline unary_expression<neg_op, E> operator-(const expression<E>& operand) {
+	return unary_expression<neg_op, E>(operand.self(), neg_op());
+}
+
+template <typename E>
+static inline unary_expression<abs_op, E> abs(const expression<E>& operand) {
+	return unary_expression<abs_op, E>(operand.self(), abs_op());
+}
+
+template <typename E>
+static inline unary_expression<sqrt_op, E> sqrt(const expression<E>& operand) {
+	return unary_expression<sqrt_op, E>(operand.self(), sqrt_op());
+}
+
+/*
+ * a * b + c, rounded once where the target has FMA instructions (AVX-512, or AVX2 with -mfma).
+ */
+template <typename A, typename B, typename C>
+static inline typename std::enable_if<is_expression<A>::value || is_expression<B>::value || is_expression<C>::value,
+	fma_expression<typename operand_traits<A>::type, typename operand_traits<B>::type, typename operand_traits<C>::type>>::type
+	fma(const A& a, const B& b, const C& c)
+{
+	return fma_expression<typename operand_traits<A>::type, typename operand_traits<B>::type, typename operand_traits<C>::type>(
+		operand_traits<A>::wrap(a), operand_traits<B>::wrap(b), operand_traits<C>::wrap(c));
+}
+
+/*
+ * Apply f, a function object from packet to packet, to every element of an expression.
+ */
+template <typename E, typename F>
+static inline unary_expression<F, E> map(const expression<E>& operand, F f) {
+	return unary_expression<F, E>(operand.self(), f);
+}
+
+/*
+ * Evaluate an expression into a destination with store(i, packet) and store_partial(i, packet, n).
+ */
+template <typename Destination, typename E>
+static inline void evaluate(const Destination& destination, const E& e, size_t n) {
+	size_t i = 0;
+	for (; i + packet::width <= n; i += packet::width) {
+		destination.store(i, e.load(i));
+	}
+	if (i != n) {
+		destination.store_partial(i, e.load_partial(i, n - i), n - i);
+	}
+}
+
+/*
+ * View of n IEEE half-precision numbers. T is float16 or const float16; only views of float16 may be assigned to.
+ */
+template <typename T>
+class fp16_array_view : public expression<fp16_array_view<T>> {
+public:
+	fp16_array_view(T* data, size_t size) : data_(data), size_(size) {}
+	fp16_array_view(const fp16_array_view&) = default;
+
+	T* data() const { return data_; }
+	size_t size() const { return size_; }
+
+	packet load(size_t i) const {
+#if FP16_SIMD_AVX512
+		return make_packet(_mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (data_ + i))));
+#elif FP16_SIMD_AVX2
+		return make_packet(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (data_ + i))));
+#else
+		return make_packet(fp16_ieee_to_fp32_value(data_[i]));
+#endif
+	}
+
+	packet load_partial(size_t i, size_t n) const {
+#if FP16_SIMD_AVX512
+		return make_packet(_mm512_cvtph_ps(_mm256_maskz_loadu_epi16(fp16_simd_avx512_mask16(n), data_ + i)));
+#elif FP16_SIMD_AVX2
+		return make_packet(_mm256_cvtph_ps(fp16_simd_avx2_load_u16x8_partial(data_ + i, n)));
+#else
+		(void) n;
+		return load(i);
+#endif
+	}
+
+	void store(size_t i, packet p) const {
+#if FP16_SIMD_AVX512
+		_mm256_storeu_si256((__m256i*) (data_ + i), _mm512_cvtps_ph(p.v, _MM_FROUND_TO_NEAREST_INT));
+#elif FP16_SIMD_AVX2
+		_mm_storeu_si128((__m128i*) (data_ + i), _mm256_cvtps_ph(p.v, _MM_FROUND_TO_NEAREST_INT));
+#else
+		data_[i] = fp32_ieee_to_fp16_value(p.v);
+#endif
+	}
+
+	void store_partial(size_t i, packet p, size_t n) const {
+#if FP16_SIMD_AVX512
+		_mm256_mask_storeu_epi16(data_ + i, fp16_simd_avx512_mask16(n), _mm512_cvtps_ph(p.v, _MM_FROUND_TO_NEAREST_INT));
+#elif FP16_SIMD_AVX2
+		fp16_simd_avx2_store_u16x8_partial(data_ + i, _mm256_cvtps_ph(p.v, _MM_FROUND_TO_NEAREST_INT), n);
+#else
+		(void) n;
+		store(i, p);
+#endif
+	}
+
+	/* Assignment evaluates the expression into the viewed array; it does not rebind the view */
+	fp16_array_view& operator=(const fp16_array_view& other) {
+		return assign(other);
+	}
+
+	template <typename E>
+	fp16_array_view& operator=(const expression<E>& e) {
+		return assign(e.self());
+	}
+
+	fp16_array_view& operator=(float value) {
+		return assign(scalar_expression(value));
+	}
+
+	template <typename R> fp16_array_view& operator+=(const R& other) { return assign(*this + other); }
+	template <typename R> fp16_array_view& operator-=(const R& other) { return assign(*this - other); }
+	template <typename R> fp16_array_view& operator*=(const R& other) { return assign(*this * other); }
+	template <typename R> fp16_array_view& operator/=(const R& other) { return assign(*this / other); }
+
+private:
+	template <typename E>
+	fp16_array_view& assign(const E& e) {
+		static_assert(!std::is_const<T>::value, "cannot assign to a view of const float16");
+		evaluate(*this, e, size_);
+		return *this;
+	}
+
+	T* data_;
+	size_t size_;
+};
+
+/*
+ * View of n IEEE single-precision numbers. T is float or const float; only views of float may be assigned to.
+ */
+template <typename T>
+class fp32_array_view : public expression<fp32_array_view<T>> {
+public:
+	fp32_array_view(T* data, size_t size) : data_(data), size_(size) {}
+	fp32_array_view(const fp32_array_view&) = default;
+
+	T* data() const { return data_; }
+	size_t size() const { return size_; }
+
+	packet load(size_t i) const {
+#if FP16_SIMD_AVX512
+		return make_packet(_mm512_loadu_ps(data_ + i));
+#elif FP16_SIMD_AVX2
+		return make_packet(_mm256_loadu_ps(data_ + i));
+#else
+		return make_packet(data_[i]);
+#endif
+	}
+
+	packet load_partial(size_t i, size_t n) const {
+#if FP16_SIMD_AVX512
+		return make_packet(_mm512_maskz_loadu_ps(fp16_simd_avx512_mask16(n), data_ + i));
+#elif FP16_SIMD_AVX2
+		return make_packet(_mm256_maskload_ps(data_ + i, fp16_simd_avx2_mask_u32x8(n)));
+#else
+		(void) n;
+		return load(i);
+#endif
+	}
+
+	void store(size_t i, packet p) const {
+#if FP16_SIMD_AVX512
+		_mm512_storeu_ps(data_ + i, p.v);
+#elif FP16_SIMD_AVX2
+		_mm256_storeu_ps(data_ + i, p.v);
+#else
+		data_[i] = p.v;
+#endif
+	}
+
+	void store_partial(size_t i, packet p, size_t n) const {
+#if FP16_SIMD_AVX512
+		_mm512_mask_storeu_ps(data_ + i, fp16_simd_avx512_mask16(n), p.v);
+#elif FP16_SIMD_AVX2
+		_mm256_maskstore_ps(data_ + i, fp16_simd_avx2_mask_u32x8(n), p.v);
+#else
+		(void) n;
+		store(i, p);
+#endif
+	}
+
+	/* Assignment evaluates the expression into the viewed array; it does not rebind the view */
+	fp32_array_view& operator=(const fp32_array_view& other) {
+		return assign(other);
+	}
+
+	template <typename E>
+	fp32_array_view& operator=(const expression<E>& e) {
+		return assign(e.self());
+	}
+
+	fp32_array_view& operator=(float value) {
+		return assign(scalar_expression(value));
+	}
+
+	template <typename R> fp32_array_view& operator+=(const R& other) { return assign(*this + other); }
+	template <typename R> fp32_array_view& operator-=(const R& other) { return assign(*this - other); }
+	template <typename R> fp32_array_view& operator*=(const R& other) { return assign(*this * other); }
+	template <typename R> fp32_array_view& operator/=(const R& other) { return assign(*this / other); }
+
+private:
+	template <typename E>
+	fp32_array_view& assign(const E& e) {
+		static_assert(!std::is_const<T>::value, "cannot assign to a view of const float");
+		evaluate(*this, e, size_);
+		return *this;
+	}
+
+	T* data_;
+	size_t size_;
+};
+
+static inline fp16_array_view<float16> fp16_array(float16* data, size_t size) {
+	return fp16_array_view<float16>(data, size);
+}
+
+static inline fp16_array_view<const float16> fp16_array(const float16* data, size_t size) {
+	return fp16_array_view<const float16>(data, size);
+}
+
+static inline fp32_array_view<float> fp32_array(float* data, size_t size) {
+	return fp32_array_view<float>(data, size);
+}
+
+static inline fp32_array_view<const float> fp32_array(const float* data, size_t size) {
+	return fp32_array_view<const float>(data, size);
+}
+
+} /* namespace fp16 */
+
+#endif /* FP16_EXPR_H */
@@ -0,0 +1,645 @@
+#pragma once
+#ifndef FP16_FILE_H
+#define FP16_FILE_H
+
+#ifndef __cplusplus
+	#error "fp16/file.h requires a C++11 compiler"
+#endif
+#if defined(_WIN32)
+	#error "fp16/file.h requires POSIX file I/O"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "fp16.h"
+#include "arena.h"
+#include "strided.h"
+
+/* Raw io_uring system calls need only the kernel UAPI header; FP16_USE_IO_URING=0 leaves them out */
+#ifndef FP16_USE_IO_URING
+	#if defined(__linux__) && defined(__has_include)
+		#if __has_include(<linux/io_uring.h>)
+			#define FP16_USE_IO_URING 1
+		#endif
+	#endif
+#endif
+#ifndef FP16_USE_IO_URING
+	#define FP16_USE_IO_URING 0
+#endif
+
+#if FP16_USE_IO_URING
+	#include <linux/io_uring.h>
+	#include <sys/mman.h>
+	#include <sys/syscall.h>
+#endif
+
+/* Block size that O_DIRECT transfers are aligned to */
+#define FP16_FILE_BLOCK_SIZE 4096
+
+/*
+ * Conversion of whole files of numbers (e.g. fp32 to fp16 and back) with reads, conversion and writes overlapped:
+ *
+ *   fp16::file_conversion_options options;
+ *   options.buffers = 3;
+ *   fp16::file_conversion_stats stats =
+ *     fp16::convert_file(FP16_CONVERSION_FP32_TO_IEEE, "weights.f32", "weights.f16", options);
+ *
+ * The input is cut into chunks of options.chunk_elements numbers, and options.buffers slots (2 for double buffering,
+ * 3 for triple buffering) each hold the input and the output of one chunk. While one chunk is converted, the next
+ * chunks are read and the previous ones are written, so a conversion of a large file takes about as long as its
+ * slowest stage rather than the sum of the three. Two I/O back ends are available:
+ *   fp16::file_io::io_uring - one thread submits the reads and writes of all slots to an io_uring (Linux 5.6 and
+ *                             later) and converts each chunk as soon as its read completes.
+ *   fp16::file_io::threads  - a reader thread and a writer thread run pread and pwrite, and the calling thread
+ *                             converts.
+ * fp16::file_io::automatic picks io_uring when the kernel provides it, and threads otherwise.
+ *
+ * With options.direct, convert_file opens both files with O_DIRECT, so that the data bypasses the page cache; file
+ * systems without O_DIRECT (e.g. tmpfs) fall back to buffered I/O. Slot buffers are page-aligned and chunks are a
+ * multiple of 4096 numbers, so every read and write is block-aligned; the last chunk is written in whole blocks and
+ * the output file is truncated to its size afterwards. The descriptor overload of convert_file takes O_DIRECT from the
+ * descriptors' flags.
+ *
+ * Inputs and outputs must be regular files, and the input size must be a multiple of the input number size. Errors are
+ * thrown as std::system_error with the errno of the failed call, or std::invalid_argument for a misaligned input size.
+ */
+namespace fp16 {
+
+enum class file_io {
+	automatic,
+	threads,
+	io_uring,
+};
+
+struct file_conversion_options {
+	/* Numbers per chunk: 4 MiB of single-precision and 2 MiB of half-precision numbers */
+	static const size_t default_chunk_elements = 1048576;
+
+	file_conversion_options() :
+		chunk_elements(default_chunk_elements),
+		buffers(3),
+		direct(false),
+		io(file_io::automatic)
+	{
+	}
+
+	size_t chunk_elements;
+	size_t buffers;
+	bool direct;
+	file_io io;
+};
+
+struct file_conversion_stats {
+	uint64_t elements;
+	uint64_t bytes_read;
+	uint64_t bytes_written;
+	/* The back end that ran the conversion: threads or io_uring */
+	file_io io;
+	/* Whether the input or the output used O_DIRECT */
+	bool direct;
+};
+
+static inline std::system_error file_error(const char* operation) {
+	return std::system_error(errno, std::generic_category(), std::string("fp16::convert_file: ") + operation);
+}
+
+/* Descriptor that closes itself */
+class file_descriptor {
+public:
+	explicit file_descriptor(int fd) : fd_(fd) {}
+
+	file_descriptor(const file_descriptor&) = delete;
+	file_descriptor& operator=(const file_descriptor&) = delete;
+
+	~file_descriptor() {
+		if (fd_ >= 0) {
+			close(fd_);
+		}
+	}
+
+	int get() const {
+		return fd_;
+	}
+
+private:
+	int fd_;
+};
+
+/* Geometry of a conversion and the page-aligned slot buffers */
+class file_conversion_plan {
+public:
+	file_conversion_plan(fp16_conversion_kind kind, uint64_t elements, size_t chunk_elements, size_t buffers,
+		bool direct_input, bool direct_output) :
+		kind(kind),
+		elements(elements),
+		chunk_elements((std::max<size_t>(chunk_elements, 1) + FP16_FILE_BLOCK_SIZE - 1) / FP16_FILE_BLOCK_SIZE * FP16_FILE_BLOCK_SIZE),
+		chunks((elements + this->chunk_elements - 1) / this->chunk_elements),
+		slots(std::max<size_t>(std::min<uint64_t>(buffers, chunks), 1)),
+		input_size(fp16_conversion_input_size(kind)),
+		output_size(fp16_conversion_output_size(kind)),
+		direct_input(direct_input),
+		direct_output(direct_output),
+		memory_size(slots * this->chunk_elements * (input_size + output_size))
+	{
+		memory = static_cast<unsigned char*>(fp16_pages_allocate(memory_size, 0));
+		if (memory == NULL) {
+			throw std::bad_alloc();
+		}
+	}
+
+	file_conversion_plan(const file_conversion_plan&) = delete;
+	file_conversion_plan& operator=(const file_conversion_plan&) = delete;
+
+	~file_conversion_plan() {
+		fp16_pages_free(memory, memory_size, 0);
+	}
+
+	size_t chunk_count(uint64_t chunk) const {
+		const uint64_t first = chunk * chunk_elements;
+		return (size_t) std::min<uint64_t>(chunk_elements, elements - first);
+	}
+
+	unsigned char* input(size_t slot) const {
+		return memory + slot * chunk_elements * input_size;
+	}
+
+	unsigned char* output(size_t slot) const {
+		return memory + slots * chunk_elements * input_size + slot * chunk_elements * output_size;
+	}
+
+	off_t input_offset(uint64_t chunk) const {
+		return (off_t) (chunk * chunk_elements * input_size);
+	}
+
+	off_t output_offset(uint64_t chunk) const {
+		return (off_t) (chunk * chunk_elements * output_size);
+	}
+
+	/* Bytes that a chunk must read and write */
+	size_t input_bytes(uint64_t chunk) const {
+		return chunk_count(chunk) * input_size;
+	}
+
+	size_t output_bytes(uint64_t chunk) const {
+		return chunk_count(chunk) * output_size;
+	}
+
+	/* Bytes that a transfer asks for: whole blocks with O_DIRECT */
+	size_t input_request(uint64_t chunk) const {
+		return direct_input ? round_to_block(input_bytes(chunk)) : input_bytes(chunk);
+	}
+
+	size_t output_request(uint64_t chunk) const {
+		return direct_output ? round_to_block(output_bytes(chunk)) : output_bytes(chunk);
+	}
+
+	void convert(size_t slot, uint64_t chunk) const {
+		fp16_convert_strided(kind, input(slot), 1, output(slot), 1, chunk_count(chunk));
+	}
+
+	const fp16_conversion_kind kind;
+	const uint64_t elements;
+	const size_t chunk_elements;
+	const uint64_t chunks;
+	const size_t slots;
+	const size_t input_size;
+	const size_t output_size;
+	const bool direct_input;
+	const bool direct_output;
+
+private:
+	static size_t round_to_block(size_t bytes) {
+		return (bytes + FP16_FILE_BLOCK_SIZE - 1) / FP16_FILE_BLOCK_SIZE * FP16_FILE_BLOCK_SIZE;
+	}
+
+	const size_t memory_size;
+	unsigned char* memory;
+};
+
+/*
+ * Threaded back end: the reader thread fills slots, the calling thread converts them and the writer thread drains
+ * them. Chunk c uses slot c % slots; the three counters of finished chunks order the stages.
+ */
+class file_threads_pipeline {
+public:
+	file_threads_pipeline(const file_conversion_plan& plan, int input_fd, int output_fd) :
+		plan_(plan), input_fd_(input_fd), output_fd_(output_fd), read_(0), converted_(0), written_(0), error_(0), failed_(nullptr)
+	{
+	}
+
+	void run() {
+		std::thread reader(&file_threads_pipeline::read_chunks, this);
+		std::thread writer(&file_threads_pipeline::write_chunks, this);
+		for (uint64_t chunk = 0; chunk < plan_.chunks; chunk++) {
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				changed_.wait(lock, [&]() { return read_ > chunk || error_ != 0; });
+				if (error_ != 0) {
+					break;
+				}
+			}
+			plan_.convert((size_t) (chunk % plan_.slots), chunk);
+			std::lock_guard<std::mutex> lock(mutex_);
+			converted_ = chunk + 1;
+			changed_.notify_all();
+		}
+		reader.join();
+		writer.join();
+		if (error_ != 0) {
+			errno = error_;
+			throw file_error(failed_);
+		}
+	}
+
+private:
+	void fail(int error, const char* operation) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (error_ == 0) {
+			error_ = error;
+			failed_ = operation;
+		}
+		changed_.notify_all();
+	}
+
+	void read_chunks() {
+		for (uint64_t chunk = 0; chunk < plan_.chunks; chunk++) {
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				changed_.wait(lock, [&]() { return chunk - written_ < plan_.slots || error_ != 0; });
+				if (error_ != 0) {
+					return;
+				}
+			}
+			unsigned char* buffer = plan_.input((size_t) (chunk % plan_.slots));
+			const size_t needed = plan_.input_bytes(chunk);
+			const size_t requested = plan_.input_request(chunk);
+			size_t done = 0;
+			while (done < needed) {
+				const ssize_t result = pread(input_fd_, buffer + done, requested - done, plan_.input_offset(chunk) + (off_t) done);
+				if (result < 0 && errno == EINTR) {
+					continue;
+				}
+				if (result <= 0) {
+					fail(result < 0 ? errno : EIO, "read");
+					return;
+				}
+				done += (size_t) result;
+			}
+			std::lock_guard<std::mutex> lock(mutex_);
+			read_ = chunk + 1;
+			changed_.notify_all();
+		}
+	}
+
+	void write_chunks() {
+		for (uint64_t chunk = 0; chunk < plan_.chunks; chunk++) {
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				changed_.wait(lock, [&]() { return converted_ > chunk || error_ != 0; });
+				if (error_ != 0) {
+					return;
+				}
+			}
+			const unsigned char* buffer = plan_.output((size_t) (chunk % plan_.slots));
+			const size_t requested = plan_.output_request(chunk);
+			size_t done = 0;
+			while (done < requested) {
+				const ssize_t result = pwrite(output_fd_, buffer + done, requested - done, plan_.output_offset(chunk) + (off_t) done);
+				if (result < 0 && errno == EINTR) {
+					continue;
+				}
+				if (result <= 0) {
+					fail(result < 0 ? errno : EIO, "write");
+					return;
+				}
+				done += (size_t) result;
+			}
+			std::lock_guard<std::mutex> lock(mutex_);
+			written_ = chunk + 1;
+			changed_.notify_all();
+		}
+	}
+
+	const file_conversion_plan& plan_;
+	const int input_fd_;
+	const int output_fd_;
+	std::mutex mutex_;
+	std::condition_variable changed_;
+	uint64_t read_;
+	uint64_t converted_;
+	uint64_t written_;
+	int error_;
+	const char* failed_;
+};
+
+#if FP16_USE_IO_URING && defined(IORING_FEAT_RW_CUR_POS)
+
+/*
+ * io_uring back end, on the raw system calls. Every slot has at most one read or write in flight; the user data of a
+ * request is the slot number times two, plus one for writes. Short transfers are resubmitted for the rest.
+ */
+class file_uring_pipeline {
+public:
+	file_uring_pipeline(const file_conversion_plan& plan, int input_fd, int output_fd) :
+		plan_(plan), input_fd_(input_fd), output_fd_(output_fd), ring_fd_(-1), ready_(false), unsubmitted_(0),
+		sq_ring_(MAP_FAILED), cq_ring_(MAP_FAILED), sqes_(MAP_FAILED), sq_ring_size_(0), cq_ring_size_(0), sqes_size_(0),
+		sq_tail_(nullptr), sq_mask_(0), sq_array_(nullptr), cq_head_(nullptr), cq_tail_(nullptr), cq_mask_(0), cqes_(nullptr),
+		slot_chunks_(plan.slots), slot_done_(plan.slots)
+	{
+		struct io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		const int fd = (int) syscall(__NR_io_uring_setup, (unsigned) (2 * plan.slots), &params);
+		if (fd < 0) {
+			return;
+		}
+		ring_fd_ = fd;
+		/* IORING_OP_READ and IORING_OP_WRITE arrived with IORING_FEAT_RW_CUR_POS in Linux 5.6 */
+		if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+			return;
+		}
+		sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+		sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+		sq_ring_ = mmap(NULL, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		cq_ring_ = mmap(NULL, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		sqes_ = mmap(NULL, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+		if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+			return;
+		}
+		unsigned char* sq = static_cast<unsigned char*>(sq_ring_);
+		sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+		sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+		sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+		unsigned char* cq = static_cast<unsigned char*>(cq_ring_);
+		cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+		cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+		cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+		cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+		ready_ = true;
+	}
+
+	file_uring_pipeline(const file_uring_pipeline&) = delete;
+	file_uring_pipeline& operator=(const file_uring_pipeline&) = delete;
+
+	~file_uring_pipeline() {
+		if (sqes_ != MAP_FAILED) {
+			munmap(sqes_, sqes_size_);
+		}
+		if (cq_ring_ != MAP_FAILED) {
+			munmap(cq_ring_, cq_ring_size_);
+		}
+		if (sq_ring_ != MAP_FAILED) {
+			munmap(sq_ring_, sq_ring_size_);
+		}
+		if (ring_fd_ >= 0) {
+			close(ring_fd_);
+		}
+	}
+
+	/* Whether the kernel provides an io_uring with IORING_OP_READ and IORING_OP_WRITE */
+	bool ready() const {
+		return ready_;
+	}
+
+	void run() {
+		uint64_t next_chunk = 0, written = 0;
+		for (size_t slot = 0; slot < plan_.slots && next_chunk < plan_.chunks; slot++) {
+			start_read(slot, next_chunk++);
+		}
+		while (written < plan_.chunks) {
+			/* Submit the queued requests and wait for at least one completion */
+			const int result = (int) syscall(__NR_io_uring_enter, ring_fd_, unsubmitted_, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+			if (result < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				throw file_error("io_uring_enter");
+			}
+			unsubmitted_ -= std::min<unsigned>((unsigned) result, unsubmitted_);
+
+			unsigned head = *cq_head_;
+			while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+				const struct io_uring_cqe cqe = cqes_[head & cq_mask_];
+				head++;
+				__atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+				const size_t slot = (size_t) (cqe.user_data >> 1);
+				const bool is_write = (cqe.user_data & 1) != 0;
+				const uint64_t chunk = slot_chunks_[slot];
+				if (cqe.res < 0 && cqe.res != -EINTR && cqe.res != -EAGAIN) {
+					errno = -cqe.res;
+					throw file_error(is_write ? "write" : "read");
+				}
+				if (cqe.res == 0) {
+					/* End of file before the end of the chunk, or a write that made no progress */
+					errno = EIO;
+					throw file_error(is_write ? "write" : "read");
+				}
+				if (cqe.res > 0) {
+					slot_done_[slot] += (size_t) cqe.res;
+				}
+				if (!is_write) {
+					if (slot_done_[slot] < plan_.input_bytes(chunk)) {
+						submit_read(slot);
+					} else {
+						plan_.convert(slot, chunk);
+						slot_done_[slot] = 0;
+						submit_write(slot);
+					}
+				} else if (slot_done_[slot] < plan_.output_request(chunk)) {
+					submit_write(slot);
+				} else {
+					written++;
+					if (next_chunk < plan_.chunks) {
+						start_read(slot, next_chunk++);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	void start_read(size_t slot, uint64_t chunk) {
+		slot_chunks_[slot] = chunk;
+		slot_done_[slot] = 0;
+		submit_read(slot);
+	}
+
+	void submit_read(size_t slot) {
+		const uint64_t chunk = slot_chunks_[slot];
+		const size_t done = slot_done_[slot];
+		submit(IORING_OP_READ, input_fd_, plan_.input(slot) + done, plan_.input_request(chunk) - done,
+			plan_.input_offset(chunk) + (off_t) done, (uint64_t) slot << 1);
+	}
+
+	void submit_write(size_t slot) {
+		const uint64_t chunk = slot_chunks_[slot];
+		const size_t done = slot_done_[slot];
+		submit(IORING_OP_WRITE, output_fd_, plan_.output(slot) + done, plan_.output_request(chunk) - done,
+			plan_.output_offset(chunk) + (off_t) done, (uint64_t) slot << 1 | 1);
+	}
+
+	void submit(uint8_t opcode, int fd, void* buffer, size_t bytes, off_t offset, uint64_t user_data) {
+		/* The ring has two entries per slot, and a slot has one request in flight, so the ring never overflows */
+		const unsigned tail = *sq_tail_;
+		const unsigned index = tail & sq_mask_;
+		struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(sqes_) + index;
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = opcode;
+		sqe->fd = fd;
+		sqe->addr = (uint64_t) (uintptr_t) buffer;
+		sqe->len = (uint32_t) bytes;
+		sqe->off = (uint64_t) offset;
+		sqe->user_data = user_data;
+		sq_array_[index] = index;
+		__atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+		unsubmitted_++;
+	}
+
+	const file_conversion_plan& plan_;
+	const int input_fd_;
+	const int output_fd_;
+	int ring_fd_;
+	bool ready_;
+	unsigned unsubmitted_;
+	void* sq_ring_;
+	void* cq_ring_;
+	void* sqes_;
+	size_t sq_ring_size_;
+	size_t cq_ring_size_;
+	size_t sqes_size_;
+	unsigned* sq_tail_;
+	unsigned sq_mask_;
+	unsigned* sq_array_;
+	unsigned* cq_head_;
+	unsigned* cq_tail_;
+	unsigned cq_mask_;
+	struct io_uring_cqe* cqes_;
+	std::vector<uint64_t> slot_chunks_;
+	std::vector<size_t> slot_done_;
+};
+
+#endif /* FP16_USE_IO_URING && defined(IORING_FEAT_RW_CUR_POS) */
+
+static inline bool file_is_direct(int fd) {
+#ifdef O_DIRECT
+	const int flags = fcntl(fd, F_GETFL);
+	return flags != -1 && (flags & O_DIRECT) != 0;
+#else
+	(void) fd;
+	return false;
+#endif
+}
+
+/*
+ * Convert the whole input file into the output file, both open as descriptors. The output is truncated to the size
+ * of the converted numbers.
+ */
+static inline file_conversion_stats convert_file(fp16_conversion_kind kind, int input_fd, int output_fd,
+	const file_conversion_options& options = file_conversion_options())
+{
+	struct stat input_stat;
+	if (fstat(input_fd, &input_stat) != 0) {
+		throw file_error("fstat");
+	}
+	const size_t input_size = fp16_conversion_input_size(kind);
+	if ((uint64_t) input_stat.st_size % input_size != 0) {
+		throw std::invalid_argument("fp16::convert_file: input size is not a multiple of the number size");
+	}
+	const uint64_t elements = (uint64_t) input_stat.st_size / input_size;
+	const uint64_t output_bytes = elements * fp16_conversion_output_size(kind);
+
+	file_conversion_stats stats;
+	stats.elements = elements;
+	stats.bytes_read = (uint64_t) input_stat.st_size;
+	stats.bytes_written = output_bytes;
+	stats.io = file_io::threads;
+	const bool direct_input = file_is_direct(input_fd);
+	const bool direct_output = file_is_direct(output_fd);
+	stats.direct = direct_input || direct_output;
+
+	if (ftruncate(output_fd, (off_t) output_bytes) != 0) {
+		throw file_error("ftruncate");
+	}
+	if (elements == 0) {
+		return stats;
+	}
+
+	file_conversion_plan plan(kind, elements, options.chunk_elements, std::max<size_t>(options.buffers, 1),
+		direct_input, direct_output);
+	bool converted = false;
+#if FP16_USE_IO_URING && defined(IORING_FEAT_RW_CUR_POS)
+	if (options.io != file_io::threads) {
+		file_uring_pipeline pipeline(plan, input_fd, output_fd);
+		if (pipeline.ready()) {
+			pipeline.run();
+			stats.io = file_io::io_uring;
+			converted = true;
+		}
+	}
+#endif
+	if (!converted) {
+		file_threads_pipeline pipeline(plan, input_fd, output_fd);
+		pipeline.run();
+	}
+
+	/* O_DIRECT writes the last chunk in whole blocks */
+	if (direct_output && ftruncate(output_fd, (off_t) output_bytes) != 0) {
+		throw file_error("ftruncate");
+	}
+	return stats;
+}
+
+/* Open a file with O_DIRECT if requested, or without if the file system does not support it */
+static inline int file_open(const char* path, int flags, bool direct) {
+#ifdef O_DIRECT
+	if (direct) {
+		const int fd = open(path, flags | O_DIRECT | O_CLOEXEC, 0644);
+		if (fd >= 0 || errno != EINVAL) {
+			return fd;
+		}
+	}
+#else
+	(void) direct;
+#endif
+	return open(path, flags | O_CLOEXEC, 0644);
+}
+
+/*
+ * Convert the whole input file into the output file, which is created or truncated.
+ */
+static inline file_conversion_stats convert_file(fp16_conversion_kind kind, const char* input_path, const char* output_path,
+	const file_conversion_options& options = file_conversion_options())
+{
+	file_descriptor input(file_open(input_path, O_RDONLY, options.direct));
+	if (input.get() < 0) {
+		throw file_error("open input");
+	}
+	file_descriptor output(file_open(output_path, O_WRONLY | O_CREAT | O_TRUNC, options.direct));
+	if (output.get() < 0) {
+		throw file_error("open output");
+	}
+	return convert_file(kind, input.get(), output.get(), options);
+}
+
+} /* namespace fp16 */
+
+#endif /* FP16_FILE_H */
@@ -7,6 +7,20 @@
 
 #include "bitcasts.h"
 
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+#if FP16_USE_NATIVE_CONVERSION && !FP16_USE_FLOAT16_TYPE && !FP16_USE_FP16_TYPE
+	#if (defined(__INTEL_COMPILER) || defined(__GNUC__)) && defined(__F16C__)
+		#include <immintrin.h>
+	#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)) && defined(__AVX2__)
+		#include <immintrin.h>
+	#elif defined(_M_ARM64) || defined(__aarch64__)
+		#include <arm_neon.h>
+	#endif
+#endif
+
 typedef uint16_t float16;
 typedef uint32_t float32_b;
 
@@ -255,9 +269,9 @@ static inline float16 fp32_ieee_to_fp16_value(float f) {
 		return fp16.as_bits;
 	#else
 		#if (defined(__INTEL_COMPILER) || defined(__GNUC__)) && defined(__F16C__)
-			return _cvtss_sh(f, _MM_FROUND_CUR_DIRECTION);
+			return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
 		#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)) && defined(__AVX2__)
-			return (uint16_t) _mm_cvtsi128_si32(_mm_cvtps_ph(_mm_set_ss(f), _MM_FROUND_CUR_DIRECTION));
+			return (uint16_t) _mm_cvtsi128_si32(_mm_cvtps_ph(_mm_set_ss(f), _MM_FROUND_TO_NEAREST_INT));
 		#elif defined(_M_ARM64) || defined(__aarch64__)
 			return vget_lane_u16(vcvt_f16_f32(vdupq_n_f32(f)), 0);
 		#else
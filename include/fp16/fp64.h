@@ -0,0 +1,241 @@
+#pragma once
+#ifndef FP16_FP64_H
+#define FP16_FP64_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bitcasts.h"
+#include "fp16.h"
+#include "simd.h"
+
+/*
+ * Conversions between IEEE half-precision and IEEE double-precision numbers.
+ *
+ * Widening is exact. Narrowing rounds the double-precision number to nearest-even once: going through
+ * single-precision, as in fp32_ieee_to_fp16_value((float) d), rounds twice and gets numbers just above or below a
+ * half-precision midpoint wrong when the first rounding lands exactly on the midpoint. Numbers from 65520 overflow to
+ * infinity and NaN inputs produce the canonical NaN of the same sign, as in fp32_ieee_to_fp16_value.
+ *
+ * The scalar narrowing conversion rounds the 53-bit significand with integer operations. The vector kernels instead
+ * round to single-precision with round-to-odd (truncate, and set the least significant bit if the result is inexact)
+ * and then to half-precision with vcvtps2ph: with 24 >= 11 + 2 significand bits, the intermediate round-to-odd result
+ * never lands on a half-precision midpoint unless the input is one, so the second rounding gives the correctly rounded
+ * result. Like the other F16C kernels in this library, they keep NaN payloads.
+ */
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format, in bit representation, to
+ * a 64-bit floating-point number in IEEE double-precision format, in bit representation.
+ *
+ * @note The implementation doesn't use any floating-point operations.
+ */
+static inline uint64_t fp16_ieee_to_fp64_bits(float16 h) {
+	/*
+	 * Extend the half-precision floating-point number to 64 bits and shift to the upper part of the 64-bit word:
+	 *      +---+-----+------------+-------------------+
+	 *      | S |EEEEE|MM MMMM MMMM|0000 ... 0000 0000|
+	 *      +---+-----+------------+-------------------+
+	 * Bits  63  58-62    48-57            0-47
+	 */
+	const uint64_t w = (uint64_t) h << 48;
+	const uint64_t sign = w & UINT64_C(0x8000000000000000);
+	const uint64_t nonsign = w & UINT64_C(0x7FFFFFFFFFFFFFFF);
+	/*
+	 * Renormalize denormalized inputs by shifting the leading 1 into the implicit position, exactly as
+	 * fp16_ieee_to_fp32_bits does; the set bits of nonsign are all in its upper 32 bits.
+	 */
+	const uint32_t nonsign_hi = (uint32_t) (nonsign >> 32);
+#ifdef _MSC_VER
+	unsigned long nonsign_bsr;
+	_BitScanReverse(&nonsign_bsr, (unsigned long) nonsign_hi);
+	uint32_t renorm_shift = (uint32_t) nonsign_bsr ^ 31;
+#else
+	uint32_t renorm_shift = __builtin_clz(nonsign_hi);
+#endif
+	renorm_shift = renorm_shift > 5 ? renorm_shift - 5 : 0;
+	/*
+	 * Iff the half-precision exponent is 31, adding 1 << 58 overflows into the sign bit, and the arithmetic shift
+	 * smears it over the double-precision exponent bits.
+	 */
+	const int64_t inf_nan_mask = ((int64_t) (nonsign + UINT64_C(0x0400000000000000)) >> 11) &
+		INT64_C(0x7FF0000000000000);
+	/* All ones iff nonsign is zero */
+	const int64_t zero_mask = (int64_t) (nonsign - 1) >> 63;
+	/*
+	 * Shift the mantissa and exponent into place (bits 42-51 and 52-56) and rebias the exponent by 1023 - 15 = 0x3F0,
+	 * less the renormalization shift.
+	 */
+	return sign | ((((nonsign << renorm_shift >> 6) + ((uint64_t) (0x3F0 - renorm_shift) << 52)) |
+		(uint64_t) inf_nan_mask) & ~(uint64_t) zero_mask);
+}
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format, in bit representation, to
+ * a 64-bit floating-point number in IEEE double-precision format.
+ */
+static inline double fp16_ieee_to_fp64_value(float16 h) {
+	return fp64b_to_fp64v(fp16_ieee_to_fp64_bits(h));
+}
+
+/*
+ * Convert a 64-bit floating-point number in IEEE double-precision format to a 16-bit floating-point number in
+ * IEEE half-precision format, in bit representation, rounding to nearest-even once.
+ */
+static inline float16 fp64_ieee_to_fp16_value(double d) {
+	const uint64_t w = fp64v_to_fp64b(d);
+	const uint32_t sign = (uint32_t) (w >> 48) & UINT32_C(0x8000);
+	const uint64_t nonsign = w & UINT64_C(0x7FFFFFFFFFFFFFFF);
+	if (nonsign > UINT64_C(0x7FF0000000000000)) {
+		return (float16) (sign | UINT32_C(0x7E00));
+	}
+	/* Numbers from 65520, halfway between 65504 and 65536, overflow: ties go to the even infinity encoding */
+	if (nonsign >= UINT64_C(0x40EFFE0000000000)) {
+		return (float16) (sign | UINT32_C(0x7C00));
+	}
+	if (nonsign >= UINT64_C(1009) << 52) {
+		/* Normalized result: round off the low 42 mantissa bits, carrying into the exponent, and rebias by 1008 */
+		const uint64_t rounded = nonsign + UINT64_C(0x000001FFFFFFFFFF) + ((nonsign >> 42) & UINT64_C(1));
+		return (float16) (sign | (uint32_t) ((rounded >> 42) - (UINT64_C(1008) << 10)));
+	}
+	/*
+	 * Denormalized result: shift the significand (with the implicit bit for normalized inputs) down to units of 2**-24.
+	 * Shifts beyond 54 bits round the 53-bit significand to zero either way.
+	 */
+	const uint32_t exponent = (uint32_t) (nonsign >> 52);
+	const uint64_t significand = exponent != 0 ?
+		(nonsign & UINT64_C(0x000FFFFFFFFFFFFF)) | UINT64_C(0x0010000000000000) : nonsign;
+	uint32_t shift = 1051 - (exponent != 0 ? exponent : 1);
+	if (shift > 54) {
+		shift = 54;
+	}
+	const uint64_t rounded = significand + ((UINT64_C(1) << (shift - 1)) - 1) + ((significand >> shift) & UINT64_C(1));
+	return (float16) (sign | (uint32_t) (rounded >> shift));
+}
+
+#if FP16_SIMD_AVX2
+/*
+ * Round four double-precision numbers to single-precision with round-to-odd.
+ * The 29 mantissa bits below single-precision are folded into a sticky bit at bit 29, so that vcvtpd2ps converts
+ * exactly; numbers below the single-precision normalized range and above its largest number still convert to
+ * numbers that round to half-precision zero and infinity respectively.
+ */
+static inline __m128 fp16_simd_avx2_fp64_to_fp32_odd(__m256d d) {
+	const __m256i w = _mm256_castpd_si256(d);
+	const __m256i low_mask = _mm256_set1_epi64x(INT64_C(0x000000001FFFFFFF));
+	const __m256i exact = _mm256_cmpeq_epi64(_mm256_and_si256(w, low_mask), _mm256_setzero_si256());
+	const __m256i sticky = _mm256_andnot_si256(exact, _mm256_set1_epi64x(INT64_C(0x0000000020000000)));
+	return _mm256_cvtpd_ps(_mm256_castsi256_pd(_mm256_or_si256(_mm256_andnot_si256(low_mask, w), sticky)));
+}
+
+/*
+ * Convert eight double-precision numbers to IEEE half-precision, rounding to nearest-even once.
+ */
+static inline __m128i fp16_simd_avx2_fp64_to_fp16(__m256d lo, __m256d hi) {
+	const __m256 f = _mm256_insertf128_ps(_mm256_castps128_ps256(fp16_simd_avx2_fp64_to_fp32_odd(lo)),
+		fp16_simd_avx2_fp64_to_fp32_odd(hi), 1);
+	return _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+}
+
+/*
+ * Mask with all bits set in the 64-bit lanes [0, n) and cleared in the lanes [n, 4), for use with vpmaskmov.
+ */
+static inline __m256i fp16_simd_avx2_mask_u64x4(size_t n) {
+	return _mm256_cmpgt_epi64(_mm256_set1_epi64x((int64_t) n), _mm256_setr_epi64x(0, 1, 2, 3));
+}
+#endif /* FP16_SIMD_AVX2 */
+
+#if FP16_SIMD_AVX512
+/*
+ * Convert eight double-precision numbers to IEEE half-precision, rounding to nearest-even once, as in
+ * fp16_simd_avx2_fp64_to_fp32_odd and fp16_simd_avx2_fp64_to_fp16.
+ */
+static inline __m128i fp16_simd_avx512_fp64_to_fp16(__m512d d) {
+	const __m512i w = _mm512_castpd_si512(d);
+	const __m512i low_mask = _mm512_set1_epi64(INT64_C(0x000000001FFFFFFF));
+	const __m512i truncated = _mm512_andnot_si512(low_mask, w);
+	const __m512i odd = _mm512_mask_or_epi64(truncated, _mm512_test_epi64_mask(w, low_mask), truncated,
+		_mm512_set1_epi64(INT64_C(0x0000000020000000)));
+	return _mm256_cvtps_ph(_mm512_cvtpd_ps(_mm512_castsi512_pd(odd)), _MM_FROUND_TO_NEAREST_INT);
+}
+#endif /* FP16_SIMD_AVX512 */
+
+/*
+ * Convert n IEEE half-precision numbers to double-precision.
+ */
+static inline void fp16_ieee_to_fp64_array(const float16* input, double* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 16; n -= 16) {
+		const __m256i h = _mm256_loadu_si256((const __m256i*) input);
+		_mm512_storeu_pd(output, _mm512_cvtps_pd(_mm256_cvtph_ps(_mm256_castsi256_si128(h))));
+		_mm512_storeu_pd(output + 8, _mm512_cvtps_pd(_mm256_cvtph_ps(_mm256_extracti128_si256(h, 1))));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	const __m256i h = _mm256_maskz_loadu_epi16(mask, input);
+	_mm512_mask_storeu_pd(output, (__mmask8) mask, _mm512_cvtps_pd(_mm256_cvtph_ps(_mm256_castsi256_si128(h))));
+	_mm512_mask_storeu_pd(output + 8, (__mmask8) (mask >> 8), _mm512_cvtps_pd(_mm256_cvtph_ps(_mm256_extracti128_si256(h, 1))));
+#elif FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		const __m256 f = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) input));
+		_mm256_storeu_pd(output, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+		_mm256_storeu_pd(output + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		const __m256 f = _mm256_cvtph_ps(fp16_simd_avx2_load_u16x8_partial(input, n));
+		_mm256_maskstore_pd(output, fp16_simd_avx2_mask_u64x4(n), _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+		if (n > 4) {
+			_mm256_maskstore_pd(output + 4, fp16_simd_avx2_mask_u64x4(n - 4), _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+		}
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp16_ieee_to_fp64_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n double-precision numbers to IEEE half-precision, rounding to nearest-even once.
+ */
+static inline void fp64_ieee_to_fp16_array(const double* input, float16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 16; n -= 16) {
+		const __m128i lo = fp16_simd_avx512_fp64_to_fp16(_mm512_loadu_pd(input));
+		const __m128i hi = fp16_simd_avx512_fp64_to_fp16(_mm512_loadu_pd(input + 8));
+		_mm256_storeu_si256((__m256i*) output, _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1));
+		input += 16;
+		output += 16;
+	}
+	if (n >= 8) {
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx512_fp64_to_fp16(_mm512_loadu_pd(input)));
+		input += 8;
+		output += 8;
+		n -= 8;
+	}
+	const __mmask8 mask = (__mmask8) fp16_simd_avx512_mask16(n);
+	_mm_mask_storeu_epi16(output, mask, fp16_simd_avx512_fp64_to_fp16(_mm512_maskz_loadu_pd(mask, input)));
+#elif FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx2_fp64_to_fp16(_mm256_loadu_pd(input), _mm256_loadu_pd(input + 4)));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		double buffer[8] = { 0 };
+		memcpy(buffer, input, n * sizeof(double));
+		fp16_simd_avx2_store_u16x8_partial(output,
+			fp16_simd_avx2_fp64_to_fp16(_mm256_loadu_pd(buffer), _mm256_loadu_pd(buffer + 4)), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp64_ieee_to_fp16_value(input[i]);
+	}
+#endif
+}
+
+#endif /* FP16_FP64_H */
@@ -0,0 +1,741 @@
+#pragma once
+#ifndef FP16_FP8_H
+#define FP16_FP8_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fp16.h"
+#include "simd.h"
+
+/*
+ * Conversions for the 8-bit floating-point formats of the OCP 8-bit Floating Point Specification:
+ * - E4M3: 1 sign bit, 4 exponent bits with bias 7, 3 mantissa bits. There are no infinities; S.1111.111 is NaN and
+ *   the largest finite number is 448.
+ * - E5M2: 1 sign bit, 5 exponent bits with bias 15, 2 mantissa bits, with IEEE infinities and NaN. This is the upper
+ *   byte of IEEE half-precision; the largest finite number is 57344.
+ *
+ * Narrowing conversions round to nearest-even and handle overflow per fp8_saturation: without saturation, numbers
+ * that round beyond the largest finite number become infinity (E5M2) or NaN (E4M3); with saturation, they and
+ * infinite inputs become the largest finite number of the same sign. NaN inputs produce the canonical NaN of the same
+ * sign (0x7F for E4M3, 0x7E for E5M2) in either mode.
+ *
+ * Widening conversions are exact. Scalar functions read 256-entry tables; vector kernels decode E5M2 with a shift
+ * and E4M3 with integer operations and a 16-entry shuffle table for denormals.
+ */
+typedef uint8_t float8;
+
+enum fp8_saturation {
+	FP8_NO_SATURATION = 0,
+	FP8_SATURATE = 1,
+};
+
+/* Single-precision bit representations of all E4M3 numbers */
+static const uint32_t fp8_e4m3_to_fp32_table[256] = {
+	0x00000000, 0x3B000000, 0x3B800000, 0x3BC00000, 0x3C000000, 0x3C200000, 0x3C400000, 0x3C600000,
+	0x3C800000, 0x3C900000, 0x3CA00000, 0x3CB00000, 0x3CC00000, 0x3CD00000, 0x3CE00000, 0x3CF00000,
+	0x3D000000, 0x3D100000, 0x3D200000, 0x3D300000, 0x3D400000, 0x3D500000, 0x3D600000, 0x3D700000,
+	0x3D800000, 0x3D900000, 0x3DA00000, 0x3DB00000, 0x3DC00000, 0x3DD00000, 0x3DE00000, 0x3DF00000,
+	0x3E000000, 0x3E100000, 0x3E200000, 0x3E300000, 0x3E400000, 0x3E500000, 0x3E600000, 0x3E700000,
+	0x3E800000, 0x3E900000, 0x3EA00000, 0x3EB00000, 0x3EC00000, 0x3ED00000, 0x3EE00000, 0x3EF00000,
+	0x3F000000, 0x3F100000, 0x3F200000, 0x3F300000, 0x3F400000, 0x3F500000, 0x3F600000, 0x3F700000,
+	0x3F800000, 0x3F900000, 0x3FA00000, 0x3FB00000, 0x3FC00000, 0x3FD00000, 0x3FE00000, 0x3FF00000,
+	0x40000000, 0x40100000, 0x40200000, 0x40300000, 0x40400000, 0x40500000, 0x40600000, 0x40700000,
+	0x40800000, 0x40900000, 0x40A00000, 0x40B00000, 0x40C00000, 0x40D00000, 0x40E00000, 0x40F00000,
+	0x41000000, 0x41100000, 0x41200000, 0x41300000, 0x41400000, 0x41500000, 0x41600000, 0x41700000,
+	0x41800000, 0x41900000, 0x41A00000, 0x41B00000, 0x41C00000, 0x41D00000, 0x41E00000, 0x41F00000,
+	0x42000000, 0x42100000, 0x42200000, 0x42300000, 0x42400000, 0x42500000, 0x42600000, 0x42700000,
+	0x42800000, 0x42900000, 0x42A00000, 0x42B00000, 0x42C00000, 0x42D00000, 0x42E00000, 0x42F00000,
+	0x43000000, 0x43100000, 0x43200000, 0x43300000, 0x43400000, 0x43500000, 0x43600000, 0x43700000,
+	0x43800000, 0x43900000, 0x43A00000, 0x43B00000, 0x43C00000, 0x43D00000, 0x43E00000, 0x7FC00000,
+	0x80000000, 0xBB000000, 0xBB800000, 0xBBC00000, 0xBC000000, 0xBC200000, 0xBC400000, 0xBC600000,
+	0xBC800000, 0xBC900000, 0xBCA00000, 0xBCB00000, 0xBCC00000, 0xBCD00000, 0xBCE00000, 0xBCF00000,
+	0xBD000000, 0xBD100000, 0xBD200000, 0xBD300000, 0xBD400000, 0xBD500000, 0xBD600000, 0xBD700000,
+	0xBD800000, 0xBD900000, 0xBDA00000, 0xBDB00000, 0xBDC00000, 0xBDD00000, 0xBDE00000, 0xBDF00000,
+	0xBE000000, 0xBE100000, 0xBE200000, 0xBE300000, 0xBE400000, 0xBE500000, 0xBE600000, 0xBE700000,
+	0xBE800000, 0xBE900000, 0xBEA00000, 0xBEB00000, 0xBEC00000, 0xBED00000, 0xBEE00000, 0xBEF00000,
+	0xBF000000, 0xBF100000, 0xBF200000, 0xBF300000, 0xBF400000, 0xBF500000, 0xBF600000, 0xBF700000,
+	0xBF800000, 0xBF900000, 0xBFA00000, 0xBFB00000, 0xBFC00000, 0xBFD00000, 0xBFE00000, 0xBFF00000,
+	0xC0000000, 0xC0100000, 0xC0200000, 0xC0300000, 0xC0400000, 0xC0500000, 0xC0600000, 0xC0700000,
+	0xC0800000, 0xC0900000, 0xC0A00000, 0xC0B00000, 0xC0C00000, 0xC0D00000, 0xC0E00000, 0xC0F00000,
+	0xC1000000, 0xC1100000, 0xC1200000, 0xC1300000, 0xC1400000, 0xC1500000, 0xC1600000, 0xC1700000,
+	0xC1800000, 0xC1900000, 0xC1A00000, 0xC1B00000, 0xC1C00000, 0xC1D00000, 0xC1E00000, 0xC1F00000,
+	0xC2000000, 0xC2100000, 0xC2200000, 0xC2300000, 0xC2400000, 0xC2500000, 0xC2600000, 0xC2700000,
+	0xC2800000, 0xC2900000, 0xC2A00000, 0xC2B00000, 0xC2C00000, 0xC2D00000, 0xC2E00000, 0xC2F00000,
+	0xC3000000, 0xC3100000, 0xC3200000, 0xC3300000, 0xC3400000, 0xC3500000, 0xC3600000, 0xC3700000,
+	0xC3800000, 0xC3900000, 0xC3A00000, 0xC3B00000, 0xC3C00000, 0xC3D00000, 0xC3E00000, 0xFFC00000,
+};
+
+/* Single-precision bit representations of all E5M2 numbers; NaN payloads are kept with the quiet bit set */
+static const uint32_t fp8_e5m2_to_fp32_table[256] = {
+	0x00000000, 0x37800000, 0x38000000, 0x38400000, 0x38800000, 0x38A00000, 0x38C00000, 0x38E00000,
+	0x39000000, 0x39200000, 0x39400000, 0x39600000, 0x39800000, 0x39A00000, 0x39C00000, 0x39E00000,
+	0x3A000000, 0x3A200000, 0x3A400000, 0x3A600000, 0x3A800000, 0x3AA00000, 0x3AC00000, 0x3AE00000,
+	0x3B000000, 0x3B200000, 0x3B400000, 0x3B600000, 0x3B800000, 0x3BA00000, 0x3BC00000, 0x3BE00000,
+	0x3C000000, 0x3C200000, 0x3C400000, 0x3C600000, 0x3C800000, 0x3CA00000, 0x3CC00000, 0x3CE00000,
+	0x3D000000, 0x3D200000, 0x3D400000, 0x3D600000, 0x3D800000, 0x3DA00000, 0x3DC00000, 0x3DE00000,
+	0x3E000000, 0x3E200000, 0x3E400000, 0x3E600000, 0x3E800000, 0x3EA00000, 0x3EC00000, 0x3EE00000,
+	0x3F000000, 0x3F200000, 0x3F400000, 0x3F600000, 0x3F800000, 0x3FA00000, 0x3FC00000, 0x3FE00000,
+	0x40000000, 0x40200000, 0x40400000, 0x40600000, 0x40800000, 0x40A00000, 0x40C00000, 0x40E00000,
+	0x41000000, 0x41200000, 0x41400000, 0x41600000, 0x41800000, 0x41A00000, 0x41C00000, 0x41E00000,
+	0x42000000, 0x42200000, 0x42400000, 0x42600000, 0x42800000, 0x42A00000, 0x42C00000, 0x42E00000,
+	0x43000000, 0x43200000, 0x43400000, 0x43600000, 0x43800000, 0x43A00000, 0x43C00000, 0x43E00000,
+	0x44000000, 0x44200000, 0x44400000, 0x44600000, 0x44800000, 0x44A00000, 0x44C00000, 0x44E00000,
+	0x45000000, 0x45200000, 0x45400000, 0x45600000, 0x45800000, 0x45A00000, 0x45C00000, 0x45E00000,
+	0x46000000, 0x46200000, 0x46400000, 0x46600000, 0x46800000, 0x46A00000, 0x46C00000, 0x46E00000,
+	0x47000000, 0x47200000, 0x47400000, 0x47600000, 0x7F800000, 0x7FE00000, 0x7FC00000, 0x7FE00000,
+	0x80000000, 0xB7800000, 0xB8000000, 0xB8400000, 0xB8800000, 0xB8A00000, 0xB8C00000, 0xB8E00000,
+	0xB9000000, 0xB9200000, 0xB9400000, 0xB9600000, 0xB9800000, 0xB9A00000, 0xB9C00000, 0xB9E00000,
+	0xBA000000, 0xBA200000, 0xBA400000, 0xBA600000, 0xBA800000, 0xBAA00000, 0xBAC00000, 0xBAE00000,
+	0xBB000000, 0xBB200000, 0xBB400000, 0xBB600000, 0xBB800000, 0xBBA00000, 0xBBC00000, 0xBBE00000,
+	0xBC000000, 0xBC200000, 0xBC400000, 0xBC600000, 0xBC800000, 0xBCA00000, 0xBCC00000, 0xBCE00000,
+	0xBD000000, 0xBD200000, 0xBD400000, 0xBD600000, 0xBD800000, 0xBDA00000, 0xBDC00000, 0xBDE00000,
+	0xBE000000, 0xBE200000, 0xBE400000, 0xBE600000, 0xBE800000, 0xBEA00000, 0xBEC00000, 0xBEE00000,
+	0xBF000000, 0xBF200000, 0xBF400000, 0xBF600000, 0xBF800000, 0xBFA00000, 0xBFC00000, 0xBFE00000,
+	0xC0000000, 0xC0200000, 0xC0400000, 0xC0600000, 0xC0800000, 0xC0A00000, 0xC0C00000, 0xC0E00000,
+	0xC1000000, 0xC1200000, 0xC1400000, 0xC1600000, 0xC1800000, 0xC1A00000, 0xC1C00000, 0xC1E00000,
+	0xC2000000, 0xC2200000, 0xC2400000, 0xC2600000, 0xC2800000, 0xC2A00000, 0xC2C00000, 0xC2E00000,
+	0xC3000000, 0xC3200000, 0xC3400000, 0xC3600000, 0xC3800000, 0xC3A00000, 0xC3C00000, 0xC3E00000,
+	0xC4000000, 0xC4200000, 0xC4400000, 0xC4600000, 0xC4800000, 0xC4A00000, 0xC4C00000, 0xC4E00000,
+	0xC5000000, 0xC5200000, 0xC5400000, 0xC5600000, 0xC5800000, 0xC5A00000, 0xC5C00000, 0xC5E00000,
+	0xC6000000, 0xC6200000, 0xC6400000, 0xC6600000, 0xC6800000, 0xC6A00000, 0xC6C00000, 0xC6E00000,
+	0xC7000000, 0xC7200000, 0xC7400000, 0xC7600000, 0xFF800000, 0xFFE00000, 0xFFC00000, 0xFFE00000,
+};
+
+/* IEEE half-precision bit representations of all E4M3 numbers */
+static const uint16_t fp8_e4m3_to_fp16_table[256] = {
+	0x0000, 0x1800, 0x1C00, 0x1E00, 0x2000, 0x2100, 0x2200, 0x2300,
+	0x2400, 0x2480, 0x2500, 0x2580, 0x2600, 0x2680, 0x2700, 0x2780,
+	0x2800, 0x2880, 0x2900, 0x2980, 0x2A00, 0x2A80, 0x2B00, 0x2B80,
+	0x2C00, 0x2C80, 0x2D00, 0x2D80, 0x2E00, 0x2E80, 0x2F00, 0x2F80,
+	0x3000, 0x3080, 0x3100, 0x3180, 0x3200, 0x3280, 0x3300, 0x3380,
+	0x3400, 0x3480, 0x3500, 0x3580, 0x3600, 0x3680, 0x3700, 0x3780,
+	0x3800, 0x3880, 0x3900, 0x3980, 0x3A00, 0x3A80, 0x3B00, 0x3B80,
+	0x3C00, 0x3C80, 0x3D00, 0x3D80, 0x3E00, 0x3E80, 0x3F00, 0x3F80,
+	0x4000, 0x4080, 0x4100, 0x4180, 0x4200, 0x4280, 0x4300, 0x4380,
+	0x4400, 0x4480, 0x4500, 0x4580, 0x4600, 0x4680, 0x4700, 0x4780,
+	0x4800, 0x4880, 0x4900, 0x4980, 0x4A00, 0x4A80, 0x4B00, 0x4B80,
+	0x4C00, 0x4C80, 0x4D00, 0x4D80, 0x4E00, 0x4E80, 0x4F00, 0x4F80,
+	0x5000, 0x5080, 0x5100, 0x5180, 0x5200, 0x5280, 0x5300, 0x5380,
+	0x5400, 0x5480, 0x5500, 0x5580, 0x5600, 0x5680, 0x5700, 0x5780,
+	0x5800, 0x5880, 0x5900, 0x5980, 0x5A00, 0x5A80, 0x5B00, 0x5B80,
+	0x5C00, 0x5C80, 0x5D00, 0x5D80, 0x5E00, 0x5E80, 0x5F00, 0x7E00,
+	0x8000, 0x9800, 0x9C00, 0x9E00, 0xA000, 0xA100, 0xA200, 0xA300,
+	0xA400, 0xA480, 0xA500, 0xA580, 0xA600, 0xA680, 0xA700, 0xA780,
+	0xA800, 0xA880, 0xA900, 0xA980, 0xAA00, 0xAA80, 0xAB00, 0xAB80,
+	0xAC00, 0xAC80, 0xAD00, 0xAD80, 0xAE00, 0xAE80, 0xAF00, 0xAF80,
+	0xB000, 0xB080, 0xB100, 0xB180, 0xB200, 0xB280, 0xB300, 0xB380,
+	0xB400, 0xB480, 0xB500, 0xB580, 0xB600, 0xB680, 0xB700, 0xB780,
+	0xB800, 0xB880, 0xB900, 0xB980, 0xBA00, 0xBA80, 0xBB00, 0xBB80,
+	0xBC00, 0xBC80, 0xBD00, 0xBD80, 0xBE00, 0xBE80, 0xBF00, 0xBF80,
+	0xC000, 0xC080, 0xC100, 0xC180, 0xC200, 0xC280, 0xC300, 0xC380,
+	0xC400, 0xC480, 0xC500, 0xC580, 0xC600, 0xC680, 0xC700, 0xC780,
+	0xC800, 0xC880, 0xC900, 0xC980, 0xCA00, 0xCA80, 0xCB00, 0xCB80,
+	0xCC00, 0xCC80, 0xCD00, 0xCD80, 0xCE00, 0xCE80, 0xCF00, 0xCF80,
+	0xD000, 0xD080, 0xD100, 0xD180, 0xD200, 0xD280, 0xD300, 0xD380,
+	0xD400, 0xD480, 0xD500, 0xD580, 0xD600, 0xD680, 0xD700, 0xD780,
+	0xD800, 0xD880, 0xD900, 0xD980, 0xDA00, 0xDA80, 0xDB00, 0xDB80,
+	0xDC00, 0xDC80, 0xDD00, 0xDD80, 0xDE00, 0xDE80, 0xDF00, 0xFE00,
+};
+
+/*
+ * Convert a 8-bit floating-point number in E4M3 format to a 32-bit floating-point number in IEEE single-precision
+ * format, in bit representation.
+ */
+static inline float32_b fp8_e4m3_to_fp32_bits(float8 x) {
+	return fp8_e4m3_to_fp32_table[x];
+}
+
+static inline float fp8_e4m3_to_fp32_value(float8 x) {
+	return fp32b_to_fp32v(fp8_e4m3_to_fp32_table[x]);
+}
+
+/*
+ * Convert a 8-bit floating-point number in E5M2 format to a 32-bit floating-point number in IEEE single-precision
+ * format, in bit representation.
+ */
+static inline float32_b fp8_e5m2_to_fp32_bits(float8 x) {
+	return fp8_e5m2_to_fp32_table[x];
+}
+
+static inline float fp8_e5m2_to_fp32_value(float8 x) {
+	return fp32b_to_fp32v(fp8_e5m2_to_fp32_table[x]);
+}
+
+/*
+ * Convert a 8-bit floating-point number in E4M3 format to a 16-bit floating-point number in IEEE half-precision
+ * format, in bit representation.
+ */
+static inline float16 fp8_e4m3_to_fp16_ieee_value(float8 x) {
+	return fp8_e4m3_to_fp16_table[x];
+}
+
+/*
+ * Convert a 8-bit floating-point number in E5M2 format to a 16-bit floating-point number in IEEE half-precision
+ * format, in bit representation. NaN payloads are kept as they are.
+ */
+static inline float16 fp8_e5m2_to_fp16_ieee_value(float8 x) {
+	return (float16) ((uint32_t) x << 8);
+}
+
+/*
+ * Round the magnitude of a finite single-precision number, in bit representation, to nearest-even in an 8-bit
+ * format with the given number of mantissa bits and exponent bias. The result must not overflow the format.
+ */
+static inline uint32_t fp8_round_magnitude(uint32_t nonsign, uint32_t mantissa_bits, uint32_t bias) {
+	const uint32_t exponent_offset = 127 - bias;
+	if (nonsign >= (exponent_offset + 1) << 23) {
+		/* Normalized result: rebias the exponent and round off the low mantissa bits, carrying into the exponent */
+		const uint32_t shift = 23 - mantissa_bits;
+		const uint32_t rounded = nonsign + ((UINT32_C(1) << (shift - 1)) - 1) + ((nonsign >> shift) & UINT32_C(1));
+		return (rounded >> shift) - (exponent_offset << mantissa_bits);
+	}
+	/*
+	 * Denormalized result: shift the significand (with the implicit bit for normalized inputs) down to units of the
+	 * smallest denormal number. Shifts beyond 25 bits round the 24-bit significand to zero either way.
+	 */
+	const uint32_t exponent = nonsign >> 23;
+	const uint32_t significand = exponent != 0 ? (nonsign & UINT32_C(0x007FFFFF)) | UINT32_C(0x00800000) : nonsign;
+	uint32_t shift = 151 - bias - mantissa_bits - (exponent != 0 ? exponent : 1);
+	if (shift > 25) {
+		shift = 25;
+	}
+	return (significand + ((UINT32_C(1) << (shift - 1)) - 1) + ((significand >> shift) & UINT32_C(1))) >> shift;
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 8-bit floating-point number in
+ * E4M3 format, rounding to nearest-even.
+ */
+static inline float8 fp32_to_fp8_e4m3_value(float f, enum fp8_saturation saturation) {
+	const uint32_t w = fp32v_to_fp32b(f);
+	const uint32_t sign = (w >> 24) & UINT32_C(0x80);
+	const uint32_t nonsign = w & UINT32_C(0x7FFFFFFF);
+	if (nonsign > UINT32_C(0x7F800000)) {
+		return (float8) (sign | UINT32_C(0x7F));
+	}
+	/* Numbers above 464, halfway between 448 and the next (unrepresentable) number 480, overflow */
+	if (nonsign > UINT32_C(0x43E80000)) {
+		return (float8) (sign | (saturation == FP8_SATURATE ? UINT32_C(0x7E) : UINT32_C(0x7F)));
+	}
+	return (float8) (sign | fp8_round_magnitude(nonsign, 3, 7));
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 8-bit floating-point number in
+ * E5M2 format, rounding to nearest-even.
+ */
+static inline float8 fp32_to_fp8_e5m2_value(float f, enum fp8_saturation saturation) {
+	const uint32_t w = fp32v_to_fp32b(f);
+	const uint32_t sign = (w >> 24) & UINT32_C(0x80);
+	const uint32_t nonsign = w & UINT32_C(0x7FFFFFFF);
+	if (nonsign > UINT32_C(0x7F800000)) {
+		return (float8) (sign | UINT32_C(0x7E));
+	}
+	/* Numbers from 61440, halfway between 57344 and 65536, overflow: ties go to the even infinity encoding */
+	if (nonsign >= UINT32_C(0x47700000)) {
+		return (float8) (sign | (saturation == FP8_SATURATE ? UINT32_C(0x7B) : UINT32_C(0x7C)));
+	}
+	return (float8) (sign | fp8_round_magnitude(nonsign, 2, 15));
+}
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format to a 8-bit floating-point number in
+ * E4M3 format, rounding to nearest-even. Widening to single-precision is exact, so the result is rounded once.
+ */
+static inline float8 fp16_ieee_to_fp8_e4m3_value(float16 h, enum fp8_saturation saturation) {
+	return fp32_to_fp8_e4m3_value(fp16_ieee_to_fp32_value(h), saturation);
+}
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format to a 8-bit floating-point number in
+ * E5M2 format, rounding to nearest-even: E5M2 is the upper byte of half-precision, so this rounds off the low byte.
+ */
+static inline float8 fp16_ieee_to_fp8_e5m2_value(float16 h, enum fp8_saturation saturation) {
+	const uint32_t sign = ((uint32_t) h >> 8) & UINT32_C(0x80);
+	const uint32_t nonsign = h & UINT32_C(0x7FFF);
+	if (nonsign > UINT32_C(0x7C00)) {
+		return (float8) (sign | UINT32_C(0x7E));
+	}
+	if (nonsign >= UINT32_C(0x7B80)) {
+		return (float8) (sign | (saturation == FP8_SATURATE ? UINT32_C(0x7B) : UINT32_C(0x7C)));
+	}
+	return (float8) (sign | ((nonsign + UINT32_C(0x7F) + ((nonsign >> 8) & UINT32_C(1))) >> 8));
+}
+
+#if FP16_SIMD_AVX2
+/*
+ * Convert sixteen E4M3 numbers in the bytes of a vector to IEEE half-precision in 16-bit lanes.
+ * Normalized numbers only need their exponent rebiased; the eight denormal magnitudes come from a shuffle table of
+ * the upper bytes of their half-precision representations (the lower bytes are zero).
+ */
+static inline __m256i fp16_simd_avx2_fp8_e4m3_to_fp16(__m128i x) {
+	const __m128i denormal_table = _mm_setr_epi8(
+		0x00, 0x18, 0x1C, 0x1E, 0x20, 0x21, 0x22, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00);
+	const __m256i denormal_value = _mm256_slli_epi16(_mm256_cvtepu8_epi16(
+		_mm_shuffle_epi8(denormal_table, _mm_and_si128(x, _mm_set1_epi8(0x07)))), 8);
+	const __m256i w = _mm256_cvtepu8_epi16(x);
+	const __m256i nonsign = _mm256_and_si256(w, _mm256_set1_epi16(0x7F));
+	const __m256i normal_value = _mm256_add_epi16(_mm256_slli_epi16(nonsign, 7), _mm256_set1_epi16(0x2000));
+	__m256i h = _mm256_blendv_epi8(normal_value, denormal_value, _mm256_cmpgt_epi16(_mm256_set1_epi16(0x08), nonsign));
+	h = _mm256_blendv_epi8(h, _mm256_set1_epi16(0x7E00), _mm256_cmpeq_epi16(nonsign, _mm256_set1_epi16(0x7F)));
+	return _mm256_or_si256(h, _mm256_slli_epi16(_mm256_and_si256(w, _mm256_set1_epi16(0x80)), 8));
+}
+
+static inline __m256i fp16_simd_avx2_fp8_e5m2_to_fp16(__m128i x) {
+	return _mm256_slli_epi16(_mm256_cvtepu8_epi16(x), 8);
+}
+
+/*
+ * Convert eight single-precision numbers to an 8-bit format in the low bytes of 32-bit lanes.
+ * This is a vector transcription of fp32_to_fp8_e4m3_value and fp32_to_fp8_e5m2_value: max_nonsign is the largest
+ * input magnitude, in bit representation, that does not overflow, and overflow and nan are the results for larger
+ * magnitudes and NaN. The format parameters are compile-time constants at every call site.
+ */
+static inline __m256i fp16_simd_avx2_fp32_to_fp8_u32(__m256 f, uint32_t mantissa_bits, uint32_t bias,
+	uint32_t max_nonsign, __m256i overflow, uint32_t nan)
+{
+	const uint32_t exponent_offset = 127 - bias;
+	const int shift = (int) (23 - mantissa_bits);
+	const __m256i w = _mm256_castps_si256(f);
+	const __m256i nonsign = _mm256_and_si256(w, _mm256_set1_epi32(0x7FFFFFFF));
+	const __m256i sign = _mm256_and_si256(_mm256_srli_epi32(w, 24), _mm256_set1_epi32(0x80));
+
+	const __m256i normal_lsb = _mm256_and_si256(_mm256_srli_epi32(nonsign, shift), _mm256_set1_epi32(1));
+	const __m256i normal_value = _mm256_sub_epi32(
+		_mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(nonsign, _mm256_set1_epi32((1 << (shift - 1)) - 1)), normal_lsb), shift),
+		_mm256_set1_epi32((int) (exponent_offset << mantissa_bits)));
+
+	/* The implicit bit is set for normalized inputs, which are exactly those with nonsign >= 0x00800000 */
+	const __m256i significand = _mm256_or_si256(_mm256_and_si256(nonsign, _mm256_set1_epi32(0x007FFFFF)),
+		_mm256_and_si256(_mm256_min_epu32(nonsign, _mm256_set1_epi32(0x00800000)), _mm256_set1_epi32(0x00800000)));
+	const __m256i exponent = _mm256_max_epu32(_mm256_srli_epi32(nonsign, 23), _mm256_set1_epi32(1));
+	const __m256i denormal_shift = _mm256_min_epu32(
+		_mm256_sub_epi32(_mm256_set1_epi32((int) (151 - bias - mantissa_bits)), exponent), _mm256_set1_epi32(25));
+	const __m256i denormal_lsb = _mm256_and_si256(_mm256_srlv_epi32(significand, denormal_shift), _mm256_set1_epi32(1));
+	const __m256i denormal_half = _mm256_sub_epi32(
+		_mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_sub_epi32(denormal_shift, _mm256_set1_epi32(1))), _mm256_set1_epi32(1));
+	const __m256i denormal_value = _mm256_srlv_epi32(
+		_mm256_add_epi32(_mm256_add_epi32(significand, denormal_half), denormal_lsb), denormal_shift);
+
+	__m256i result = _mm256_blendv_epi8(normal_value, denormal_value,
+		_mm256_cmpgt_epi32(_mm256_set1_epi32((int) ((exponent_offset + 1) << 23)), nonsign));
+	result = _mm256_blendv_epi8(result, overflow, _mm256_cmpgt_epi32(nonsign, _mm256_set1_epi32((int) max_nonsign)));
+	result = _mm256_blendv_epi8(result, _mm256_set1_epi32((int) nan), _mm256_cmpgt_epi32(nonsign, _mm256_set1_epi32(0x7F800000)));
+	return _mm256_or_si256(result, sign);
+}
+
+static inline __m256i fp16_simd_avx2_fp32_to_fp8_e4m3_u32(__m256 f, __m256i overflow) {
+	return fp16_simd_avx2_fp32_to_fp8_u32(f, 3, 7, UINT32_C(0x43E80000), overflow, UINT32_C(0x7F));
+}
+
+static inline __m256i fp16_simd_avx2_fp32_to_fp8_e5m2_u32(__m256 f, __m256i overflow) {
+	return fp16_simd_avx2_fp32_to_fp8_u32(f, 2, 15, UINT32_C(0x476FFFFF), overflow, UINT32_C(0x7E));
+}
+
+/*
+ * Convert sixteen IEEE half-precision numbers to E5M2 in the low bytes of 16-bit lanes.
+ * This is a vector transcription of fp16_ieee_to_fp8_e5m2_value.
+ */
+static inline __m256i fp16_simd_avx2_fp16_to_fp8_e5m2_u16(__m256i h, __m256i overflow) {
+	const __m256i nonsign = _mm256_and_si256(h, _mm256_set1_epi16(0x7FFF));
+	const __m256i lsb = _mm256_and_si256(_mm256_srli_epi16(nonsign, 8), _mm256_set1_epi16(1));
+	__m256i result = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(nonsign, _mm256_set1_epi16(0x7F)), lsb), 8);
+	result = _mm256_blendv_epi8(result, overflow, _mm256_cmpgt_epi16(nonsign, _mm256_set1_epi16(0x7B7F)));
+	result = _mm256_blendv_epi8(result, _mm256_set1_epi16(0x7E), _mm256_cmpgt_epi16(nonsign, _mm256_set1_epi16(0x7C00)));
+	return _mm256_or_si256(result, _mm256_and_si256(_mm256_srli_epi16(h, 8), _mm256_set1_epi16(0x80)));
+}
+
+/*
+ * Narrow sixteen 16-bit lanes holding values in [0, 0xFF] to sixteen bytes.
+ */
+static inline __m128i fp16_simd_avx2_pack_u16x16(__m256i v) {
+	return _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+#endif /* FP16_SIMD_AVX2 */
+
+#if FP16_SIMD_AVX512
+/*
+ * Convert thirty-two E4M3 numbers in the bytes of a vector to IEEE half-precision in 16-bit lanes, as in
+ * fp16_simd_avx2_fp8_e4m3_to_fp16.
+ */
+static inline __m512i fp16_simd_avx512_fp8_e4m3_to_fp16(__m256i x) {
+	const __m256i denormal_table = _mm256_setr_epi8(
+		0x00, 0x18, 0x1C, 0x1E, 0x20, 0x21, 0x22, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x18, 0x1C, 0x1E, 0x20, 0x21, 0x22, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00);
+	const __m512i denormal_value = _mm512_slli_epi16(_mm512_cvtepu8_epi16(
+		_mm256_shuffle_epi8(denormal_table, _mm256_and_si256(x, _mm256_set1_epi8(0x07)))), 8);
+	const __m512i w = _mm512_cvtepu8_epi16(x);
+	const __m512i nonsign = _mm512_and_si512(w, _mm512_set1_epi16(0x7F));
+	__m512i h = _mm512_add_epi16(_mm512_slli_epi16(nonsign, 7), _mm512_set1_epi16(0x2000));
+	h = _mm512_mask_mov_epi16(h, _mm512_cmplt_epu16_mask(nonsign, _mm512_set1_epi16(0x08)), denormal_value);
+	h = _mm512_mask_mov_epi16(h, _mm512_cmpeq_epi16_mask(nonsign, _mm512_set1_epi16(0x7F)), _mm512_set1_epi16(0x7E00));
+	return _mm512_or_si512(h, _mm512_slli_epi16(_mm512_and_si512(w, _mm512_set1_epi16(0x80)), 8));
+}
+
+static inline __m512i fp16_simd_avx512_fp8_e5m2_to_fp16(__m256i x) {
+	return _mm512_slli_epi16(_mm512_cvtepu8_epi16(x), 8);
+}
+
+/*
+ * Convert sixteen single-precision numbers to an 8-bit format, as in fp16_simd_avx2_fp32_to_fp8_u32.
+ */
+static inline __m128i fp16_simd_avx512_fp32_to_fp8(__m512 f, uint32_t mantissa_bits, uint32_t bias,
+	uint32_t max_nonsign, __m512i overflow, uint32_t nan)
+{
+	const uint32_t exponent_offset = 127 - bias;
+	const unsigned int shift = 23 - mantissa_bits;
+	const __m512i w = _mm512_castps_si512(f);
+	const __m512i nonsign = _mm512_and_si512(w, _mm512_set1_epi32(0x7FFFFFFF));
+	const __m512i sign = _mm512_and_si512(_mm512_srli_epi32(w, 24), _mm512_set1_epi32(0x80));
+
+	const __m512i normal_lsb = _mm512_and_si512(_mm512_srli_epi32(nonsign, shift), _mm512_set1_epi32(1));
+	const __m512i normal_value = _mm512_sub_epi32(
+		_mm512_srli_epi32(_mm512_add_epi32(_mm512_add_epi32(nonsign, _mm512_set1_epi32((1 << (shift - 1)) - 1)), normal_lsb), shift),
+		_mm512_set1_epi32((int) (exponent_offset << mantissa_bits)));
+
+	const __m512i significand = _mm512_or_si512(_mm512_and_si512(nonsign, _mm512_set1_epi32(0x007FFFFF)),
+		_mm512_and_si512(_mm512_min_epu32(nonsign, _mm512_set1_epi32(0x00800000)), _mm512_set1_epi32(0x00800000)));
+	const __m512i exponent = _mm512_max_epu32(_mm512_srli_epi32(nonsign, 23), _mm512_set1_epi32(1));
+	const __m512i denormal_shift = _mm512_min_epu32(
+		_mm512_sub_epi32(_mm512_set1_epi32((int) (151 - bias - mantissa_bits)), exponent), _mm512_set1_epi32(25));
+	const __m512i denormal_lsb = _mm512_and_si512(_mm512_srlv_epi32(significand, denormal_shift), _mm512_set1_epi32(1));
+	const __m512i denormal_half = _mm512_sub_epi32(
+		_mm512_sllv_epi32(_mm512_set1_epi32(1), _mm512_sub_epi32(denormal_shift, _mm512_set1_epi32(1))), _mm512_set1_epi32(1));
+	const __m512i denormal_value = _mm512_srlv_epi32(
+		_mm512_add_epi32(_mm512_add_epi32(significand, denormal_half), denormal_lsb), denormal_shift);
+
+	__m512i result = _mm512_mask_mov_epi32(normal_value,
+		_mm512_cmplt_epu32_mask(nonsign, _mm512_set1_epi32((int) ((exponent_offset + 1) << 23))), denormal_value);
+	result = _mm512_mask_mov_epi32(result, _mm512_cmpgt_epu32_mask(nonsign, _mm512_set1_epi32((int) max_nonsign)), overflow);
+	result = _mm512_mask_mov_epi32(result, _mm512_cmpgt_epu32_mask(nonsign, _mm512_set1_epi32(0x7F800000)), _mm512_set1_epi32((int) nan));
+	return _mm512_cvtepi32_epi8(_mm512_or_si512(result, sign));
+}
+
+static inline __m128i fp16_simd_avx512_fp32_to_fp8_e4m3(__m512 f, __m512i overflow) {
+	return fp16_simd_avx512_fp32_to_fp8(f, 3, 7, UINT32_C(0x43E80000), overflow, UINT32_C(0x7F));
+}
+
+static inline __m128i fp16_simd_avx512_fp32_to_fp8_e5m2(__m512 f, __m512i overflow) {
+	return fp16_simd_avx512_fp32_to_fp8(f, 2, 15, UINT32_C(0x476FFFFF), overflow, UINT32_C(0x7E));
+}
+
+static inline __m256i fp16_simd_avx512_fp16_to_fp8_e5m2(__m512i h, __m512i overflow) {
+	const __m512i nonsign = _mm512_and_si512(h, _mm512_set1_epi16(0x7FFF));
+	const __m512i lsb = _mm512_and_si512(_mm512_srli_epi16(nonsign, 8), _mm512_set1_epi16(1));
+	__m512i result = _mm512_srli_epi16(_mm512_add_epi16(_mm512_add_epi16(nonsign, _mm512_set1_epi16(0x7F)), lsb), 8);
+	result = _mm512_mask_mov_epi16(result, _mm512_cmpgt_epu16_mask(nonsign, _mm512_set1_epi16(0x7B7F)), overflow);
+	result = _mm512_mask_mov_epi16(result, _mm512_cmpgt_epu16_mask(nonsign, _mm512_set1_epi16(0x7C00)), _mm512_set1_epi16(0x7E));
+	return _mm512_cvtepi16_epi8(_mm512_or_si512(result, _mm512_and_si512(_mm512_srli_epi16(h, 8), _mm512_set1_epi16(0x80))));
+}
+
+/*
+ * Mask with bits [0, n) set, for n <= 32.
+ */
+static inline __mmask32 fp16_simd_avx512_mask32(size_t n) {
+	return (__mmask32) ((UINT64_C(1) << n) - 1);
+}
+#endif /* FP16_SIMD_AVX512 */
+
+/*
+ * Convert n E4M3 numbers to single-precision.
+ */
+static inline void fp8_e4m3_to_fp32_array(const float8* input, float* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 32; n -= 32) {
+		const __m512i h = fp16_simd_avx512_fp8_e4m3_to_fp16(_mm256_loadu_si256((const __m256i*) input));
+		_mm512_storeu_ps(output, _mm512_cvtph_ps(_mm512_castsi512_si256(h)));
+		_mm512_storeu_ps(output + 16, _mm512_cvtph_ps(_mm512_extracti64x4_epi64(h, 1)));
+		input += 32;
+		output += 32;
+	}
+	const __mmask32 mask = fp16_simd_avx512_mask32(n);
+	const __m512i h = fp16_simd_avx512_fp8_e4m3_to_fp16(_mm256_maskz_loadu_epi8(mask, input));
+	_mm512_mask_storeu_ps(output, (__mmask16) mask, _mm512_cvtph_ps(_mm512_castsi512_si256(h)));
+	_mm512_mask_storeu_ps(output + 16, (__mmask16) (mask >> 16), _mm512_cvtph_ps(_mm512_extracti64x4_epi64(h, 1)));
+#elif FP16_SIMD_AVX2
+	for (; n >= 16; n -= 16) {
+		const __m256i h = fp16_simd_avx2_fp8_e4m3_to_fp16(_mm_loadu_si128((const __m128i*) input));
+		_mm256_storeu_ps(output, _mm256_cvtph_ps(_mm256_castsi256_si128(h)));
+		_mm256_storeu_ps(output + 8, _mm256_cvtph_ps(_mm256_extracti128_si256(h, 1)));
+		input += 16;
+		output += 16;
+	}
+	if (n != 0) {
+		float8 buffer[16] = { 0 };
+		memcpy(buffer, input, n);
+		const __m256i h = fp16_simd_avx2_fp8_e4m3_to_fp16(_mm_loadu_si128((const __m128i*) buffer));
+		_mm256_maskstore_ps(output, fp16_simd_avx2_mask_u32x8(n), _mm256_cvtph_ps(_mm256_castsi256_si128(h)));
+		if (n > 8) {
+			_mm256_maskstore_ps(output + 8, fp16_simd_avx2_mask_u32x8(n - 8), _mm256_cvtph_ps(_mm256_extracti128_si256(h, 1)));
+		}
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp8_e4m3_to_fp32_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n E5M2 numbers to single-precision.
+ */
+static inline void fp8_e5m2_to_fp32_array(const float8* input, float* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 32; n -= 32) {
+		const __m512i h = fp16_simd_avx512_fp8_e5m2_to_fp16(_mm256_loadu_si256((const __m256i*) input));
+		_mm512_storeu_ps(output, _mm512_cvtph_ps(_mm512_castsi512_si256(h)));
+		_mm512_storeu_ps(output + 16, _mm512_cvtph_ps(_mm512_extracti64x4_epi64(h, 1)));
+		input += 32;
+		output += 32;
+	}
+	const __mmask32 mask = fp16_simd_avx512_mask32(n);
+	const __m512i h = fp16_simd_avx512_fp8_e5m2_to_fp16(_mm256_maskz_loadu_epi8(mask, input));
+	_mm512_mask_storeu_ps(output, (__mmask16) mask, _mm512_cvtph_ps(_mm512_castsi512_si256(h)));
+	_mm512_mask_storeu_ps(output + 16, (__mmask16) (mask >> 16), _mm512_cvtph_ps(_mm512_extracti64x4_epi64(h, 1)));
+#elif FP16_SIMD_AVX2
+	for (; n >= 16; n -= 16) {
+		const __m256i h = fp16_simd_avx2_fp8_e5m2_to_fp16(_mm_loadu_si128((const __m128i*) input));
+		_mm256_storeu_ps(output, _mm256_cvtph_ps(_mm256_castsi256_si128(h)));
+		_mm256_storeu_ps(output + 8, _mm256_cvtph_ps(_mm256_extracti128_si256(h, 1)));
+		input += 16;
+		output += 16;
+	}
+	if (n != 0) {
+		float8 buffer[16] = { 0 };
+		memcpy(buffer, input, n);
+		const __m256i h = fp16_simd_avx2_fp8_e5m2_to_fp16(_mm_loadu_si128((const __m128i*) buffer));
+		_mm256_maskstore_ps(output, fp16_simd_avx2_mask_u32x8(n), _mm256_cvtph_ps(_mm256_castsi256_si128(h)));
+		if (n > 8) {
+			_mm256_maskstore_ps(output + 8, fp16_simd_avx2_mask_u32x8(n - 8), _mm256_cvtph_ps(_mm256_extracti128_si256(h, 1)));
+		}
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp8_e5m2_to_fp32_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n E4M3 numbers to IEEE half-precision.
+ */
+static inline void fp8_e4m3_to_fp16_ieee_array(const float8* input, float16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 32; n -= 32) {
+		_mm512_storeu_si512(output, fp16_simd_avx512_fp8_e4m3_to_fp16(_mm256_loadu_si256((const __m256i*) input)));
+		input += 32;
+		output += 32;
+	}
+	const __mmask32 mask = fp16_simd_avx512_mask32(n);
+	_mm512_mask_storeu_epi16(output, mask, fp16_simd_avx512_fp8_e4m3_to_fp16(_mm256_maskz_loadu_epi8(mask, input)));
+#elif FP16_SIMD_AVX2
+	for (; n >= 16; n -= 16) {
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx2_fp8_e4m3_to_fp16(_mm_loadu_si128((const __m128i*) input)));
+		input += 16;
+		output += 16;
+	}
+	if (n != 0) {
+		float8 buffer[16] = { 0 };
+		float16 result[16];
+		memcpy(buffer, input, n);
+		_mm256_storeu_si256((__m256i*) result, fp16_simd_avx2_fp8_e4m3_to_fp16(_mm_loadu_si128((const __m128i*) buffer)));
+		memcpy(output, result, n * sizeof(float16));
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp8_e4m3_to_fp16_ieee_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n E5M2 numbers to IEEE half-precision.
+ */
+static inline void fp8_e5m2_to_fp16_ieee_array(const float8* input, float16* output, size_t n) {
+#if FP16_SIMD_AVX512
+	for (; n >= 32; n -= 32) {
+		_mm512_storeu_si512(output, fp16_simd_avx512_fp8_e5m2_to_fp16(_mm256_loadu_si256((const __m256i*) input)));
+		input += 32;
+		output += 32;
+	}
+	const __mmask32 mask = fp16_simd_avx512_mask32(n);
+	_mm512_mask_storeu_epi16(output, mask, fp16_simd_avx512_fp8_e5m2_to_fp16(_mm256_maskz_loadu_epi8(mask, input)));
+#elif FP16_SIMD_AVX2
+	for (; n >= 16; n -= 16) {
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx2_fp8_e5m2_to_fp16(_mm_loadu_si128((const __m128i*) input)));
+		input += 16;
+		output += 16;
+	}
+	if (n != 0) {
+		float8 buffer[16] = { 0 };
+		float16 result[16];
+		memcpy(buffer, input, n);
+		_mm256_storeu_si256((__m256i*) result, fp16_simd_avx2_fp8_e5m2_to_fp16(_mm_loadu_si128((const __m128i*) buffer)));
+		memcpy(output, result, n * sizeof(float16));
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp8_e5m2_to_fp16_ieee_value(input[i]);
+	}
+#endif
+}
+
+/*
+ * Convert n single-precision numbers to E4M3, rounding to nearest-even.
+ */
+static inline void fp32_to_fp8_e4m3_array(const float* input, float8* output, size_t n, enum fp8_saturation saturation) {
+#if FP16_SIMD_AVX512
+	const __m512i overflow = _mm512_set1_epi32(saturation == FP8_SATURATE ? 0x7E : 0x7F);
+	for (; n >= 16; n -= 16) {
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx512_fp32_to_fp8_e4m3(_mm512_loadu_ps(input), overflow));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm_mask_storeu_epi8(output, mask, fp16_simd_avx512_fp32_to_fp8_e4m3(_mm512_maskz_loadu_ps(mask, input), overflow));
+#elif FP16_SIMD_AVX2
+	const __m256i overflow = _mm256_set1_epi32(saturation == FP8_SATURATE ? 0x7E : 0x7F);
+	for (; n >= 16; n -= 16) {
+		const __m128i lo = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e4m3_u32(_mm256_loadu_ps(input), overflow));
+		const __m128i hi = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e4m3_u32(_mm256_loadu_ps(input + 8), overflow));
+		_mm_storeu_si128((__m128i*) output, _mm_packus_epi16(lo, hi));
+		input += 16;
+		output += 16;
+	}
+	if (n != 0) {
+		float buffer[16] = { 0 };
+		float8 result[16];
+		memcpy(buffer, input, n * sizeof(float));
+		const __m128i lo = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e4m3_u32(_mm256_loadu_ps(buffer), overflow));
+		const __m128i hi = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e4m3_u32(_mm256_loadu_ps(buffer + 8), overflow));
+		_mm_storeu_si128((__m128i*) result, _mm_packus_epi16(lo, hi));
+		memcpy(output, result, n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_to_fp8_e4m3_value(input[i], saturation);
+	}
+#endif
+}
+
+/*
+ * Convert n single-precision numbers to E5M2, rounding to nearest-even.
+ */
+static inline void fp32_to_fp8_e5m2_array(const float* input, float8* output, size_t n, enum fp8_saturation saturation) {
+#if FP16_SIMD_AVX512
+	const __m512i overflow = _mm512_set1_epi32(saturation == FP8_SATURATE ? 0x7B : 0x7C);
+	for (; n >= 16; n -= 16) {
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx512_fp32_to_fp8_e5m2(_mm512_loadu_ps(input), overflow));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm_mask_storeu_epi8(output, mask, fp16_simd_avx512_fp32_to_fp8_e5m2(_mm512_maskz_loadu_ps(mask, input), overflow));
+#elif FP16_SIMD_AVX2
+	const __m256i overflow = _mm256_set1_epi32(saturation == FP8_SATURATE ? 0x7B : 0x7C);
+	for (; n >= 16; n -= 16) {
+		const __m128i lo = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e5m2_u32(_mm256_loadu_ps(input), overflow));
+		const __m128i hi = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e5m2_u32(_mm256_loadu_ps(input + 8), overflow));
+		_mm_storeu_si128((__m128i*) output, _mm_packus_epi16(lo, hi));
+		input += 16;
+		output += 16;
+	}
+	if (n != 0) {
+		float buffer[16] = { 0 };
+		float8 result[16];
+		memcpy(buffer, input, n * sizeof(float));
+		const __m128i lo = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e5m2_u32(_mm256_loadu_ps(buffer), overflow));
+		const __m128i hi = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e5m2_u32(_mm256_loadu_ps(buffer + 8), overflow));
+		_mm_storeu_si128((__m128i*) result, _mm_packus_epi16(lo, hi));
+		memcpy(output, result, n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_to_fp8_e5m2_value(input[i], saturation);
+	}
+#endif
+}
+
+/*
+ * Convert n IEEE half-precision numbers to E4M3, rounding to nearest-even.
+ */
+static inline void fp16_ieee_to_fp8_e4m3_array(const float16* input, float8* output, size_t n, enum fp8_saturation saturation) {
+#if FP16_SIMD_AVX512
+	const __m512i overflow = _mm512_set1_epi32(saturation == FP8_SATURATE ? 0x7E : 0x7F);
+	for (; n >= 16; n -= 16) {
+		const __m512 f = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) input));
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx512_fp32_to_fp8_e4m3(f, overflow));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	const __m512 f = _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(mask, input));
+	_mm_mask_storeu_epi8(output, mask, fp16_simd_avx512_fp32_to_fp8_e4m3(f, overflow));
+#elif FP16_SIMD_AVX2
+	const __m256i overflow = _mm256_set1_epi32(saturation == FP8_SATURATE ? 0x7E : 0x7F);
+	for (; n >= 16; n -= 16) {
+		const __m256 f_lo = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) input));
+		const __m256 f_hi = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (input + 8)));
+		const __m128i lo = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e4m3_u32(f_lo, overflow));
+		const __m128i hi = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e4m3_u32(f_hi, overflow));
+		_mm_storeu_si128((__m128i*) output, _mm_packus_epi16(lo, hi));
+		input += 16;
+		output += 16;
+	}
+	if (n != 0) {
+		float16 buffer[16] = { 0 };
+		float8 result[16];
+		memcpy(buffer, input, n * sizeof(float16));
+		const __m256 f_lo = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) buffer));
+		const __m256 f_hi = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (buffer + 8)));
+		const __m128i lo = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e4m3_u32(f_lo, overflow));
+		const __m128i hi = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp8_e4m3_u32(f_hi, overflow));
+		_mm_storeu_si128((__m128i*) result, _mm_packus_epi16(lo, hi));
+		memcpy(output, result, n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp16_ieee_to_fp8_e4m3_value(input[i], saturation);
+	}
+#endif
+}
+
+/*
+ * Convert n IEEE half-precision numbers to E5M2, rounding to nearest-even.
+ */
+static inline void fp16_ieee_to_fp8_e5m2_array(const float16* input, float8* output, size_t n, enum fp8_saturation saturation) {
+#if FP16_SIMD_AVX512
+	const __m512i overflow = _mm512_set1_epi16(saturation == FP8_SATURATE ? 0x7B : 0x7C);
+	for (; n >= 32; n -= 32) {
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx512_fp16_to_fp8_e5m2(_mm512_loadu_si512(input), overflow));
+		input += 32;
+		output += 32;
+	}
+	const __mmask32 mask = fp16_simd_avx512_mask32(n);
+	_mm256_mask_storeu_epi8(output, mask, fp16_simd_avx512_fp16_to_fp8_e5m2(_mm512_maskz_loadu_epi16(mask, input), overflow));
+#elif FP16_SIMD_AVX2
+	const __m256i overflow = _mm256_set1_epi16(saturation == FP8_SATURATE ? 0x7B : 0x7C);
+	for (; n >= 16; n -= 16) {
+		const __m256i h = _mm256_loadu_si256((const __m256i*) input);
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx2_pack_u16x16(fp16_simd_avx2_fp16_to_fp8_e5m2_u16(h, overflow)));
+		input += 16;
+		output += 16;
+	}
+	if (n != 0) {
+		float16 buffer[16] = { 0 };
+		float8 result[16];
+		memcpy(buffer, input, n * sizeof(float16));
+		const __m256i h = _mm256_loadu_si256((const __m256i*) buffer);
+		_mm_storeu_si128((__m128i*) result, fp16_simd_avx2_pack_u16x16(fp16_simd_avx2_fp16_to_fp8_e5m2_u16(h, overflow)));
+		memcpy(output, result, n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp16_ieee_to_fp8_e5m2_value(input[i], saturation);
+	}
+#endif
+}
+
+#endif /* FP16_FP8_H */
@@ -0,0 +1,256 @@
+#pragma once
+#ifndef FP16_HALF_H
+#define FP16_HALF_H
+
+#ifndef __cplusplus
+	#error "fp16/half.h requires a C++11 compiler"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <iosfwd>
+#include <limits>
+#include <type_traits>
+
+#include "fp16.h"
+#include "fp64.h"
+
+/*
+ * A half-precision value type for C++ code: fp16::half wraps the IEEE half-precision bits of a float16 and is
+ * trivially copyable, with the size and alignment of uint16_t, so arrays of float16 and fp16::half have the same
+ * layout.
+ *
+ * Arithmetic promotes to single-precision: fp16::half converts implicitly (and exactly) to float, and the built-in
+ * operators of float do the rest, so the type of an expression with half operands is float (or double, if an operand
+ * is double) and its intermediate results are never rounded to half-precision. The only rounding to half-precision
+ * happens when the result is assigned to, or used to construct, a half:
+ *
+ *   fp16::half y = a * x + b;   one rounding to half-precision, where a wrapper that converts on every operator
+ *                               rounds twice and keeps the compiler from fusing or vectorizing the float operations
+ *
+ * Conversions to half round to nearest even: float with fp32_ieee_to_fp16_value, double with fp64_ieee_to_fp16_value
+ * (a single rounding), and integers exactly through float. The Conversion parameter selects whether they are implicit:
+ *
+ *   fp16::half          (basic_half<fp16::implicit_conversion>)  half h = 0.1f; h = x * y;
+ *   fp16::strict_half   (basic_half<fp16::explicit_conversion>)  strict_half h(0.1f); h = strict_half(x * y);
+ *
+ * Conversions between the two types keep the bits. Compound assignments (+=, -=, *=, /=), increments and decrements
+ * compute in the promoted type and round once, for both. Negation and unary plus are exact and return a half.
+ * Comparisons compare the promoted values, so +0 == -0 and NaN compares unequal to everything; std::hash is
+ * consistent with that.
+ */
+namespace fp16 {
+
+struct implicit_conversion {};
+struct explicit_conversion {};
+
+template <typename Conversion>
+class basic_half {
+	struct bits_tag {};
+
+	constexpr basic_half(float16 bits, bits_tag) : data(bits) {}
+
+	static float16 encode(float value) {
+		return fp32_ieee_to_fp16_value(value);
+	}
+
+	static float16 encode(double value) {
+		return fp64_ieee_to_fp16_value(value);
+	}
+
+	/* Long double goes through double: only numbers within 2**-1000 of a double-precision midpoint round twice */
+	static float16 encode(long double value) {
+		return fp64_ieee_to_fp16_value((double) value);
+	}
+
+	/* Integers that do not overflow half-precision are exact in single-precision */
+	template <typename T>
+	static typename std::enable_if<std::is_integral<T>::value, float16>::type encode(T value) {
+		return fp32_ieee_to_fp16_value((float) value);
+	}
+
+	template <typename T>
+	struct is_implicit : std::integral_constant<bool,
+		std::is_arithmetic<T>::value && std::is_same<Conversion, implicit_conversion>::value> {};
+
+	template <typename T>
+	struct is_explicit : std::integral_constant<bool,
+		std::is_arithmetic<T>::value && !std::is_same<Conversion, implicit_conversion>::value> {};
+
+public:
+	/* Uninitialized, like float; value-initialization (basic_half()) gives +0 */
+	basic_half() = default;
+
+	template <typename T, typename std::enable_if<is_implicit<T>::value, int>::type = 0>
+	basic_half(T value) : data(encode(value)) {}
+
+	template <typename T, typename std::enable_if<is_explicit<T>::value, int>::type = 0>
+	explicit basic_half(T value) : data(encode(value)) {}
+
+	template <typename OtherConversion>
+	constexpr basic_half(basic_half<OtherConversion> other) : data(other.to_bits()) {}
+
+	/*
+	 * Reinterpret IEEE half-precision bits as a half, and back.
+	 */
+	static constexpr basic_half from_bits(float16 bits) {
+		return basic_half(bits, bits_tag());
+	}
+
+	constexpr float16 to_bits() const {
+		return data;
+	}
+
+	operator float() const {
+		return fp16_ieee_to_fp32_value(data);
+	}
+
+	constexpr basic_half operator+() const {
+		return *this;
+	}
+
+	constexpr basic_half operator-() const {
+		return from_bits((float16) (data ^ UINT16_C(0x8000)));
+	}
+
+	template <typename T>
+	basic_half& operator+=(const T& other) {
+		data = encode(static_cast<float>(*this) + other);
+		return *this;
+	}
+
+	template <typename T>
+	basic_half& operator-=(const T& other) {
+		data = encode(static_cast<float>(*this) - other);
+		return *this;
+	}
+
+	template <typename T>
+	basic_half& operator*=(const T& other) {
+		data = encode(static_cast<float>(*this) * other);
+		return *this;
+	}
+
+	template <typename T>
+	basic_half& operator/=(const T& other) {
+		data = encode(static_cast<float>(*this) / other);
+		return *this;
+	}
+
+	basic_half& operator++() {
+		return *this += 1.0f;
+	}
+
+	basic_half& operator--() {
+		return *this -= 1.0f;
+	}
+
+	basic_half operator++(int) {
+		const basic_half old = *this;
+		*this += 1.0f;
+		return old;
+	}
+
+	basic_half operator--(int) {
+		const basic_half old = *this;
+		*this -= 1.0f;
+		return old;
+	}
+
+private:
+	float16 data;
+};
+
+typedef basic_half<implicit_conversion> half;
+typedef basic_half<explicit_conversion> strict_half;
+
+template <typename Conversion, typename CharT, typename Traits>
+std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& stream, basic_half<Conversion> h) {
+	return stream << static_cast<float>(h);
+}
+
+} /* namespace fp16 */
+
+namespace std {
+
+template <typename Conversion>
+class numeric_limits<fp16::basic_half<Conversion>> {
+	typedef fp16::basic_half<Conversion> half;
+
+public:
+	static constexpr bool is_specialized = true;
+	static constexpr bool is_signed = true;
+	static constexpr bool is_integer = false;
+	static constexpr bool is_exact = false;
+	static constexpr bool has_infinity = true;
+	static constexpr bool has_quiet_NaN = true;
+	static constexpr bool has_signaling_NaN = true;
+	static constexpr float_denorm_style has_denorm = denorm_present;
+	static constexpr bool has_denorm_loss = false;
+	static constexpr float_round_style round_style = round_to_nearest;
+	static constexpr bool is_iec559 = true;
+	static constexpr bool is_bounded = true;
+	static constexpr bool is_modulo = false;
+	static constexpr int digits = 11;
+	static constexpr int digits10 = 3;
+	static constexpr int max_digits10 = 5;
+	static constexpr int radix = 2;
+	static constexpr int min_exponent = -13;
+	static constexpr int min_exponent10 = -4;
+	static constexpr int max_exponent = 16;
+	static constexpr int max_exponent10 = 4;
+	static constexpr bool traps = false;
+	static constexpr bool tinyness_before = false;
+
+	static constexpr half min() noexcept { return half::from_bits(UINT16_C(0x0400)); }
+	static constexpr half lowest() noexcept { return half::from_bits(UINT16_C(0xFBFF)); }
+	static constexpr half max() noexcept { return half::from_bits(UINT16_C(0x7BFF)); }
+	static constexpr half epsilon() noexcept { return half::from_bits(UINT16_C(0x1400)); }
+	static constexpr half round_error() noexcept { return half::from_bits(UINT16_C(0x3800)); }
+	static constexpr half infinity() noexcept { return half::from_bits(UINT16_C(0x7C00)); }
+	static constexpr half quiet_NaN() noexcept { return half::from_bits(UINT16_C(0x7E00)); }
+	static constexpr half signaling_NaN() noexcept { return half::from_bits(UINT16_C(0x7D00)); }
+	static constexpr half denorm_min() noexcept { return half::from_bits(UINT16_C(0x0001)); }
+};
+
+/* Definitions for ODR-uses before C++17, where static constexpr data members become inline */
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::is_specialized;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::is_signed;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::is_integer;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::is_exact;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::has_infinity;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::has_quiet_NaN;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::has_signaling_NaN;
+template <typename C> constexpr float_denorm_style numeric_limits<fp16::basic_half<C>>::has_denorm;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::has_denorm_loss;
+template <typename C> constexpr float_round_style numeric_limits<fp16::basic_half<C>>::round_style;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::is_iec559;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::is_bounded;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::is_modulo;
+template <typename C> constexpr int numeric_limits<fp16::basic_half<C>>::digits;
+template <typename C> constexpr int numeric_limits<fp16::basic_half<C>>::digits10;
+template <typename C> constexpr int numeric_limits<fp16::basic_half<C>>::max_digits10;
+template <typename C> constexpr int numeric_limits<fp16::basic_half<C>>::radix;
+template <typename C> constexpr int numeric_limits<fp16::basic_half<C>>::min_exponent;
+template <typename C> constexpr int numeric_limits<fp16::basic_half<C>>::min_exponent10;
+template <typename C> constexpr int numeric_limits<fp16::basic_half<C>>::max_exponent;
+template <typename C> constexpr int numeric_limits<fp16::basic_half<C>>::max_exponent10;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::traps;
+template <typename C> constexpr bool numeric_limits<fp16::basic_half<C>>::tinyness_before;
+
+/*
+ * Hash of the value: +0 and -0 compare equal and hash the same.
+ */
+template <typename Conversion>
+struct hash<fp16::basic_half<Conversion>> {
+	size_t operator()(fp16::basic_half<Conversion> h) const noexcept {
+		const float16 bits = h.to_bits();
+		return hash<uint16_t>()(bits == UINT16_C(0x8000) ? UINT16_C(0) : bits);
+	}
+};
+
+} /* namespace std */
+
+#endif /* FP16_HALF_H */
@@ -0,0 +1,598 @@
+#pragma once
+#ifndef FP16_MINIFLOAT_H
+#define FP16_MINIFLOAT_H
+
+#ifndef __cplusplus
+	#error "fp16/minifloat.h requires a C++11 compiler"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <type_traits>
+
+#include <fp16/bitcasts.h>
+#include <fp16/simd.h>
+#include <fp16/array.h>
+
+/*
+ * Compile-time generated conversions between IEEE single-precision and small binary floating-point formats with
+ * a sign bit, ExponentBits exponent bits, MantissaBits mantissa bits and an arbitrary exponent bias:
+ *
+ *   minifloat<5, 10>                             IEEE half-precision, same results as fp32_ieee_to_fp16_value etc.
+ *   minifloat<5, 10, 15, MINIFLOAT_FINITE>       ARM alternative half-precision, same results as fp32_alt_to_fp16_value
+ *   minifloat<8, 10>                             TF32
+ *   minifloat<7, 16>                             fp24 (1-7-16, bias 63)
+ *   minifloat<4, 3, 7, MINIFLOAT_NAN_ONLY>       OCP FP8 E4M3, same results as fp32_to_fp8_e4m3_value without saturation
+ *   minifloat<5, 6>                              a 12-bit format with the exponent range of IEEE half-precision
+ *
+ * Numbers are stored in the low bits of the smallest of uint8_t, uint16_t and uint32_t that holds them.
+ * Conversions from single-precision round to nearest even.
+ *
+ * Formats with fewer than 8 exponent bits use the same floating-point tricks as fp16.h, with all shifts, masks and
+ * magic numbers derived from the template parameters, so for the half-precision instantiations the compiler sees the
+ * same operations as in fp16_ieee_to_fp32_value, fp32_ieee_to_fp16_value, fp16_alt_to_fp32_value and
+ * fp32_alt_to_fp16_value. Formats with 8 exponent bits and bias 127 (bfloat16, TF32) are truncated single-precision
+ * numbers and use integer rounding as in bf16.h. The array functions use AVX2 or AVX-512 transcriptions of the scalar
+ * conversions when fp16/simd.h selects them, except for IEEE half-precision, which has F16C instructions and uses the
+ * fp16/array.h kernels (NaN payloads are then kept as described there).
+ */
+enum minifloat_specials {
+	/* The largest exponent encodes infinities and NaNs; overflow produces infinity. */
+	MINIFLOAT_IEEE = 0,
+	/* Only the all-ones code (with either sign) is NaN and there are no infinities; overflow produces NaN. */
+	MINIFLOAT_NAN_ONLY = 1,
+	/* All codes are finite; overflow, infinities and NaN saturate to the largest finite number of the same sign. */
+	MINIFLOAT_FINITE = 2,
+};
+
+template <unsigned Bits>
+struct minifloat_storage {
+	typedef typename std::conditional<(Bits <= 8), uint8_t,
+		typename std::conditional<(Bits <= 16), uint16_t, uint32_t>::type>::type type;
+};
+
+/*
+ * 2**k as a single-precision number. Only meaningful for k in [-126, 127].
+ */
+static inline float minifloat_exp2(int k) {
+	return fp32b_to_fp32v((uint32_t) (127 + k) << 23);
+}
+
+/*
+ * The smallest integer not less than minimum which is congruent to value modulo modulus.
+ */
+static constexpr int minifloat_congruent(int value, int modulus, int minimum) {
+	return minimum + ((value - minimum) % modulus + modulus) % modulus;
+}
+
+#if FP16_SIMD_AVX2
+/*
+ * Load eight consecutive elements, zero-extended into 32-bit lanes.
+ */
+static inline __m256i fp16_simd_avx2_load_widen_u32x8(const uint8_t* p) {
+	return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) p));
+}
+
+static inline __m256i fp16_simd_avx2_load_widen_u32x8(const uint16_t* p) {
+	return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) p));
+}
+
+static inline __m256i fp16_simd_avx2_load_widen_u32x8(const uint32_t* p) {
+	return _mm256_loadu_si256((const __m256i*) p);
+}
+
+/*
+ * Store the 32-bit lanes of a vector as eight consecutive elements. The lanes must fit in the element type.
+ */
+static inline void fp16_simd_avx2_store_narrow_u32x8(uint8_t* p, __m256i v) {
+	const __m128i h = fp16_simd_avx2_pack_u32x8(v);
+	_mm_storel_epi64((__m128i*) p, _mm_packus_epi16(h, h));
+}
+
+static inline void fp16_simd_avx2_store_narrow_u32x8(uint16_t* p, __m256i v) {
+	_mm_storeu_si128((__m128i*) p, fp16_simd_avx2_pack_u32x8(v));
+}
+
+static inline void fp16_simd_avx2_store_narrow_u32x8(uint32_t* p, __m256i v) {
+	_mm256_storeu_si256((__m256i*) p, v);
+}
+#endif /* FP16_SIMD_AVX2 */
+
+#if FP16_SIMD_AVX512
+/*
+ * Load the elements selected by mask out of sixteen consecutive elements, zero-extended into 32-bit lanes.
+ * Unselected lanes are zero and their memory is not accessed.
+ */
+static inline __m512i fp16_simd_avx512_load_widen_u32x16(const uint8_t* p, __mmask16 mask) {
+	return _mm512_cvtepu8_epi32(_mm_maskz_loadu_epi8(mask, p));
+}
+
+static inline __m512i fp16_simd_avx512_load_widen_u32x16(const uint16_t* p, __mmask16 mask) {
+	return _mm512_cvtepu16_epi32(_mm256_maskz_loadu_epi16(mask, p));
+}
+
+static inline __m512i fp16_simd_avx512_load_widen_u32x16(const uint32_t* p, __mmask16 mask) {
+	return _mm512_maskz_loadu_epi32(mask, p);
+}
+
+/*
+ * Store the 32-bit lanes selected by mask, truncated to the element type.
+ */
+static inline void fp16_simd_avx512_store_narrow_u32x16(uint8_t* p, __mmask16 mask, __m512i v) {
+	_mm512_mask_cvtepi32_storeu_epi8(p, mask, v);
+}
+
+static inline void fp16_simd_avx512_store_narrow_u32x16(uint16_t* p, __mmask16 mask, __m512i v) {
+	_mm512_mask_cvtepi32_storeu_epi16(p, mask, v);
+}
+
+static inline void fp16_simd_avx512_store_narrow_u32x16(uint32_t* p, __mmask16 mask, __m512i v) {
+	_mm512_mask_storeu_epi32(p, mask, v);
+}
+#endif /* FP16_SIMD_AVX512 */
+
+/*
+ * Scalar and vector conversions for formats with 2-7 exponent bits, generalized from fp16.h.
+ */
+template <unsigned ExponentBits, unsigned MantissaBits, int Bias, minifloat_specials Specials, bool Fp32Prefix>
+struct minifloat_codec {
+	static_assert(ExponentBits >= 2 && ExponentBits <= 7,
+		"minifloat supports 2-7 exponent bits, or 8 exponent bits with bias 127 and IEEE special values");
+	static_assert(MantissaBits >= 1 && MantissaBits <= 21, "minifloat supports 1-21 mantissa bits");
+	static_assert(Bias >= 1 && Bias + (int) MantissaBits <= 126,
+		"minifloat denormals must be normal single-precision numbers");
+
+	static constexpr unsigned bits = 1 + ExponentBits + MantissaBits;
+	typedef typename minifloat_storage<bits>::type storage;
+
+	static constexpr uint32_t nonsign_mask = (UINT32_C(1) << (ExponentBits + MantissaBits)) - 1;
+	static constexpr uint32_t exponent_mask = ((UINT32_C(1) << ExponentBits) - 1) << MantissaBits;
+	/* Largest finite number and the NaN produced by conversions, without the sign bit */
+	static constexpr uint32_t max_nonsign = Specials == MINIFLOAT_IEEE ? exponent_mask - 1 :
+		Specials == MINIFLOAT_NAN_ONLY ? nonsign_mask - 1 : nonsign_mask;
+	static constexpr uint32_t nan_nonsign = Specials == MINIFLOAT_IEEE ? exponent_mask | (UINT32_C(1) << (MantissaBits - 1)) :
+		Specials == MINIFLOAT_NAN_ONLY ? nonsign_mask : max_nonsign;
+
+	/* Unbiased exponents of the largest finite numbers and of the smallest normal numbers */
+	static constexpr int max_exponent = (int) (max_nonsign >> MantissaBits) - Bias;
+	static constexpr int min_exponent = 1 - Bias;
+	/* Largest finite number as a single-precision number, in bit representation */
+	static constexpr uint32_t max_fp32 = ((uint32_t) (max_exponent + 127) << 23) |
+		((max_nonsign & ((UINT32_C(1) << MantissaBits) - 1)) << (23 - MantissaBits));
+
+	/*
+	 * Decoding (see fp16_ieee_to_fp32_value): the exponent field of a normal number is adjusted by exp_offset and the
+	 * result multiplied by 2**exp_scale. With IEEE special values exp_offset maps the largest exponent to 0xFF, otherwise
+	 * it is the bias difference and no multiplication is needed. Denormal numbers are built as a single-precision number
+	 * with biased exponent denormal_exponent, where a unit of the mantissa has the value of the smallest denormal.
+	 */
+	static constexpr int exp_offset = Specials == MINIFLOAT_IEEE ? 256 - (1 << ExponentBits) : 127 - Bias;
+	static constexpr int exp_scale = 127 - Bias - exp_offset;
+	static constexpr int denormal_exponent = 151 - Bias - (int) MantissaBits;
+
+	/*
+	 * Encoding (see fp32_ieee_to_fp16_value): the input, scaled by 2**round_scale, is added to 2**(e + round_offset),
+	 * where e is the input exponent clamped to min_exponent. The addition rounds the input to MantissaBits bits, and
+	 * round_offset is chosen so that the low ExponentBits bits of the exponent of the sum, plus the leading bit of the
+	 * input, are the biased exponent of the result.
+	 */
+	static constexpr int round_offset = minifloat_congruent(Bias - 128, 1 << ExponentBits, 23 - (int) MantissaBits);
+	static constexpr int round_scale = round_offset - 23 + (int) MantissaBits;
+	static constexpr uint32_t shl1_bias_min = (uint32_t) (min_exponent + 127) << 24;
+	/* Inputs above this value, shifted left by 1, overflow with MINIFLOAT_NAN_ONLY (ties round to the even max_nonsign) */
+	static constexpr uint32_t shl1_overflow = (max_fp32 + (UINT32_C(1) << (22 - MantissaBits))) << 1;
+
+	static_assert(denormal_exponent >= 1 && denormal_exponent <= 254, "minifloat denormal magic number out of range");
+	static_assert(Specials == MINIFLOAT_IEEE ? exp_scale >= -126 && exp_scale <= 127 :
+		(1 << ExponentBits) - 1 + exp_offset <= 254, "minifloat exponent range exceeds single-precision");
+	static_assert(min_exponent + round_offset + 127 >= 1 && max_exponent + round_offset + 127 <= 254,
+		"minifloat rounding magic number out of range");
+	static_assert(Specials == MINIFLOAT_IEEE ?
+		round_scale - 127 + max_exponent >= -126 && 127 - max_exponent <= 127 :
+		max_exponent + 127 + round_scale <= 254, "minifloat rounding scale out of range");
+
+	/*
+	 * Convert a number in bit representation to a single-precision number in bit representation, without any
+	 * floating-point operations (see fp16_ieee_to_fp32_bits). NaN payloads are preserved.
+	 */
+	static inline uint32_t to_fp32_bits(storage x) {
+		const uint32_t w = (uint32_t) x << (32 - bits);
+		const uint32_t sign = w & UINT32_C(0x80000000);
+		const uint32_t nonsign = w & UINT32_C(0x7FFFFFFF);
+#ifdef _MSC_VER
+		unsigned long nonsign_bsr;
+		_BitScanReverse(&nonsign_bsr, (unsigned long) nonsign);
+		uint32_t renorm_shift = (uint32_t) nonsign_bsr ^ 31;
+#else
+		uint32_t renorm_shift = __builtin_clz(nonsign);
+#endif
+		renorm_shift = renorm_shift > ExponentBits ? renorm_shift - ExponentBits : 0;
+		const int32_t inf_nan_mask = Specials == MINIFLOAT_IEEE ?
+			((int32_t) (nonsign + (UINT32_C(1) << (31 - ExponentBits))) >> 8) & INT32_C(0x7F800000) : 0;
+		const int32_t zero_mask = (int32_t) (nonsign - 1) >> 31;
+		const uint32_t result = sign | ((((nonsign << renorm_shift >> (8 - ExponentBits)) +
+			((uint32_t) (127 - Bias - (int) renorm_shift) << 23)) | inf_nan_mask) & ~zero_mask);
+		if (Specials == MINIFLOAT_NAN_ONLY) {
+			return (nonsign >> (31 - ExponentBits - MantissaBits)) == nonsign_mask ? sign | UINT32_C(0x7FC00000) : result;
+		}
+		return result;
+	}
+
+	/*
+	 * Convert a number in bit representation to a single-precision number (see fp16_ieee_to_fp32_value).
+	 */
+	static inline float to_fp32_value(storage x) {
+		const uint32_t w = (uint32_t) x << (32 - bits);
+		const uint32_t sign = w & UINT32_C(0x80000000);
+		const uint32_t two_w = w + w;
+
+		const float normalized_bits_value = fp32b_to_fp32v((two_w >> (9 - ExponentBits)) + ((uint32_t) exp_offset << 23));
+		const float normalized_value = Specials == MINIFLOAT_IEEE ?
+			normalized_bits_value * minifloat_exp2(exp_scale) : normalized_bits_value;
+
+		const uint32_t magic_mask = (uint32_t) denormal_exponent << 23;
+		const float magic_bias = minifloat_exp2(denormal_exponent - 127);
+		const float denormalized_value =
+			fp32b_to_fp32v((two_w >> (32 - ExponentBits - MantissaBits)) | magic_mask) - magic_bias;
+
+		const uint32_t denormalized_cutoff = UINT32_C(1) << (32 - ExponentBits);
+		uint32_t result = sign |
+			(two_w < denormalized_cutoff ? fp32v_to_fp32b(denormalized_value) : fp32v_to_fp32b(normalized_value));
+		if (Specials == MINIFLOAT_NAN_ONLY) {
+			const uint32_t nan_code = nonsign_mask;
+			result = (two_w >> (32 - ExponentBits - MantissaBits)) == nan_code ? sign | UINT32_C(0x7FC00000) : result;
+		}
+		return fp32b_to_fp32v(result);
+	}
+
+	/*
+	 * Convert a single-precision number to bit representation, rounding to nearest even. With MINIFLOAT_IEEE this is
+	 * fp32_ieee_to_fp16_value, otherwise fp32_alt_to_fp16_value followed by the NaN selection of MINIFLOAT_NAN_ONLY.
+	 */
+	static inline storage from_fp32_value(float f) {
+		const uint32_t w = fp32v_to_fp32b(f);
+		const uint32_t shl1_w = w + w;
+		const uint32_t sign = w & UINT32_C(0x80000000);
+
+		uint32_t bits_value;
+		if (Specials == MINIFLOAT_IEEE) {
+			const float scale_to_inf = minifloat_exp2(127 - max_exponent);
+			const float scale_to_zero = minifloat_exp2(round_scale - 127 + max_exponent);
+#if defined(_MSC_VER) && defined(_M_IX86_FP) && (_M_IX86_FP == 0) || defined(__GNUC__) && defined(__FLT_EVAL_METHOD__) && (__FLT_EVAL_METHOD__ != 0)
+			const volatile float saturated_f = fabsf(f) * scale_to_inf;
+#else
+			const float saturated_f = fabsf(f) * scale_to_inf;
+#endif
+			float base = saturated_f * scale_to_zero;
+
+			uint32_t bias = shl1_w & UINT32_C(0xFF000000);
+			if (bias < shl1_bias_min) {
+				bias = shl1_bias_min;
+			}
+			base = fp32b_to_fp32v((bias >> 1) + ((uint32_t) round_offset << 23)) + base;
+			bits_value = fp32v_to_fp32b(base);
+		} else {
+			const uint32_t shl1_max = max_fp32 << 1;
+			const uint32_t shl1_base = shl1_w > shl1_max ? shl1_max : shl1_w;
+			uint32_t shl1_bias = shl1_base & UINT32_C(0xFF000000);
+			if (shl1_bias < shl1_bias_min) {
+				shl1_bias = shl1_bias_min;
+			}
+			const float bias = fp32b_to_fp32v((shl1_bias >> 1) + ((uint32_t) round_offset << 23));
+			const float base = fp32b_to_fp32v((shl1_base >> 1) + ((uint32_t) round_scale << 23)) + bias;
+			bits_value = fp32v_to_fp32b(base);
+		}
+
+		const uint32_t exp_bits = (bits_value >> (23 - MantissaBits)) & exponent_mask;
+		const uint32_t mantissa_bits = bits_value & ((UINT32_C(1) << (MantissaBits + 2)) - 1);
+		uint32_t nonsign = exp_bits + mantissa_bits;
+		if (Specials == MINIFLOAT_IEEE) {
+			nonsign = shl1_w > UINT32_C(0xFF000000) ? (uint32_t) nan_nonsign : nonsign;
+		} else if (Specials == MINIFLOAT_NAN_ONLY) {
+			nonsign = shl1_w > shl1_overflow ? (uint32_t) nan_nonsign : nonsign;
+		}
+		return (storage) ((sign >> (32 - bits)) | nonsign);
+	}
+
+#if FP16_SIMD_AVX2
+	/*
+	 * Vector transcriptions of to_fp32_value and from_fp32_value for numbers in 32-bit lanes.
+	 */
+	static inline __m256 to_fp32_avx2(__m256i x) {
+		const __m256i w = _mm256_slli_epi32(x, 32 - bits);
+		const __m256i sign = _mm256_and_si256(w, _mm256_set1_epi32((int) UINT32_C(0x80000000)));
+		const __m256i two_w = _mm256_add_epi32(w, w);
+
+		__m256 normalized_value = _mm256_castsi256_ps(
+			_mm256_add_epi32(_mm256_srli_epi32(two_w, 9 - ExponentBits), _mm256_set1_epi32(exp_offset << 23)));
+		if (Specials == MINIFLOAT_IEEE) {
+			normalized_value = _mm256_mul_ps(normalized_value, _mm256_set1_ps(minifloat_exp2(exp_scale)));
+		}
+		const __m256i code = _mm256_srli_epi32(two_w, 32 - ExponentBits - MantissaBits);
+		const __m256 denormalized_value = _mm256_sub_ps(
+			_mm256_castsi256_ps(_mm256_or_si256(code, _mm256_set1_epi32(denormal_exponent << 23))),
+			_mm256_set1_ps(minifloat_exp2(denormal_exponent - 127)));
+
+		const __m256i denormalized_mask = _mm256_cmpeq_epi32(_mm256_srli_epi32(two_w, 32 - ExponentBits), _mm256_setzero_si256());
+		__m256i nonsign = _mm256_blendv_epi8(_mm256_castps_si256(normalized_value), _mm256_castps_si256(denormalized_value),
+			denormalized_mask);
+		if (Specials == MINIFLOAT_NAN_ONLY) {
+			nonsign = _mm256_blendv_epi8(nonsign, _mm256_set1_epi32(0x7FC00000),
+				_mm256_cmpeq_epi32(code, _mm256_set1_epi32((int) nonsign_mask)));
+		}
+		return _mm256_castsi256_ps(_mm256_or_si256(sign, nonsign));
+	}
+
+	static inline __m256i from_fp32_avx2(__m256 f) {
+		const __m256i w = _mm256_castps_si256(f);
+		const __m256i sign = _mm256_and_si256(w, _mm256_set1_epi32((int) UINT32_C(0x80000000)));
+		const __m256i shl1_w = _mm256_add_epi32(w, w);
+
+		__m256 base;
+		if (Specials == MINIFLOAT_IEEE) {
+			const __m256 abs_f = _mm256_castsi256_ps(_mm256_srli_epi32(shl1_w, 1));
+			base = _mm256_mul_ps(_mm256_mul_ps(abs_f, _mm256_set1_ps(minifloat_exp2(127 - max_exponent))),
+				_mm256_set1_ps(minifloat_exp2(round_scale - 127 + max_exponent)));
+			const __m256i bias = _mm256_max_epu32(_mm256_and_si256(shl1_w, _mm256_set1_epi32((int) UINT32_C(0xFF000000))),
+				_mm256_set1_epi32((int) shl1_bias_min));
+			base = _mm256_add_ps(
+				_mm256_castsi256_ps(_mm256_add_epi32(_mm256_srli_epi32(bias, 1), _mm256_set1_epi32(round_offset << 23))), base);
+		} else {
+			const __m256i shl1_base = _mm256_min_epu32(shl1_w, _mm256_set1_epi32((int) (max_fp32 << 1)));
+			const __m256i shl1_bias = _mm256_max_epu32(
+				_mm256_and_si256(shl1_base, _mm256_set1_epi32((int) UINT32_C(0xFF000000))),
+				_mm256_set1_epi32((int) shl1_bias_min));
+			const __m256 bias = _mm256_castsi256_ps(
+				_mm256_add_epi32(_mm256_srli_epi32(shl1_bias, 1), _mm256_set1_epi32(round_offset << 23)));
+			base = _mm256_add_ps(_mm256_castsi256_ps(
+				_mm256_add_epi32(_mm256_srli_epi32(shl1_base, 1), _mm256_set1_epi32(round_scale << 23))), bias);
+		}
+
+		const __m256i base_bits = _mm256_castps_si256(base);
+		const __m256i exp_bits = _mm256_and_si256(_mm256_srli_epi32(base_bits, 23 - MantissaBits),
+			_mm256_set1_epi32((int) exponent_mask));
+		const __m256i mantissa_bits = _mm256_and_si256(base_bits, _mm256_set1_epi32((1 << (MantissaBits + 2)) - 1));
+		__m256i nonsign = _mm256_add_epi32(exp_bits, mantissa_bits);
+		if (Specials != MINIFLOAT_FINITE) {
+			const uint32_t shl1_nan_min = (Specials == MINIFLOAT_IEEE ? UINT32_C(0xFF000000) : shl1_overflow) + 1;
+			const __m256i nan_mask = _mm256_cmpeq_epi32(_mm256_max_epu32(shl1_w, _mm256_set1_epi32((int) shl1_nan_min)), shl1_w);
+			nonsign = _mm256_blendv_epi8(nonsign, _mm256_set1_epi32((int) nan_nonsign), nan_mask);
+		}
+		return _mm256_or_si256(_mm256_srli_epi32(sign, 32 - bits), nonsign);
+	}
+#endif /* FP16_SIMD_AVX2 */
+
+#if FP16_SIMD_AVX512
+	static inline __m512 to_fp32_avx512(__m512i x) {
+		const __m512i w = _mm512_slli_epi32(x, 32 - bits);
+		const __m512i sign = _mm512_and_si512(w, _mm512_set1_epi32((int) UINT32_C(0x80000000)));
+		const __m512i two_w = _mm512_add_epi32(w, w);
+
+		__m512 normalized_value = _mm512_castsi512_ps(
+			_mm512_add_epi32(_mm512_srli_epi32(two_w, 9 - ExponentBits), _mm512_set1_epi32(exp_offset << 23)));
+		if (Specials == MINIFLOAT_IEEE) {
+			normalized_value = _mm512_mul_ps(normalized_value, _mm512_set1_ps(minifloat_exp2(exp_scale)));
+		}
+		const __m512i code = _mm512_srli_epi32(two_w, 32 - ExponentBits - MantissaBits);
+		const __m512 denormalized_value = _mm512_sub_ps(
+			_mm512_castsi512_ps(_mm512_or_si512(code, _mm512_set1_epi32(denormal_exponent << 23))),
+			_mm512_set1_ps(minifloat_exp2(denormal_exponent - 127)));
+
+		const __mmask16 denormalized_mask = _mm512_cmplt_epu32_mask(two_w, _mm512_set1_epi32(1 << (32 - ExponentBits)));
+		__m512i nonsign = _mm512_mask_blend_epi32(denormalized_mask, _mm512_castps_si512(normalized_value),
+			_mm512_castps_si512(denormalized_value));
+		if (Specials == MINIFLOAT_NAN_ONLY) {
+			nonsign = _mm512_mask_mov_epi32(nonsign, _mm512_cmpeq_epi32_mask(code, _mm512_set1_epi32((int) nonsign_mask)),
+				_mm512_set1_epi32(0x7FC00000));
+		}
+		return _mm512_castsi512_ps(_mm512_or_si512(sign, nonsign));
+	}
+
+	static inline __m512i from_fp32_avx512(__m512 f) {
+		const __m512i w = _mm512_castps_si512(f);
+		const __m512i sign = _mm512_and_si512(w, _mm512_set1_epi32((int) UINT32_C(0x80000000)));
+		const __m512i shl1_w = _mm512_add_epi32(w, w);
+
+		__m512 base;
+		if (Specials == MINIFLOAT_IEEE) {
+			const __m512 abs_f = _mm512_castsi512_ps(_mm512_srli_epi32(shl1_w, 1));
+			base = _mm512_mul_ps(_mm512_mul_ps(abs_f, _mm512_set1_ps(minifloat_exp2(127 - max_exponent))),
+				_mm512_set1_ps(minifloat_exp2(round_scale - 127 + max_exponent)));
+			const __m512i bias = _mm512_max_epu32(_mm512_and_si512(shl1_w, _mm512_set1_epi32((int) UINT32_C(0xFF000000))),
+				_mm512_set1_epi32((int) shl1_bias_min));
+			base = _mm512_add_ps(
+				_mm512_castsi512_ps(_mm512_add_epi32(_mm512_srli_epi32(bias, 1), _mm512_set1_epi32(round_offset << 23))), base);
+		} else {
+			const __m512i shl1_base = _mm512_min_epu32(shl1_w, _mm512_set1_epi32((int) (max_fp32 << 1)));
+			const __m512i shl1_bias = _mm512_max_epu32(
+				_mm512_and_si512(shl1_base, _mm512_set1_epi32((int) UINT32_C(0xFF000000))),
+				_mm512_set1_epi32((int) shl1_bias_min));
+			const __m512 bias = _mm512_castsi512_ps(
+				_mm512_add_epi32(_mm512_srli_epi32(shl1_bias, 1), _mm512_set1_epi32(round_offset << 23)));
+			base = _mm512_add_ps(_mm512_castsi512_ps(
+				_mm512_add_epi32(_mm512_srli_epi32(shl1_base, 1), _mm512_set1_epi32(round_scale << 23))), bias);
+		}
+
+		const __m512i base_bits = _mm512_castps_si512(base);
+		const __m512i exp_bits = _mm512_and_si512(_mm512_srli_epi32(base_bits, 23 - MantissaBits),
+			_mm512_set1_epi32((int) exponent_mask));
+		const __m512i mantissa_bits = _mm512_and_si512(base_bits, _mm512_set1_epi32((1 << (MantissaBits + 2)) - 1));
+		__m512i nonsign = _mm512_add_epi32(exp_bits, mantissa_bits);
+		if (Specials != MINIFLOAT_FINITE) {
+			const uint32_t shl1_nan_threshold = Specials == MINIFLOAT_IEEE ? UINT32_C(0xFF000000) : shl1_overflow;
+			nonsign = _mm512_mask_mov_epi32(nonsign, _mm512_cmpgt_epu32_mask(shl1_w, _mm512_set1_epi32((int) shl1_nan_threshold)),
+				_mm512_set1_epi32((int) nan_nonsign));
+		}
+		return _mm512_or_si512(_mm512_srli_epi32(sign, 32 - bits), nonsign);
+	}
+#endif /* FP16_SIMD_AVX512 */
+};
+
+/*
+ * Formats with 8 exponent bits and bias 127 are single-precision numbers with the low mantissa bits removed.
+ */
+template <unsigned MantissaBits>
+struct minifloat_codec<8, MantissaBits, 127, MINIFLOAT_IEEE, true> {
+	static_assert(MantissaBits >= 1 && MantissaBits <= 22, "minifloat supports 1-22 mantissa bits");
+
+	static constexpr unsigned bits = 9 + MantissaBits;
+	typedef typename minifloat_storage<bits>::type storage;
+
+	static constexpr unsigned shift = 23 - MantissaBits;
+
+	static inline uint32_t to_fp32_bits(storage x) {
+		return (uint32_t) x << shift;
+	}
+
+	static inline float to_fp32_value(storage x) {
+		return fp32b_to_fp32v((uint32_t) x << shift);
+	}
+
+	/*
+	 * Round to nearest even as in fp32_to_bf16_value: finite numbers carry into infinity, NaNs are quieted.
+	 */
+	static inline storage from_fp32_value(float f) {
+		const uint32_t w = fp32v_to_fp32b(f);
+		if ((w & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000)) {
+			return (storage) ((w >> shift) | (UINT32_C(1) << (MantissaBits - 1)));
+		}
+		return (storage) ((w + ((UINT32_C(1) << (shift - 1)) - 1) + ((w >> shift) & UINT32_C(1))) >> shift);
+	}
+
+#if FP16_SIMD_AVX2
+	static inline __m256 to_fp32_avx2(__m256i x) {
+		return _mm256_castsi256_ps(_mm256_slli_epi32(x, shift));
+	}
+
+	static inline __m256i from_fp32_avx2(__m256 f) {
+		const __m256i w = _mm256_castps_si256(f);
+		const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(w, shift), _mm256_set1_epi32(1));
+		const __m256i rounded = _mm256_srli_epi32(
+			_mm256_add_epi32(_mm256_add_epi32(w, _mm256_set1_epi32((1 << (shift - 1)) - 1)), lsb), shift);
+		const __m256i quiet_nan = _mm256_or_si256(_mm256_srli_epi32(w, shift), _mm256_set1_epi32(1 << (MantissaBits - 1)));
+		const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+		return _mm256_blendv_epi8(rounded, quiet_nan, nan);
+	}
+#endif /* FP16_SIMD_AVX2 */
+
+#if FP16_SIMD_AVX512
+	static inline __m512 to_fp32_avx512(__m512i x) {
+		return _mm512_castsi512_ps(_mm512_slli_epi32(x, shift));
+	}
+
+	static inline __m512i from_fp32_avx512(__m512 f) {
+		const __m512i w = _mm512_castps_si512(f);
+		const __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(w, shift), _mm512_set1_epi32(1));
+		const __m512i rounded = _mm512_srli_epi32(
+			_mm512_add_epi32(_mm512_add_epi32(w, _mm512_set1_epi32((1 << (shift - 1)) - 1)), lsb), shift);
+		const __m512i quiet_nan = _mm512_or_si512(_mm512_srli_epi32(w, shift), _mm512_set1_epi32(1 << (MantissaBits - 1)));
+		return _mm512_mask_mov_epi32(rounded, _mm512_cmp_ps_mask(f, f, _CMP_UNORD_Q), quiet_nan);
+	}
+#endif /* FP16_SIMD_AVX512 */
+};
+
+template <unsigned ExponentBits, unsigned MantissaBits, int Bias = (1 << (ExponentBits - 1)) - 1,
+	minifloat_specials Specials = MINIFLOAT_IEEE>
+struct minifloat : minifloat_codec<ExponentBits, MantissaBits, Bias, Specials,
+	ExponentBits == 8 && Bias == 127 && Specials == MINIFLOAT_IEEE>
+{
+	typedef minifloat_codec<ExponentBits, MantissaBits, Bias, Specials,
+		ExponentBits == 8 && Bias == 127 && Specials == MINIFLOAT_IEEE> codec;
+	typedef typename codec::storage storage;
+
+	static constexpr unsigned exponent_bits = ExponentBits;
+	static constexpr unsigned mantissa_bits = MantissaBits;
+	static constexpr int bias = Bias;
+	static constexpr minifloat_specials specials = Specials;
+	static constexpr bool is_fp16_ieee = ExponentBits == 5 && MantissaBits == 10 && Bias == 15 && Specials == MINIFLOAT_IEEE;
+
+	/*
+	 * Convert n numbers to single-precision.
+	 */
+	static inline void to_fp32_array(const storage* input, float* output, size_t n) {
+#if FP16_SIMD_AVX2
+		if (is_fp16_ieee) {
+			fp16_ieee_to_fp32_array((const uint16_t*) input, output, n);
+			return;
+		}
+#endif
+#if FP16_SIMD_AVX512
+		for (; n >= 16; n -= 16) {
+			_mm512_storeu_ps(output, codec::to_fp32_avx512(fp16_simd_avx512_load_widen_u32x16(input, (__mmask16) 0xFFFF)));
+			input += 16;
+			output += 16;
+		}
+		if (n != 0) {
+			const __mmask16 mask = fp16_simd_avx512_mask16(n);
+			_mm512_mask_storeu_ps(output, mask, codec::to_fp32_avx512(fp16_simd_avx512_load_widen_u32x16(input, mask)));
+		}
+#elif FP16_SIMD_AVX2
+		for (; n >= 8; n -= 8) {
+			_mm256_storeu_ps(output, codec::to_fp32_avx2(fp16_simd_avx2_load_widen_u32x8(input)));
+			input += 8;
+			output += 8;
+		}
+		if (n != 0) {
+			storage buffer[8] = { 0 };
+			memcpy(buffer, input, n * sizeof(storage));
+			_mm256_maskstore_ps(output, fp16_simd_avx2_mask_u32x8(n), codec::to_fp32_avx2(fp16_simd_avx2_load_widen_u32x8(buffer)));
+		}
+#else
+		for (size_t i = 0; i < n; i++) {
+			output[i] = codec::to_fp32_value(input[i]);
+		}
+#endif
+	}
+
+	/*
+	 * Convert n single-precision numbers, rounding to nearest even.
+	 */
+	static inline void from_fp32_array(const float* input, storage* output, size_t n) {
+#if FP16_SIMD_AVX2
+		if (is_fp16_ieee) {
+			fp32_ieee_to_fp16_array(input, (uint16_t*) output, n);
+			return;
+		}
+#endif
+#if FP16_SIMD_AVX512
+		for (; n >= 16; n -= 16) {
+			fp16_simd_avx512_store_narrow_u32x16(output, (__mmask16) 0xFFFF, codec::from_fp32_avx512(_mm512_loadu_ps(input)));
+			input += 16;
+			output += 16;
+		}
+		if (n != 0) {
+			const __mmask16 mask = fp16_simd_avx512_mask16(n);
+			fp16_simd_avx512_store_narrow_u32x16(output, mask, codec::from_fp32_avx512(_mm512_maskz_loadu_ps(mask, input)));
+		}
+#elif FP16_SIMD_AVX2
+		for (; n >= 8; n -= 8) {
+			fp16_simd_avx2_store_narrow_u32x8(output, codec::from_fp32_avx2(_mm256_loadu_ps(input)));
+			input += 8;
+			output += 8;
+		}
+		if (n != 0) {
+			storage buffer[8];
+			fp16_simd_avx2_store_narrow_u32x8(buffer,
+				codec::from_fp32_avx2(_mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n))));
+			memcpy(output, buffer, n * sizeof(storage));
+		}
+#else
+		for (size_t i = 0; i < n; i++) {
+			output[i] = codec::from_fp32_value(input[i]);
+		}
+#endif
+	}
+};
+
+typedef minifloat<5, 10> minifloat_fp16_ieee;
+typedef minifloat<5, 10, 15, MINIFLOAT_FINITE> minifloat_fp16_alt;
+typedef minifloat<8, 7> minifloat_bf16;
+typedef minifloat<8, 10> minifloat_tf32;
+typedef minifloat<7, 16> minifloat_fp24;
+typedef minifloat<4, 3, 7, MINIFLOAT_NAN_ONLY> minifloat_fp8_e4m3;
+typedef minifloat<5, 2> minifloat_fp8_e5m2;
+
+#endif /* FP16_MINIFLOAT_H */
@@ -0,0 +1,948 @@
+#pragma once
+#ifndef FP16_NPY_H
+#define FP16_NPY_H
+
+#ifndef __cplusplus
+	#error "fp16/npy.h requires a C++11 compiler"
+#endif
+#if defined(_WIN32)
+	#error "fp16/npy.h requires POSIX memory mapping"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "fp16.h"
+#include "array.h"
+#include "range.h"
+
+/*
+ * Memory-mapped NumPy .npy files and stored (uncompressed) .npz archives of float16 and float32 arrays.
+ *
+ *   fp16::npz_file checkpoint("weights.npz");
+ *   const fp16::npy_array w = checkpoint["layer0.weight"];
+ *   const uint16_t* w16 = w.fp16_data();                 // zero-copy view of the mapped file
+ *   for (float x : w.fp32()) { ... }                      // lazily decoded, 16 elements at a time
+ *   w.decode(begin, count, buffer);                       // bulk decode of a slice with the array kernels
+ *
+ *   fp16::npz_writer out("weights16.npz");
+ *   out.add("layer0.weight", fp32_weights, { 4096, 4096 }, fp16::npy_dtype::float16);   // encoded while written
+ *   out.close();
+ *
+ * Opening a file maps it and parses the headers only, and an .npz archive parses only its central directory at the
+ * end of the file and the headers of the members that are looked up: pages of array data are read from disk when they
+ * are first touched, so a model starts loading without reading the whole file. The advice given to the constructor
+ * (npy_advice::sequential by default for .npy files, npy_advice::normal for .npz archives) is passed to madvise for
+ * the whole mapping; npy_array::advise applies MADV_SEQUENTIAL, MADV_RANDOM or MADV_WILLNEED to the pages of one
+ * array or slice, e.g. to start reading the next tensor while the current one is decoded.
+ *
+ * Arrays must be little-endian float16 ('<f2') or float32 ('<f4'), in C or Fortran order. Members of .npz archives
+ * must be stored without compression, as written by numpy.savez (numpy.savez_compressed is not supported); Zip64
+ * archives are supported. npy_array views point into the mapping and must not outlive the file object. The .npy files
+ * that fp16::npy_save and fp16::npz_writer write have their data aligned to 64 bytes, within .npz archives too.
+ *
+ * Malformed files throw std::runtime_error, and failed system calls std::system_error with their errno.
+ */
+namespace fp16 {
+
+enum class npy_dtype {
+	float16,
+	float32,
+};
+
+enum class npy_advice {
+	normal,
+	sequential,
+	random,
+	willneed,
+};
+
+static inline size_t npy_dtype_size(npy_dtype dtype) {
+	return dtype == npy_dtype::float16 ? sizeof(float16) : sizeof(float);
+}
+
+static inline std::system_error npy_system_error(const std::string& operation) {
+	return std::system_error(errno, std::generic_category(), "fp16::npy: " + operation);
+}
+
+static inline std::runtime_error npy_format_error(const std::string& message) {
+	return std::runtime_error("fp16::npy: " + message);
+}
+
+static inline uint16_t npy_load_le16(const unsigned char* p) {
+	return (uint16_t) (p[0] | p[1] << 8);
+}
+
+static inline uint32_t npy_load_le32(const unsigned char* p) {
+	return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static inline uint64_t npy_load_le64(const unsigned char* p) {
+	return (uint64_t) npy_load_le32(p) | (uint64_t) npy_load_le32(p + 4) << 32;
+}
+
+static inline void npy_store_le16(unsigned char* p, uint16_t value) {
+	p[0] = (unsigned char) value;
+	p[1] = (unsigned char) (value >> 8);
+}
+
+static inline void npy_store_le32(unsigned char* p, uint32_t value) {
+	npy_store_le16(p, (uint16_t) value);
+	npy_store_le16(p + 2, (uint16_t) (value >> 16));
+}
+
+static inline void npy_store_le64(unsigned char* p, uint64_t value) {
+	npy_store_le32(p, (uint32_t) value);
+	npy_store_le32(p + 4, (uint32_t) (value >> 32));
+}
+
+static inline int npy_madvise_flag(npy_advice advice) {
+	switch (advice) {
+		case npy_advice::sequential: return MADV_SEQUENTIAL;
+		case npy_advice::random: return MADV_RANDOM;
+		case npy_advice::willneed: return MADV_WILLNEED;
+		default: return MADV_NORMAL;
+	}
+}
+
+/* Advise the kernel about the pages that hold [data, data + size); advice is a hint, so errors are ignored */
+static inline void npy_advise(const void* data, size_t size, npy_advice advice) {
+	if (size == 0) {
+		return;
+	}
+	const uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+	const uintptr_t begin = (uintptr_t) data / page * page;
+	const uintptr_t end = ((uintptr_t) data + size + page - 1) / page * page;
+	madvise((void*) begin, (size_t) (end - begin), npy_madvise_flag(advice));
+}
+
+/* The header of a .npy file: dtype, order and shape of the array, and the offset of its data */
+struct npy_header {
+	npy_dtype dtype;
+	bool fortran_order;
+	std::vector<size_t> shape;
+	size_t data_offset;
+};
+
+/* Value of a key of the header dictionary, e.g. "'<f2'" for 'descr', with leading spaces skipped */
+static inline size_t npy_find_key(const std::string& header, const char* key) {
+	const std::string quoted[2] = { std::string("'") + key + "'", std::string("\"") + key + "\"" };
+	for (const std::string& q : quoted) {
+		size_t position = header.find(q);
+		if (position != std::string::npos) {
+			position = header.find(':', position + q.size());
+			if (position == std::string::npos) {
+				break;
+			}
+			position++;
+			while (position < header.size() && header[position] == ' ') {
+				position++;
+			}
+			return position;
+		}
+	}
+	throw npy_format_error(std::string("header has no '") + key + "'");
+}
+
+/* Parse the magic string, version and header dictionary at the start of a .npy file of `size` bytes */
+static inline npy_header npy_parse_header(const void* data, size_t size) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	if (size < 10 || memcmp(bytes, "\x93NUMPY", 6) != 0) {
+		throw npy_format_error("not a .npy file");
+	}
+	const unsigned major = bytes[6];
+	size_t header_length, header_begin;
+	if (major == 1) {
+		header_length = npy_load_le16(bytes + 8);
+		header_begin = 10;
+	} else if (major == 2 || major == 3) {
+		if (size < 12) {
+			throw npy_format_error("truncated header");
+		}
+		header_length = npy_load_le32(bytes + 8);
+		header_begin = 12;
+	} else {
+		throw npy_format_error("unsupported .npy version " + std::to_string(major));
+	}
+	if (header_length > size - header_begin) {
+		throw npy_format_error("truncated header");
+	}
+	const std::string header(reinterpret_cast<const char*>(bytes + header_begin), header_length);
+
+	npy_header result;
+	result.data_offset = header_begin + header_length;
+
+	size_t position = npy_find_key(header, "descr");
+	const char quote = position < header.size() ? header[position] : '\0';
+	const size_t descr_end = header.find(quote, position + 1);
+	if ((quote != '\'' && quote != '"') || descr_end == std::string::npos) {
+		throw npy_format_error("malformed 'descr'");
+	}
+	const std::string descr = header.substr(position + 1, descr_end - position - 1);
+	if (descr == "<f2") {
+		result.dtype = npy_dtype::float16;
+	} else if (descr == "<f4") {
+		result.dtype = npy_dtype::float32;
+	} else {
+		throw npy_format_error("unsupported dtype '" + descr + "', expected '<f2' or '<f4'");
+	}
+
+	position = npy_find_key(header, "fortran_order");
+	if (header.compare(position, 4, "True") == 0) {
+		result.fortran_order = true;
+	} else if (header.compare(position, 5, "False") == 0) {
+		result.fortran_order = false;
+	} else {
+		throw npy_format_error("malformed 'fortran_order'");
+	}
+
+	position = npy_find_key(header, "shape");
+	if (position >= header.size() || header[position] != '(') {
+		throw npy_format_error("malformed 'shape'");
+	}
+	position++;
+	for (;;) {
+		while (position < header.size() && (header[position] == ' ' || header[position] == ',')) {
+			position++;
+		}
+		if (position >= header.size()) {
+			throw npy_format_error("malformed 'shape'");
+		}
+		if (header[position] == ')') {
+			break;
+		}
+		if (header[position] < '0' || header[position] > '9') {
+			throw npy_format_error("malformed 'shape'");
+		}
+		size_t dimension = 0;
+		while (position < header.size() && header[position] >= '0' && header[position] <= '9') {
+			const size_t digit = (size_t) (header[position++] - '0');
+			if (dimension > (SIZE_MAX - digit) / 10) {
+				throw npy_format_error("'shape' overflows");
+			}
+			dimension = dimension * 10 + digit;
+		}
+		/* Python 2 writers append L to long integers */
+		if (position < header.size() && header[position] == 'L') {
+			position++;
+		}
+		result.shape.push_back(dimension);
+	}
+	return result;
+}
+
+static inline size_t npy_shape_size(const std::vector<size_t>& shape) {
+	size_t size = 1;
+	for (size_t dimension : shape) {
+		if (dimension != 0 && size > SIZE_MAX / dimension) {
+			throw npy_format_error("'shape' overflows");
+		}
+		size *= dimension;
+	}
+	return size;
+}
+
+/*
+ * The magic string, version and header dictionary of a .npy file, padded with spaces so that the data that follows
+ * starts at a multiple of 64 bytes from the start of the file, as numpy writes it.
+ */
+static inline std::string npy_format_header(npy_dtype dtype, const std::vector<size_t>& shape, bool fortran_order = false) {
+	/* numpy spells shapes as "()", "(5,)" and "(3, 4)" */
+	std::string shape_text = "(";
+	for (size_t i = 0; i < shape.size(); i++) {
+		shape_text += (i == 0 ? "" : ", ") + std::to_string(shape[i]);
+	}
+	shape_text += shape.size() == 1 ? ",)" : ")";
+	std::string dictionary = std::string("{'descr': '") + (dtype == npy_dtype::float16 ? "<f2" : "<f4") +
+		"', 'fortran_order': " + (fortran_order ? "True" : "False") + ", 'shape': " + shape_text + ", }";
+
+	const bool version2 = dictionary.size() + 1 + 10 > 65535;
+	const size_t prefix = version2 ? 12 : 10;
+	const size_t total = (prefix + dictionary.size() + 1 + 63) / 64 * 64;
+	dictionary.append(total - prefix - dictionary.size() - 1, ' ');
+	dictionary += '\n';
+
+	std::string result("\x93NUMPY", 6);
+	result += (char) (version2 ? 2 : 1);
+	result += (char) 0;
+	unsigned char length[4];
+	npy_store_le32(length, (uint32_t) dictionary.size());
+	result.append(reinterpret_cast<const char*>(length), version2 ? 4 : 2);
+	return result + dictionary;
+}
+
+/* A float16 or float32 array in a mapped file */
+class npy_array {
+public:
+	npy_array() : data_(nullptr), dtype_(npy_dtype::float32), fortran_order_(false), size_(0) {}
+
+	npy_array(const unsigned char* data, const npy_header& header) :
+		data_(data),
+		dtype_(header.dtype),
+		fortran_order_(header.fortran_order),
+		shape_(header.shape),
+		size_(npy_shape_size(header.shape))
+	{
+	}
+
+	npy_dtype dtype() const {
+		return dtype_;
+	}
+
+	bool fortran_order() const {
+		return fortran_order_;
+	}
+
+	const std::vector<size_t>& shape() const {
+		return shape_;
+	}
+
+	/* Number of elements */
+	size_t size() const {
+		return size_;
+	}
+
+	size_t bytes() const {
+		return size_ * npy_dtype_size(dtype_);
+	}
+
+	const void* data() const {
+		return data_;
+	}
+
+	/* Whether the data is aligned to its element size, as the .npy files of numpy are; members of .npz archives
+	 * written by other tools may not be */
+	bool aligned() const {
+		return (uintptr_t) data_ % npy_dtype_size(dtype_) == 0;
+	}
+
+	/* Zero-copy views of the data */
+	const float16* fp16_data() const {
+		if (dtype_ != npy_dtype::float16) {
+			throw std::logic_error("fp16::npy_array: not a float16 array");
+		}
+		return reinterpret_cast<const float16*>(data_);
+	}
+
+	const float* fp32_data() const {
+		if (dtype_ != npy_dtype::float32) {
+			throw std::logic_error("fp16::npy_array: not a float32 array");
+		}
+		return reinterpret_cast<const float*>(data_);
+	}
+
+	/* Lazily decoded single-precision view of a float16 array (see fp16/range.h) */
+	fp32_range fp32() const {
+		return fp32_range(fp16_data(), size_);
+	}
+
+	/* Decode elements [begin, begin + count) of either dtype to single precision, with the bulk array kernels */
+	void decode(size_t begin, size_t count, float* output) const {
+		if (begin > size_ || count > size_ - begin) {
+			throw std::out_of_range("fp16::npy_array: decoded range out of bounds");
+		}
+		if (dtype_ == npy_dtype::float16) {
+			fp16_ieee_to_fp32_array(reinterpret_cast<const float16*>(data_) + begin, output, count);
+		} else {
+			memcpy(output, reinterpret_cast<const float*>(data_) + begin, count * sizeof(float));
+		}
+	}
+
+	std::vector<float> to_fp32() const {
+		std::vector<float> result(size_);
+		decode(0, size_, result.data());
+		return result;
+	}
+
+	/* Advise the kernel about the pages of elements [begin, begin + count) */
+	void advise(npy_advice advice, size_t begin = 0, size_t count = SIZE_MAX) const {
+		begin = std::min(begin, size_);
+		count = std::min(count, size_ - begin);
+		const size_t element = npy_dtype_size(dtype_);
+		npy_advise(data_ + begin * element, count * element, advice);
+	}
+
+private:
+	const unsigned char* data_;
+	npy_dtype dtype_;
+	bool fortran_order_;
+	std::vector<size_t> shape_;
+	size_t size_;
+};
+
+/* A read-only mapping of a whole file */
+class npy_mapping {
+public:
+	npy_mapping(const char* path, npy_advice advice) : data_(nullptr), size_(0) {
+		const int fd = open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			throw npy_system_error(std::string("open ") + path);
+		}
+		struct stat file_stat;
+		if (fstat(fd, &file_stat) != 0) {
+			const int error = errno;
+			close(fd);
+			errno = error;
+			throw npy_system_error(std::string("fstat ") + path);
+		}
+		size_ = (size_t) file_stat.st_size;
+		if (size_ != 0) {
+			void* data = mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+			if (data == MAP_FAILED) {
+				const int error = errno;
+				close(fd);
+				errno = error;
+				throw npy_system_error(std::string("mmap ") + path);
+			}
+			data_ = static_cast<const unsigned char*>(data);
+			npy_advise(data_, size_, advice);
+		}
+		close(fd);
+	}
+
+	npy_mapping(const npy_mapping&) = delete;
+	npy_mapping& operator=(const npy_mapping&) = delete;
+
+	~npy_mapping() {
+		if (data_ != nullptr) {
+			munmap(const_cast<unsigned char*>(data_), size_);
+		}
+	}
+
+	const unsigned char* data() const {
+		return data_;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+private:
+	const unsigned char* data_;
+	size_t size_;
+};
+
+/* Parse the .npy file at [data, data + size) and check that its array fits */
+static inline npy_array npy_map_array(const unsigned char* data, size_t size) {
+	const npy_header header = npy_parse_header(data, size);
+	const npy_array array(data + header.data_offset, header);
+	if (array.size() > (size - header.data_offset) / npy_dtype_size(array.dtype())) {
+		throw npy_format_error("array data is truncated");
+	}
+	return array;
+}
+
+class npy_file {
+public:
+	explicit npy_file(const char* path, npy_advice advice = npy_advice::sequential) :
+		mapping_(path, advice),
+		array_(npy_map_array(mapping_.data(), mapping_.size()))
+	{
+	}
+
+	const npy_array& array() const {
+		return array_;
+	}
+
+	size_t file_size() const {
+		return mapping_.size();
+	}
+
+private:
+	npy_mapping mapping_;
+	npy_array array_;
+};
+
+class npz_file {
+public:
+	explicit npz_file(const char* path, npy_advice advice = npy_advice::normal) : mapping_(path, advice) {
+		const unsigned char* data = mapping_.data();
+		const size_t size = mapping_.size();
+
+		/* The end of central directory record is the last 22 bytes, before an archive comment of up to 64 KiB */
+		if (size < 22) {
+			throw npy_format_error("not a .npz file");
+		}
+		size_t eocd = size - 22;
+		while (npy_load_le32(data + eocd) != 0x06054B50) {
+			if (eocd == 0 || size - eocd > 22 + 65535) {
+				throw npy_format_error("not a .npz file");
+			}
+			eocd--;
+		}
+		uint64_t entries = npy_load_le16(data + eocd + 10);
+		uint64_t directory_size = npy_load_le32(data + eocd + 12);
+		uint64_t directory_offset = npy_load_le32(data + eocd + 16);
+		if (entries == 0xFFFF || directory_size == 0xFFFFFFFF || directory_offset == 0xFFFFFFFF) {
+			/* Zip64: the locator precedes the end of central directory record and points to the Zip64 record */
+			if (eocd < 20 || npy_load_le32(data + eocd - 20) != 0x07064B50) {
+				throw npy_format_error("missing Zip64 end of central directory locator");
+			}
+			const uint64_t record = npy_load_le64(data + eocd - 20 + 8);
+			if (record > size - 56 || npy_load_le32(data + record) != 0x06064B50) {
+				throw npy_format_error("malformed Zip64 end of central directory record");
+			}
+			entries = npy_load_le64(data + record + 32);
+			directory_size = npy_load_le64(data + record + 40);
+			directory_offset = npy_load_le64(data + record + 48);
+		}
+		if (directory_offset > size || directory_size > size - directory_offset) {
+			throw npy_format_error("central directory out of bounds");
+		}
+
+		size_t position = (size_t) directory_offset;
+		const size_t directory_end = (size_t) (directory_offset + directory_size);
+		for (uint64_t i = 0; i < entries; i++) {
+			if (directory_end - position < 46 || npy_load_le32(data + position) != 0x02014B50) {
+				throw npy_format_error("malformed central directory");
+			}
+			const unsigned char* entry = data + position;
+			const uint16_t flags = npy_load_le16(entry + 8);
+			const uint16_t method = npy_load_le16(entry + 10);
+			uint64_t compressed_size = npy_load_le32(entry + 20);
+			uint64_t uncompressed_size = npy_load_le32(entry + 24);
+			const size_t name_length = npy_load_le16(entry + 28);
+			const size_t extra_length = npy_load_le16(entry + 30);
+			const size_t comment_length = npy_load_le16(entry + 32);
+			uint64_t local_offset = npy_load_le32(entry + 42);
+			if (directory_end - position - 46 < name_length + extra_length + comment_length) {
+				throw npy_format_error("malformed central directory");
+			}
+			std::string name(reinterpret_cast<const char*>(entry + 46), name_length);
+
+			/* The Zip64 extra field holds the sizes and offset that do not fit into 32 bits, in this order */
+			const unsigned char* extra = entry + 46 + name_length;
+			for (size_t e = 0; e + 4 <= extra_length;) {
+				const uint16_t id = npy_load_le16(extra + e);
+				const size_t length = npy_load_le16(extra + e + 2);
+				if (e + 4 + length > extra_length) {
+					break;
+				}
+				if (id == 0x0001) {
+					const unsigned char* field = extra + e + 4;
+					const unsigned char* field_end = field + length;
+					if (uncompressed_size == 0xFFFFFFFF && field + 8 <= field_end) {
+						uncompressed_size = npy_load_le64(field);
+						field += 8;
+					}
+					if (compressed_size == 0xFFFFFFFF && field + 8 <= field_end) {
+						compressed_size = npy_load_le64(field);
+						field += 8;
+					}
+					if (local_offset == 0xFFFFFFFF && field + 8 <= field_end) {
+						local_offset = npy_load_le64(field);
+					}
+				}
+				e += 4 + length;
+			}
+			position += 46 + name_length + extra_length + comment_length;
+
+			if (local_offset > size - 30 || compressed_size > size) {
+				throw npy_format_error("member '" + name + "' out of bounds");
+			}
+			member m;
+			m.stored = method == 0 && (flags & 0x1) == 0 && compressed_size == uncompressed_size;
+			m.local_offset = (size_t) local_offset;
+			m.size = (size_t) compressed_size;
+			/* numpy.savez stores array "x" as "x.npy" */
+			if (name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0) {
+				name.resize(name.size() - 4);
+			}
+			names_.push_back(name);
+			members_[name] = m;
+		}
+	}
+
+	/* Names of the arrays, in archive order */
+	const std::vector<std::string>& names() const {
+		return names_;
+	}
+
+	size_t size() const {
+		return names_.size();
+	}
+
+	bool contains(const std::string& name) const {
+		return members_.count(name) != 0;
+	}
+
+	/* The array of a member; its local header and .npy header are parsed on every call */
+	npy_array operator[](const std::string& name) const {
+		const std::map<std::string, member>::const_iterator it = members_.find(name);
+		if (it == members_.end()) {
+			throw std::out_of_range("fp16::npz_file: no array '" + name + "'");
+		}
+		const member& m = it->second;
+		if (!m.stored) {
+			throw npy_format_error("array '" + name + "' is compressed; only stored .npz archives are supported");
+		}
+		const unsigned char* data = mapping_.data();
+		const size_t size = mapping_.size();
+		if (npy_load_le32(data + m.local_offset) != 0x04034B50) {
+			throw npy_format_error("malformed local header of '" + name + "'");
+		}
+		const size_t data_offset = m.local_offset + 30 + npy_load_le16(data + m.local_offset + 26) +
+			npy_load_le16(data + m.local_offset + 28);
+		if (data_offset > size || m.size > size - data_offset) {
+			throw npy_format_error("member '" + name + "' out of bounds");
+		}
+		return npy_map_array(data + data_offset, m.size);
+	}
+
+	size_t file_size() const {
+		return mapping_.size();
+	}
+
+private:
+	struct member {
+		bool stored;
+		size_t local_offset;
+		size_t size;
+	};
+
+	npy_mapping mapping_;
+	std::vector<std::string> names_;
+	std::map<std::string, member> members_;
+};
+
+/* CRC-32 of the Zip format (reflected polynomial 0xEDB88320), slicing by 8 bytes */
+static inline uint32_t npy_crc32(uint32_t crc, const void* data, size_t size) {
+	struct tables {
+		tables() {
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t c = i;
+				for (int k = 0; k < 8; k++) {
+					c = (c & 1) != 0 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				}
+				t[0][i] = c;
+			}
+			for (uint32_t i = 0; i < 256; i++) {
+				for (int k = 1; k < 8; k++) {
+					t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+				}
+			}
+		}
+		uint32_t t[8][256];
+	};
+	static const tables table;
+
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	crc = ~crc;
+	for (; size >= 8; size -= 8, bytes += 8) {
+		const uint32_t low = crc ^ npy_load_le32(bytes);
+		const uint32_t high = npy_load_le32(bytes + 4);
+		crc = table.t[7][low & 0xFF] ^ table.t[6][(low >> 8) & 0xFF] ^ table.t[5][(low >> 16) & 0xFF] ^ table.t[4][low >> 24] ^
+			table.t[3][high & 0xFF] ^ table.t[2][(high >> 8) & 0xFF] ^ table.t[1][(high >> 16) & 0xFF] ^ table.t[0][high >> 24];
+	}
+	for (; size != 0; size--, bytes++) {
+		crc = table.t[0][(crc ^ *bytes) & 0xFF] ^ (crc >> 8);
+	}
+	return ~crc;
+}
+
+/* Sequential writer of raw bytes that keeps the CRC-32 and the offset of what it wrote */
+class npy_output {
+public:
+	npy_output(const char* path, bool checksum) : file_(fopen(path, "wb")), checksum_(checksum), offset_(0), crc_(0) {
+		if (file_ == NULL) {
+			throw npy_system_error(std::string("open ") + path);
+		}
+	}
+
+	npy_output(const npy_output&) = delete;
+	npy_output& operator=(const npy_output&) = delete;
+
+	~npy_output() {
+		if (file_ != NULL) {
+			fclose(file_);
+		}
+	}
+
+	uint64_t offset() const {
+		return offset_;
+	}
+
+	uint32_t crc() const {
+		return crc_;
+	}
+
+	void reset_crc() {
+		crc_ = 0;
+	}
+
+	void write(const void* data, size_t size) {
+		if (size != 0 && fwrite(data, 1, size, file_) != size) {
+			throw npy_system_error("write");
+		}
+		if (checksum_) {
+			crc_ = npy_crc32(crc_, data, size);
+		}
+		offset_ += size;
+	}
+
+	/* Overwrite bytes written earlier, e.g. a CRC in a header, and continue at the end */
+	void patch(uint64_t offset, const void* data, size_t size) {
+		if (fseeko(file_, (off_t) offset, SEEK_SET) != 0 || fwrite(data, 1, size, file_) != size ||
+			fseeko(file_, (off_t) offset_, SEEK_SET) != 0)
+		{
+			throw npy_system_error("write");
+		}
+	}
+
+	void close() {
+		FILE* file = file_;
+		file_ = NULL;
+		if (fclose(file) != 0) {
+			throw npy_system_error("close");
+		}
+	}
+
+	/* Write n elements of float16 or float32 data, given as float16 or float, as `dtype` */
+	template <typename T>
+	void write_array(const T* data, size_t n, npy_dtype dtype) {
+		const bool source_fp16 = sizeof(T) == sizeof(float16);
+		if (source_fp16 == (dtype == npy_dtype::float16)) {
+			write(data, n * sizeof(T));
+			return;
+		}
+		/* Convert through a buffer that stays in L1 */
+		const size_t block = 4096;
+		unsigned char buffer[block * sizeof(float)];
+		for (size_t i = 0; i < n; i += block) {
+			const size_t count = std::min(block, n - i);
+			if (source_fp16) {
+				fp16_ieee_to_fp32_array(reinterpret_cast<const float16*>(data) + i, reinterpret_cast<float*>(buffer), count);
+				write(buffer, count * sizeof(float));
+			} else {
+				fp32_ieee_to_fp16_array(reinterpret_cast<const float*>(data) + i, reinterpret_cast<float16*>(buffer), count);
+				write(buffer, count * sizeof(float16));
+			}
+		}
+	}
+
+private:
+	FILE* file_;
+	const bool checksum_;
+	uint64_t offset_;
+	uint32_t crc_;
+};
+
+/* Write a .npy file; float data is encoded to half precision while written if dtype is npy_dtype::float16 */
+static inline void npy_save(const char* path, const float16* data, const std::vector<size_t>& shape,
+	npy_dtype dtype = npy_dtype::float16)
+{
+	npy_output output(path, false);
+	const std::string header = npy_format_header(dtype, shape);
+	output.write(header.data(), header.size());
+	output.write_array(data, npy_shape_size(shape), dtype);
+	output.close();
+}
+
+static inline void npy_save(const char* path, const float* data, const std::vector<size_t>& shape,
+	npy_dtype dtype = npy_dtype::float32)
+{
+	npy_output output(path, false);
+	const std::string header = npy_format_header(dtype, shape);
+	output.write(header.data(), header.size());
+	output.write_array(data, npy_shape_size(shape), dtype);
+	output.close();
+}
+
+/*
+ * Writer of stored .npz archives, one array at a time. Each member is a .npy file named "<name>.npy", its data aligned
+ * to 64 bytes from the start of the archive by padding the local header with an extra field. The archive is complete
+ * only after close().
+ */
+class npz_writer {
+public:
+	explicit npz_writer(const char* path) : output_(path, true), closed_(false) {}
+
+	npz_writer(const npz_writer&) = delete;
+	npz_writer& operator=(const npz_writer&) = delete;
+
+	void add(const std::string& name, const float16* data, const std::vector<size_t>& shape,
+		npy_dtype dtype = npy_dtype::float16)
+	{
+		add_member(name, data, shape, dtype);
+	}
+
+	void add(const std::string& name, const float* data, const std::vector<size_t>& shape,
+		npy_dtype dtype = npy_dtype::float32)
+	{
+		add_member(name, data, shape, dtype);
+	}
+
+	/* Write the central directory */
+	void close() {
+		if (closed_) {
+			return;
+		}
+		const uint64_t directory_offset = output_.offset();
+		for (const entry& e : entries_) {
+			const bool zip64_size = e.size >= 0xFFFFFFFF;
+			const bool zip64_offset = e.offset >= 0xFFFFFFFF;
+			unsigned char extra[4 + 24];
+			size_t extra_length = 0;
+			if (zip64_size || zip64_offset) {
+				extra_length = 4;
+				if (zip64_size) {
+					npy_store_le64(extra + extra_length, e.size);
+					npy_store_le64(extra + extra_length + 8, e.size);
+					extra_length += 16;
+				}
+				if (zip64_offset) {
+					npy_store_le64(extra + extra_length, e.offset);
+					extra_length += 8;
+				}
+				npy_store_le16(extra, 0x0001);
+				npy_store_le16(extra + 2, (uint16_t) (extra_length - 4));
+			}
+			unsigned char header[46];
+			npy_store_le32(header, 0x02014B50);
+			npy_store_le16(header + 4, extra_length != 0 ? 45 : 20);
+			npy_store_le16(header + 6, extra_length != 0 ? 45 : 20);
+			npy_store_le16(header + 8, 0);
+			npy_store_le16(header + 10, 0);
+			npy_store_le16(header + 12, 0);
+			npy_store_le16(header + 14, 0x21);
+			npy_store_le32(header + 16, e.crc);
+			npy_store_le32(header + 20, zip64_size ? 0xFFFFFFFF : (uint32_t) e.size);
+			npy_store_le32(header + 24, zip64_size ? 0xFFFFFFFF : (uint32_t) e.size);
+			npy_store_le16(header + 28, (uint16_t) e.name.size());
+			npy_store_le16(header + 30, (uint16_t) extra_length);
+			npy_store_le16(header + 32, 0);
+			npy_store_le16(header + 34, 0);
+			npy_store_le16(header + 36, 0);
+			npy_store_le32(header + 38, 0644u << 16);
+			npy_store_le32(header + 42, zip64_offset ? 0xFFFFFFFF : (uint32_t) e.offset);
+			output_.write(header, sizeof(header));
+			output_.write(e.name.data(), e.name.size());
+			output_.write(extra, extra_length);
+		}
+		const uint64_t directory_end = output_.offset();
+		const uint64_t directory_size = directory_end - directory_offset;
+		const bool zip64 = entries_.size() >= 0xFFFF || directory_offset >= 0xFFFFFFFF || directory_size >= 0xFFFFFFFF;
+		if (zip64) {
+			unsigned char record[56 + 20];
+			npy_store_le32(record, 0x06064B50);
+			npy_store_le64(record + 4, 44);
+			npy_store_le16(record + 12, 45);
+			npy_store_le16(record + 14, 45);
+			npy_store_le32(record + 16, 0);
+			npy_store_le32(record + 20, 0);
+			npy_store_le64(record + 24, entries_.size());
+			npy_store_le64(record + 32, entries_.size());
+			npy_store_le64(record + 40, directory_size);
+			npy_store_le64(record + 48, directory_offset);
+			npy_store_le32(record + 56, 0x07064B50);
+			npy_store_le32(record + 60, 0);
+			npy_store_le64(record + 64, directory_end);
+			npy_store_le32(record + 72, 1);
+			output_.write(record, sizeof(record));
+		}
+		unsigned char end[22];
+		npy_store_le32(end, 0x06054B50);
+		npy_store_le16(end + 4, 0);
+		npy_store_le16(end + 6, 0);
+		npy_store_le16(end + 8, zip64 ? 0xFFFF : (uint16_t) entries_.size());
+		npy_store_le16(end + 10, zip64 ? 0xFFFF : (uint16_t) entries_.size());
+		npy_store_le32(end + 12, zip64 ? 0xFFFFFFFF : (uint32_t) directory_size);
+		npy_store_le32(end + 16, zip64 ? 0xFFFFFFFF : (uint32_t) directory_offset);
+		npy_store_le16(end + 20, 0);
+		output_.write(end, sizeof(end));
+		output_.close();
+		closed_ = true;
+	}
+
+private:
+	struct entry {
+		std::string name;
+		uint64_t offset;
+		uint64_t size;
+		uint32_t crc;
+	};
+
+	template <typename T>
+	void add_member(const std::string& name, const T* data, const std::vector<size_t>& shape, npy_dtype dtype) {
+		if (closed_) {
+			throw std::logic_error("fp16::npz_writer: archive is closed");
+		}
+		entry e;
+		e.name = name + ".npy";
+		e.offset = output_.offset();
+		const std::string header = npy_format_header(dtype, shape);
+		const size_t elements = npy_shape_size(shape);
+		e.size = header.size() + elements * npy_dtype_size(dtype);
+		const bool zip64 = e.size >= 0xFFFFFFFF;
+
+		/* Local header, then the Zip64 sizes if needed, then padding that aligns the .npy file to 64 bytes */
+		size_t extra_length = zip64 ? 20 : 0;
+		const uint64_t unpadded = e.offset + 30 + e.name.size() + extra_length;
+		size_t padding = (size_t) ((64 - unpadded % 64) % 64);
+		if (padding != 0 && padding < 4) {
+			padding += 64;
+		}
+		extra_length += padding;
+		std::vector<unsigned char> local(30 + e.name.size() + extra_length, 0);
+		npy_store_le32(local.data(), 0x04034B50);
+		npy_store_le16(local.data() + 4, zip64 ? 45 : 20);
+		npy_store_le16(local.data() + 6, 0);
+		npy_store_le16(local.data() + 8, 0);
+		npy_store_le16(local.data() + 10, 0);
+		npy_store_le16(local.data() + 12, 0x21);
+		npy_store_le32(local.data() + 14, 0);
+		npy_store_le32(local.data() + 18, zip64 ? 0xFFFFFFFF : (uint32_t) e.size);
+		npy_store_le32(local.data() + 22, zip64 ? 0xFFFFFFFF : (uint32_t) e.size);
+		npy_store_le16(local.data() + 26, (uint16_t) e.name.size());
+		npy_store_le16(local.data() + 28, (uint16_t) extra_length);
+		memcpy(local.data() + 30, e.name.data(), e.name.size());
+		unsigned char* extra = local.data() + 30 + e.name.size();
+		if (zip64) {
+			npy_store_le16(extra, 0x0001);
+			npy_store_le16(extra + 2, 16);
+			npy_store_le64(extra + 4, e.size);
+			npy_store_le64(extra + 12, e.size);
+			extra += 20;
+		}
+		if (padding != 0) {
+			/* Alignment extra field, as written by Android's zipalign */
+			npy_store_le16(extra, 0xD935);
+			npy_store_le16(extra + 2, (uint16_t) (padding - 4));
+		}
+		output_.write(local.data(), local.size());
+
+		/* The .npy file, then its CRC in the local header */
+		output_.reset_crc();
+		output_.write(header.data(), header.size());
+		output_.write_array(data, elements, dtype);
+		e.crc = output_.crc();
+		unsigned char crc[4];
+		npy_store_le32(crc, e.crc);
+		output_.patch(e.offset + 14, crc, sizeof(crc));
+		entries_.push_back(e);
+	}
+
+	npy_output output_;
+	std::vector<entry> entries_;
+	bool closed_;
+};
+
+} /* namespace fp16 */
+
+#endif /* FP16_NPY_H */
@@ -0,0 +1,132 @@
+#pragma once
+#ifndef FP16_PMR_H
+#define FP16_PMR_H
+
+#if !defined(__cplusplus) || ((defined(_MSVC_LANG) ? _MSVC_LANG : __cplusplus) < 201703L)
+	#error "fp16/pmr.h requires a C++17 compiler"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory_resource>
+#include <new>
+
+#include "arena.h"
+
+/*
+ * std::pmr memory resources over the page-backed buffers and arenas of fp16/arena.h, for conversion buffers held in
+ * std::pmr containers:
+ *
+ *   fp16::page_resource pages(FP16_PAGES_HUGE | FP16_PAGES_PREFAULT);
+ *   std::pmr::vector<float> fp32(n, &pages);
+ *
+ *   fp16::arena_resource scratch(64 << 20, FP16_PAGES_HUGE);
+ *   std::pmr::vector<uint16_t> fp16(n, &scratch);
+ *   scratch.release();
+ *
+ * fp16::page_resource maps every allocation on its own with fp16_pages_allocate and unmaps it on deallocation, which
+ * suits a few large buffers. fp16::arena_resource allocates from one fp16_arena: deallocation returns memory only for
+ * the most recent allocation, and release() frees everything at once, as std::pmr::monotonic_buffer_resource does.
+ * Allocations that do not fit into the rest of the arena throw std::bad_alloc rather than going to another resource,
+ * so the arena capacity bounds the memory of a request. Neither resource is thread-safe.
+ */
+namespace fp16 {
+
+class page_resource : public std::pmr::memory_resource {
+public:
+	explicit page_resource(unsigned flags = 0) : flags_(flags) {}
+
+	unsigned flags() const {
+		return flags_;
+	}
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		const size_t page = (flags_ & (FP16_PAGES_HUGE | FP16_PAGES_HUGETLB)) != 0 ? FP16_HUGE_PAGE_SIZE : fp16_pages_base_size();
+		void* pages = alignment <= page ? fp16_pages_allocate(bytes, flags_) : NULL;
+		if (pages == NULL) {
+			throw std::bad_alloc();
+		}
+		return pages;
+	}
+
+	void do_deallocate(void* pages, size_t bytes, size_t) override {
+		fp16_pages_free(pages, bytes, flags_);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		const page_resource* pages = dynamic_cast<const page_resource*>(&other);
+		return pages != nullptr && pages->flags_ == flags_;
+	}
+
+	unsigned flags_;
+};
+
+class arena_resource : public std::pmr::memory_resource {
+public:
+	explicit arena_resource(size_t capacity, unsigned flags = 0) {
+		if (fp16_arena_init(&arena_, capacity, flags) != 0) {
+			throw std::bad_alloc();
+		}
+	}
+
+	arena_resource(const arena_resource&) = delete;
+	arena_resource& operator=(const arena_resource&) = delete;
+
+	~arena_resource() override {
+		fp16_arena_destroy(&arena_);
+	}
+
+	/* Free every allocation at once */
+	void release() {
+		fp16_arena_reset(&arena_);
+	}
+
+	size_t used() const {
+		return arena_.offset;
+	}
+
+	size_t capacity() const {
+		return arena_.capacity;
+	}
+
+	/* The underlying arena, for the C interfaces that take one */
+	struct fp16_arena* arena() {
+		return &arena_;
+	}
+
+private:
+	/* Allocation sizes are rounded up to FP16_ARENA_ALIGNMENT, so that an allocation ends where the next one starts
+	 * unless the next one asks for a larger alignment */
+	static size_t rounded_size(size_t bytes) {
+		return (bytes + (FP16_ARENA_ALIGNMENT - 1)) & ~(size_t) (FP16_ARENA_ALIGNMENT - 1);
+	}
+
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		void* pointer = bytes <= SIZE_MAX - FP16_ARENA_ALIGNMENT ?
+			fp16_arena_allocate(&arena_, rounded_size(bytes), alignment) : NULL;
+		if (pointer == NULL) {
+			throw std::bad_alloc();
+		}
+		return pointer;
+	}
+
+	void do_deallocate(void* pointer, size_t bytes, size_t) override {
+		/* Only the most recent allocation can be returned to a bump-pointer arena */
+		unsigned char* bytes_pointer = static_cast<unsigned char*>(pointer);
+		if (bytes_pointer + rounded_size(bytes) == arena_.base + arena_.offset) {
+			arena_.offset = (size_t) (bytes_pointer - arena_.base);
+		}
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+	struct fp16_arena arena_;
+};
+
+} /* namespace fp16 */
+
+#endif /* FP16_PMR_H */
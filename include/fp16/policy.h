@@ -0,0 +1,189 @@
+#pragma once
+#ifndef FP16_POLICY_H
+#define FP16_POLICY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fp16.h"
+#include "simd.h"
+#include "array.h"
+
+/*
+ * Conversions from single-precision to half-precision with encode policies applied to the results, so that a
+ * pipeline needs no second pass over the output to remove infinities, NaN, or denormals. The policies are flags that
+ * can be combined:
+ *
+ * - FP16_ENCODE_SATURATE: results that would be infinite (finite overflow and infinite inputs) become the largest
+ *   finite number of the same sign, +-65504 in IEEE format. The ARM alternative format always saturates and has no
+ *   infinity (0x7C00 is the finite number 65536), so the flag does not apply to it.
+ * - FP16_ENCODE_NAN_TO_VALUE: NaN inputs produce the caller-provided bits nan_value, e.g. 0 to map NaN to +0.
+ * - FP16_ENCODE_FLUSH_DENORMALS: denormalized results become zero of the same sign.
+ *
+ * Results are rounded to nearest-even; the policies are applied to the rounded result. The vector kernels apply them
+ * with compares and blends on the 16-bit results, without branches.
+ */
+enum fp16_encode_flags {
+	FP16_ENCODE_SATURATE = 1,
+	FP16_ENCODE_NAN_TO_VALUE = 2,
+	FP16_ENCODE_FLUSH_DENORMALS = 4,
+};
+
+/*
+ * Apply encode policies to a half-precision result h of converting an input that is NaN if is_nan is non-zero.
+ */
+static inline float16 fp16_apply_encode_policy(float16 h, int is_nan, unsigned flags, float16 nan_value) {
+	const uint16_t nonsign = h & UINT16_C(0x7FFF);
+	if ((flags & FP16_ENCODE_SATURATE) && nonsign == UINT16_C(0x7C00)) {
+		h = (float16) (h - 1);
+	}
+	if ((flags & FP16_ENCODE_FLUSH_DENORMALS) && nonsign < UINT16_C(0x0400)) {
+		h &= UINT16_C(0x8000);
+	}
+	if ((flags & FP16_ENCODE_NAN_TO_VALUE) && is_nan) {
+		h = nan_value;
+	}
+	return h;
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * IEEE half-precision format, in bit representation, with the given encode policies.
+ */
+static inline float16 fp32_ieee_to_fp16_value_policy(float f, unsigned flags, float16 nan_value) {
+	const float16 h = fp32_ieee_to_fp16_value(f);
+	return fp16_apply_encode_policy(h, (h & UINT16_C(0x7FFF)) > UINT16_C(0x7C00), flags, nan_value);
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * ARM alternative half-precision format, in bit representation, with the given encode policies.
+ */
+static inline float16 fp32_alt_to_fp16_value_policy(float f, unsigned flags, float16 nan_value) {
+	const uint32_t nonsign = fp32v_to_fp32b(f) & UINT32_C(0x7FFFFFFF);
+	return fp16_apply_encode_policy(fp32_alt_to_fp16_value(f), nonsign > UINT32_C(0x7F800000),
+		flags & ~(unsigned) FP16_ENCODE_SATURATE, nan_value);
+}
+
+#if FP16_SIMD_AVX2
+/*
+ * Loop-invariant masks and values for the vector policy fixups, in 16-bit lanes.
+ */
+struct fp16_simd_avx2_policy {
+	__m256i saturate;
+	__m256i nan_to_value;
+	__m256i flush_denormals;
+	__m256i nan_value;
+};
+
+static inline struct fp16_simd_avx2_policy fp16_simd_avx2_make_policy(unsigned flags, float16 nan_value) {
+	struct fp16_simd_avx2_policy policy;
+	policy.saturate = _mm256_set1_epi16((flags & FP16_ENCODE_SATURATE) ? -1 : 0);
+	policy.nan_to_value = _mm256_set1_epi16((flags & FP16_ENCODE_NAN_TO_VALUE) ? -1 : 0);
+	policy.flush_denormals = _mm256_set1_epi16((flags & FP16_ENCODE_FLUSH_DENORMALS) ? -1 : 0);
+	policy.nan_value = _mm256_set1_epi16((short) nan_value);
+	return policy;
+}
+
+/*
+ * Apply encode policies to sixteen half-precision results in 16-bit lanes. NaN inputs are marked by all-ones 16-bit
+ * lanes of nan; this is a vector transcription of fp16_apply_encode_policy.
+ */
+static inline __m256i fp16_simd_avx2_apply_policy_u16x16(__m256i h, __m256i nan, struct fp16_simd_avx2_policy policy) {
+	const __m256i nonsign = _mm256_and_si256(h, _mm256_set1_epi16(0x7FFF));
+	const __m256i infinity = _mm256_and_si256(_mm256_cmpeq_epi16(nonsign, _mm256_set1_epi16(0x7C00)), policy.saturate);
+	h = _mm256_add_epi16(h, infinity);
+	const __m256i denormal = _mm256_and_si256(_mm256_cmpgt_epi16(_mm256_set1_epi16(0x0400), nonsign), policy.flush_denormals);
+	h = _mm256_andnot_si256(_mm256_andnot_si256(_mm256_set1_epi16((short) 0x8000), denormal), h);
+	return _mm256_blendv_epi8(h, policy.nan_value, _mm256_and_si256(nan, policy.nan_to_value));
+}
+
+static inline __m128i fp16_simd_avx2_apply_policy_u16x8(__m128i h, __m128i nan, struct fp16_simd_avx2_policy policy) {
+	return _mm256_castsi256_si128(fp16_simd_avx2_apply_policy_u16x16(
+		_mm256_castsi128_si256(h), _mm256_castsi128_si256(nan), policy));
+}
+
+/*
+ * NaN masks of IEEE half-precision results in 16-bit lanes.
+ */
+static inline __m128i fp16_simd_avx2_ieee_nan_u16x8(__m128i h) {
+	return _mm_cmpgt_epi16(_mm_and_si128(h, _mm_set1_epi16(0x7FFF)), _mm_set1_epi16(0x7C00));
+}
+
+/*
+ * NaN masks of eight single-precision inputs, packed into 16-bit lanes.
+ */
+static inline __m128i fp16_simd_avx2_fp32_nan_u16x8(__m256 f) {
+	const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+	return _mm_packs_epi32(_mm256_castsi256_si128(nan), _mm256_extracti128_si256(nan, 1));
+}
+#endif /* FP16_SIMD_AVX2 */
+
+/*
+ * Convert n single-precision numbers to IEEE half-precision with the given encode policies.
+ */
+static inline void fp32_ieee_to_fp16_array_policy(const float* input, float16* output, size_t n,
+	unsigned flags, float16 nan_value)
+{
+#if FP16_SIMD_AVX512
+	const struct fp16_simd_avx2_policy policy = fp16_simd_avx2_make_policy(flags, nan_value);
+	for (; n >= 16; n -= 16) {
+		const __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps(input), _MM_FROUND_TO_NEAREST_INT);
+		const __m256i nan = _mm256_cmpgt_epi16(_mm256_and_si256(h, _mm256_set1_epi16(0x7FFF)), _mm256_set1_epi16(0x7C00));
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx2_apply_policy_u16x16(h, nan, policy));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	const __m256i h = _mm512_cvtps_ph(_mm512_maskz_loadu_ps(mask, input), _MM_FROUND_TO_NEAREST_INT);
+	const __m256i nan = _mm256_cmpgt_epi16(_mm256_and_si256(h, _mm256_set1_epi16(0x7FFF)), _mm256_set1_epi16(0x7C00));
+	_mm256_mask_storeu_epi16(output, mask, fp16_simd_avx2_apply_policy_u16x16(h, nan, policy));
+#elif FP16_SIMD_AVX2
+	const struct fp16_simd_avx2_policy policy = fp16_simd_avx2_make_policy(flags, nan_value);
+	for (; n >= 8; n -= 8) {
+		const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(input), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx2_apply_policy_u16x8(h, fp16_simd_avx2_ieee_nan_u16x8(h), policy));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		const __m128i h = _mm256_cvtps_ph(_mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n)), _MM_FROUND_TO_NEAREST_INT);
+		fp16_simd_avx2_store_u16x8_partial(output,
+			fp16_simd_avx2_apply_policy_u16x8(h, fp16_simd_avx2_ieee_nan_u16x8(h), policy), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_ieee_to_fp16_value_policy(input[i], flags, nan_value);
+	}
+#endif
+}
+
+/*
+ * Convert n single-precision numbers to ARM alternative half-precision with the given encode policies.
+ */
+static inline void fp32_alt_to_fp16_array_policy(const float* input, float16* output, size_t n,
+	unsigned flags, float16 nan_value)
+{
+#if FP16_SIMD_AVX2
+	const struct fp16_simd_avx2_policy policy = fp16_simd_avx2_make_policy(flags & ~(unsigned) FP16_ENCODE_SATURATE, nan_value);
+	for (; n >= 8; n -= 8) {
+		const __m256 f = _mm256_loadu_ps(input);
+		const __m128i h = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(f));
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx2_apply_policy_u16x8(h, fp16_simd_avx2_fp32_nan_u16x8(f), policy));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		const __m256 f = _mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n));
+		const __m128i h = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(f));
+		fp16_simd_avx2_store_u16x8_partial(output,
+			fp16_simd_avx2_apply_policy_u16x8(h, fp16_simd_avx2_fp32_nan_u16x8(f), policy), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_alt_to_fp16_value_policy(input[i], flags, nan_value);
+	}
+#endif
+}
+
+#endif /* FP16_POLICY_H */
@@ -0,0 +1,281 @@
+#pragma once
+#ifndef FP16_RANGE_H
+#define FP16_RANGE_H
+
+#ifndef __cplusplus
+	#error "fp16/range.h requires a C++11 compiler"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iterator>
+#include <type_traits>
+#if defined(__has_include)
+	#if __has_include(<version>)
+		#include <version>
+	#endif
+#endif
+#if defined(__cpp_lib_ranges)
+	#include <ranges>
+#endif
+
+#include "fp16.h"
+#include "fp64.h"
+#include "array.h"
+
+/*
+ * Iteration over IEEE half-precision arrays as single-precision numbers, without allocating a single-precision copy.
+ *
+ * fp16::as_fp32(data, n), or fp16::as_fp32(c) for any contiguous container or span of float16 with data() and
+ * size(), returns a non-owning view whose iterators dereference to float:
+ *
+ *   float sum = std::accumulate(fp16::as_fp32(x).begin(), fp16::as_fp32(x).end(), 0.0f);
+ *   std::vector<float> copy(view.begin(), view.end());
+ *
+ * An iterator decodes fp16::fp32_range::chunk elements at a time into a buffer it carries, with
+ * fp16_ieee_to_fp32_array_small, and serves the following dereferences from the buffer. Iterators are forward
+ * iterators in the C++20 sense (iterator_concept) and input iterators in the C++11 sense (iterator_category), as
+ * dereferencing returns a float by value. With the C++20 ranges library, fp32_range is a borrowed view and composes
+ * with the std::views adaptors.
+ *
+ * fp16::fp16_encoder(data) is an output iterator that encodes every float (or double, or integer) assigned through it
+ * to the next element of data, with fp32_ieee_to_fp16_value (fp64_ieee_to_fp16_value for doubles):
+ *
+ *   std::transform(view.begin(), view.end(), fp16::fp16_encoder(y), [](float f) { return f * 0.5f; });
+ *
+ * For long sequences, fp16::fp16_writer collects chunk floats and encodes them at once with
+ * fp32_ieee_to_fp16_array_small. Its iterators refer to the writer, so all copies share one buffer, as
+ * std::ostream_iterator shares its stream; the last partial chunk is written by flush() or the destructor:
+ *
+ *   fp16::fp16_writer writer(y);
+ *   std::transform(view.begin(), view.end(), writer.begin(), [](float f) { return f * 0.5f; });
+ *   writer.flush();
+ */
+namespace fp16 {
+
+class fp32_range_iterator {
+public:
+	/* Elements decoded at once: a 16-lane vector of the AVX-512 kernels, two 8-lane vectors of the AVX2 kernels */
+	static const size_t chunk = 16;
+
+	typedef std::input_iterator_tag iterator_category;
+	typedef std::forward_iterator_tag iterator_concept;
+	typedef float value_type;
+	typedef ptrdiff_t difference_type;
+	typedef const float* pointer;
+	typedef float reference;
+
+	fp32_range_iterator() : data(nullptr), size(0), index(0), buffer_begin(SIZE_MAX) {}
+
+	fp32_range_iterator(const float16* data, size_t size, size_t index) :
+		data(data), size(size), index(index), buffer_begin(SIZE_MAX) {}
+
+	float operator*() const {
+		if (index - index % chunk != buffer_begin) {
+			decode();
+		}
+		return buffer[index - buffer_begin];
+	}
+
+	fp32_range_iterator& operator++() {
+		index++;
+		return *this;
+	}
+
+	fp32_range_iterator operator++(int) {
+		const fp32_range_iterator old = *this;
+		index++;
+		return old;
+	}
+
+	/* Position in the viewed array */
+	size_t position() const {
+		return index;
+	}
+
+	friend bool operator==(const fp32_range_iterator& a, const fp32_range_iterator& b) {
+		return a.index == b.index;
+	}
+
+	friend bool operator!=(const fp32_range_iterator& a, const fp32_range_iterator& b) {
+		return a.index != b.index;
+	}
+
+private:
+	/* Decode the aligned chunk that holds the current element. buffer_begin == SIZE_MAX, never a chunk boundary,
+	 * marks an empty buffer. */
+	void decode() const {
+		buffer_begin = index - index % chunk;
+		const size_t n = size - buffer_begin < chunk ? size - buffer_begin : chunk;
+		fp16_ieee_to_fp32_array_small(data + buffer_begin, buffer, n);
+	}
+
+	const float16* data;
+	size_t size;
+	size_t index;
+	mutable size_t buffer_begin;
+	mutable float buffer[chunk];
+};
+
+class fp32_range
+#if defined(__cpp_lib_ranges)
+	: public std::ranges::view_base
+#endif
+{
+public:
+	typedef fp32_range_iterator iterator;
+	typedef fp32_range_iterator const_iterator;
+	typedef float value_type;
+	static const size_t chunk = fp32_range_iterator::chunk;
+
+	fp32_range() : data_(nullptr), size_(0) {}
+	fp32_range(const float16* data, size_t size) : data_(data), size_(size) {}
+
+	iterator begin() const { return iterator(data_, size_, 0); }
+	iterator end() const { return iterator(data_, size_, size_); }
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+	const float16* data() const { return data_; }
+
+	float operator[](size_t i) const {
+		return fp16_ieee_to_fp32_value(data_[i]);
+	}
+
+private:
+	const float16* data_;
+	size_t size_;
+};
+
+static inline fp32_range as_fp32(const float16* data, size_t size) {
+	return fp32_range(data, size);
+}
+
+template <typename Container>
+static inline typename std::enable_if<
+	std::is_convertible<decltype(std::declval<const Container&>().data()), const float16*>::value, fp32_range>::type
+	as_fp32(const Container& c)
+{
+	return fp32_range(c.data(), c.size());
+}
+
+class fp16_output_iterator {
+public:
+	typedef std::output_iterator_tag iterator_category;
+	typedef void value_type;
+	typedef ptrdiff_t difference_type;
+	typedef void pointer;
+	typedef void reference;
+
+	fp16_output_iterator() : data(nullptr) {}
+	explicit fp16_output_iterator(float16* data) : data(data) {}
+
+	fp16_output_iterator& operator=(float value) {
+		*data++ = fp32_ieee_to_fp16_value(value);
+		return *this;
+	}
+
+	fp16_output_iterator& operator=(double value) {
+		*data++ = fp64_ieee_to_fp16_value(value);
+		return *this;
+	}
+
+	template <typename T>
+	typename std::enable_if<std::is_integral<T>::value, fp16_output_iterator&>::type operator=(T value) {
+		return *this = (float) value;
+	}
+
+	/* As std::ostream_iterator: assignment writes and advances, dereference and increment do nothing */
+	fp16_output_iterator& operator*() { return *this; }
+	fp16_output_iterator& operator++() { return *this; }
+	fp16_output_iterator& operator++(int) { return *this; }
+
+	/* The next element to be written */
+	float16* base() const {
+		return data;
+	}
+
+private:
+	float16* data;
+};
+
+static inline fp16_output_iterator fp16_encoder(float16* data) {
+	return fp16_output_iterator(data);
+}
+
+class fp16_writer {
+public:
+	static const size_t chunk = fp32_range_iterator::chunk;
+
+	class iterator {
+	public:
+		typedef std::output_iterator_tag iterator_category;
+		typedef void value_type;
+		typedef ptrdiff_t difference_type;
+		typedef void pointer;
+		typedef void reference;
+
+		iterator() : writer(nullptr) {}
+		explicit iterator(fp16_writer* writer) : writer(writer) {}
+
+		iterator& operator=(float value) {
+			writer->put(value);
+			return *this;
+		}
+
+		iterator& operator*() { return *this; }
+		iterator& operator++() { return *this; }
+		iterator& operator++(int) { return *this; }
+
+	private:
+		fp16_writer* writer;
+	};
+
+	explicit fp16_writer(float16* data) : data(data), count(0) {}
+
+	fp16_writer(const fp16_writer&) = delete;
+	fp16_writer& operator=(const fp16_writer&) = delete;
+
+	~fp16_writer() {
+		flush();
+	}
+
+	iterator begin() {
+		return iterator(this);
+	}
+
+	void put(float value) {
+		buffer[count++] = value;
+		if (count == chunk) {
+			fp32_ieee_to_fp16_array_small(buffer, data, chunk);
+			data += chunk;
+			count = 0;
+		}
+	}
+
+	/* Encode the buffered numbers; the following numbers are written after them */
+	void flush() {
+		fp32_ieee_to_fp16_array_small(buffer, data, count);
+		data += count;
+		count = 0;
+	}
+
+	/* The next element to be written, once the buffered numbers are flushed */
+	float16* base() const {
+		return data + count;
+	}
+
+private:
+	float16* data;
+	size_t count;
+	float buffer[chunk];
+};
+
+} /* namespace fp16 */
+
+#if defined(__cpp_lib_ranges)
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<fp16::fp32_range> = true;
+#endif
+
+#endif /* FP16_RANGE_H */
@@ -0,0 +1,376 @@
+#pragma once
+#ifndef FP16_ROUNDING_H
+#define FP16_ROUNDING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fp16.h"
+#include "simd.h"
+#include "array.h"
+
+/*
+ * Conversions from single-precision to half-precision with an explicit rounding mode. They never read or change the
+ * floating-point environment: the scalar functions use integer arithmetic only, and the F16C kernels encode the
+ * rounding mode in the instruction immediate instead of taking it from MXCSR.
+ *
+ * With FP16_ROUND_NEAREST_EVEN the results are bit-identical to fp32_ieee_to_fp16_value and fp32_alt_to_fp16_value
+ * under the default floating-point environment, and stay round-to-nearest-even when MXCSR selects another mode.
+ */
+enum fp16_rounding_mode {
+	/* Round to nearest, ties to even (IEEE 754 default) */
+	FP16_ROUND_NEAREST_EVEN = 0,
+	/* Round toward zero (truncate) */
+	FP16_ROUND_TOWARD_ZERO = 1,
+	/* Round toward positive infinity */
+	FP16_ROUND_UP = 2,
+	/* Round toward negative infinity */
+	FP16_ROUND_DOWN = 3,
+	/* Round to nearest, ties away from zero */
+	FP16_ROUND_NEAREST_AWAY = 4,
+};
+
+/*
+ * Round the magnitude of a single-precision number (sign bit cleared) to 15 bits of half-precision magnitude.
+ * Magnitudes of 2**16 and above overflow past the largest exponent; callers handle them before calling this function.
+ *
+ * @note The result of rounding up the largest finite half-precision magnitude is the first magnitude with the all-ones
+ * exponent, which is infinity in IEEE format.
+ */
+static inline uint32_t fp16_round_magnitude(uint32_t nonsign, uint32_t sign, enum fp16_rounding_mode mode) {
+	uint32_t h, remainder, half;
+	if (nonsign >= UINT32_C(113) << 23) {
+		/* Normalized half-precision: re-bias the exponent and drop 13 mantissa bits */
+		h = (nonsign - (UINT32_C(112) << 23)) >> 13;
+		remainder = nonsign & UINT32_C(0x1FFF);
+		half = UINT32_C(0x1000);
+	} else {
+		/*
+		 * Denormalized half-precision or zero: the value in units of 2**-24 is the mantissa (with the implicit bit for
+		 * normalized single-precision inputs) shifted right by 126 - exponent, or by 125 for denormalized inputs.
+		 * Shifts above 25 are clamped: the mantissa has at most 24 bits, so the remainder stays below one half.
+		 */
+		const uint32_t exponent = nonsign >> 23;
+		const uint32_t mantissa = exponent != 0 ? (nonsign & UINT32_C(0x007FFFFF)) | UINT32_C(0x00800000) : nonsign;
+		uint32_t shift = exponent != 0 ? 126 - exponent : 125;
+		if (shift > 25) {
+			shift = 25;
+		}
+		h = mantissa >> shift;
+		remainder = mantissa & ((UINT32_C(1) << shift) - 1);
+		half = UINT32_C(1) << (shift - 1);
+	}
+
+	uint32_t increment;
+	switch (mode) {
+		case FP16_ROUND_NEAREST_EVEN:
+			increment = (uint32_t) (remainder > half) | ((uint32_t) (remainder == half) & h & 1);
+			break;
+		case FP16_ROUND_NEAREST_AWAY:
+			increment = remainder >= half;
+			break;
+		case FP16_ROUND_UP:
+			increment = remainder != 0 && sign == 0;
+			break;
+		case FP16_ROUND_DOWN:
+			increment = remainder != 0 && sign != 0;
+			break;
+		default:
+			increment = 0;
+			break;
+	}
+	return h + increment;
+}
+
+/*
+ * Check whether a rounding mode rounds numbers of the given sign away from zero when they exceed the largest finite
+ * half-precision number.
+ */
+static inline int fp16_rounds_overflow_to_infinity(uint32_t sign, enum fp16_rounding_mode mode) {
+	switch (mode) {
+		case FP16_ROUND_NEAREST_EVEN:
+		case FP16_ROUND_NEAREST_AWAY:
+			return 1;
+		case FP16_ROUND_UP:
+			return sign == 0;
+		case FP16_ROUND_DOWN:
+			return sign != 0;
+		default:
+			return 0;
+	}
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * IEEE half-precision format, in bit representation, with the given rounding mode.
+ *
+ * Finite numbers beyond the half-precision range become infinity or the largest finite number, as IEEE 754 specifies
+ * for the rounding mode. NaN inputs produce the canonical quiet NaN 0x7E00 with the sign of the input.
+ */
+static inline float16 fp32_ieee_to_fp16_value_rounded(float f, enum fp16_rounding_mode mode) {
+	const uint32_t w = fp32v_to_fp32b(f);
+	const uint32_t sign = w & UINT32_C(0x80000000);
+	const uint32_t nonsign = w & UINT32_C(0x7FFFFFFF);
+
+	uint32_t h;
+	if (nonsign > UINT32_C(0x7F800000)) {
+		h = UINT32_C(0x7E00);
+	} else if (nonsign == UINT32_C(0x7F800000)) {
+		h = UINT32_C(0x7C00);
+	} else if (nonsign >= UINT32_C(0x47800000)) {
+		h = fp16_rounds_overflow_to_infinity(sign, mode) ? UINT32_C(0x7C00) : UINT32_C(0x7BFF);
+	} else {
+		h = fp16_round_magnitude(nonsign, sign, mode);
+	}
+	return (float16) ((sign >> 16) | h);
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * ARM alternative half-precision format, in bit representation, with the given rounding mode.
+ *
+ * The alternative format has no infinity or NaN: infinity, NaN, and finite numbers beyond the format range saturate
+ * to the largest magnitude 0x7FFF with the sign of the input, in every rounding mode.
+ */
+static inline float16 fp32_alt_to_fp16_value_rounded(float f, enum fp16_rounding_mode mode) {
+	const uint32_t w = fp32v_to_fp32b(f);
+	const uint32_t sign = w & UINT32_C(0x80000000);
+	const uint32_t nonsign = w & UINT32_C(0x7FFFFFFF);
+
+	uint32_t h = UINT32_C(0x7FFF);
+	if (nonsign < UINT32_C(0x48000000)) {
+		h = fp16_round_magnitude(nonsign, sign, mode);
+		if (h > UINT32_C(0x7FFF)) {
+			h = UINT32_C(0x7FFF);
+		}
+	}
+	return (float16) ((sign >> 16) | h);
+}
+
+#if FP16_SIMD_AVX2
+/*
+ * Convert eight single-precision numbers to IEEE (alt = 0) or ARM alternative (alt = 1) half-precision numbers in
+ * 32-bit lanes with the given rounding mode. This is a branch-free vector transcription of
+ * fp32_ieee_to_fp16_value_rounded and fp32_alt_to_fp16_value_rounded, used where F16C has no matching instruction.
+ */
+static inline __m256i fp16_simd_avx2_fp32_to_fp16_rounded_u32(__m256 f, enum fp16_rounding_mode mode, int alt) {
+	const __m256i w = _mm256_castps_si256(f);
+	const __m256i sign = _mm256_and_si256(w, _mm256_set1_epi32((int) UINT32_C(0x80000000)));
+	const __m256i nonsign = _mm256_and_si256(w, _mm256_set1_epi32(0x7FFFFFFF));
+	const __m256i negative = _mm256_srai_epi32(w, 31);
+	const __m256i one = _mm256_set1_epi32(1);
+
+	/* Normalized half-precision results */
+	const __m256i normalized_h = _mm256_srli_epi32(_mm256_sub_epi32(nonsign, _mm256_set1_epi32(112 << 23)), 13);
+	const __m256i normalized_remainder = _mm256_and_si256(nonsign, _mm256_set1_epi32(0x1FFF));
+
+	/* Denormalized half-precision results: shift = min(126 - exponent, 25), or 125 for a zero exponent */
+	const __m256i exponent = _mm256_srli_epi32(nonsign, 23);
+	const __m256i zero_exponent = _mm256_cmpeq_epi32(exponent, _mm256_setzero_si256());
+	const __m256i mantissa = _mm256_or_si256(_mm256_and_si256(nonsign, _mm256_set1_epi32(0x007FFFFF)),
+		_mm256_andnot_si256(zero_exponent, _mm256_set1_epi32(0x00800000)));
+	const __m256i shift = _mm256_min_epi32(
+		_mm256_add_epi32(_mm256_sub_epi32(_mm256_set1_epi32(126), exponent), zero_exponent),
+		_mm256_set1_epi32(25));
+	const __m256i denormalized_h = _mm256_srlv_epi32(mantissa, shift);
+	const __m256i denormalized_remainder = _mm256_sub_epi32(mantissa, _mm256_sllv_epi32(denormalized_h, shift));
+	const __m256i denormalized_half = _mm256_sllv_epi32(one, _mm256_sub_epi32(shift, one));
+
+	const __m256i normalized = _mm256_cmpgt_epi32(nonsign, _mm256_set1_epi32((113 << 23) - 1));
+	const __m256i h = _mm256_blendv_epi8(denormalized_h, normalized_h, normalized);
+	const __m256i remainder = _mm256_blendv_epi8(denormalized_remainder, normalized_remainder, normalized);
+	const __m256i half = _mm256_blendv_epi8(denormalized_half, _mm256_set1_epi32(0x1000), normalized);
+
+	/* Rounding increment as an all-ones mask */
+	const __m256i above_half = _mm256_cmpgt_epi32(remainder, half);
+	const __m256i at_half = _mm256_cmpeq_epi32(remainder, half);
+	const __m256i inexact = _mm256_cmpgt_epi32(remainder, _mm256_setzero_si256());
+	__m256i increment;
+	__m256i to_infinity;
+	switch (mode) {
+		case FP16_ROUND_NEAREST_EVEN:
+			increment = _mm256_or_si256(above_half,
+				_mm256_and_si256(at_half, _mm256_cmpeq_epi32(_mm256_and_si256(h, one), one)));
+			to_infinity = _mm256_set1_epi32(-1);
+			break;
+		case FP16_ROUND_NEAREST_AWAY:
+			increment = _mm256_or_si256(above_half, at_half);
+			to_infinity = _mm256_set1_epi32(-1);
+			break;
+		case FP16_ROUND_UP:
+			increment = _mm256_andnot_si256(negative, inexact);
+			to_infinity = _mm256_xor_si256(negative, _mm256_set1_epi32(-1));
+			break;
+		case FP16_ROUND_DOWN:
+			increment = _mm256_and_si256(negative, inexact);
+			to_infinity = negative;
+			break;
+		default:
+			increment = _mm256_setzero_si256();
+			to_infinity = _mm256_setzero_si256();
+			break;
+	}
+	__m256i rounded = _mm256_sub_epi32(h, increment);
+
+	if (alt) {
+		/* Saturate overflow, infinity, and NaN to the largest magnitude */
+		rounded = _mm256_min_epi32(rounded, _mm256_set1_epi32(0x7FFF));
+		const __m256i overflow = _mm256_cmpgt_epi32(nonsign, _mm256_set1_epi32(0x48000000 - 1));
+		rounded = _mm256_or_si256(rounded, _mm256_and_si256(overflow, _mm256_set1_epi32(0x7FFF)));
+	} else {
+		const __m256i overflow = _mm256_cmpgt_epi32(nonsign, _mm256_set1_epi32(0x47800000 - 1));
+		const __m256i infinity = _mm256_cmpeq_epi32(nonsign, _mm256_set1_epi32(0x7F800000));
+		const __m256i nan = _mm256_cmpgt_epi32(nonsign, _mm256_set1_epi32(0x7F800000));
+		const __m256i overflow_value = _mm256_sub_epi32(_mm256_set1_epi32(0x7BFF),
+			_mm256_or_si256(to_infinity, infinity));
+		rounded = _mm256_blendv_epi8(rounded, overflow_value, overflow);
+		rounded = _mm256_blendv_epi8(rounded, _mm256_set1_epi32(0x7E00), nan);
+	}
+	return _mm256_or_si256(rounded, _mm256_srli_epi32(sign, 16));
+}
+
+/*
+ * Convert eight single-precision numbers to IEEE half-precision with F16C, using the rounding mode encoded in the
+ * instruction. Round to nearest with ties away from zero is not available in F16C.
+ */
+static inline __m128i fp16_simd_avx2_cvtps_ph_rounded(__m256 f, enum fp16_rounding_mode mode) {
+	switch (mode) {
+		case FP16_ROUND_TOWARD_ZERO:
+			return _mm256_cvtps_ph(f, _MM_FROUND_TO_ZERO);
+		case FP16_ROUND_UP:
+			return _mm256_cvtps_ph(f, _MM_FROUND_TO_POS_INF);
+		case FP16_ROUND_DOWN:
+			return _mm256_cvtps_ph(f, _MM_FROUND_TO_NEG_INF);
+		case FP16_ROUND_NEAREST_AWAY:
+			return fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_fp16_rounded_u32(f, mode, 0));
+		default:
+			return _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+	}
+}
+#endif /* FP16_SIMD_AVX2 */
+
+#if FP16_SIMD_AVX512
+static inline __m256i fp16_simd_avx512_cvtps_ph_rounded(__m512 f, enum fp16_rounding_mode mode) {
+	switch (mode) {
+		case FP16_ROUND_TOWARD_ZERO:
+			return _mm512_cvtps_ph(f, _MM_FROUND_TO_ZERO);
+		case FP16_ROUND_UP:
+			return _mm512_cvtps_ph(f, _MM_FROUND_TO_POS_INF);
+		case FP16_ROUND_DOWN:
+			return _mm512_cvtps_ph(f, _MM_FROUND_TO_NEG_INF);
+		default:
+			return _mm512_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+	}
+}
+#endif /* FP16_SIMD_AVX512 */
+
+/*
+ * Vector loops for a single rounding mode. The array functions below call them with a constant mode, so that the
+ * mode dispatch inside the kernels folds away after inlining.
+ */
+static inline void fp32_ieee_to_fp16_array_rounded_loop(const float* input, float16* output, size_t n,
+	enum fp16_rounding_mode mode)
+{
+#if FP16_SIMD_AVX512
+	if (mode != FP16_ROUND_NEAREST_AWAY) {
+		for (; n >= 16; n -= 16) {
+			_mm256_storeu_si256((__m256i*) output, fp16_simd_avx512_cvtps_ph_rounded(_mm512_loadu_ps(input), mode));
+			input += 16;
+			output += 16;
+		}
+		const __mmask16 mask = fp16_simd_avx512_mask16(n);
+		_mm256_mask_storeu_epi16(output, mask, fp16_simd_avx512_cvtps_ph_rounded(_mm512_maskz_loadu_ps(mask, input), mode));
+		return;
+	}
+#endif
+#if FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx2_cvtps_ph_rounded(_mm256_loadu_ps(input), mode));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		const __m256 f = _mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n));
+		fp16_simd_avx2_store_u16x8_partial(output, fp16_simd_avx2_cvtps_ph_rounded(f, mode), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_ieee_to_fp16_value_rounded(input[i], mode);
+	}
+#endif
+}
+
+static inline void fp32_alt_to_fp16_array_rounded_loop(const float* input, float16* output, size_t n,
+	enum fp16_rounding_mode mode)
+{
+#if FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		const __m256i h = fp16_simd_avx2_fp32_to_fp16_rounded_u32(_mm256_loadu_ps(input), mode, 1);
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx2_pack_u32x8(h));
+		input += 8;
+		output += 8;
+	}
+	if (n != 0) {
+		const __m256 f = _mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n));
+		const __m256i h = fp16_simd_avx2_fp32_to_fp16_rounded_u32(f, mode, 1);
+		fp16_simd_avx2_store_u16x8_partial(output, fp16_simd_avx2_pack_u32x8(h), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_alt_to_fp16_value_rounded(input[i], mode);
+	}
+#endif
+}
+
+/*
+ * Convert n single-precision numbers to IEEE half-precision with the given rounding mode.
+ * NaN inputs convert to NaN outputs, with the payload bits kept by the hardware in the F16C kernels.
+ */
+static inline void fp32_ieee_to_fp16_array_rounded(const float* input, float16* output, size_t n,
+	enum fp16_rounding_mode mode)
+{
+	switch (mode) {
+		case FP16_ROUND_TOWARD_ZERO:
+			fp32_ieee_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_TOWARD_ZERO);
+			break;
+		case FP16_ROUND_UP:
+			fp32_ieee_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_UP);
+			break;
+		case FP16_ROUND_DOWN:
+			fp32_ieee_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_DOWN);
+			break;
+		case FP16_ROUND_NEAREST_AWAY:
+			fp32_ieee_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_NEAREST_AWAY);
+			break;
+		default:
+			fp32_ieee_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_NEAREST_EVEN);
+			break;
+	}
+}
+
+/*
+ * Convert n single-precision numbers to ARM alternative half-precision with the given rounding mode.
+ */
+static inline void fp32_alt_to_fp16_array_rounded(const float* input, float16* output, size_t n,
+	enum fp16_rounding_mode mode)
+{
+	switch (mode) {
+		case FP16_ROUND_TOWARD_ZERO:
+			fp32_alt_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_TOWARD_ZERO);
+			break;
+		case FP16_ROUND_UP:
+			fp32_alt_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_UP);
+			break;
+		case FP16_ROUND_DOWN:
+			fp32_alt_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_DOWN);
+			break;
+		case FP16_ROUND_NEAREST_AWAY:
+			fp32_alt_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_NEAREST_AWAY);
+			break;
+		default:
+			fp32_alt_to_fp16_array_rounded_loop(input, output, n, FP16_ROUND_NEAREST_EVEN);
+			break;
+	}
+}
+
+#endif /* FP16_ROUNDING_H */
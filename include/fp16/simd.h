@@ -0,0 +1,93 @@
+#pragma once
+#ifndef FP16_SIMD_H
+#define FP16_SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Instruction set selection for the bulk conversion kernels. The kernels are chosen at compile time from the
+ * target flags, the same way fp16.h chooses its native conversions:
+ *   FP16_SIMD_AVX512 - AVX512F + AVX512BW + AVX512VL + F16C (e.g. -mavx512f -mavx512bw -mavx512vl -mf16c)
+ *   FP16_SIMD_AVX2   - AVX2 + F16C (e.g. -mavx2 -mf16c)
+ * Without either, the bulk functions fall back to loops over the scalar conversions in fp16.h.
+ * Define FP16_SIMD_DISABLE to force the scalar fallback.
+ *
+ * On top of FP16_SIMD_AVX512, FP16_SIMD_AVX512_BF16 enables the AVX512-BF16 conversion instructions in bf16.h
+ * (e.g. -mavx512bf16).
+ */
+#if !defined(FP16_SIMD_DISABLE) && defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__) && \
+	(defined(__F16C__) || defined(_MSC_VER))
+	#define FP16_SIMD_AVX512 1
+	#define FP16_SIMD_AVX2 1
+#elif !defined(FP16_SIMD_DISABLE) && defined(__AVX2__) && (defined(__F16C__) || defined(_MSC_VER))
+	#define FP16_SIMD_AVX512 0
+	#define FP16_SIMD_AVX2 1
+#else
+	#define FP16_SIMD_AVX512 0
+	#define FP16_SIMD_AVX2 0
+#endif
+
+#if FP16_SIMD_AVX512 && defined(__AVX512BF16__)
+	#define FP16_SIMD_AVX512_BF16 1
+#else
+	#define FP16_SIMD_AVX512_BF16 0
+#endif
+
+#if FP16_SIMD_AVX2
+	#include <immintrin.h>
+#endif
+
+#if FP16_SIMD_AVX2
+/*
+ * Mask with all bits set in the 32-bit lanes [0, n) and cleared in the lanes [n, 8), for use with vpmaskmov.
+ */
+static inline __m256i fp16_simd_avx2_mask_u32x8(size_t n) {
+	return _mm256_cmpgt_epi32(_mm256_set1_epi32((int) n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+/*
+ * Load n < 8 consecutive 16-bit elements into the low lanes of a vector and zero the remaining lanes,
+ * without touching memory past p[n - 1]. Pairs of elements are loaded with vpmaskmovd; the last element of
+ * an odd-length input is broadcast and blended into its lane.
+ */
+static inline __m128i fp16_simd_avx2_load_u16x8_partial(const uint16_t* p, size_t n) {
+	const __m128i pair_mask = _mm_cmpgt_epi32(_mm_set1_epi32((int) (n >> 1)), _mm_setr_epi32(0, 1, 2, 3));
+	__m128i v = _mm_maskload_epi32((const int*) p, pair_mask);
+	if (n & 1) {
+		const __m128i last_mask = _mm_cmpeq_epi16(_mm_set1_epi16((short) (n - 1)), _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7));
+		v = _mm_blendv_epi8(v, _mm_set1_epi16((short) p[n - 1]), last_mask);
+	}
+	return v;
+}
+
+/*
+ * Store the low n < 8 16-bit lanes of a vector to p[0], ..., p[n - 1], without touching memory past p[n - 1].
+ */
+static inline void fp16_simd_avx2_store_u16x8_partial(uint16_t* p, __m128i v, size_t n) {
+	const __m128i pair_mask = _mm_cmpgt_epi32(_mm_set1_epi32((int) (n >> 1)), _mm_setr_epi32(0, 1, 2, 3));
+	_mm_maskstore_epi32((int*) p, pair_mask, v);
+	if (n & 1) {
+		const __m128 last_pair = _mm_permutevar_ps(_mm_castsi128_ps(v), _mm_set1_epi32((int) (n >> 1)));
+		p[n - 1] = (uint16_t) _mm_cvtsi128_si32(_mm_castps_si128(last_pair));
+	}
+}
+
+/*
+ * Narrow eight 32-bit lanes holding values in [0, 0xFFFF] to eight 16-bit lanes.
+ */
+static inline __m128i fp16_simd_avx2_pack_u32x8(__m256i v) {
+	return _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+#endif /* FP16_SIMD_AVX2 */
+
+#if FP16_SIMD_AVX512
+/*
+ * Mask with bits [0, n) set, for n <= 16.
+ */
+static inline __mmask16 fp16_simd_avx512_mask16(size_t n) {
+	return (__mmask16) ((UINT32_C(1) << n) - 1);
+}
+#endif /* FP16_SIMD_AVX512 */
+
+#endif /* FP16_SIMD_H */
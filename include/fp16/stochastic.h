@@ -0,0 +1,221 @@
+#pragma once
+#ifndef FP16_STOCHASTIC_H
+#define FP16_STOCHASTIC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fp16.h"
+#include "simd.h"
+#include "array.h"
+
+/*
+ * Conversions from single-precision to half-precision with stochastic rounding: a number between two adjacent
+ * half-precision numbers rounds up with probability equal to its distance from the lower one, divided by the distance
+ * between them. The result is unbiased in expectation, so that small updates accumulated into half-precision weights
+ * do not vanish as they would with round-to-nearest.
+ *
+ * The random numbers come from a counter-based generator: the 32 random bits for element i of an array are a hash of
+ * the seed and the 64-bit index offset + i. Results therefore depend only on (seed, offset + i), not on how an array
+ * is split across calls or threads, and no generator state is shared or updated.
+ *
+ * Rounding adds random bits to the mantissa bits that do not fit into half-precision and clears them; the carry out of
+ * the discarded bits rounds up with exactly the right probability. Numbers below the smallest half-precision
+ * denormal round up with a probability of 2**-31 resolution instead. Infinity and NaN convert as in
+ * fp32_ieee_to_fp16_value and fp32_alt_to_fp16_value, and so do numbers that round up past the largest finite
+ * number.
+ */
+
+/*
+ * 32-bit integer hash with good avalanche behavior (xor-shift-multiply, "lowbias32" constants).
+ */
+static inline uint32_t fp16_stochastic_hash(uint32_t x) {
+	x ^= x >> 16;
+	x *= UINT32_C(0x7FEB352D);
+	x ^= x >> 15;
+	x *= UINT32_C(0x846CA68B);
+	x ^= x >> 16;
+	return x;
+}
+
+/*
+ * Derive the two 32-bit keys of the random number generator from a 64-bit seed.
+ */
+static inline void fp16_stochastic_keys(uint64_t seed, uint32_t keys[2]) {
+	keys[0] = fp16_stochastic_hash((uint32_t) seed ^ fp16_stochastic_hash((uint32_t) (seed >> 32)));
+	keys[1] = fp16_stochastic_hash(keys[0] ^ UINT32_C(0x9E3779B9));
+}
+
+/*
+ * Random bits for a 64-bit counter: hash(hash(low ^ key0 ^ high * golden) ^ key1).
+ */
+static inline uint32_t fp16_stochastic_random(const uint32_t keys[2], uint64_t index) {
+	const uint32_t x = (uint32_t) index ^ keys[0] ^ ((uint32_t) (index >> 32) * UINT32_C(0x9E3779B9));
+	return fp16_stochastic_hash(fp16_stochastic_hash(x) ^ keys[1]);
+}
+
+/*
+ * Apply stochastic rounding to the bits of a single-precision number: the result is a single-precision number that
+ * is exactly representable in half-precision (or beyond the half-precision range), one of the two neighbours of the
+ * input. Infinity and NaN are returned unchanged.
+ */
+static inline uint32_t fp16_stochastic_perturb(uint32_t w, uint32_t random) {
+	const uint32_t sign = w & UINT32_C(0x80000000);
+	const uint32_t nonsign = w & UINT32_C(0x7FFFFFFF);
+	const uint32_t exponent = nonsign >> 23;
+	if (nonsign >= UINT32_C(0x7F800000)) {
+		return w;
+	} else if (exponent >= 103) {
+		/* 13 mantissa bits do not fit into normalized half-precision, up to 23 into denormalized */
+		const uint32_t shift = exponent >= 113 ? 13 : 126 - exponent;
+		const uint32_t noise = random >> (32 - shift);
+		return sign | ((nonsign + noise) & (UINT32_C(0xFFFFFFFF) << shift));
+	} else {
+		/* Below 2**-24: round to 0 or 2**-24, with the input scaled by 2**55 as the 31-bit probability */
+		const uint32_t fraction = (uint32_t) (fp32b_to_fp32v(nonsign) * fp32b_to_fp32v(UINT32_C(0x5B000000)));
+		return sign | ((random >> 1) < fraction ? UINT32_C(0x33800000) : 0);
+	}
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * IEEE half-precision format, in bit representation, with stochastic rounding. The result is the same as for
+ * element index of fp32_ieee_to_fp16_array_stochastic with the same seed.
+ */
+static inline float16 fp32_ieee_to_fp16_value_stochastic(float f, uint64_t seed, uint64_t index) {
+	uint32_t keys[2];
+	fp16_stochastic_keys(seed, keys);
+	const uint32_t w = fp16_stochastic_perturb(fp32v_to_fp32b(f), fp16_stochastic_random(keys, index));
+	return fp32_ieee_to_fp16_value(fp32b_to_fp32v(w));
+}
+
+/*
+ * Convert a 32-bit floating-point number in IEEE single-precision format to a 16-bit floating-point number in
+ * ARM alternative half-precision format, in bit representation, with stochastic rounding.
+ */
+static inline float16 fp32_alt_to_fp16_value_stochastic(float f, uint64_t seed, uint64_t index) {
+	uint32_t keys[2];
+	fp16_stochastic_keys(seed, keys);
+	const uint32_t w = fp16_stochastic_perturb(fp32v_to_fp32b(f), fp16_stochastic_random(keys, index));
+	return fp32_alt_to_fp16_value(fp32b_to_fp32v(w));
+}
+
+#if FP16_SIMD_AVX2
+static inline __m256i fp16_simd_avx2_stochastic_hash(__m256i x) {
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32(0x7FEB352D));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32((int) UINT32_C(0x846CA68B)));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+	return x;
+}
+
+/*
+ * Random bits for the eight counters index, index + 1, ..., index + 7. The high half of the counter is one larger in
+ * the lanes where the low half wraps around, so those lanes use the key for the next high half.
+ */
+static inline __m256i fp16_simd_avx2_stochastic_random(const uint32_t keys[2], uint64_t index) {
+	const __m256i sign_bit = _mm256_set1_epi32((int) UINT32_C(0x80000000));
+	const uint32_t high = (uint32_t) (index >> 32);
+	const __m256i base_low = _mm256_set1_epi32((int) (uint32_t) index);
+	const __m256i low = _mm256_add_epi32(base_low, _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	const __m256i wrapped = _mm256_cmpgt_epi32(_mm256_xor_si256(base_low, sign_bit), _mm256_xor_si256(low, sign_bit));
+	const __m256i key = _mm256_blendv_epi8(
+		_mm256_set1_epi32((int) (keys[0] ^ (high * UINT32_C(0x9E3779B9)))),
+		_mm256_set1_epi32((int) (keys[0] ^ ((high + 1) * UINT32_C(0x9E3779B9)))),
+		wrapped);
+	return fp16_simd_avx2_stochastic_hash(
+		_mm256_xor_si256(fp16_simd_avx2_stochastic_hash(_mm256_xor_si256(low, key)), _mm256_set1_epi32((int) keys[1])));
+}
+
+/*
+ * Apply stochastic rounding to eight single-precision numbers. This is a branch-free vector transcription of
+ * fp16_stochastic_perturb: the results are converted exactly by F16C or the alternative-format kernel.
+ */
+static inline __m256 fp16_simd_avx2_stochastic_perturb(__m256 f, __m256i random) {
+	const __m256i sign_bit = _mm256_set1_epi32((int) UINT32_C(0x80000000));
+	const __m256i w = _mm256_castps_si256(f);
+	const __m256i sign = _mm256_and_si256(w, sign_bit);
+	const __m256i nonsign = _mm256_andnot_si256(sign_bit, w);
+	const __m256i exponent = _mm256_srli_epi32(nonsign, 23);
+
+	/* Non-finite lanes get no noise and keep all bits */
+	const __m256i nonfinite = _mm256_cmpgt_epi32(nonsign, _mm256_set1_epi32(0x7F800000 - 1));
+	const __m256i shift = _mm256_max_epi32(_mm256_sub_epi32(_mm256_set1_epi32(126), exponent), _mm256_set1_epi32(13));
+	const __m256i noise = _mm256_andnot_si256(nonfinite,
+		_mm256_srlv_epi32(random, _mm256_sub_epi32(_mm256_set1_epi32(32), shift)));
+	const __m256i keep = _mm256_or_si256(nonfinite, _mm256_sllv_epi32(_mm256_set1_epi32(-1), shift));
+	const __m256i rounded = _mm256_and_si256(_mm256_add_epi32(nonsign, noise), keep);
+
+	const __m256i fraction = _mm256_cvttps_epi32(
+		_mm256_mul_ps(_mm256_castsi256_ps(nonsign), _mm256_castsi256_ps(_mm256_set1_epi32(0x5B000000))));
+	const __m256i tiny_rounded = _mm256_and_si256(_mm256_cmpgt_epi32(fraction, _mm256_srli_epi32(random, 1)),
+		_mm256_set1_epi32(0x33800000));
+	const __m256i tiny = _mm256_cmpgt_epi32(_mm256_set1_epi32(103 << 23), nonsign);
+
+	return _mm256_castsi256_ps(_mm256_or_si256(sign, _mm256_blendv_epi8(rounded, tiny_rounded, tiny)));
+}
+#endif /* FP16_SIMD_AVX2 */
+
+/*
+ * Convert n single-precision numbers to IEEE half-precision with stochastic rounding. Element i uses the random bits
+ * for counter offset + i of the generator seeded with seed.
+ */
+static inline void fp32_ieee_to_fp16_array_stochastic(const float* input, float16* output, size_t n,
+	uint64_t seed, uint64_t offset)
+{
+	uint32_t keys[2];
+	fp16_stochastic_keys(seed, keys);
+#if FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		const __m256i random = fp16_simd_avx2_stochastic_random(keys, offset);
+		const __m256 f = fp16_simd_avx2_stochastic_perturb(_mm256_loadu_ps(input), random);
+		_mm_storeu_si128((__m128i*) output, _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+		input += 8;
+		output += 8;
+		offset += 8;
+	}
+	if (n != 0) {
+		const __m256 f = _mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n));
+		const __m256i random = fp16_simd_avx2_stochastic_random(keys, offset);
+		const __m256 rounded = fp16_simd_avx2_stochastic_perturb(f, random);
+		fp16_simd_avx2_store_u16x8_partial(output, _mm256_cvtps_ph(rounded, _MM_FROUND_TO_NEAREST_INT), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_ieee_to_fp16_value_stochastic(input[i], seed, offset + i);
+	}
+#endif
+}
+
+/*
+ * Convert n single-precision numbers to ARM alternative half-precision with stochastic rounding.
+ */
+static inline void fp32_alt_to_fp16_array_stochastic(const float* input, float16* output, size_t n,
+	uint64_t seed, uint64_t offset)
+{
+	uint32_t keys[2];
+	fp16_stochastic_keys(seed, keys);
+#if FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		const __m256i random = fp16_simd_avx2_stochastic_random(keys, offset);
+		const __m256 f = fp16_simd_avx2_stochastic_perturb(_mm256_loadu_ps(input), random);
+		_mm_storeu_si128((__m128i*) output, fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(f)));
+		input += 8;
+		output += 8;
+		offset += 8;
+	}
+	if (n != 0) {
+		const __m256 f = _mm256_maskload_ps(input, fp16_simd_avx2_mask_u32x8(n));
+		const __m256i random = fp16_simd_avx2_stochastic_random(keys, offset);
+		const __m256 rounded = fp16_simd_avx2_stochastic_perturb(f, random);
+		fp16_simd_avx2_store_u16x8_partial(output, fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(rounded)), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp32_alt_to_fp16_value_stochastic(input[i], seed, offset + i);
+	}
+#endif
+}
+
+#endif /* FP16_STOCHASTIC_H */
@@ -0,0 +1,406 @@
+#pragma once
+#ifndef FP16_STREAM_H
+#define FP16_STREAM_H
+
+#ifndef __cplusplus
+	#error "fp16/stream.h requires a C++11 compiler"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "fp16.h"
+#include "arena.h"
+#include "strided.h"
+
+/*
+ * Streaming conversion of chunks of numbers between threads, on lock-free bounded ring buffers.
+ *
+ * fp16::spsc_ring<T> is a ring for one producer thread and one consumer thread: each side owns one index, and keeps
+ * a cached copy of the other side's index, so that a push or a pop touches the other side's cache line only when the
+ * ring looks full or empty. fp16::mpmc_ring<T> is the bounded queue of Dmitry Vyukov, with a sequence number in every
+ * cell, for any number of producers and consumers (in particular, multiple producers and a single consumer). Both
+ * rings round the capacity up to a power of two; try_push and try_pop never block and return false if the ring is
+ * full or empty.
+ *
+ * fp16::stream_converter is a conversion stage between producer and consumer threads. It owns a fixed number of
+ * slots, each with an input chunk and an output chunk of chunk_elements numbers in page-backed memory
+ * (fp16_pages_allocate), and worker threads that convert submitted slots:
+ *
+ *   fp16::stream_converter stage(FP16_CONVERSION_FP32_TO_IEEE, 4096);
+ *   // producer threads
+ *   fp16::stream_converter::input_chunk in = stage.acquire();
+ *   read_frame((float*) in.data, in.capacity);
+ *   stage.submit(in, in.capacity);
+ *   // consumer threads
+ *   fp16::stream_converter::output_chunk out;
+ *   while (stage.pop(out)) {
+ *     store((const uint16_t*) out.data, out.count, out.sequence);
+ *     stage.release(out);
+ *   }
+ *
+ * Producers write into slot memory and consumers read from it, so no chunk is copied on the way. A slot goes from the
+ * free ring to the producer, the submitted ring, a worker, the ready ring and the consumer, and back to the free ring
+ * on release(); every ring can hold every slot, so pushes never fail. submit() numbers chunks in submission order; with
+ * more than one worker or producer, chunks can be popped out of order and the sequence numbers restore the order.
+ * Once close() is called, no more chunks may be submitted, and pop() returns false when every submitted chunk has been
+ * popped. Waiting threads spin for a short while and then yield.
+ */
+namespace fp16 {
+
+/* Spin-then-yield backoff for threads waiting on a ring */
+class stream_backoff {
+public:
+	stream_backoff() : spins(0) {}
+
+	void wait() {
+		if (spins < 64) {
+			spins++;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+private:
+	unsigned spins;
+};
+
+static inline size_t stream_ring_capacity(size_t capacity) {
+	size_t result = 2;
+	while (result < capacity) {
+		result *= 2;
+	}
+	return result;
+}
+
+template <typename T>
+class spsc_ring {
+public:
+	explicit spsc_ring(size_t capacity) :
+		mask(stream_ring_capacity(capacity) - 1),
+		cells(new T[mask + 1]),
+		head(0), cached_tail(0),
+		tail(0), cached_head(0)
+	{
+	}
+
+	spsc_ring(const spsc_ring&) = delete;
+	spsc_ring& operator=(const spsc_ring&) = delete;
+
+	size_t capacity() const {
+		return mask + 1;
+	}
+
+	/* Producer side */
+	bool try_push(const T& value) {
+		const size_t position = tail.load(std::memory_order_relaxed);
+		if (position - cached_head > mask) {
+			cached_head = head.load(std::memory_order_acquire);
+			if (position - cached_head > mask) {
+				return false;
+			}
+		}
+		cells[position & mask] = value;
+		tail.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Consumer side */
+	bool try_pop(T& value) {
+		const size_t position = head.load(std::memory_order_relaxed);
+		if (position == cached_tail) {
+			cached_tail = tail.load(std::memory_order_acquire);
+			if (position == cached_tail) {
+				return false;
+			}
+		}
+		value = cells[position & mask];
+		head.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	const size_t mask;
+	const std::unique_ptr<T[]> cells;
+	char padding0[64];
+	/* Consumer cache line */
+	std::atomic<size_t> head;
+	size_t cached_tail;
+	char padding1[64];
+	/* Producer cache line */
+	std::atomic<size_t> tail;
+	size_t cached_head;
+	char padding2[64];
+};
+
+template <typename T>
+class mpmc_ring {
+public:
+	explicit mpmc_ring(size_t capacity) :
+		mask(stream_ring_capacity(capacity) - 1),
+		cells(new cell[mask + 1]),
+		head(0),
+		tail(0)
+	{
+		for (size_t i = 0; i <= mask; i++) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	mpmc_ring(const mpmc_ring&) = delete;
+	mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+	size_t capacity() const {
+		return mask + 1;
+	}
+
+	bool try_push(const T& value) {
+		size_t position = tail.load(std::memory_order_relaxed);
+		for (;;) {
+			cell& c = cells[position & mask];
+			const size_t sequence = c.sequence.load(std::memory_order_acquire);
+			const ptrdiff_t difference = (ptrdiff_t) (sequence - position);
+			if (difference == 0) {
+				if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					c.value = value;
+					c.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0) {
+				/* The cell still holds the value pushed one lap ago */
+				return false;
+			} else {
+				position = tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	bool try_pop(T& value) {
+		size_t position = head.load(std::memory_order_relaxed);
+		for (;;) {
+			cell& c = cells[position & mask];
+			const size_t sequence = c.sequence.load(std::memory_order_acquire);
+			const ptrdiff_t difference = (ptrdiff_t) (sequence - (position + 1));
+			if (difference == 0) {
+				if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					value = c.value;
+					c.sequence.store(position + mask + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0) {
+				/* The cell has not been pushed yet in this lap */
+				return false;
+			} else {
+				position = head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+private:
+	struct cell {
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	const size_t mask;
+	const std::unique_ptr<cell[]> cells;
+	char padding0[64];
+	std::atomic<size_t> head;
+	char padding1[64];
+	std::atomic<size_t> tail;
+	char padding2[64];
+};
+
+class stream_converter {
+public:
+	struct input_chunk {
+		void* data;
+		size_t capacity;
+		uint32_t slot;
+	};
+
+	struct output_chunk {
+		const void* data;
+		size_t count;
+		uint64_t sequence;
+		uint32_t slot;
+	};
+
+	/*
+	 * A stage with `slots` slots of chunk_elements numbers and `workers` conversion threads. The slot memory is mapped
+	 * with the FP16_PAGES_* flags of fp16/arena.h, pre-faulted by default so that the stream takes no page faults.
+	 */
+	stream_converter(fp16_conversion_kind kind, size_t chunk_elements, size_t slots = 64, size_t workers = 1,
+		unsigned page_flags = FP16_PAGES_PREFAULT) :
+		kind_(kind),
+		chunk_elements_(chunk_elements),
+		slot_count_(slots != 0 ? slots : 1),
+		page_flags_(page_flags),
+		input_stride_(round_up(chunk_elements * fp16_conversion_input_size(kind))),
+		output_stride_(round_up(chunk_elements * fp16_conversion_output_size(kind))),
+		counts_(slot_count_),
+		sequences_(slot_count_),
+		free_(slot_count_),
+		submitted_(slot_count_),
+		ready_(slot_count_),
+		next_sequence_(0),
+		pending_(0),
+		closed_(false)
+	{
+		memory_ = static_cast<unsigned char*>(fp16_pages_allocate(memory_size(), page_flags_));
+		if (memory_ == NULL) {
+			throw std::bad_alloc();
+		}
+		for (size_t i = 0; i < slot_count_; i++) {
+			free_.try_push((uint32_t) i);
+		}
+		for (size_t i = 0; i < workers; i++) {
+			workers_.push_back(std::thread(&stream_converter::work, this));
+		}
+	}
+
+	stream_converter(const stream_converter&) = delete;
+	stream_converter& operator=(const stream_converter&) = delete;
+
+	~stream_converter() {
+		close();
+		for (std::thread& worker : workers_) {
+			worker.join();
+		}
+		fp16_pages_free(memory_, memory_size(), page_flags_);
+	}
+
+	size_t chunk_elements() const {
+		return chunk_elements_;
+	}
+
+	/* Take a free slot to fill with input numbers; fails if every slot is in use */
+	bool try_acquire(input_chunk& chunk) {
+		uint32_t slot;
+		if (!free_.try_pop(slot)) {
+			return false;
+		}
+		chunk.data = memory_ + slot * input_stride_;
+		chunk.capacity = chunk_elements_;
+		chunk.slot = slot;
+		return true;
+	}
+
+	input_chunk acquire() {
+		input_chunk chunk;
+		stream_backoff backoff;
+		while (!try_acquire(chunk)) {
+			backoff.wait();
+		}
+		return chunk;
+	}
+
+	/* Hand the first count numbers of an acquired chunk to the workers; returns the sequence number of the chunk */
+	uint64_t submit(const input_chunk& chunk, size_t count) {
+		const uint64_t sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+		counts_[chunk.slot] = count < chunk_elements_ ? count : chunk_elements_;
+		sequences_[chunk.slot] = sequence;
+		pending_.fetch_add(1, std::memory_order_relaxed);
+		submitted_.try_push(chunk.slot);
+		return sequence;
+	}
+
+	/* Take a converted chunk; fails if none is ready */
+	bool try_pop(output_chunk& chunk) {
+		uint32_t slot;
+		if (!ready_.try_pop(slot)) {
+			return false;
+		}
+		pending_.fetch_sub(1, std::memory_order_relaxed);
+		chunk.data = memory_ + slot_count_ * input_stride_ + slot * output_stride_;
+		chunk.count = counts_[slot];
+		chunk.sequence = sequences_[slot];
+		chunk.slot = slot;
+		return true;
+	}
+
+	/* Wait for a converted chunk; returns false once the stage is closed and every submitted chunk was popped */
+	bool pop(output_chunk& chunk) {
+		stream_backoff backoff;
+		for (;;) {
+			if (try_pop(chunk)) {
+				return true;
+			}
+			if (closed_.load(std::memory_order_acquire) && pending_.load(std::memory_order_acquire) == 0) {
+				return false;
+			}
+			backoff.wait();
+		}
+	}
+
+	/* Return a popped chunk's slot to the producers */
+	void release(const output_chunk& chunk) {
+		free_.try_push(chunk.slot);
+	}
+
+	/* No more chunks will be submitted; the workers exit once the submitted chunks are converted */
+	void close() {
+		closed_.store(true, std::memory_order_release);
+	}
+
+private:
+	static size_t round_up(size_t bytes) {
+		return (bytes + 63) / 64 * 64;
+	}
+
+	size_t memory_size() const {
+		return slot_count_ * (input_stride_ + output_stride_);
+	}
+
+	void convert_slot(uint32_t slot) {
+		fp16_convert_strided(kind_, memory_ + slot * input_stride_, 1,
+			memory_ + slot_count_ * input_stride_ + slot * output_stride_, 1, counts_[slot]);
+		ready_.try_push(slot);
+	}
+
+	void work() {
+		stream_backoff backoff;
+		for (;;) {
+			uint32_t slot;
+			if (submitted_.try_pop(slot)) {
+				convert_slot(slot);
+				backoff = stream_backoff();
+			} else if (closed_.load(std::memory_order_acquire)) {
+				/* Submissions happen before close(), so once the ring is seen empty after close() it stays empty */
+				if (!submitted_.try_pop(slot)) {
+					return;
+				}
+				convert_slot(slot);
+			} else {
+				backoff.wait();
+			}
+		}
+	}
+
+	const fp16_conversion_kind kind_;
+	const size_t chunk_elements_;
+	const size_t slot_count_;
+	const unsigned page_flags_;
+	const size_t input_stride_;
+	const size_t output_stride_;
+	unsigned char* memory_;
+	std::vector<size_t> counts_;
+	std::vector<uint64_t> sequences_;
+	mpmc_ring<uint32_t> free_;
+	mpmc_ring<uint32_t> submitted_;
+	mpmc_ring<uint32_t> ready_;
+	std::atomic<uint64_t> next_sequence_;
+	std::atomic<size_t> pending_;
+	std::atomic<bool> closed_;
+	std::vector<std::thread> workers_;
+};
+
+} /* namespace fp16 */
+
+#endif /* FP16_STREAM_H */
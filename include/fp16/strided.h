@@ -0,0 +1,304 @@
+#pragma once
+#ifndef FP16_STRIDED_H
+#define FP16_STRIDED_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fp16.h"
+#include "simd.h"
+#include "array.h"
+
+/*
+ * Conversions between non-contiguous arrays: 1D arrays with arbitrary element strides, 2D arrays with row and column
+ * strides, and N-dimensional arrays described by shape and stride vectors. All strides are in elements of the
+ * respective array (not bytes) and may be negative or zero for inputs.
+ *
+ * Arrays with unit strides on both sides go through the contiguous kernels in array.h. Otherwise, the AVX2 kernels
+ * gather eight inputs (vgatherdps for single-precision inputs, word inserts for half-precision inputs), convert them
+ * in registers, and store them contiguously or scatter them lane by lane, so no temporary copy of the array is made.
+ */
+
+enum fp16_conversion_kind {
+	FP16_CONVERSION_IEEE_TO_FP32 = 0,
+	FP16_CONVERSION_FP32_TO_IEEE = 1,
+	FP16_CONVERSION_ALT_TO_FP32 = 2,
+	FP16_CONVERSION_FP32_TO_ALT = 3,
+};
+
+#if FP16_SIMD_AVX2
+/* Largest stride for which the gather offsets of eight lanes fit into 32-bit indices */
+#define FP16_STRIDED_MAX_GATHER_STRIDE (INT32_MAX / 8)
+
+static inline __m256 fp16_strided_avx2_load_fp32(const float* p, ptrdiff_t stride) {
+	if (stride == 1) {
+		return _mm256_loadu_ps(p);
+	}
+	const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32((int) stride));
+	return _mm256_i32gather_ps(p, offsets, 4);
+}
+
+static inline __m128i fp16_strided_avx2_load_fp16(const uint16_t* p, ptrdiff_t stride) {
+	if (stride == 1) {
+		return _mm_loadu_si128((const __m128i*) p);
+	}
+	return _mm_setr_epi16(
+		(short) p[0], (short) p[stride], (short) p[2 * stride], (short) p[3 * stride],
+		(short) p[4 * stride], (short) p[5 * stride], (short) p[6 * stride], (short) p[7 * stride]);
+}
+
+static inline void fp16_strided_avx2_store_fp32(float* p, ptrdiff_t stride, __m256 f) {
+	if (stride == 1) {
+		_mm256_storeu_ps(p, f);
+		return;
+	}
+	const __m128 lo = _mm256_castps256_ps128(f);
+	const __m128 hi = _mm256_extractf128_ps(f, 1);
+	_mm_store_ss(p, lo);
+	_mm_store_ss(p + stride, _mm_shuffle_ps(lo, lo, _MM_SHUFFLE(1, 1, 1, 1)));
+	_mm_store_ss(p + 2 * stride, _mm_shuffle_ps(lo, lo, _MM_SHUFFLE(2, 2, 2, 2)));
+	_mm_store_ss(p + 3 * stride, _mm_shuffle_ps(lo, lo, _MM_SHUFFLE(3, 3, 3, 3)));
+	_mm_store_ss(p + 4 * stride, hi);
+	_mm_store_ss(p + 5 * stride, _mm_shuffle_ps(hi, hi, _MM_SHUFFLE(1, 1, 1, 1)));
+	_mm_store_ss(p + 6 * stride, _mm_shuffle_ps(hi, hi, _MM_SHUFFLE(2, 2, 2, 2)));
+	_mm_store_ss(p + 7 * stride, _mm_shuffle_ps(hi, hi, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+static inline void fp16_strided_avx2_store_fp16(uint16_t* p, ptrdiff_t stride, __m128i h) {
+	if (stride == 1) {
+		_mm_storeu_si128((__m128i*) p, h);
+		return;
+	}
+	p[0] = (uint16_t) _mm_extract_epi16(h, 0);
+	p[stride] = (uint16_t) _mm_extract_epi16(h, 1);
+	p[2 * stride] = (uint16_t) _mm_extract_epi16(h, 2);
+	p[3 * stride] = (uint16_t) _mm_extract_epi16(h, 3);
+	p[4 * stride] = (uint16_t) _mm_extract_epi16(h, 4);
+	p[5 * stride] = (uint16_t) _mm_extract_epi16(h, 5);
+	p[6 * stride] = (uint16_t) _mm_extract_epi16(h, 6);
+	p[7 * stride] = (uint16_t) _mm_extract_epi16(h, 7);
+}
+#endif /* FP16_SIMD_AVX2 */
+
+/*
+ * Convert n IEEE half-precision numbers at input[0], input[input_stride], ... to single-precision numbers at
+ * output[0], output[output_stride], ...
+ */
+static inline void fp16_ieee_to_fp32_strided(
+	const float16* input, ptrdiff_t input_stride,
+	float* output, ptrdiff_t output_stride,
+	size_t n)
+{
+	if (input_stride == 1 && output_stride == 1) {
+		fp16_ieee_to_fp32_array(input, output, n);
+		return;
+	}
+#if FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		fp16_strided_avx2_store_fp32(output, output_stride, _mm256_cvtph_ps(fp16_strided_avx2_load_fp16(input, input_stride)));
+		input += 8 * input_stride;
+		output += 8 * output_stride;
+	}
+#endif
+	for (; n != 0; n--) {
+		*output = fp16_ieee_to_fp32_value(*input);
+		input += input_stride;
+		output += output_stride;
+	}
+}
+
+/*
+ * Convert n single-precision numbers at input[0], input[input_stride], ... to IEEE half-precision numbers at
+ * output[0], output[output_stride], ...
+ */
+static inline void fp32_ieee_to_fp16_strided(
+	const float* input, ptrdiff_t input_stride,
+	float16* output, ptrdiff_t output_stride,
+	size_t n)
+{
+	if (input_stride == 1 && output_stride == 1) {
+		fp32_ieee_to_fp16_array(input, output, n);
+		return;
+	}
+#if FP16_SIMD_AVX2
+	if (input_stride <= FP16_STRIDED_MAX_GATHER_STRIDE && input_stride >= -FP16_STRIDED_MAX_GATHER_STRIDE) {
+		for (; n >= 8; n -= 8) {
+			const __m256 f = fp16_strided_avx2_load_fp32(input, input_stride);
+			fp16_strided_avx2_store_fp16(output, output_stride, _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+			input += 8 * input_stride;
+			output += 8 * output_stride;
+		}
+	}
+#endif
+	for (; n != 0; n--) {
+		*output = fp32_ieee_to_fp16_value(*input);
+		input += input_stride;
+		output += output_stride;
+	}
+}
+
+/*
+ * Convert n ARM alternative half-precision numbers at input[0], input[input_stride], ... to single-precision numbers
+ * at output[0], output[output_stride], ...
+ */
+static inline void fp16_alt_to_fp32_strided(
+	const float16* input, ptrdiff_t input_stride,
+	float* output, ptrdiff_t output_stride,
+	size_t n)
+{
+	if (input_stride == 1 && output_stride == 1) {
+		fp16_alt_to_fp32_array(input, output, n);
+		return;
+	}
+#if FP16_SIMD_AVX2
+	for (; n >= 8; n -= 8) {
+		fp16_strided_avx2_store_fp32(output, output_stride, fp16_simd_avx2_alt_to_fp32(fp16_strided_avx2_load_fp16(input, input_stride)));
+		input += 8 * input_stride;
+		output += 8 * output_stride;
+	}
+#endif
+	for (; n != 0; n--) {
+		*output = fp16_alt_to_fp32_value(*input);
+		input += input_stride;
+		output += output_stride;
+	}
+}
+
+/*
+ * Convert n single-precision numbers at input[0], input[input_stride], ... to ARM alternative half-precision numbers
+ * at output[0], output[output_stride], ...
+ */
+static inline void fp32_alt_to_fp16_strided(
+	const float* input, ptrdiff_t input_stride,
+	float16* output, ptrdiff_t output_stride,
+	size_t n)
+{
+	if (input_stride == 1 && output_stride == 1) {
+		fp32_alt_to_fp16_array(input, output, n);
+		return;
+	}
+#if FP16_SIMD_AVX2
+	if (input_stride <= FP16_STRIDED_MAX_GATHER_STRIDE && input_stride >= -FP16_STRIDED_MAX_GATHER_STRIDE) {
+		for (; n >= 8; n -= 8) {
+			const __m256 f = fp16_strided_avx2_load_fp32(input, input_stride);
+			fp16_strided_avx2_store_fp16(output, output_stride, fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(f)));
+			input += 8 * input_stride;
+			output += 8 * output_stride;
+		}
+	}
+#endif
+	for (; n != 0; n--) {
+		*output = fp32_alt_to_fp16_value(*input);
+		input += input_stride;
+		output += output_stride;
+	}
+}
+
+/* Size in bytes of the input and output elements of a conversion */
+static inline size_t fp16_conversion_input_size(enum fp16_conversion_kind kind) {
+	return kind == FP16_CONVERSION_FP32_TO_IEEE || kind == FP16_CONVERSION_FP32_TO_ALT ? sizeof(float) : sizeof(float16);
+}
+
+static inline size_t fp16_conversion_output_size(enum fp16_conversion_kind kind) {
+	return kind == FP16_CONVERSION_FP32_TO_IEEE || kind == FP16_CONVERSION_FP32_TO_ALT ? sizeof(float16) : sizeof(float);
+}
+
+/*
+ * Strided conversion of any kind, with input and output passed as untyped pointers.
+ */
+static inline void fp16_convert_strided(enum fp16_conversion_kind kind,
+	const void* input, ptrdiff_t input_stride,
+	void* output, ptrdiff_t output_stride,
+	size_t n)
+{
+	switch (kind) {
+		case FP16_CONVERSION_IEEE_TO_FP32:
+			fp16_ieee_to_fp32_strided((const float16*) input, input_stride, (float*) output, output_stride, n);
+			break;
+		case FP16_CONVERSION_FP32_TO_IEEE:
+			fp32_ieee_to_fp16_strided((const float*) input, input_stride, (float16*) output, output_stride, n);
+			break;
+		case FP16_CONVERSION_ALT_TO_FP32:
+			fp16_alt_to_fp32_strided((const float16*) input, input_stride, (float*) output, output_stride, n);
+			break;
+		case FP16_CONVERSION_FP32_TO_ALT:
+			fp32_alt_to_fp16_strided((const float*) input, input_stride, (float16*) output, output_stride, n);
+			break;
+	}
+}
+
+/*
+ * Convert a rows x columns matrix. Element (i, j) of the input is at input[i * input_row_stride + j * input_column_stride],
+ * and likewise for the output. If both matrices are dense along rows, they are converted as a single 1D array.
+ * When the rows are short and the columns long, the matrix is traversed column by column instead.
+ */
+static inline void fp16_convert_2d(enum fp16_conversion_kind kind, size_t rows, size_t columns,
+	const void* input, ptrdiff_t input_row_stride, ptrdiff_t input_column_stride,
+	void* output, ptrdiff_t output_row_stride, ptrdiff_t output_column_stride)
+{
+	if (rows == 0 || columns == 0) {
+		return;
+	}
+	if (input_column_stride * (ptrdiff_t) columns == input_row_stride &&
+		output_column_stride * (ptrdiff_t) columns == output_row_stride)
+	{
+		fp16_convert_strided(kind, input, input_column_stride, output, output_column_stride, rows * columns);
+		return;
+	}
+	if (columns < rows && input_column_stride != 1 && output_column_stride != 1) {
+		/* Transposed traversal: the long dimension becomes the inner loop */
+		size_t swap = rows;
+		rows = columns;
+		columns = swap;
+		ptrdiff_t swap_stride = input_row_stride;
+		input_row_stride = input_column_stride;
+		input_column_stride = swap_stride;
+		swap_stride = output_row_stride;
+		output_row_stride = output_column_stride;
+		output_column_stride = swap_stride;
+	}
+	const unsigned char* input_row = (const unsigned char*) input;
+	unsigned char* output_row = (unsigned char*) output;
+	const ptrdiff_t input_row_bytes = input_row_stride * (ptrdiff_t) fp16_conversion_input_size(kind);
+	const ptrdiff_t output_row_bytes = output_row_stride * (ptrdiff_t) fp16_conversion_output_size(kind);
+	for (size_t i = 0; i < rows; i++) {
+		fp16_convert_strided(kind, input_row, input_column_stride, output_row, output_column_stride, columns);
+		input_row += input_row_bytes;
+		output_row += output_row_bytes;
+	}
+}
+
+/*
+ * Convert an N-dimensional array with the given shape. Element (i[0], ..., i[ndim - 1]) of the input is at
+ * input[i[0] * input_strides[0] + ... + i[ndim - 1] * input_strides[ndim - 1]], and likewise for the output.
+ * The two innermost dimensions are converted with fp16_convert_2d.
+ */
+static inline void fp16_convert_nd(enum fp16_conversion_kind kind, size_t ndim, const size_t* shape,
+	const void* input, const ptrdiff_t* input_strides,
+	void* output, const ptrdiff_t* output_strides)
+{
+	switch (ndim) {
+		case 0:
+			fp16_convert_strided(kind, input, 1, output, 1, 1);
+			return;
+		case 1:
+			fp16_convert_strided(kind, input, input_strides[0], output, output_strides[0], shape[0]);
+			return;
+		case 2:
+			fp16_convert_2d(kind, shape[0], shape[1],
+				input, input_strides[0], input_strides[1],
+				output, output_strides[0], output_strides[1]);
+			return;
+	}
+	const unsigned char* input_slice = (const unsigned char*) input;
+	unsigned char* output_slice = (unsigned char*) output;
+	const ptrdiff_t input_slice_bytes = input_strides[0] * (ptrdiff_t) fp16_conversion_input_size(kind);
+	const ptrdiff_t output_slice_bytes = output_strides[0] * (ptrdiff_t) fp16_conversion_output_size(kind);
+	for (size_t i = 0; i < shape[0]; i++) {
+		fp16_convert_nd(kind, ndim - 1, shape + 1, input_slice, input_strides + 1, output_slice, output_strides + 1);
+		input_slice += input_slice_bytes;
+		output_slice += output_slice_bytes;
+	}
+}
+
+#endif /* FP16_STRIDED_H */
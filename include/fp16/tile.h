@@ -0,0 +1,185 @@
+#pragma once
+#ifndef FP16_TILE_H
+#define FP16_TILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__APPLE__)
+	#include <sys/types.h>
+	#include <sys/sysctl.h>
+#elif defined(__unix__)
+	#include <unistd.h>
+#endif
+
+#include "fp16.h"
+#include "array.h"
+
+/*
+ * Tiled conversions for arrays that are decoded only to be consumed once, or produced only to be encoded.
+ *
+ * fp16_ieee_to_fp32_tiled decodes a half-precision array one tile at a time into a scratch buffer of single-precision
+ * numbers, and calls a consumer with every tile while it is still in cache. fp32_ieee_to_fp16_tiled calls a producer
+ * to fill the scratch buffer with the next tile and encodes it into a half-precision array. Either way, the
+ * single-precision data never takes more memory than one tile, however long the array is:
+ *
+ *   static int accumulate(float* tile, size_t offset, size_t count, void* context) {
+ *     double* sum = (double*) context;
+ *     for (size_t i = 0; i < count; i++) *sum += tile[i];
+ *     return 0;
+ *   }
+ *   double sum = 0.0;
+ *   fp16_ieee_to_fp32_tiled(x, n, NULL, 0, accumulate, &sum);
+ *
+ * Tiles hold `tile` elements, except for the last one, and are passed with their offset in the array. With tile == 0,
+ * the tile takes half of the L1 data cache (fp16_tile_elements), so the tile and the half-precision numbers it is
+ * converted from or to stay in L1 together. With scratch == NULL, the scratch buffer is on the stack and tiles are
+ * limited to FP16_TILE_MAX_ELEMENTS; a caller-provided scratch buffer must hold `tile` elements and may be sized for
+ * the L2 cache instead, e.g. with fp16_tile_elements(fp16_cache_size(2)), and taken from a per-thread fp16_arena
+ * (fp16/arena.h) so that repeated calls reuse the same pages.
+ *
+ * The callback may read and write the scratch buffer, which is overwritten by the next tile. If it returns non-zero,
+ * the conversion stops after the current tile. The functions return the number of elements converted.
+ */
+
+/* Number of elements of the largest tile kept on the stack when the caller provides no scratch buffer */
+#ifndef FP16_TILE_MAX_ELEMENTS
+	#define FP16_TILE_MAX_ELEMENTS 8192
+#endif
+
+/* Cache sizes in bytes assumed where they cannot be queried */
+#ifndef FP16_TILE_DEFAULT_L1_CACHE_SIZE
+	#define FP16_TILE_DEFAULT_L1_CACHE_SIZE 32768
+#endif
+#ifndef FP16_TILE_DEFAULT_L2_CACHE_SIZE
+	#define FP16_TILE_DEFAULT_L2_CACHE_SIZE 262144
+#endif
+
+typedef int (*fp16_tile_callback)(float* tile, size_t offset, size_t count, void* context);
+
+/*
+ * Size in bytes of the level 1 data cache (level 1) or of the level 2 cache (level 2) of the processor, from sysconf
+ * with glibc and from sysctl on Apple platforms.
+ */
+static inline size_t fp16_cache_size(unsigned level) {
+	long size = 0;
+#if defined(__APPLE__)
+	int64_t value = 0;
+	size_t length = sizeof(value);
+	if (sysctlbyname(level <= 1 ? "hw.l1dcachesize" : "hw.l2cachesize", &value, &length, NULL, 0) == 0) {
+		size = (long) value;
+	}
+#elif defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+	size = sysconf(level <= 1 ? _SC_LEVEL1_DCACHE_SIZE : _SC_LEVEL2_CACHE_SIZE);
+#endif
+	if (size > 0) {
+		return (size_t) size;
+	}
+	return level <= 1 ? FP16_TILE_DEFAULT_L1_CACHE_SIZE : FP16_TILE_DEFAULT_L2_CACHE_SIZE;
+}
+
+/*
+ * Number of single-precision elements in a tile that takes half of a cache of the given size in bytes, as a multiple
+ * of 64 elements (four AVX-512 vectors) and at least 64 elements.
+ */
+static inline size_t fp16_tile_elements(size_t cache_size) {
+	const size_t elements = cache_size / 2 / sizeof(float) / 64 * 64;
+	return elements > 64 ? elements : 64;
+}
+
+/*
+ * Shared implementation of the decoding functions: alt selects the ARM alternative half-precision format.
+ */
+static inline size_t fp16_to_fp32_tiled(const float16* input, size_t n, float* scratch, size_t tile, int alt,
+	fp16_tile_callback consumer, void* context)
+{
+	float buffer[FP16_TILE_MAX_ELEMENTS + 16];
+	if (tile == 0) {
+		tile = fp16_tile_elements(fp16_cache_size(1));
+	}
+	if (scratch == NULL) {
+		/* Align the stack tile to a cache line, so that no vector store is split across two lines */
+		scratch = (float*) (((uintptr_t) buffer + 63) & ~(uintptr_t) 63);
+		tile = tile < FP16_TILE_MAX_ELEMENTS ? tile : FP16_TILE_MAX_ELEMENTS;
+	}
+	for (size_t offset = 0; offset < n; offset += tile) {
+		const size_t count = n - offset < tile ? n - offset : tile;
+		if (alt) {
+			fp16_alt_to_fp32_array(input + offset, scratch, count);
+		} else {
+			fp16_ieee_to_fp32_array(input + offset, scratch, count);
+		}
+		if (consumer(scratch, offset, count, context) != 0) {
+			return offset + count;
+		}
+	}
+	return n;
+}
+
+/*
+ * Shared implementation of the encoding functions: alt selects the ARM alternative half-precision format.
+ */
+static inline size_t fp32_to_fp16_tiled(float16* output, size_t n, float* scratch, size_t tile, int alt,
+	fp16_tile_callback producer, void* context)
+{
+	float buffer[FP16_TILE_MAX_ELEMENTS + 16];
+	if (tile == 0) {
+		tile = fp16_tile_elements(fp16_cache_size(1));
+	}
+	if (scratch == NULL) {
+		scratch = (float*) (((uintptr_t) buffer + 63) & ~(uintptr_t) 63);
+		tile = tile < FP16_TILE_MAX_ELEMENTS ? tile : FP16_TILE_MAX_ELEMENTS;
+	}
+	for (size_t offset = 0; offset < n; offset += tile) {
+		const size_t count = n - offset < tile ? n - offset : tile;
+		const int stop = producer(scratch, offset, count, context);
+		if (alt) {
+			fp32_alt_to_fp16_array(scratch, output + offset, count);
+		} else {
+			fp32_ieee_to_fp16_array(scratch, output + offset, count);
+		}
+		if (stop != 0) {
+			return offset + count;
+		}
+	}
+	return n;
+}
+
+/*
+ * Decode n IEEE half-precision numbers tile by tile and pass every tile of single-precision numbers to the consumer.
+ */
+static inline size_t fp16_ieee_to_fp32_tiled(const float16* input, size_t n, float* scratch, size_t tile,
+	fp16_tile_callback consumer, void* context)
+{
+	return fp16_to_fp32_tiled(input, n, scratch, tile, 0, consumer, context);
+}
+
+/*
+ * Fill tiles of single-precision numbers with the producer and encode them into n IEEE half-precision numbers.
+ */
+static inline size_t fp32_ieee_to_fp16_tiled(float16* output, size_t n, float* scratch, size_t tile,
+	fp16_tile_callback producer, void* context)
+{
+	return fp32_to_fp16_tiled(output, n, scratch, tile, 0, producer, context);
+}
+
+/*
+ * Decode n ARM alternative half-precision numbers tile by tile and pass every tile to the consumer.
+ */
+static inline size_t fp16_alt_to_fp32_tiled(const float16* input, size_t n, float* scratch, size_t tile,
+	fp16_tile_callback consumer, void* context)
+{
+	return fp16_to_fp32_tiled(input, n, scratch, tile, 1, consumer, context);
+}
+
+/*
+ * Fill tiles of single-precision numbers with the producer and encode them into n ARM alternative half-precision
+ * numbers.
+ */
+static inline size_t fp32_alt_to_fp16_tiled(float16* output, size_t n, float* scratch, size_t tile,
+	fp16_tile_callback producer, void* context)
+{
+	return fp32_to_fp16_tiled(output, n, scratch, tile, 1, producer, context);
+}
+
+#endif /* FP16_TILE_H */
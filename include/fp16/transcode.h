@@ -0,0 +1,153 @@
+#pragma once
+#ifndef FP16_TRANSCODE_H
+#define FP16_TRANSCODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fp16.h"
+#include "simd.h"
+#include "policy.h"
+
+/*
+ * Direct transcoding between IEEE half-precision and ARM alternative half-precision, with integer operations only.
+ *
+ * Both formats share the sign, exponent, and mantissa layout and bias, so every number below 65536 in magnitude has
+ * the same bits in both; only exponent 31 differs. In the IEEE format it encodes infinities and NaN, in the
+ * alternative format the numbers from 65536 to 131008. The results equal the two-step conversions through
+ * single-precision with the encode policies of policy.h:
+ *
+ * - Alternative to IEEE: numbers from 65536 overflow to infinity, or become +-65504 with FP16_ENCODE_SATURATE.
+ * - IEEE to alternative: infinities become +-131008, as the alternative format always saturates. NaN becomes
+ *   +-131008 with the sign of the NaN, or nan_value with FP16_ENCODE_NAN_TO_VALUE.
+ * - FP16_ENCODE_FLUSH_DENORMALS flushes denormalized numbers to zero of the same sign in either direction.
+ */
+
+/*
+ * Convert a 16-bit floating-point number in ARM alternative half-precision format to IEEE half-precision format,
+ * both in bit representation, with the given encode policies.
+ */
+static inline float16 fp16_alt_to_fp16_ieee_value(float16 h, unsigned flags) {
+	const float16 ieee = (h & UINT16_C(0x7FFF)) >= UINT16_C(0x7C00) ? (float16) ((h & UINT16_C(0x8000)) | UINT16_C(0x7C00)) : h;
+	return fp16_apply_encode_policy(ieee, 0, flags, 0);
+}
+
+/*
+ * Convert a 16-bit floating-point number in IEEE half-precision format to ARM alternative half-precision format,
+ * both in bit representation, with the given encode policies.
+ */
+static inline float16 fp16_ieee_to_fp16_alt_value(float16 h, unsigned flags, float16 nan_value) {
+	const uint16_t nonsign = h & UINT16_C(0x7FFF);
+	const float16 alt = nonsign >= UINT16_C(0x7C00) ? (float16) (h | UINT16_C(0x7FFF)) : h;
+	/* Results are never 0x7C00 in magnitude, so FP16_ENCODE_SATURATE has no effect */
+	return fp16_apply_encode_policy(alt, nonsign > UINT16_C(0x7C00), flags, nan_value);
+}
+
+#if FP16_SIMD_AVX2
+/*
+ * Transcode sixteen ARM alternative half-precision numbers to IEEE half-precision, as in fp16_alt_to_fp16_ieee_value.
+ */
+static inline __m256i fp16_simd_avx2_alt_to_ieee_u16x16(__m256i h, struct fp16_simd_avx2_policy policy) {
+	const __m256i sign = _mm256_and_si256(h, _mm256_set1_epi16((short) 0x8000));
+	const __m256i overflow = _mm256_cmpgt_epi16(_mm256_andnot_si256(sign, h), _mm256_set1_epi16(0x7BFF));
+	h = _mm256_blendv_epi8(h, _mm256_or_si256(sign, _mm256_set1_epi16(0x7C00)), overflow);
+	return fp16_simd_avx2_apply_policy_u16x16(h, _mm256_setzero_si256(), policy);
+}
+
+/*
+ * Transcode sixteen IEEE half-precision numbers to ARM alternative half-precision, as in fp16_ieee_to_fp16_alt_value.
+ */
+static inline __m256i fp16_simd_avx2_ieee_to_alt_u16x16(__m256i h, struct fp16_simd_avx2_policy policy) {
+	const __m256i nonsign = _mm256_and_si256(h, _mm256_set1_epi16(0x7FFF));
+	const __m256i inf_nan = _mm256_cmpgt_epi16(nonsign, _mm256_set1_epi16(0x7BFF));
+	const __m256i nan = _mm256_cmpgt_epi16(nonsign, _mm256_set1_epi16(0x7C00));
+	h = _mm256_or_si256(h, _mm256_and_si256(inf_nan, _mm256_set1_epi16(0x7FFF)));
+	return fp16_simd_avx2_apply_policy_u16x16(h, nan, policy);
+}
+#endif /* FP16_SIMD_AVX2 */
+
+/*
+ * Convert n ARM alternative half-precision numbers to IEEE half-precision with the given encode policies.
+ * The input and output may be the same array.
+ */
+static inline void fp16_alt_to_fp16_ieee_array(const float16* input, float16* output, size_t n, unsigned flags) {
+#if FP16_SIMD_AVX512
+	const struct fp16_simd_avx2_policy policy = fp16_simd_avx2_make_policy(flags, 0);
+	for (; n >= 16; n -= 16) {
+		const __m256i h = _mm256_loadu_si256((const __m256i*) input);
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx2_alt_to_ieee_u16x16(h, policy));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm256_mask_storeu_epi16(output, mask, fp16_simd_avx2_alt_to_ieee_u16x16(_mm256_maskz_loadu_epi16(mask, input), policy));
+#elif FP16_SIMD_AVX2
+	const struct fp16_simd_avx2_policy policy = fp16_simd_avx2_make_policy(flags, 0);
+	for (; n >= 16; n -= 16) {
+		const __m256i h = _mm256_loadu_si256((const __m256i*) input);
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx2_alt_to_ieee_u16x16(h, policy));
+		input += 16;
+		output += 16;
+	}
+	if (n >= 8) {
+		const __m256i h = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) input));
+		_mm_storeu_si128((__m128i*) output, _mm256_castsi256_si128(fp16_simd_avx2_alt_to_ieee_u16x16(h, policy)));
+		input += 8;
+		output += 8;
+		n -= 8;
+	}
+	if (n != 0) {
+		const __m256i h = _mm256_castsi128_si256(fp16_simd_avx2_load_u16x8_partial(input, n));
+		fp16_simd_avx2_store_u16x8_partial(output, _mm256_castsi256_si128(fp16_simd_avx2_alt_to_ieee_u16x16(h, policy)), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp16_alt_to_fp16_ieee_value(input[i], flags);
+	}
+#endif
+}
+
+/*
+ * Convert n IEEE half-precision numbers to ARM alternative half-precision with the given encode policies.
+ * The input and output may be the same array.
+ */
+static inline void fp16_ieee_to_fp16_alt_array(const float16* input, float16* output, size_t n,
+	unsigned flags, float16 nan_value)
+{
+#if FP16_SIMD_AVX512
+	const struct fp16_simd_avx2_policy policy = fp16_simd_avx2_make_policy(flags, nan_value);
+	for (; n >= 16; n -= 16) {
+		const __m256i h = _mm256_loadu_si256((const __m256i*) input);
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx2_ieee_to_alt_u16x16(h, policy));
+		input += 16;
+		output += 16;
+	}
+	const __mmask16 mask = fp16_simd_avx512_mask16(n);
+	_mm256_mask_storeu_epi16(output, mask, fp16_simd_avx2_ieee_to_alt_u16x16(_mm256_maskz_loadu_epi16(mask, input), policy));
+#elif FP16_SIMD_AVX2
+	const struct fp16_simd_avx2_policy policy = fp16_simd_avx2_make_policy(flags, nan_value);
+	for (; n >= 16; n -= 16) {
+		const __m256i h = _mm256_loadu_si256((const __m256i*) input);
+		_mm256_storeu_si256((__m256i*) output, fp16_simd_avx2_ieee_to_alt_u16x16(h, policy));
+		input += 16;
+		output += 16;
+	}
+	if (n >= 8) {
+		const __m256i h = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) input));
+		_mm_storeu_si128((__m128i*) output, _mm256_castsi256_si128(fp16_simd_avx2_ieee_to_alt_u16x16(h, policy)));
+		input += 8;
+		output += 8;
+		n -= 8;
+	}
+	if (n != 0) {
+		const __m256i h = _mm256_castsi128_si256(fp16_simd_avx2_load_u16x8_partial(input, n));
+		fp16_simd_avx2_store_u16x8_partial(output, _mm256_castsi256_si128(fp16_simd_avx2_ieee_to_alt_u16x16(h, policy)), n);
+	}
+#else
+	for (size_t i = 0; i < n; i++) {
+		output[i] = fp16_ieee_to_fp16_alt_value(input[i], flags, nan_value);
+	}
+#endif
+}
+
+#endif /* FP16_TRANSCODE_H */
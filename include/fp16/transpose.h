@@ -0,0 +1,232 @@
+#pragma once
+#ifndef FP16_TRANSPOSE_H
+#define FP16_TRANSPOSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fp16.h"
+#include "simd.h"
+#include "array.h"
+#include "strided.h"
+
+/*
+ * Fused transpose-and-convert of matrices. The input is a rows x columns matrix with element (i, j) at
+ * input[i * input_stride + j]; the output is the columns x rows matrix with element (j, i) at
+ * output[j * output_stride + i]. A row-major input thus becomes a column-major output in a single pass, without the
+ * intermediate matrix of a separate transpose.
+ *
+ * The matrices are traversed in square cache blocks of FP16_TRANSPOSE_BLOCK elements. Inside a block, the AVX2
+ * kernels convert 8x8 tiles: eight input rows are loaded and converted, the tile of 16-bit values is transposed in
+ * registers, and eight output rows are stored. Elements of partial tiles at the right and bottom edges are converted
+ * one by one.
+ */
+
+#ifndef FP16_TRANSPOSE_BLOCK
+	#define FP16_TRANSPOSE_BLOCK 64
+#endif
+
+#if FP16_SIMD_AVX2
+/*
+ * Transpose an 8x8 matrix of 16-bit elements held in eight vectors, one row per vector.
+ */
+static inline void fp16_transpose_8x8_u16(__m128i rows[8]) {
+	const __m128i a0 = _mm_unpacklo_epi16(rows[0], rows[1]);
+	const __m128i a1 = _mm_unpackhi_epi16(rows[0], rows[1]);
+	const __m128i a2 = _mm_unpacklo_epi16(rows[2], rows[3]);
+	const __m128i a3 = _mm_unpackhi_epi16(rows[2], rows[3]);
+	const __m128i a4 = _mm_unpacklo_epi16(rows[4], rows[5]);
+	const __m128i a5 = _mm_unpackhi_epi16(rows[4], rows[5]);
+	const __m128i a6 = _mm_unpacklo_epi16(rows[6], rows[7]);
+	const __m128i a7 = _mm_unpackhi_epi16(rows[6], rows[7]);
+
+	const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	rows[0] = _mm_unpacklo_epi64(b0, b4);
+	rows[1] = _mm_unpackhi_epi64(b0, b4);
+	rows[2] = _mm_unpacklo_epi64(b1, b5);
+	rows[3] = _mm_unpackhi_epi64(b1, b5);
+	rows[4] = _mm_unpacklo_epi64(b2, b6);
+	rows[5] = _mm_unpackhi_epi64(b2, b6);
+	rows[6] = _mm_unpacklo_epi64(b3, b7);
+	rows[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+static inline void fp32_ieee_to_fp16_transpose_8x8(const void* input_tile, size_t input_stride, void* output_tile, size_t output_stride) {
+	const float* input = (const float*) input_tile;
+	float16* output = (float16*) output_tile;
+	__m128i tile[8];
+	for (size_t k = 0; k < 8; k++) {
+		tile[k] = _mm256_cvtps_ph(_mm256_loadu_ps(input + k * input_stride), _MM_FROUND_TO_NEAREST_INT);
+	}
+	fp16_transpose_8x8_u16(tile);
+	for (size_t k = 0; k < 8; k++) {
+		_mm_storeu_si128((__m128i*) (output + k * output_stride), tile[k]);
+	}
+}
+
+static inline void fp16_ieee_to_fp32_transpose_8x8(const void* input_tile, size_t input_stride, void* output_tile, size_t output_stride) {
+	const float16* input = (const float16*) input_tile;
+	float* output = (float*) output_tile;
+	__m128i tile[8];
+	for (size_t k = 0; k < 8; k++) {
+		tile[k] = _mm_loadu_si128((const __m128i*) (input + k * input_stride));
+	}
+	fp16_transpose_8x8_u16(tile);
+	for (size_t k = 0; k < 8; k++) {
+		_mm256_storeu_ps(output + k * output_stride, _mm256_cvtph_ps(tile[k]));
+	}
+}
+
+static inline void fp32_alt_to_fp16_transpose_8x8(const void* input_tile, size_t input_stride, void* output_tile, size_t output_stride) {
+	const float* input = (const float*) input_tile;
+	float16* output = (float16*) output_tile;
+	__m128i tile[8];
+	for (size_t k = 0; k < 8; k++) {
+		tile[k] = fp16_simd_avx2_pack_u32x8(fp16_simd_avx2_fp32_to_alt_u32(_mm256_loadu_ps(input + k * input_stride)));
+	}
+	fp16_transpose_8x8_u16(tile);
+	for (size_t k = 0; k < 8; k++) {
+		_mm_storeu_si128((__m128i*) (output + k * output_stride), tile[k]);
+	}
+}
+
+static inline void fp16_alt_to_fp32_transpose_8x8(const void* input_tile, size_t input_stride, void* output_tile, size_t output_stride) {
+	const float16* input = (const float16*) input_tile;
+	float* output = (float*) output_tile;
+	__m128i tile[8];
+	for (size_t k = 0; k < 8; k++) {
+		tile[k] = _mm_loadu_si128((const __m128i*) (input + k * input_stride));
+	}
+	fp16_transpose_8x8_u16(tile);
+	for (size_t k = 0; k < 8; k++) {
+		_mm256_storeu_ps(output + k * output_stride, fp16_simd_avx2_alt_to_fp32(tile[k]));
+	}
+}
+#endif /* FP16_SIMD_AVX2 */
+
+/*
+ * Convert the element at input to the element at output with the scalar conversion of the given kind.
+ */
+static inline void fp16_transpose_convert_element(enum fp16_conversion_kind kind, const void* input, void* output) {
+	switch (kind) {
+		case FP16_CONVERSION_IEEE_TO_FP32:
+			*(float*) output = fp16_ieee_to_fp32_value(*(const float16*) input);
+			break;
+		case FP16_CONVERSION_FP32_TO_IEEE:
+			*(float16*) output = fp32_ieee_to_fp16_value(*(const float*) input);
+			break;
+		case FP16_CONVERSION_ALT_TO_FP32:
+			*(float*) output = fp16_alt_to_fp32_value(*(const float16*) input);
+			break;
+		case FP16_CONVERSION_FP32_TO_ALT:
+			*(float16*) output = fp32_alt_to_fp16_value(*(const float*) input);
+			break;
+	}
+}
+
+/*
+ * Blocked traversal shared by all transposes, with input and output passed as untyped pointers. The tile kernel
+ * converts full 8x8 tiles and may be NULL, in which case every element goes through the scalar conversion.
+ */
+static inline void fp16_transpose_blocked(enum fp16_conversion_kind kind, size_t rows, size_t columns,
+	const void* input, size_t input_stride,
+	void* output, size_t output_stride,
+	void (*tile)(const void*, size_t, void*, size_t))
+{
+	const unsigned char* input_bytes = (const unsigned char*) input;
+	unsigned char* output_bytes = (unsigned char*) output;
+	const size_t input_size = fp16_conversion_input_size(kind);
+	const size_t output_size = fp16_conversion_output_size(kind);
+	for (size_t ib = 0; ib < rows; ib += FP16_TRANSPOSE_BLOCK) {
+		const size_t ie = rows - ib < FP16_TRANSPOSE_BLOCK ? rows : ib + FP16_TRANSPOSE_BLOCK;
+		const size_t ie8 = tile != NULL ? ib + ((ie - ib) & ~(size_t) 7) : ib;
+		for (size_t jb = 0; jb < columns; jb += FP16_TRANSPOSE_BLOCK) {
+			const size_t je = columns - jb < FP16_TRANSPOSE_BLOCK ? columns : jb + FP16_TRANSPOSE_BLOCK;
+			const size_t je8 = jb + ((je - jb) & ~(size_t) 7);
+			for (size_t i = ib; i < ie8; i += 8) {
+				for (size_t j = jb; j < je8; j += 8) {
+					tile(input_bytes + (i * input_stride + j) * input_size, input_stride,
+						output_bytes + (j * output_stride + i) * output_size, output_stride);
+				}
+				for (size_t j = je8; j < je; j++) {
+					for (size_t k = i; k < i + 8; k++) {
+						fp16_transpose_convert_element(kind, input_bytes + (k * input_stride + j) * input_size,
+							output_bytes + (j * output_stride + k) * output_size);
+					}
+				}
+			}
+			for (size_t j = jb; j < je; j++) {
+				for (size_t i = ie8; i < ie; i++) {
+					fp16_transpose_convert_element(kind, input_bytes + (i * input_stride + j) * input_size,
+						output_bytes + (j * output_stride + i) * output_size);
+				}
+			}
+		}
+	}
+}
+
+#if FP16_SIMD_AVX2
+	#define FP16_TRANSPOSE_KERNEL(kernel) kernel
+#else
+	#define FP16_TRANSPOSE_KERNEL(kernel) NULL
+#endif
+
+/*
+ * Convert a rows x columns matrix of single-precision numbers into the transposed columns x rows matrix of IEEE
+ * half-precision numbers. Strides are in elements and must be at least columns (input) and rows (output).
+ */
+static inline void fp32_ieee_to_fp16_transpose(size_t rows, size_t columns,
+	const float* input, size_t input_stride,
+	float16* output, size_t output_stride)
+{
+	fp16_transpose_blocked(FP16_CONVERSION_FP32_TO_IEEE, rows, columns, input, input_stride, output, output_stride,
+		FP16_TRANSPOSE_KERNEL(fp32_ieee_to_fp16_transpose_8x8));
+}
+
+/*
+ * Convert a rows x columns matrix of IEEE half-precision numbers into the transposed columns x rows matrix of
+ * single-precision numbers.
+ */
+static inline void fp16_ieee_to_fp32_transpose(size_t rows, size_t columns,
+	const float16* input, size_t input_stride,
+	float* output, size_t output_stride)
+{
+	fp16_transpose_blocked(FP16_CONVERSION_IEEE_TO_FP32, rows, columns, input, input_stride, output, output_stride,
+		FP16_TRANSPOSE_KERNEL(fp16_ieee_to_fp32_transpose_8x8));
+}
+
+/*
+ * Convert a rows x columns matrix of single-precision numbers into the transposed columns x rows matrix of ARM
+ * alternative half-precision numbers.
+ */
+static inline void fp32_alt_to_fp16_transpose(size_t rows, size_t columns,
+	const float* input, size_t input_stride,
+	float16* output, size_t output_stride)
+{
+	fp16_transpose_blocked(FP16_CONVERSION_FP32_TO_ALT, rows, columns, input, input_stride, output, output_stride,
+		FP16_TRANSPOSE_KERNEL(fp32_alt_to_fp16_transpose_8x8));
+}
+
+/*
+ * Convert a rows x columns matrix of ARM alternative half-precision numbers into the transposed columns x rows matrix
+ * of single-precision numbers.
+ */
+static inline void fp16_alt_to_fp32_transpose(size_t rows, size_t columns,
+	const float16* input, size_t input_stride,
+	float* output, size_t output_stride)
+{
+	fp16_transpose_blocked(FP16_CONVERSION_ALT_TO_FP32, rows, columns, input, input_stride, output, output_stride,
+		FP16_TRANSPOSE_KERNEL(fp16_alt_to_fp32_transpose_8x8));
+}
+
+#undef FP16_TRANSPOSE_KERNEL
+
+#endif /* FP16_TRANSPOSE_H */
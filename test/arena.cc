@@ -0,0 +1,183 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <fp16.h>
+#include <fp16/arena.h>
+#include <fp16/array.h>
+#if __cplusplus >= 201703L
+	#include <fp16/pmr.h>
+	#include <vector>
+#endif
+#include "simple_test.h"
+#include <string>
+#include <sstream>
+
+static const unsigned kFlags[] = {
+	0,
+	FP16_PAGES_PREFAULT,
+	FP16_PAGES_HUGE,
+	FP16_PAGES_HUGE | FP16_PAGES_PREFAULT,
+	FP16_PAGES_HUGETLB,
+	FP16_PAGES_HUGETLB | FP16_PAGES_PREFAULT,
+};
+
+void test_pages() {
+	const size_t sizes[] = { 1, 4096, 100000, 3 * FP16_HUGE_PAGE_SIZE + 12345 };
+	for (unsigned flags : kFlags) {
+		for (size_t size : sizes) {
+			std::stringstream ss;
+			ss << "flags = " << flags << ", size = " << size;
+			const size_t page = (flags & (FP16_PAGES_HUGE | FP16_PAGES_HUGETLB)) != 0 ? FP16_HUGE_PAGE_SIZE : fp16_pages_base_size();
+			std::string message = ss.str() + ": mapped size";
+			const size_t mapped_size = fp16_pages_mapped_size(size, flags);
+			ASSERT_TRUE(mapped_size >= size && mapped_size % page == 0 && mapped_size - size < page, message);
+
+			unsigned char* pages = (unsigned char*) fp16_pages_allocate(size, flags);
+			message = ss.str() + ": allocation";
+			ASSERT_TRUE(pages != NULL, message);
+#if !defined(_WIN32)
+			message = ss.str() + ": alignment";
+			ASSERT_EQ(0u, (unsigned) ((uintptr_t) pages % page), message);
+#endif
+			message = ss.str() + ": zero-filled";
+			for (size_t i = 0; i < mapped_size; i += 997) {
+				ASSERT_EQ(0, pages[i], message);
+			}
+			memset(pages, 0xA5, mapped_size);
+			message = ss.str() + ": writable";
+			ASSERT_TRUE(pages[0] == 0xA5 && pages[mapped_size - 1] == 0xA5, message);
+			fp16_pages_free(pages, size, flags);
+		}
+	}
+	/* Sizes that would wrap around when rounded up to whole pages */
+	for (unsigned flags : kFlags) {
+		std::string message = "flags = " + std::to_string(flags) + ": size near SIZE_MAX";
+		ASSERT_TRUE(fp16_pages_mapped_size(SIZE_MAX - 1, flags) == 0 && fp16_pages_allocate(SIZE_MAX - 1, flags) == NULL &&
+			fp16_pages_allocate(SIZE_MAX - FP16_HUGE_PAGE_SIZE, flags) == NULL, message);
+	}
+	/* Freeing NULL does nothing */
+	fp16_pages_free(NULL, 4096, 0);
+}
+
+void test_arena() {
+	for (unsigned flags : kFlags) {
+		struct fp16_arena arena;
+		std::stringstream ss;
+		ss << "flags = " << flags;
+		std::string message = ss.str() + ": init";
+		ASSERT_EQ(0, fp16_arena_init(&arena, 100000, flags), message);
+		ASSERT_TRUE(arena.capacity == fp16_pages_mapped_size(100000, flags) && arena.offset == 0, message);
+
+		/* Allocations are aligned to at least a cache line, and to larger requested alignments */
+		unsigned char* a = (unsigned char*) fp16_arena_allocate(&arena, 3, 0);
+		unsigned char* b = (unsigned char*) fp16_arena_allocate(&arena, 5, 1);
+		unsigned char* c = (unsigned char*) fp16_arena_allocate(&arena, 7, 4096);
+		message = ss.str() + ": alignment";
+		ASSERT_TRUE(a != NULL && b != NULL && c != NULL, message);
+		ASSERT_TRUE((uintptr_t) a % 64 == 0 && (uintptr_t) b % 64 == 0 && (uintptr_t) c % 4096 == 0, message);
+		message = ss.str() + ": order";
+		ASSERT_TRUE(a + 3 <= b && b + 5 <= c, message);
+
+		/* Mark and release return the memory allocated after the mark */
+		const size_t mark = fp16_arena_mark(&arena);
+		float* fp32 = fp16_arena_allocate_fp32(&arena, 1000);
+		uint16_t* fp16 = fp16_arena_allocate_fp16(&arena, 1000);
+		message = ss.str() + ": typed allocations";
+		ASSERT_TRUE(fp32 != NULL && fp16 != NULL && (unsigned char*) fp16 >= (unsigned char*) (fp32 + 1000), message);
+		for (size_t i = 0; i < 1000; i++) {
+			fp16[i] = (uint16_t) (i * 40503);
+		}
+		fp16_ieee_to_fp32_array(fp16, fp32, 1000);
+		message = ss.str() + ": conversion into arena memory";
+		ASSERT_TRUE(fp32v_to_fp32b(fp32[999]) == fp16_ieee_to_fp32_bits(fp16[999]) || fp32[999] != fp32[999], message);
+		fp16_arena_release(&arena, mark);
+		message = ss.str() + ": release";
+		ASSERT_EQ(mark, fp16_arena_mark(&arena), message);
+		ASSERT_TRUE(fp16_arena_allocate_fp32(&arena, 1000) == fp32, message);
+
+		/* Allocations that do not fit fail and leave the arena unchanged */
+		const size_t used = fp16_arena_mark(&arena);
+		message = ss.str() + ": exhaustion";
+		ASSERT_TRUE(fp16_arena_allocate(&arena, arena.capacity, 0) == NULL, message);
+		ASSERT_TRUE(fp16_arena_allocate_fp32(&arena, SIZE_MAX / 2) == NULL, message);
+		ASSERT_EQ(used, fp16_arena_mark(&arena), message);
+		ASSERT_TRUE(fp16_arena_allocate(&arena, arena.capacity - 3 * 4096, 4096) != NULL, message);
+
+		fp16_arena_reset(&arena);
+		message = ss.str() + ": reset";
+		ASSERT_TRUE(fp16_arena_allocate(&arena, 3, 0) == a, message);
+		fp16_arena_destroy(&arena);
+		message = ss.str() + ": destroyed arena";
+		ASSERT_TRUE(fp16_arena_allocate(&arena, 1, 0) == NULL, message);
+	}
+}
+
+#if __cplusplus >= 201703L
+void test_memory_resources() {
+	{
+		fp16::page_resource pages(FP16_PAGES_HUGE | FP16_PAGES_PREFAULT);
+		std::pmr::vector<float> fp32(1 << 20, 1.0f, &pages);
+		std::string message = "page_resource: alignment";
+		ASSERT_EQ(0u, (unsigned) ((uintptr_t) fp32.data() % FP16_HUGE_PAGE_SIZE), message);
+		fp32.resize(3 << 20, 2.0f);
+		message = "page_resource: contents after growth";
+		ASSERT_TRUE(fp32[(1 << 20) - 1] == 1.0f && fp32[1 << 20] == 2.0f, message);
+		message = "page_resource: equality";
+		ASSERT_TRUE(pages.is_equal(fp16::page_resource(FP16_PAGES_HUGE | FP16_PAGES_PREFAULT)) &&
+			!pages.is_equal(fp16::page_resource(0)), message);
+	}
+
+	fp16::arena_resource scratch(1 << 20, FP16_PAGES_HUGE);
+	{
+		std::pmr::vector<uint16_t> fp16(1000, UINT16_C(0x3C00), &scratch);
+		std::pmr::vector<float> fp32(1000, &scratch);
+		fp16_ieee_to_fp32_array(fp16.data(), fp32.data(), fp16.size());
+		std::string message = "arena_resource: conversion";
+		ASSERT_TRUE(fp32.front() == 1.0f && fp32.back() == 1.0f, message);
+		message = "arena_resource: alignment";
+		ASSERT_TRUE((uintptr_t) fp16.data() % 64 == 0 && (uintptr_t) fp32.data() % 64 == 0, message);
+	}
+	/* The vectors were freed in reverse order of allocation, so the arena is empty again */
+	std::string message = "arena_resource: most recent allocations returned";
+	ASSERT_EQ(0u, (unsigned) scratch.used(), message);
+
+	std::pmr::vector<float> big(1000, &scratch);
+	bool thrown = false;
+	try {
+		big.resize(scratch.capacity());
+	} catch (const std::bad_alloc&) {
+		thrown = true;
+	}
+	message = "arena_resource: exhaustion throws std::bad_alloc";
+	ASSERT_TRUE(thrown && big.size() == 1000, message);
+	/* Through a volatile so that the compiler does not reject the constant size */
+	volatile size_t huge_size = SIZE_MAX - 100;
+	thrown = false;
+	try {
+		(void) fp16::page_resource(FP16_PAGES_HUGE).allocate(huge_size);
+	} catch (const std::bad_alloc&) {
+		thrown = true;
+	}
+	message = "page_resource: size near SIZE_MAX throws std::bad_alloc";
+	ASSERT_TRUE(thrown, message);
+	big = std::pmr::vector<float>(&scratch);
+	scratch.release();
+	message = "arena_resource: release";
+	ASSERT_EQ(0u, (unsigned) scratch.used(), message);
+	ASSERT_TRUE(fp16_arena_allocate(scratch.arena(), 64, 0) != NULL, message);
+}
+#endif
+
+int main() {
+	printf("Running page and arena allocator tests...\n");
+
+	RUN_TEST(test_pages);
+	RUN_TEST(test_arena);
+#if __cplusplus >= 201703L
+	RUN_TEST(test_memory_resources);
+#endif
+
+	printf("All page and arena allocator tests passed!\n");
+	return 0;
+}
@@ -0,0 +1,155 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <fp16.h>
+#include "simple_test.h"
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+
+/* Guard elements around every output array to detect stores past the requested length */
+static const size_t kGuard = 16;
+static const uint16_t kGuardBits16 = UINT16_C(0xDEAD);
+static const uint32_t kGuardBits32 = UINT32_C(0xDEADBEEF);
+
+static bool is_fp16_nan(uint16_t h) {
+	return (h & UINT16_C(0x7FFF)) > UINT16_C(0x7C00);
+}
+
+static bool is_fp32_nan(uint32_t w) {
+	return (w & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000);
+}
+
+static std::vector<uint32_t> generate_fp32_bits(size_t n, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> bits;
+	std::uniform_real_distribution<float> values(-70000.0f, 70000.0f);
+	std::vector<uint32_t> fp32(n);
+	for (size_t i = 0; i < n; i++) {
+		/* Mix arbitrary bit patterns (all exponents, NaN, Inf) with values in the half-precision range */
+		fp32[i] = (i % 3 == 0) ? bits(rng) : fp32v_to_fp32b(values(rng) * (i % 3 == 1 ? 1.0f : 1.0f / 4096.0f));
+	}
+	return fp32;
+}
+
+static std::vector<uint16_t> generate_fp16_bits(size_t n, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> bits(0, UINT32_C(0xFFFF));
+	std::vector<uint16_t> fp16(n);
+	for (size_t i = 0; i < n; i++) {
+		fp16[i] = (uint16_t) bits(rng);
+	}
+	return fp16;
+}
+
+static void check_fp16_to_fp32(void (*convert)(const float16*, float*, size_t), float (*reference)(float16),
+	const std::string& name, size_t n)
+{
+	const std::vector<uint16_t> input = generate_fp16_bits(n, (uint32_t) n);
+	std::vector<float> output(n + 2 * kGuard, fp32b_to_fp32v(kGuardBits32));
+	convert(input.data(), output.data() + kGuard, n);
+
+	for (size_t i = 0; i < output.size(); i++) {
+		const uint32_t actual = fp32v_to_fp32b(output[i]);
+		std::stringstream ss;
+		ss << name << ": N = " << std::dec << n << ", I = " << i << std::hex << std::uppercase << std::setfill('0');
+		if (i < kGuard || i >= kGuard + n) {
+			ss << ", guard overwritten with 0x" << std::setw(8) << actual;
+			std::string message = ss.str();
+			ASSERT_EQ(kGuardBits32, actual, message);
+			continue;
+		}
+		const uint16_t h = input[i - kGuard];
+		const uint32_t expected = fp32v_to_fp32b(reference(h));
+		ss << ", F16 = 0x" << std::setw(4) << h <<
+			", F32(F16) = 0x" << std::setw(8) << actual << ", F32 = 0x" << std::setw(8) << expected;
+		std::string message = ss.str();
+		if (is_fp32_nan(expected)) {
+			ASSERT_TRUE(is_fp32_nan(actual), message);
+		} else {
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+static void check_fp32_to_fp16(void (*convert)(const float*, float16*, size_t), float16 (*reference)(float),
+	const std::string& name, size_t n)
+{
+	const std::vector<uint32_t> bits = generate_fp32_bits(n, (uint32_t) n);
+	std::vector<float> input(n);
+	for (size_t i = 0; i < n; i++) {
+		input[i] = fp32b_to_fp32v(bits[i]);
+	}
+	std::vector<uint16_t> output(n + 2 * kGuard, kGuardBits16);
+	convert(input.data(), output.data() + kGuard, n);
+
+	for (size_t i = 0; i < output.size(); i++) {
+		const uint16_t actual = output[i];
+		std::stringstream ss;
+		ss << name << ": N = " << std::dec << n << ", I = " << i << std::hex << std::uppercase << std::setfill('0');
+		if (i < kGuard || i >= kGuard + n) {
+			ss << ", guard overwritten with 0x" << std::setw(4) << actual;
+			std::string message = ss.str();
+			ASSERT_EQ(kGuardBits16, actual, message);
+			continue;
+		}
+		const uint32_t w = bits[i - kGuard];
+		const uint16_t expected = reference(fp32b_to_fp32v(w));
+		ss << ", F32 = 0x" << std::setw(8) << w <<
+			", F16(F32) = 0x" << std::setw(4) << actual << ", F16 = 0x" << std::setw(4) << expected;
+		std::string message = ss.str();
+		if (is_fp16_nan(expected)) {
+			ASSERT_TRUE(is_fp16_nan(actual), message);
+		} else {
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+/* Every length up to 300 covers the masked, overlapping and unrolled paths of all vector widths */
+static const size_t kMaxLength = 300;
+
+void test_fp16_ieee_to_fp32_array() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_fp16_to_fp32(fp16_ieee_to_fp32_array, fp16_ieee_to_fp32_value, "fp16_ieee_to_fp32_array", n);
+		check_fp16_to_fp32(fp16_ieee_to_fp32_array_small, fp16_ieee_to_fp32_value, "fp16_ieee_to_fp32_array_small", n);
+	}
+	check_fp16_to_fp32(fp16_ieee_to_fp32_array, fp16_ieee_to_fp32_value, "fp16_ieee_to_fp32_array", 65536 + 7);
+}
+
+void test_fp32_ieee_to_fp16_array() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_fp32_to_fp16(fp32_ieee_to_fp16_array, fp32_ieee_to_fp16_value, "fp32_ieee_to_fp16_array", n);
+		check_fp32_to_fp16(fp32_ieee_to_fp16_array_small, fp32_ieee_to_fp16_value, "fp32_ieee_to_fp16_array_small", n);
+	}
+	check_fp32_to_fp16(fp32_ieee_to_fp16_array, fp32_ieee_to_fp16_value, "fp32_ieee_to_fp16_array", 65536 + 7);
+}
+
+void test_fp16_alt_to_fp32_array() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_fp16_to_fp32(fp16_alt_to_fp32_array, fp16_alt_to_fp32_value, "fp16_alt_to_fp32_array", n);
+		check_fp16_to_fp32(fp16_alt_to_fp32_array_small, fp16_alt_to_fp32_value, "fp16_alt_to_fp32_array_small", n);
+	}
+	check_fp16_to_fp32(fp16_alt_to_fp32_array, fp16_alt_to_fp32_value, "fp16_alt_to_fp32_array", 65536 + 7);
+}
+
+void test_fp32_alt_to_fp16_array() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_fp32_to_fp16(fp32_alt_to_fp16_array, fp32_alt_to_fp16_value, "fp32_alt_to_fp16_array", n);
+		check_fp32_to_fp16(fp32_alt_to_fp16_array_small, fp32_alt_to_fp16_value, "fp32_alt_to_fp16_array_small", n);
+	}
+	check_fp32_to_fp16(fp32_alt_to_fp16_array, fp32_alt_to_fp16_value, "fp32_alt_to_fp16_array", 65536 + 7);
+}
+
+int main() {
+	printf("Running FP16 array conversion tests...\n");
+
+	RUN_TEST(test_fp16_ieee_to_fp32_array);
+	RUN_TEST(test_fp32_ieee_to_fp16_array);
+	RUN_TEST(test_fp16_alt_to_fp32_array);
+	RUN_TEST(test_fp32_alt_to_fp16_array);
+
+	printf("All array conversion tests passed!\n");
+	return 0;
+}
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <fp16.h>
+#include <fp16/batch.h>
+#include "simple_test.h"
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <vector>
+
+/*
+ * A batch of arrays of every kind of conversion, with lengths from 0 to about a million elements in a scrambled order,
+ * and a guard byte after every output array.
+ */
+struct batch {
+	std::vector<std::vector<unsigned char>> inputs;
+	std::vector<std::vector<unsigned char>> outputs;
+	std::vector<fp16::conversion_job> jobs;
+};
+
+static batch make_batch(size_t count, size_t seed) {
+	static const fp16_conversion_kind kinds[] = {
+		FP16_CONVERSION_IEEE_TO_FP32, FP16_CONVERSION_FP32_TO_IEEE, FP16_CONVERSION_ALT_TO_FP32, FP16_CONVERSION_FP32_TO_ALT,
+	};
+	batch b;
+	b.inputs.resize(count);
+	b.outputs.resize(count);
+	uint32_t state = (uint32_t) seed;
+	for (size_t i = 0; i < count; i++) {
+		state = state * 1664525u + 1013904223u;
+		size_t n;
+		switch (state >> 29) {
+			case 0: n = 0; break;
+			case 1: n = 1 + (state >> 8) % 16; break;
+			case 2: case 3: case 4: n = (state >> 8) % 1000; break;
+			case 5: case 6: n = (state >> 8) % 100000; break;
+			default: n = (i % 16 == 7) ? 1000000 + (state >> 8) % 1000 : (state >> 8) % 10000; break;
+		}
+		const fp16_conversion_kind kind = kinds[(state >> 4) % 4];
+		b.inputs[i].resize(n * fp16_conversion_input_size(kind));
+		for (size_t j = 0; j < b.inputs[i].size(); j++) {
+			b.inputs[i][j] = (unsigned char) ((i + j) * 40503 >> 3);
+		}
+		b.outputs[i].assign(n * fp16_conversion_output_size(kind) + 1, 0xA5);
+		const fp16::conversion_job job = { b.inputs[i].data(), b.outputs[i].data(), n, kind };
+		b.jobs.push_back(job);
+	}
+	return b;
+}
+
+/*
+ * The batch converter runs the same kernels as a single fp16_convert_strided call over the whole array, so the outputs
+ * match bit for bit, NaN payloads included.
+ */
+static void check_batch(const batch& b, const std::string& name) {
+	for (size_t i = 0; i < b.jobs.size(); i++) {
+		const fp16::conversion_job& job = b.jobs[i];
+		std::vector<unsigned char> expected(b.outputs[i].size(), 0xA5);
+		fp16_convert_strided(job.kind, job.input, 1, expected.data(), 1, job.count);
+		std::stringstream ss;
+		ss << name << ": job " << i << ", kind " << (int) job.kind << ", N = " << job.count;
+		std::string message = ss.str();
+		ASSERT_TRUE(memcmp(expected.data(), b.outputs[i].data(), expected.size()) == 0, message);
+	}
+}
+
+void test_batches() {
+	const size_t threads[] = { 1, 2, 3, 8 };
+	const size_t grains[] = { 64, 1000, 65536 };
+	for (size_t t : threads) {
+		for (size_t grain : grains) {
+			fp16::batch_converter converter(t, grain);
+			std::stringstream ss;
+			ss << "threads = " << t << ", grain = " << grain;
+			std::string message = ss.str() + ": thread count";
+			ASSERT_EQ(t, converter.threads(), message);
+
+			/* Several batches on the same pool, including an empty one */
+			for (size_t seed = 1; seed <= 3; seed++) {
+				batch b = make_batch(seed == 2 ? 0 : 200 * seed, seed);
+				converter.convert(b.jobs);
+				check_batch(b, ss.str() + ", batch " + std::to_string(seed));
+			}
+
+			/* A single small job is converted on the calling thread */
+			batch single = make_batch(1, 5);
+			converter.convert(single.jobs.data(), single.jobs.size());
+			check_batch(single, ss.str() + ", single job");
+		}
+	}
+}
+
+/*
+ * Many small batches back to back on one pool: a worker still leaving one batch must not disturb the next.
+ */
+void test_consecutive_batches() {
+	fp16::batch_converter converter(4, 64);
+	std::vector<float> input(1024);
+	for (size_t i = 0; i < input.size(); i++) {
+		input[i] = (float) i * 0.25f - 100.0f;
+	}
+	std::vector<uint16_t> expected(input.size()), output(input.size());
+	fp32_ieee_to_fp16_array(input.data(), expected.data(), input.size());
+	const fp16::conversion_job job = { input.data(), output.data(), input.size(), FP16_CONVERSION_FP32_TO_IEEE };
+	for (size_t batch = 0; batch < 20000; batch++) {
+		std::fill(output.begin(), output.end(), UINT16_C(0xDEAD));
+		converter.convert(&job, 1);
+		std::string message = "batch " + std::to_string(batch);
+		ASSERT_TRUE(output == expected, message);
+	}
+}
+
+void test_default_pool() {
+	fp16::batch_converter converter;
+	std::string message = "default thread count";
+	ASSERT_TRUE(converter.threads() >= 1, message);
+	batch b = make_batch(1000, 11);
+	converter.convert(b.jobs);
+	check_batch(b, "default pool");
+	printf("%u threads, %u steals\n", (unsigned) converter.threads(), (unsigned) converter.steals());
+}
+
+int main() {
+	printf("Running batched conversion tests...\n");
+
+	RUN_TEST(test_batches);
+	RUN_TEST(test_consecutive_batches);
+	RUN_TEST(test_default_pool);
+
+	printf("All batched conversion tests passed!\n");
+	return 0;
+}
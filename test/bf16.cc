@@ -0,0 +1,277 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/bf16.h>
+#include <fp16/rounding.h>
+#include "simple_test.h"
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+
+/*
+ * Reference rounding to nearest-even bfloat16 in double-precision arithmetic: pick the nearer of the two bfloat16
+ * numbers around the input, the even one on ties. The number after the largest finite one is 2**128 (infinity).
+ */
+static double bf16_bits_to_double(uint32_t h) {
+	const double magnitude = (h & 0x7F80) == 0x7F80 ? std::ldexp(1.0, 128) : (double) bf16_to_fp32_value((uint16_t) (h & 0x7FFF));
+	return (h & 0x8000) ? -magnitude : magnitude;
+}
+
+static uint16_t reference_fp32_to_bf16(uint32_t w) {
+	if ((w & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000)) {
+		return (uint16_t) ((w >> 16) | 0x0040);
+	}
+	if ((w & UINT32_C(0x7FFFFFFF)) == UINT32_C(0x7F800000)) {
+		return (uint16_t) (w >> 16);
+	}
+	const double value = (double) fp32b_to_fp32v(w);
+	const uint32_t lower = w >> 16;
+	const uint32_t upper = lower + 1;
+	const double lower_distance = std::fabs(value - bf16_bits_to_double(lower));
+	const double upper_distance = std::fabs(bf16_bits_to_double(upper) - value);
+	if (lower_distance < upper_distance || (lower_distance == upper_distance && (lower & 1) == 0)) {
+		return (uint16_t) lower;
+	}
+	return (uint16_t) upper;
+}
+
+static std::string describe(const char* name, uint32_t input, int input_digits, uint16_t actual, uint16_t expected) {
+	std::stringstream ss;
+	ss << name << std::hex << std::uppercase << std::setfill('0') <<
+		": input = 0x" << std::setw(input_digits) << input <<
+		", actual = 0x" << std::setw(4) << actual << ", expected = 0x" << std::setw(4) << expected;
+	return ss.str();
+}
+
+void test_bf16_to_fp32() {
+	for (uint32_t h = 0; h < 0x10000; h++) {
+		const uint32_t expected = h << 16;
+		const std::string message = describe("bf16_to_fp32", h, 4, (uint16_t) (bf16_to_fp32_bits((uint16_t) h) >> 16), (uint16_t) h);
+		ASSERT_EQ(expected, bf16_to_fp32_bits((uint16_t) h), message);
+		ASSERT_EQ(expected, fp32v_to_fp32b(bf16_to_fp32_value((uint16_t) h)), message);
+	}
+}
+
+/*
+ * Inputs exactly at, just above, just below, and halfway between every pair of bfloat16 neighbours, plus a sweep
+ * over all single-precision bit patterns.
+ */
+static std::vector<uint32_t> generate_boundary_inputs() {
+	std::vector<uint32_t> inputs;
+	for (uint32_t h = 0; h < 0x10000; h++) {
+		const uint32_t base = h << 16;
+		const uint32_t offsets[] = { 0x0000, 0x0001, 0x7FFF, 0x8000, 0x8001, 0xFFFF };
+		for (uint32_t offset : offsets) {
+			inputs.push_back(base | offset);
+		}
+	}
+	for (uint64_t w = 0; w <= UINT64_C(0xFFFFFFFF); w += 0x10003) {
+		inputs.push_back((uint32_t) w);
+	}
+	return inputs;
+}
+
+void test_fp32_to_bf16_value() {
+	for (uint32_t w : generate_boundary_inputs()) {
+		const uint16_t expected = reference_fp32_to_bf16(w);
+		const uint16_t actual = fp32_to_bf16_value(fp32b_to_fp32v(w));
+		const std::string message = describe("fp32_to_bf16_value", w, 8, actual, expected);
+		ASSERT_EQ(expected, actual, message);
+	}
+}
+
+void test_fp32_to_bf16_value_truncate() {
+	for (uint32_t w : generate_boundary_inputs()) {
+		const bool nan = (w & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000);
+		const uint16_t expected = (uint16_t) ((w >> 16) | (nan ? 0x0040 : 0));
+		const uint16_t actual = fp32_to_bf16_value_truncate(fp32b_to_fp32v(w));
+		const std::string message = describe("fp32_to_bf16_value_truncate", w, 8, actual, expected);
+		ASSERT_EQ(expected, actual, message);
+		if (!nan) {
+			ASSERT_TRUE(std::fabs(bf16_to_fp32_value(actual)) <= std::fabs(fp32b_to_fp32v(w)), message);
+		}
+	}
+}
+
+/*
+ * The direct conversions must round once: bfloat16 to half-precision like the integer reference in rounding.h,
+ * half-precision to bfloat16 like the double-precision reference above.
+ */
+void test_bf16_to_fp16_ieee_value() {
+	for (uint32_t h = 0; h < 0x10000; h++) {
+		const uint16_t expected = fp32_ieee_to_fp16_value_rounded(bf16_to_fp32_value((uint16_t) h), FP16_ROUND_NEAREST_EVEN);
+		const uint16_t actual = bf16_to_fp16_ieee_value((uint16_t) h);
+		const std::string message = describe("bf16_to_fp16_ieee_value", h, 4, actual, expected);
+		if ((h & 0x7FFF) > 0x7F80) {
+			ASSERT_TRUE((actual & 0x7FFF) > 0x7C00 && (actual & 0x8000) == (h & 0x8000), message);
+		} else {
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+void test_fp16_ieee_to_bf16_value() {
+	for (uint32_t h = 0; h < 0x10000; h++) {
+		const uint16_t expected = reference_fp32_to_bf16(fp16_ieee_to_fp32_bits((uint16_t) h));
+		const uint16_t actual = fp16_ieee_to_bf16_value((uint16_t) h);
+		const std::string message = describe("fp16_ieee_to_bf16_value", h, 4, actual, expected);
+		ASSERT_EQ(expected, actual, message);
+	}
+}
+
+/*
+ * Single-precision inputs of every class: random bit patterns (mostly large and small exponents), numbers around
+ * one, denormals, and special values.
+ */
+static std::vector<float> generate_fp32_data(size_t n, uint32_t seed) {
+	static const uint32_t specials[] = {
+		UINT32_C(0x00000000), UINT32_C(0x80000000), UINT32_C(0x00000001), UINT32_C(0x807FFFFF), UINT32_C(0x00008000),
+		UINT32_C(0x00018000), UINT32_C(0x7F7FFFFF), UINT32_C(0xFF7F8000), UINT32_C(0x7F800000), UINT32_C(0xFF800000),
+		UINT32_C(0x7FC00000), UINT32_C(0xFF800001), UINT32_C(0x7F80FFFF), UINT32_C(0x3F808000), UINT32_C(0x3F818000),
+	};
+	const size_t special_count = sizeof(specials) / sizeof(specials[0]);
+
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> bits;
+	std::vector<float> fp32(n);
+	for (size_t i = 0; i < n; i++) {
+		const uint32_t w = bits(rng);
+		switch (w % 4) {
+			case 0:
+				fp32[i] = fp32b_to_fp32v(specials[(w >> 2) % special_count]);
+				break;
+			case 1:
+				/* Denormals */
+				fp32[i] = fp32b_to_fp32v(w & UINT32_C(0x807FFFFF));
+				break;
+			case 2:
+				fp32[i] = fp32b_to_fp32v((w & UINT32_C(0x807FFFFF)) | UINT32_C(0x3F800000));
+				break;
+			default:
+				fp32[i] = fp32b_to_fp32v(bits(rng));
+				break;
+		}
+	}
+	return fp32;
+}
+
+static std::vector<uint16_t> generate_u16_data(size_t n, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> bits(0, 0xFFFF);
+	std::vector<uint16_t> u16(n);
+	for (size_t i = 0; i < n; i++) {
+		u16[i] = (uint16_t) bits(rng);
+	}
+	return u16;
+}
+
+/*
+ * Array results must equal the scalar results for every length, with no element written past the end.
+ */
+void test_bf16_to_fp32_array() {
+	const size_t lengths[] = { 0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 40, 10007 };
+	for (size_t n : lengths) {
+		const std::vector<uint16_t> input = generate_u16_data(n, (uint32_t) n);
+		std::vector<float> output(n + 1, fp32b_to_fp32v(UINT32_C(0xDEADBEEF)));
+		bf16_to_fp32_array(input.data(), output.data(), n);
+		for (size_t i = 0; i < n; i++) {
+			const uint32_t expected = bf16_to_fp32_bits(input[i]);
+			const uint32_t actual = fp32v_to_fp32b(output[i]);
+			std::stringstream ss;
+			ss << "bf16_to_fp32_array: N = " << n << ", I = " << i << std::hex << ", actual = 0x" << actual;
+			std::string message = ss.str();
+			ASSERT_EQ(expected, actual, message);
+		}
+		const std::string guard_message = "bf16_to_fp32_array: guard element overwritten";
+		ASSERT_EQ(UINT32_C(0xDEADBEEF), fp32v_to_fp32b(output[n]), guard_message);
+	}
+}
+
+static void check_narrowing_array(void (*convert_array)(const float*, uint16_t*, size_t),
+	uint16_t (*convert)(float), const char* name)
+{
+	for (size_t n = 0; n <= 40; n++) {
+		const std::vector<float> input = generate_fp32_data(n, (uint32_t) n);
+		std::vector<uint16_t> output(n + 1, UINT16_C(0xDEAD));
+		convert_array(input.data(), output.data(), n);
+		for (size_t i = 0; i < n; i++) {
+			const uint16_t expected = convert(input[i]);
+			const std::string message = describe(name, fp32v_to_fp32b(input[i]), 8, output[i], expected);
+			ASSERT_EQ(expected, output[i], message);
+		}
+		const std::string guard_message = std::string(name) + ": guard element overwritten";
+		ASSERT_EQ(UINT16_C(0xDEAD), output[n], guard_message);
+	}
+	const size_t n = 10007;
+	const std::vector<float> input = generate_fp32_data(n, 1);
+	std::vector<uint16_t> output(n);
+	convert_array(input.data(), output.data(), n);
+	for (size_t i = 0; i < n; i++) {
+		const uint16_t expected = convert(input[i]);
+		const std::string message = describe(name, fp32v_to_fp32b(input[i]), 8, output[i], expected);
+		ASSERT_EQ(expected, output[i], message);
+	}
+}
+
+void test_fp32_to_bf16_array() {
+	check_narrowing_array(fp32_to_bf16_array, fp32_to_bf16_value, "fp32_to_bf16_array");
+}
+
+void test_fp32_to_bf16_array_truncate() {
+	check_narrowing_array(fp32_to_bf16_array_truncate, fp32_to_bf16_value_truncate, "fp32_to_bf16_array_truncate");
+}
+
+/*
+ * Transcoding arrays; NaN outputs of bf16_to_fp16_ieee_array are compared by sign and NaN-ness only, because NaN
+ * payloads depend on the hardware path.
+ */
+static void check_transcoding_array(void (*convert_array)(const uint16_t*, uint16_t*, size_t),
+	uint16_t (*convert)(uint16_t), bool output_fp16, const char* name)
+{
+	const size_t lengths[] = { 0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 40, 10007 };
+	for (size_t n : lengths) {
+		const std::vector<uint16_t> input = generate_u16_data(n, (uint32_t) n + 1);
+		std::vector<uint16_t> output(n + 1, UINT16_C(0xDEAD));
+		convert_array(input.data(), output.data(), n);
+		for (size_t i = 0; i < n; i++) {
+			const uint16_t expected = convert(input[i]);
+			const std::string message = describe(name, input[i], 4, output[i], expected);
+			if (output_fp16 && (expected & 0x7FFF) > 0x7C00) {
+				ASSERT_TRUE((output[i] & 0x7FFF) > 0x7C00 && (output[i] & 0x8000) == (expected & 0x8000), message);
+			} else {
+				ASSERT_EQ(expected, output[i], message);
+			}
+		}
+		const std::string guard_message = std::string(name) + ": guard element overwritten";
+		ASSERT_EQ(UINT16_C(0xDEAD), output[n], guard_message);
+	}
+}
+
+void test_bf16_to_fp16_ieee_array() {
+	check_transcoding_array(bf16_to_fp16_ieee_array, bf16_to_fp16_ieee_value, true, "bf16_to_fp16_ieee_array");
+}
+
+void test_fp16_ieee_to_bf16_array() {
+	check_transcoding_array(fp16_ieee_to_bf16_array, fp16_ieee_to_bf16_value, false, "fp16_ieee_to_bf16_array");
+}
+
+int main() {
+	printf("Running bfloat16 conversion tests...\n");
+
+	RUN_TEST(test_bf16_to_fp32);
+	RUN_TEST(test_fp32_to_bf16_value);
+	RUN_TEST(test_fp32_to_bf16_value_truncate);
+	RUN_TEST(test_bf16_to_fp16_ieee_value);
+	RUN_TEST(test_fp16_ieee_to_bf16_value);
+	RUN_TEST(test_bf16_to_fp32_array);
+	RUN_TEST(test_fp32_to_bf16_array);
+	RUN_TEST(test_fp32_to_bf16_array_truncate);
+	RUN_TEST(test_bf16_to_fp16_ieee_array);
+	RUN_TEST(test_fp16_ieee_to_bf16_array);
+
+	printf("All bfloat16 conversion tests passed!\n");
+	return 0;
+}
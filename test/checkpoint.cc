@@ -0,0 +1,380 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fp16.h>
+#include <fp16/bf16.h>
+#include <fp16/checkpoint.h>
+#include "simple_test.h"
+#include "temp_file.h"
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <vector>
+
+static void append_le32(std::string& s, uint32_t value) {
+	for (int i = 0; i < 4; i++) {
+		s += (char) (value >> (8 * i));
+	}
+}
+
+static void append_le64(std::string& s, uint64_t value) {
+	for (int i = 0; i < 8; i++) {
+		s += (char) (value >> (8 * i));
+	}
+}
+
+/* Single-precision numbers of every kind: normal, subnormal, out of half-precision range, infinite and NaN */
+static std::vector<float> make_weights(size_t n) {
+	std::vector<float> weights(n);
+	uint32_t state = 2024;
+	for (size_t i = 0; i < n; i++) {
+		state = state * 1664525u + 1013904223u;
+		weights[i] = fp32b_to_fp32v(state);
+	}
+	weights[0] = 1.0f;
+	weights[1] = -0.0f;
+	return weights;
+}
+
+static std::string float_bytes(const std::vector<float>& values) {
+	return std::string((const char*) values.data(), values.size() * sizeof(float));
+}
+
+/* A safetensors file as the reference implementation writes it, with metadata and a name that needs escapes */
+static std::string make_safetensors(const std::vector<float>& matrix, const std::vector<float>& vector, const std::string& tokens) {
+	const size_t matrix_bytes = matrix.size() * sizeof(float), vector_bytes = vector.size() * sizeof(float);
+	std::stringstream json;
+	json << "{\"__metadata__\": {\"format\": \"pt\", \"note\": \"a, b: {c}\"}, "
+	     << "\"layer.0/w\\\"\\u00e9\": {\"dtype\": \"F32\", \"shape\": [" << matrix.size() / 64 << ", 64], \"data_offsets\": [0, "
+	     << matrix_bytes << "]}, "
+	     << "\"norm\": {\"dtype\": \"F32\", \"shape\": [" << vector.size() << "], \"data_offsets\": [" << matrix_bytes << ", "
+	     << matrix_bytes + vector_bytes << "]}, "
+	     << "\"tokens\": {\"dtype\": \"I64\", \"shape\": [" << tokens.size() / 8 << "], \"data_offsets\": ["
+	     << matrix_bytes + vector_bytes << ", " << matrix_bytes + vector_bytes + tokens.size() << "]}}";
+	std::string header = json.str();
+	header.append((8 - header.size() % 8) % 8, ' ');
+	std::string file;
+	append_le64(file, header.size());
+	return file + header + float_bytes(matrix) + float_bytes(vector) + tokens;
+}
+
+static void append_gguf_string(std::string& s, const std::string& value) {
+	append_le64(s, value.size());
+	s += value;
+}
+
+/* A GGUF v3 file with 64-byte alignment, string and array metadata, and a quantized (Q8_0) tensor */
+static std::string make_gguf(const std::vector<float>& matrix, const std::vector<float>& vector, const std::string& q8) {
+	std::string file("GGUF", 4);
+	append_le32(file, 3);
+	append_le64(file, 3);
+	append_le64(file, 4);
+	append_gguf_string(file, "general.architecture");
+	append_le32(file, 8);
+	append_gguf_string(file, "llama");
+	append_gguf_string(file, "general.alignment");
+	append_le32(file, 4);
+	append_le32(file, 64);
+	append_gguf_string(file, "tokenizer.ggml.tokens");
+	append_le32(file, 9);
+	append_le32(file, 8);
+	append_le64(file, 2);
+	append_gguf_string(file, "<s>");
+	append_gguf_string(file, "</s>");
+	append_gguf_string(file, "general.file_type");
+	append_le32(file, 4);
+	append_le32(file, 0);
+
+	const uint64_t matrix_offset = 0, q8_offset = (matrix.size() * sizeof(float) + 63) / 64 * 64;
+	const uint64_t vector_offset = (q8_offset + q8.size() + 63) / 64 * 64;
+	append_gguf_string(file, "blk.0.attn_q.weight");
+	append_le32(file, 2);
+	append_le64(file, 64);
+	append_le64(file, matrix.size() / 64);
+	append_le32(file, 0);
+	append_le64(file, matrix_offset);
+	append_gguf_string(file, "blk.0.ffn_down.weight");
+	append_le32(file, 1);
+	append_le64(file, q8.size() / 34 * 32);
+	append_le32(file, 8);
+	append_le64(file, q8_offset);
+	append_gguf_string(file, "output_norm.weight");
+	append_le32(file, 1);
+	append_le64(file, vector.size());
+	append_le32(file, 0);
+	append_le64(file, vector_offset);
+	file.append((64 - file.size() % 64) % 64, '\0');
+
+	const size_t data_start = file.size();
+	file += float_bytes(matrix);
+	file.resize(data_start + q8_offset, '\0');
+	file += q8;
+	file.resize(data_start + vector_offset, '\0');
+	file += float_bytes(vector);
+	file.resize((file.size() + 63) / 64 * 64, '\0');
+	return file;
+}
+
+static bool same_bits(float a, float b) {
+	return fp32v_to_fp32b(a) == fp32v_to_fp32b(b);
+}
+
+/* Check a converted float32 tensor against the scalar conversion of the original numbers */
+static void check_narrowed(const fp16::checkpoint_tensor& tensor, fp16::checkpoint_dtype dtype, const std::vector<float>& original,
+	const std::string& name)
+{
+	std::string message = name + ": dtype";
+	ASSERT_TRUE(tensor.dtype == dtype, message);
+	message = name + ": size";
+	ASSERT_EQ(original.size() * 2, tensor.bytes, message);
+	const uint16_t* data = (const uint16_t*) tensor.data;
+	for (size_t i = 0; i < original.size(); i++) {
+		const uint16_t expected = dtype == fp16::checkpoint_dtype::float16 ?
+			fp32_ieee_to_fp16_value(original[i]) : fp32_to_bf16_value(original[i]);
+		if (original[i] != original[i]) {
+			/* The vector kernels keep more of the NaN payload than the scalar conversion */
+			const uint16_t exponent = dtype == fp16::checkpoint_dtype::float16 ? 0x7C00 : 0x7F80;
+			message = name + ": NaN stays NaN at element " + std::to_string(i);
+			ASSERT_TRUE((data[i] & exponent) == exponent && (data[i] & (0x7FFF ^ exponent)) != 0, message);
+			continue;
+		}
+		if (data[i] != expected) {
+			std::stringstream ss;
+			ss << name << ": element " << i << " is 0x" << std::hex << data[i] << " instead of 0x" << expected;
+			message = ss.str();
+			ASSERT_EQ(expected, data[i], message);
+		}
+	}
+}
+
+static void check_float32(const fp16::checkpoint_tensor& tensor, const std::vector<float>& expected, const std::string& name) {
+	std::string message = name + ": dtype";
+	ASSERT_TRUE(tensor.dtype == fp16::checkpoint_dtype::float32, message);
+	message = name + ": size";
+	ASSERT_EQ(expected.size() * sizeof(float), tensor.bytes, message);
+	for (size_t i = 0; i < expected.size(); i++) {
+		float value;
+		memcpy(&value, tensor.data + i * sizeof(float), sizeof(float));
+		message = name + ": element " + std::to_string(i);
+		ASSERT_TRUE(same_bits(expected[i], value) || (expected[i] != expected[i] && value != value), message);
+	}
+}
+
+void test_safetensors() {
+	const std::vector<float> matrix = make_weights(64 * 300 + 64), vector = make_weights(64);
+	std::string tokens;
+	for (uint64_t i = 0; i < 17; i++) {
+		append_le64(tokens, i * 1000003);
+	}
+	const std::string input_path = temp_path("model.safetensors"), half_path = temp_path("model-f16.safetensors");
+	const std::string wide_path = temp_path("model-f32.safetensors");
+	write_bytes(input_path, make_safetensors(matrix, vector, tokens));
+	const std::string name = "layer.0/w\"\xc3\xa9";
+
+	{
+		const fp16::checkpoint_file input(input_path.c_str());
+		std::string message = "safetensors detected";
+		ASSERT_TRUE(input.format() == fp16::checkpoint_format::safetensors, message);
+		message = "tensor count";
+		ASSERT_EQ(3, input.tensors().size(), message);
+		const fp16::checkpoint_tensor* weight = input.find(name);
+		message = "escaped name is decoded";
+		ASSERT_TRUE(weight != nullptr, message);
+		message = "shape";
+		ASSERT_TRUE(weight->shape.size() == 2 && weight->shape[0] == matrix.size() / 64 && weight->shape[1] == 64, message);
+		check_float32(*weight, matrix, "input matrix");
+	}
+
+	/* Small tasks on several threads, so that tensors are split between threads */
+	fp16::checkpoint_options options;
+	options.threads = 4;
+	options.chunk_elements = 64;
+	fp16::checkpoint_stats stats = fp16::convert_checkpoint(input_path.c_str(), half_path.c_str(), options);
+	std::string message = "one tensor converted, the vector kept";
+	ASSERT_EQ(1, stats.converted, message);
+	message = "converted numbers";
+	ASSERT_EQ(matrix.size(), stats.elements, message);
+	message = "bytes written";
+	ASSERT_EQ(read_bytes(half_path).size(), stats.bytes_written, message);
+	message = "metadata is copied";
+	ASSERT_TRUE(read_bytes(half_path).find("\"__metadata__\":{\"format\": \"pt\", \"note\": \"a, b: {c}\"}") != std::string::npos, message);
+	{
+		const fp16::checkpoint_file half(half_path.c_str());
+		const fp16::checkpoint_tensor* weight = half.find(name);
+		message = "converted tensor is listed";
+		ASSERT_TRUE(weight != nullptr, message);
+		message = "F16 dtype";
+		ASSERT_TRUE(weight->type == "F16", message);
+		check_narrowed(*weight, fp16::checkpoint_dtype::float16, matrix, "F32 to F16");
+		check_float32(*half.find("norm"), vector, "kept vector");
+		const fp16::checkpoint_tensor* copied = half.find("tokens");
+		message = "integer tensor is copied";
+		ASSERT_TRUE(copied->type == "I64" && std::string((const char*) copied->data, copied->bytes) == tokens, message);
+		message = "data starts at a multiple of 8 bytes";
+		ASSERT_EQ(0, weight->offset % 8, message);
+	}
+
+	/* And back: the F16 tensor widens exactly */
+	options.dtype = fp16::checkpoint_dtype::float32;
+	stats = fp16::convert_checkpoint(half_path.c_str(), wide_path.c_str(), options);
+	message = "F16 tensor widened";
+	ASSERT_EQ(1, stats.converted, message);
+	{
+		const fp16::checkpoint_file wide(wide_path.c_str());
+		std::vector<float> expected(matrix.size());
+		for (size_t i = 0; i < matrix.size(); i++) {
+			expected[i] = fp16_ieee_to_fp32_value(fp32_ieee_to_fp16_value(matrix[i]));
+		}
+		check_float32(*wide.find(name), expected, "F16 to F32");
+	}
+
+	/* bfloat16, vectors included */
+	options = fp16::checkpoint_options();
+	options.dtype = fp16::checkpoint_dtype::bfloat16;
+	options.keep_vectors = false;
+	stats = fp16::convert_checkpoint(input_path.c_str(), half_path.c_str(), options);
+	message = "both float tensors converted";
+	ASSERT_EQ(2, stats.converted, message);
+	{
+		const fp16::checkpoint_file half(half_path.c_str());
+		check_narrowed(*half.find(name), fp16::checkpoint_dtype::bfloat16, matrix, "F32 to BF16");
+		check_narrowed(*half.find("norm"), fp16::checkpoint_dtype::bfloat16, vector, "F32 to BF16 vector");
+	}
+
+	remove(input_path.c_str());
+	remove(half_path.c_str());
+	remove(wide_path.c_str());
+}
+
+void test_gguf() {
+	const std::vector<float> matrix = make_weights(64 * 100), vector = make_weights(48);
+	std::string q8;
+	for (size_t i = 0; i < 3 * 34; i++) {
+		q8 += (char) (i * 7);
+	}
+	const std::string input_path = temp_path("model.gguf"), output_path = temp_path("model-f16.gguf");
+	write_bytes(input_path, make_gguf(matrix, vector, q8));
+
+	fp16::checkpoint_options options;
+	options.threads = 3;
+	options.chunk_elements = 1000;
+	const fp16::checkpoint_stats stats = fp16::convert_checkpoint(input_path.c_str(), output_path.c_str(), options);
+	std::string message = "GGUF detected";
+	ASSERT_TRUE(stats.format == fp16::checkpoint_format::gguf, message);
+	message = "one tensor converted";
+	ASSERT_EQ(1, stats.converted, message);
+
+	const std::string output = read_bytes(output_path);
+	const size_t file_type = output.find("general.file_type") + strlen("general.file_type") + 4;
+	message = "file type is MOSTLY_F16";
+	ASSERT_EQ(1, fp16::npy_load_le32((const unsigned char*) output.data() + file_type), message);
+	message = "output size is a multiple of the alignment";
+	ASSERT_EQ(0, output.size() % 64, message);
+
+	const fp16::checkpoint_file converted(output_path.c_str());
+	message = "tensor count";
+	ASSERT_EQ(3, converted.tensors().size(), message);
+	const fp16::checkpoint_tensor& weight = converted.tensors()[0];
+	message = "tensor order and GGML type";
+	ASSERT_TRUE(weight.name == "blk.0.attn_q.weight" && weight.ggml_type == 1, message);
+	check_narrowed(weight, fp16::checkpoint_dtype::float16, matrix, "GGUF F32 to F16");
+	const fp16::checkpoint_tensor* quantized = converted.find("blk.0.ffn_down.weight");
+	message = "quantized tensor is copied";
+	ASSERT_TRUE(quantized->ggml_type == 8 && std::string((const char*) quantized->data, q8.size()) == q8, message);
+	check_float32(*converted.find("output_norm.weight"), vector, "GGUF kept vector");
+	for (const fp16::checkpoint_tensor& tensor : converted.tensors()) {
+		message = tensor.name + " is aligned";
+		ASSERT_EQ(0, tensor.offset % 64, message);
+	}
+
+	remove(input_path.c_str());
+	remove(output_path.c_str());
+}
+
+void test_errors() {
+	const std::string input_path = temp_path("bad.safetensors"), output_path = temp_path("bad-output.safetensors");
+
+	/* A tensor that extends past the end of the file */
+	std::string file;
+	const std::string header = "{\"w\":{\"dtype\":\"F32\",\"shape\":[4],\"data_offsets\":[0,16]}}";
+	append_le64(file, header.size());
+	write_bytes(input_path, file + header + std::string(8, '\0'));
+	bool thrown = false;
+	try {
+		fp16::convert_checkpoint(input_path.c_str(), output_path.c_str());
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	std::string message = "truncated tensor throws";
+	ASSERT_TRUE(thrown, message);
+	message = "no output is left behind";
+	ASSERT_TRUE(read_bytes(output_path).empty() && access(output_path.c_str(), F_OK) != 0, message);
+
+	/* A byte count that is not a whole number of elements */
+	file.clear();
+	const std::string partial_header = "{\"w\":{\"dtype\":\"F32\",\"shape\":[3],\"data_offsets\":[0,13]}}";
+	append_le64(file, partial_header.size());
+	write_bytes(input_path, file + partial_header + std::string(13, '\0'));
+	thrown = false;
+	try {
+		fp16::checkpoint_file checkpoint(input_path.c_str());
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	message = "partial trailing element throws";
+	ASSERT_TRUE(thrown, message);
+
+	/* A GGUF file that ends before the value of general.alignment */
+	std::string gguf("GGUF", 4);
+	append_le32(gguf, 3);
+	append_le64(gguf, 0);
+	append_le64(gguf, 1);
+	append_gguf_string(gguf, "general.alignment");
+	append_le32(gguf, 4);
+	write_bytes(input_path, gguf);
+	thrown = false;
+	try {
+		fp16::checkpoint_file checkpoint(input_path.c_str());
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	message = "truncated GGUF alignment throws";
+	ASSERT_TRUE(thrown, message);
+
+	/* Converting a file onto itself would truncate the mapped input */
+	file.clear();
+	append_le64(file, header.size());
+	write_bytes(input_path, file + header + std::string(16, '\0'));
+	thrown = false;
+	try {
+		fp16::convert_checkpoint(input_path.c_str(), input_path.c_str());
+	} catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	message = "output onto the input throws";
+	ASSERT_TRUE(thrown, message);
+
+	int error = 0;
+	try {
+		fp16::convert_checkpoint(input_path.c_str(), (temp_path("missing") + "/out.safetensors").c_str());
+	} catch (const std::system_error& e) {
+		error = e.code().value();
+	}
+	message = "missing output directory throws ENOENT";
+	ASSERT_EQ(ENOENT, error, message);
+	remove(input_path.c_str());
+}
+
+int main() {
+	printf("Running checkpoint conversion tests...\n");
+
+	RUN_TEST(test_safetensors);
+	RUN_TEST(test_gguf);
+	RUN_TEST(test_errors);
+
+	printf("All checkpoint conversion tests passed!\n");
+	return 0;
+}
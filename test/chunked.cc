@@ -0,0 +1,278 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fp16.h>
+#include <fp16/chunked.h>
+#include "simple_test.h"
+#include "temp_file.h"
+#include <fstream>
+#include <limits>
+#include <string>
+#include <sstream>
+#include <vector>
+
+/*
+ * A slowly drifting series with noise, so that chunks cover narrow ranges, with a chunk of NaNs, a chunk of one
+ * value, infinities and signed zeros
+ */
+static std::vector<float> make_series(size_t n, size_t chunk) {
+	std::vector<float> series(n);
+	uint32_t state = 7;
+	for (size_t i = 0; i < n; i++) {
+		state = state * 1664525u + 1013904223u;
+		series[i] = (float) i / 64.0f - 100.0f + (float) (state >> 8) / 16777216.0f;
+	}
+	for (size_t i = chunk; i < 2 * chunk; i++) {
+		series[i] = std::numeric_limits<float>::quiet_NaN();
+	}
+	for (size_t i = 3 * chunk; i < 4 * chunk; i++) {
+		series[i] = 5.0f;
+	}
+	series[5 * chunk + 1] = std::numeric_limits<float>::infinity();
+	series[5 * chunk + 2] = std::numeric_limits<float>::quiet_NaN();
+	series[6 * chunk] = -0.0f;
+	series[6 * chunk + 1] = 0.0f;
+	return series;
+}
+
+/* The series as the file holds it: rounded to half precision */
+static std::vector<float> rounded(const std::vector<float>& series) {
+	std::vector<float> result(series.size());
+	for (size_t i = 0; i < series.size(); i++) {
+		result[i] = fp16_ieee_to_fp32_value(fp32_ieee_to_fp16_value(series[i]));
+	}
+	return result;
+}
+
+static bool same_value(float a, float b) {
+	return a == b || (a != a && b != b);
+}
+
+void test_index() {
+	const size_t chunk = 256, n = 10 * chunk + 77;
+	const std::vector<float> series = make_series(n, chunk), expected = rounded(series);
+	const std::string path = temp_path("index");
+	{
+		fp16::chunked_writer writer(path.c_str(), chunk);
+		/* Appends that do not line up with the chunks */
+		for (size_t i = 0; i < n; i += 100) {
+			writer.append(&series[i], std::min<size_t>(100, n - i));
+		}
+		std::string message = "appended numbers";
+		ASSERT_EQ(n, writer.size(), message);
+		writer.close();
+	}
+
+	fp16::chunked_file file(path.c_str());
+	std::string message = "series size";
+	ASSERT_EQ(n, file.size(), message);
+	message = "chunk count";
+	ASSERT_EQ(11, file.chunks().size(), message);
+	message = "data is aligned";
+	ASSERT_EQ(0, (uintptr_t) file.fp16_data() % 64, message);
+	for (size_t c = 0; c < file.chunks().size(); c++) {
+		const fp16::chunked_chunk& entry = file.chunks()[c];
+		uint32_t nan_count = 0;
+		float min = std::numeric_limits<float>::infinity(), max = -std::numeric_limits<float>::infinity();
+		for (size_t i = entry.first; i < entry.first + entry.count; i++) {
+			if (expected[i] != expected[i]) {
+				nan_count++;
+			} else {
+				min = std::min(min, expected[i]);
+				max = std::max(max, expected[i]);
+			}
+		}
+		message = "chunk " + std::to_string(c) + ": first";
+		ASSERT_EQ(c * chunk, entry.first, message);
+		message = "chunk " + std::to_string(c) + ": NaN count";
+		ASSERT_EQ(nan_count, entry.nan_count, message);
+		message = "chunk " + std::to_string(c) + ": minimum and maximum";
+		ASSERT_TRUE(min == entry.min && max == entry.max, message);
+	}
+	message = "chunk of NaNs";
+	ASSERT_TRUE(file.chunks()[1].nan_count == chunk && file.chunks()[1].min > file.chunks()[1].max, message);
+	const uint16_t zeros[] = { UINT16_C(0x0000), UINT16_C(0x8000), UINT16_C(0x7E00) };
+	uint32_t zero_nans;
+	uint16_t zero_min, zero_max;
+	fp16::chunked_statistics(zeros, 3, zero_nans, zero_min, zero_max);
+	message = "-0 orders before +0";
+	ASSERT_TRUE(zero_nans == 1 && zero_min == UINT16_C(0x8000) && zero_max == UINT16_C(0x0000), message);
+	message = "infinity is the maximum";
+	ASSERT_TRUE(file.chunks()[5].max == std::numeric_limits<float>::infinity(), message);
+
+	/* Ranges across chunk boundaries */
+	const uint64_t ranges[][2] = { { 0, n }, { 0, 1 }, { chunk - 3, 7 }, { 4 * chunk + 10, 3 * chunk }, { n - 5, 5 }, { n, 0 } };
+	for (const auto& range : ranges) {
+		std::vector<float> output(range[1] + 1, 12345.0f);
+		file.decode(range[0], (size_t) range[1], output.data());
+		for (size_t i = 0; i < range[1]; i++) {
+			message = "decode " + std::to_string(range[0]) + "+" + std::to_string(range[1]) + " at " + std::to_string(i);
+			ASSERT_TRUE(same_value(expected[range[0] + i], output[i]), message);
+		}
+		message = "decode stops at the end of the range";
+		ASSERT_TRUE(output[range[1]] == 12345.0f, message);
+	}
+	bool thrown = false;
+	try {
+		std::vector<float> output(2);
+		file.decode(n - 1, 2, output.data());
+	} catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	message = "decode past the end throws";
+	ASSERT_TRUE(thrown, message);
+	remove(path.c_str());
+}
+
+void test_queries() {
+	const size_t chunk = 512, n = 40 * chunk + 300;
+	const std::vector<float> series = make_series(n, chunk), expected = rounded(series);
+	const std::string path = temp_path("queries");
+	{
+		fp16::chunked_writer writer(path.c_str(), chunk);
+		writer.append(series.data(), n);
+		writer.close();
+	}
+	fp16::chunked_file file(path.c_str());
+
+	const float queries[][2] = {
+		{ -1000.0f, 1000.0f }, { 5.0f, 5.0f }, { 0.0f, 0.0f }, { 100.0f, 120.0f }, { 1e6f, 2e6f }, { 3.0f, 2.0f },
+		{ 200.0f, std::numeric_limits<float>::infinity() }, { -std::numeric_limits<float>::infinity(), -99.5f },
+	};
+	for (const auto& query : queries) {
+		const float lo = query[0], hi = query[1];
+		std::stringstream ss;
+		ss << "[" << lo << ", " << hi << "]";
+		uint64_t expected_count = 0;
+		std::vector<bool> has_match(file.chunks().size(), false);
+		for (size_t i = 0; i < n; i++) {
+			if (lo <= expected[i] && expected[i] <= hi) {
+				expected_count++;
+				has_match[i / chunk] = true;
+			}
+		}
+		std::string message = ss.str() + ": count";
+		ASSERT_EQ(expected_count, file.count(lo, hi), message);
+
+		/* Every chunk with a match is selected, and scan sees exactly the matches */
+		const std::vector<size_t> selected = file.select(lo, hi);
+		for (size_t c = 0; c < has_match.size(); c++) {
+			if (has_match[c]) {
+				message = ss.str() + ": chunk " + std::to_string(c) + " is selected";
+				ASSERT_TRUE(std::find(selected.begin(), selected.end(), c) != selected.end(), message);
+			}
+		}
+		uint64_t scanned = 0;
+		const size_t decoded = file.scan(lo, hi, [&](uint64_t first, const float* values, size_t count) {
+			for (size_t i = 0; i < count; i++) {
+				scanned += lo <= values[i] && values[i] <= hi;
+				if (!same_value(expected[first + i], values[i])) {
+					scanned = UINT64_MAX / 2;
+				}
+			}
+		});
+		message = ss.str() + ": scanned matches";
+		ASSERT_EQ(expected_count, scanned, message);
+		message = ss.str() + ": scan decodes the selected chunks";
+		ASSERT_EQ(selected.size(), decoded, message);
+	}
+
+	/* A narrow query on a drifting series skips most chunks */
+	std::string message = "zone maps prune chunks";
+	ASSERT_TRUE(file.select(100.0f, 101.0f).size() <= 3, message);
+	message = "chunk of NaNs is never selected";
+	ASSERT_TRUE(file.select(-1e9f, 1e9f, chunk, 2 * chunk).empty(), message);
+	message = "selection is limited to the element range";
+	ASSERT_EQ(2, file.select(-1e9f, 1e9f, 2 * chunk + 1, 4 * chunk - 1).size(), message);
+	remove(path.c_str());
+}
+
+void test_fp16_input() {
+	const size_t chunk = 64;
+	std::vector<uint16_t> halfs(1000);
+	for (size_t i = 0; i < halfs.size(); i++) {
+		halfs[i] = (uint16_t) (i * 97);
+	}
+	const std::string path = temp_path("fp16");
+	{
+		fp16::chunked_writer writer(path.c_str(), chunk);
+		writer.append(halfs.data(), 10);
+		writer.append(halfs.data() + 10, halfs.size() - 10);
+		writer.close();
+	}
+	fp16::chunked_file file(path.c_str());
+	std::string message = "half-precision input is stored as is";
+	ASSERT_TRUE(memcmp(file.fp16_data(), halfs.data(), halfs.size() * 2) == 0, message);
+	message = "last chunk is partial";
+	ASSERT_EQ(1000 % chunk, file.chunks().back().count, message);
+	remove(path.c_str());
+
+	/* An empty series */
+	{
+		fp16::chunked_writer writer(path.c_str());
+		writer.close();
+	}
+	fp16::chunked_file empty(path.c_str());
+	message = "empty series";
+	ASSERT_TRUE(empty.size() == 0 && empty.chunks().empty() && empty.count(-1.0f, 1.0f) == 0, message);
+	remove(path.c_str());
+}
+
+void test_errors() {
+	bool thrown = false;
+	try {
+		fp16::chunked_writer writer(temp_path("bad-chunk").c_str(), 100);
+	} catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	remove(temp_path("bad-chunk").c_str());
+	std::string message = "chunk size not a multiple of 32 throws";
+	ASSERT_TRUE(thrown, message);
+
+	const std::string path = temp_path("corrupt");
+	{
+		std::vector<float> series(1000, 1.0f);
+		fp16::chunked_writer writer(path.c_str(), 128);
+		writer.append(series.data(), series.size());
+		writer.close();
+	}
+	const std::string good = read_bytes(path);
+
+	std::string corrupt = good;
+	corrupt[good.size() - 32 - 24 + 16] ^= 1;  /* minimum of the last chunk */
+	write_bytes(path, corrupt);
+	thrown = false;
+	try {
+		fp16::chunked_file file(path.c_str());
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	message = "corrupt index fails the checksum";
+	ASSERT_TRUE(thrown, message);
+
+	write_bytes(path, good.substr(0, good.size() - 10));
+	thrown = false;
+	try {
+		fp16::chunked_file file(path.c_str());
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	message = "truncated file throws";
+	ASSERT_TRUE(thrown, message);
+	remove(path.c_str());
+}
+
+int main() {
+	printf("Running chunked file tests...\n");
+
+	RUN_TEST(test_index);
+	RUN_TEST(test_queries);
+	RUN_TEST(test_fp16_input);
+	RUN_TEST(test_errors);
+
+	printf("All chunked file tests passed!\n");
+	return 0;
+}
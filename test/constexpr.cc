@@ -0,0 +1,201 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/constexpr.h>
+#include "simple_test.h"
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+
+/*
+ * Constant expressions: these fail to compile if the conversions are not evaluated at compile time.
+ */
+static_assert(fp32_ieee_to_fp16_value_constexpr(1.0f) == UINT16_C(0x3C00), "1.0");
+static_assert(fp32_ieee_to_fp16_value_constexpr(-2.0f) == UINT16_C(0xC000), "-2.0");
+static_assert(fp32_ieee_to_fp16_value_constexpr(0.1f) == UINT16_C(0x2E66), "0.1");
+static_assert(fp32_ieee_to_fp16_value_constexpr(65504.0f) == UINT16_C(0x7BFF), "largest number");
+static_assert(fp32_ieee_to_fp16_value_constexpr(65520.0f) == UINT16_C(0x7C00), "overflow");
+static_assert(fp32_ieee_to_fp16_value_constexpr(5.9604645e-8f) == UINT16_C(0x0001), "smallest denormal");
+static_assert(fp32_ieee_to_fp16_value_constexpr(std::numeric_limits<float>::infinity()) == UINT16_C(0x7C00), "infinity");
+static_assert(fp16_ieee_to_fp32_value_constexpr(UINT16_C(0x3555)) == 0.33325195f, "1/3");
+static_assert(fp16_ieee_to_fp32_bits_constexpr(UINT16_C(0x0001)) == UINT32_C(0x33800000), "smallest denormal");
+static_assert(fp16_ieee_to_fp32_bits_constexpr(UINT16_C(0xFE01)) == UINT32_C(0xFFC02000), "NaN payload");
+static_assert(fp32_alt_to_fp16_value_constexpr(131008.0f) == UINT16_C(0x7FFF), "largest alternative number");
+static_assert(fp32_alt_to_fp16_value_constexpr(1.0e10f) == UINT16_C(0x7FFF), "alternative saturation");
+static_assert(fp16_alt_to_fp32_value_constexpr(UINT16_C(0x7C00)) == 65536.0f, "alternative exponent 31");
+static_assert(fp64_ieee_to_fp16_value_constexpr(0.1) == UINT16_C(0x2E66), "0.1 in double-precision");
+static_assert(fp16_ieee_to_fp64_value_constexpr(UINT16_C(0x7BFF)) == 65504.0, "largest number in double-precision");
+static_assert(fp64v_to_fp64b_constexpr(1.0) == UINT64_C(0x3FF0000000000000), "1.0 in double-precision");
+#if FP16_CONSTEXPR_BIT_CAST
+static_assert(fp32_ieee_to_fp16_value_constexpr(-0.0f) == UINT16_C(0x8000), "negative zero");
+#endif
+
+/*
+ * A lookup table computed at compile time, covering every exponent of both signs.
+ */
+struct Table {
+	uint32_t bits[1024];
+};
+
+static constexpr Table make_table() {
+	Table table = {};
+	for (uint32_t i = 0; i < 1024; i++) {
+		table.bits[i] = fp16_ieee_to_fp32_bits_constexpr((uint16_t) (i * 64 + i % 64));
+	}
+	return table;
+}
+
+static constexpr Table kTable = make_table();
+static_assert(kTable.bits[240] == UINT32_C(0x3F800000) + (UINT32_C(48) << 13), "table entry");
+
+void test_table() {
+	for (uint32_t i = 0; i < 1024; i++) {
+		const uint16_t h = (uint16_t) (i * 64 + i % 64);
+		std::stringstream ss;
+		ss << "table entry " << i << std::hex << std::uppercase << ": F16 = 0x" << h;
+		std::string message = ss.str();
+		ASSERT_TRUE(kTable.bits[i] == fp16_ieee_to_fp32_bits(h), message);
+	}
+}
+
+/*
+ * Without bit casts, the arithmetic fallback converts negative zero to the bits of positive zero and NaN to the bits
+ * of the canonical quiet NaN.
+ */
+static uint32_t fallback_fp32_bits(uint32_t w) {
+#if FP16_CONSTEXPR_BIT_CAST
+	return w;
+#else
+	if ((w & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000)) {
+		return UINT32_C(0x7FC00000);
+	}
+	return w == UINT32_C(0x80000000) ? 0 : w;
+#endif
+}
+
+static uint64_t fallback_fp64_bits(uint64_t w) {
+#if FP16_CONSTEXPR_BIT_CAST
+	return w;
+#else
+	if ((w & UINT64_C(0x7FFFFFFFFFFFFFFF)) > UINT64_C(0x7FF0000000000000)) {
+		return UINT64_C(0x7FF8000000000000);
+	}
+	return w == UINT64_C(0x8000000000000000) ? 0 : w;
+#endif
+}
+
+/*
+ * Numbers converted from bits by the arithmetic fallback are exact, except that NaN is the canonical quiet NaN.
+ */
+static bool same_fp32_bits(uint32_t actual, uint32_t expected) {
+	const bool nan = (actual & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000) &&
+		(expected & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000);
+	return actual == expected || (!FP16_CONSTEXPR_BIT_CAST && nan);
+}
+
+static bool same_fp64_bits(uint64_t actual, uint64_t expected) {
+	const bool nan = (actual & UINT64_C(0x7FFFFFFFFFFFFFFF)) > UINT64_C(0x7FF0000000000000) &&
+		(expected & UINT64_C(0x7FFFFFFFFFFFFFFF)) > UINT64_C(0x7FF0000000000000);
+	return actual == expected || (!FP16_CONSTEXPR_BIT_CAST && nan);
+}
+
+void test_fp16_to_fp32() {
+	for (uint32_t h = 0; h <= 0xFFFF; h++) {
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << "F16 = 0x" << h;
+		std::string message = "fp16_ieee_to_fp32_bits_constexpr: " + ss.str();
+		ASSERT_TRUE(fp16_ieee_to_fp32_bits_constexpr((uint16_t) h) == fp16_ieee_to_fp32_bits((uint16_t) h), message);
+		message = "fp16_alt_to_fp32_bits_constexpr: " + ss.str();
+		ASSERT_TRUE(fp16_alt_to_fp32_bits_constexpr((uint16_t) h) == fp16_alt_to_fp32_bits((uint16_t) h), message);
+		message = "fp16_ieee_to_fp32_value_constexpr: " + ss.str();
+		ASSERT_TRUE(same_fp32_bits(fp32v_to_fp32b(fp16_ieee_to_fp32_value_constexpr((uint16_t) h)),
+			fp16_ieee_to_fp32_bits((uint16_t) h)), message);
+		message = "fp16_alt_to_fp32_value_constexpr: " + ss.str();
+		ASSERT_TRUE(same_fp32_bits(fp32v_to_fp32b(fp16_alt_to_fp32_value_constexpr((uint16_t) h)),
+			fp16_alt_to_fp32_bits((uint16_t) h)), message);
+	}
+}
+
+static void check_fp32_input(uint32_t w) {
+	const float f = fp32b_to_fp32v(w);
+	std::stringstream ss;
+	ss << std::hex << std::uppercase << "F32 = 0x" << w;
+	const uint32_t cast = fallback_fp32_bits(w);
+	std::string message = "fp32v_to_fp32b_constexpr: " + ss.str();
+	ASSERT_TRUE(fp32v_to_fp32b_constexpr(f) == cast, message);
+	message = "fp32b_to_fp32v_constexpr: " + ss.str();
+	ASSERT_TRUE(same_fp32_bits(fp32v_to_fp32b(fp32b_to_fp32v_constexpr(w)), w), message);
+	message = "fp32_ieee_to_fp16_value_constexpr: " + ss.str();
+	ASSERT_TRUE(fp32_ieee_to_fp16_value_constexpr(f) == fp32_ieee_to_fp16_value(fp32b_to_fp32v(cast)), message);
+	message = "fp32_alt_to_fp16_value_constexpr: " + ss.str();
+	ASSERT_TRUE(fp32_alt_to_fp16_value_constexpr(f) == fp32_alt_to_fp16_value(fp32b_to_fp32v(cast)), message);
+}
+
+void test_fp32_to_fp16() {
+	/* Every single-precision number around the half-precision rounding boundaries, and a sample of all others */
+	for (uint32_t h = 0; h < 0x8000; h++) {
+		const uint32_t w = fp16_alt_to_fp32_bits((uint16_t) h) + (h < 0x0400 ? 0 : UINT32_C(0x1000));
+		for (uint32_t delta = 0; delta < 4; delta++) {
+			check_fp32_input(w - 2 + delta);
+			check_fp32_input((w - 2 + delta) | UINT32_C(0x80000000));
+		}
+	}
+	for (uint64_t w = 0; w <= UINT32_C(0xFFFFFFFF); w += 997) {
+		check_fp32_input((uint32_t) w);
+	}
+	const uint32_t specials[] = {
+		UINT32_C(0x00000000), UINT32_C(0x80000000), UINT32_C(0x00000001), UINT32_C(0x7F7FFFFF), UINT32_C(0x7F800000),
+		UINT32_C(0xFF800000), UINT32_C(0x7FC00000), UINT32_C(0xFFC00001), UINT32_C(0x7F800001),
+	};
+	for (uint32_t w : specials) {
+		check_fp32_input(w);
+	}
+}
+
+void test_fp16_fp64() {
+	for (uint32_t h = 0; h <= 0xFFFF; h++) {
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << "F16 = 0x" << h;
+		std::string message = "fp16_ieee_to_fp64_bits_constexpr: " + ss.str();
+		ASSERT_TRUE(fp16_ieee_to_fp64_bits_constexpr((uint16_t) h) == fp16_ieee_to_fp64_bits((uint16_t) h), message);
+		message = "fp16_ieee_to_fp64_value_constexpr: " + ss.str();
+		ASSERT_TRUE(same_fp64_bits(fp64v_to_fp64b(fp16_ieee_to_fp64_value_constexpr((uint16_t) h)),
+			fp16_ieee_to_fp64_bits((uint16_t) h)), message);
+	}
+
+	std::mt19937_64 rng(1);
+	std::uniform_int_distribution<uint64_t> bits;
+	for (size_t i = 0; i < 1000000; i++) {
+		uint64_t w = bits(rng);
+		if (i % 2 == 0) {
+			/* Exponents from 2**-30 to 2**17 */
+			w = (w & UINT64_C(0x800FFFFFFFFFFFFF)) | ((uint64_t) (993 + (w >> 12) % 48) << 52);
+		}
+		const double d = fp64b_to_fp64v(w);
+		const uint64_t cast = fallback_fp64_bits(w);
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << "F64 = 0x" << w;
+		std::string message = "fp64v_to_fp64b_constexpr: " + ss.str();
+		ASSERT_TRUE(fp64v_to_fp64b_constexpr(d) == cast, message);
+		message = "fp64b_to_fp64v_constexpr: " + ss.str();
+		ASSERT_TRUE(same_fp64_bits(fp64v_to_fp64b(fp64b_to_fp64v_constexpr(w)), w), message);
+		message = "fp64_ieee_to_fp16_value_constexpr: " + ss.str();
+		ASSERT_TRUE(fp64_ieee_to_fp16_value_constexpr(d) == fp64_ieee_to_fp16_value(fp64b_to_fp64v(cast)), message);
+	}
+}
+
+int main() {
+	printf("Running constexpr conversion tests (%s bit casts)...\n",
+		FP16_CONSTEXPR_BIT_CAST ? "compiler" : "arithmetic");
+
+	RUN_TEST(test_table);
+	RUN_TEST(test_fp16_to_fp32);
+	RUN_TEST(test_fp32_to_fp16);
+	RUN_TEST(test_fp16_fp64);
+
+	printf("All constexpr conversion tests passed!\n");
+	return 0;
+}
@@ -0,0 +1,215 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/expr.h>
+#include <fp16/half.h>
+#include "simple_test.h"
+#include <string>
+#include <sstream>
+#include <vector>
+
+/*
+ * Inputs: every half-precision number, including infinities and NaN, in a scrambled order, and positive
+ * single-precision numbers with 24-bit significands.
+ */
+static std::vector<uint16_t> make_fp16_input() {
+	std::vector<uint16_t> input(65536);
+	for (size_t i = 0; i < input.size(); i++) {
+		input[i] = (uint16_t) (i * 40503);
+	}
+	return input;
+}
+
+static std::vector<float> make_fp32_input() {
+	std::vector<float> input(65536);
+	for (size_t i = 0; i < input.size(); i++) {
+		input[i] = (float) (i * 2654435761u % 16777213u + 1) / 1048576.0f;
+	}
+	return input;
+}
+
+static bool is_nan_fp16(uint16_t h) {
+	return (h & UINT16_C(0x7FFF)) > UINT16_C(0x7C00);
+}
+
+/*
+ * The F16C kernels keep NaN payloads, so any NaN matches a NaN.
+ */
+static bool same_fp16(uint16_t actual, uint16_t expected) {
+	return actual == expected || (is_nan_fp16(actual) && is_nan_fp16(expected));
+}
+
+static bool same_fp32(float actual, float expected) {
+	return fp32v_to_fp32b(actual) == fp32v_to_fp32b(expected) || (std::isnan(actual) && std::isnan(expected));
+}
+
+static std::vector<size_t> lengths() {
+	std::vector<size_t> result;
+	for (size_t n = 0; n <= 40; n++) {
+		result.push_back(n);
+	}
+	result.push_back(1000);
+	result.push_back(65536);
+	return result;
+}
+
+/*
+ * Evaluate into a half-precision array of every length, check every element against the scalar reference, and check
+ * that no element past the end is written.
+ */
+template<typename Assign, typename Reference>
+static void check_fp16_output(Assign assign, Reference reference, const std::string& name) {
+	for (size_t n : lengths()) {
+		std::vector<uint16_t> output(n + 1, UINT16_C(0xDEAD));
+		assign(fp16::fp16_array(output.data(), n));
+		for (size_t i = 0; i < n; i++) {
+			const uint16_t expected = reference(i);
+			std::stringstream ss;
+			ss << name << ": N = " << n << ", I = " << i << std::hex << std::uppercase << std::setfill('0') <<
+				", actual = 0x" << std::setw(4) << output[i] << ", expected = 0x" << std::setw(4) << expected;
+			std::string message = ss.str();
+			ASSERT_TRUE(same_fp16(output[i], expected), message);
+		}
+		const std::string guard_message = name + ": guard element overwritten";
+		ASSERT_EQ(UINT16_C(0xDEAD), output[n], guard_message);
+	}
+}
+
+template<typename Assign, typename Reference>
+static void check_fp32_output(Assign assign, Reference reference, const std::string& name) {
+	for (size_t n : lengths()) {
+		std::vector<float> output(n + 1, 12345.0f);
+		assign(fp16::fp32_array(output.data(), n));
+		for (size_t i = 0; i < n; i++) {
+			const float expected = reference(i);
+			std::stringstream ss;
+			ss << name << ": N = " << n << ", I = " << i << std::hex << std::uppercase <<
+				", actual = 0x" << fp32v_to_fp32b(output[i]) << ", expected = 0x" << fp32v_to_fp32b(expected);
+			std::string message = ss.str();
+			ASSERT_TRUE(same_fp32(output[i], expected), message);
+		}
+		const std::string guard_message = name + ": guard element overwritten";
+		ASSERT_EQ(12345.0f, output[n], guard_message);
+	}
+}
+
+/*
+ * Products of two half-precision numbers are exact in single-precision, so the references below do not depend on
+ * whether the compiler contracts a multiplication and an addition into a fused multiply-add.
+ */
+void test_affine() {
+	const std::vector<uint16_t> x = make_fp16_input();
+	const float a = 0.75f, b = -3.5f;
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) { y = a * fp16::fp16_array(x.data(), y.size()) + b; },
+		[&](size_t i) { return fp32_ieee_to_fp16_value(a * fp16_ieee_to_fp32_value(x[i]) + b); },
+		"y = a * x + b");
+	check_fp32_output(
+		[&](fp16::fp32_array_view<float> y) { y = fp16::fp16_array(x.data(), y.size()) * a - b; },
+		[&](size_t i) { return fp16_ieee_to_fp32_value(x[i]) * a - b; },
+		"fp32 y = x * a - b");
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) { y = b - fp16::fp16_array(x.data(), y.size()) / a; },
+		[&](size_t i) { return fp32_ieee_to_fp16_value(b - fp16_ieee_to_fp32_value(x[i]) / a); },
+		"y = b - x / a");
+}
+
+void test_mixed_precision() {
+	const std::vector<uint16_t> x = make_fp16_input();
+	const std::vector<float> w = make_fp32_input();
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) {
+			y = fp16::fp16_array(x.data(), y.size()) / fp16::fp32_array(w.data(), y.size()) + 1.0f;
+		},
+		[&](size_t i) { return fp32_ieee_to_fp16_value(fp16_ieee_to_fp32_value(x[i]) / w[i] + 1.0f); },
+		"y = x16 / w32 + 1");
+	check_fp32_output(
+		[&](fp16::fp32_array_view<float> y) { y = fp16::fp32_array(w.data(), y.size()); },
+		[&](size_t i) { return w[i]; },
+		"fp32 y = w32");
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) { y = fp16::fp32_array(w.data(), y.size()); },
+		[&](size_t i) { return fp32_ieee_to_fp16_value(w[i]); },
+		"y = w32");
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) { y = fp16::half(0.5f) * fp16::fp16_array(x.data(), y.size()); },
+		[&](size_t i) { return fp32_ieee_to_fp16_value(0.5f * fp16_ieee_to_fp32_value(x[i])); },
+		"y = half(0.5) * x");
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) { y = 1.5f; },
+		[&](size_t) { return UINT16_C(0x3E00); },
+		"y = 1.5");
+}
+
+void test_functions() {
+	const std::vector<uint16_t> x = make_fp16_input();
+	const std::vector<uint16_t> z(x.rbegin(), x.rend());
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) { y = -fp16::sqrt(fp16::abs(fp16::fp16_array(x.data(), y.size()))); },
+		[&](size_t i) { return fp32_ieee_to_fp16_value(-std::sqrt(std::fabs(fp16_ieee_to_fp32_value(x[i])))); },
+		"y = -sqrt(abs(x))");
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) {
+			y = fp16::max(fp16::min(fp16::fp16_array(x.data(), y.size()), 6.0f), 0.0f);
+		},
+		[&](size_t i) {
+			float f = fp16_ieee_to_fp32_value(x[i]);
+			f = f < 6.0f ? f : 6.0f;
+			return fp32_ieee_to_fp16_value(f > 0.0f ? f : 0.0f);
+		},
+		"y = max(min(x, 6), 0)");
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) {
+			y = fp16::fma(fp16::fp16_array(x.data(), y.size()), fp16::fp16_array(z.data(), y.size()), 0.25f);
+		},
+		[&](size_t i) { return fp32_ieee_to_fp16_value(fp16_ieee_to_fp32_value(x[i]) * fp16_ieee_to_fp32_value(z[i]) + 0.25f); },
+		"y = fma(x, z, 0.25)");
+	check_fp16_output(
+		[&](fp16::fp16_array_view<uint16_t> y) {
+			const fp16::packet one_half = fp16::packet::broadcast(0.5f);
+			y = fp16::map(fp16::fp16_array(x.data(), y.size()), [=](fp16::packet p) { return p * (p + one_half); });
+		},
+		[&](size_t i) {
+			const float f = fp16_ieee_to_fp32_value(x[i]);
+			return fp32_ieee_to_fp16_value(f * (f + 0.5f));
+		},
+		"y = map(x, x * (x + 0.5))");
+}
+
+void test_compound_assignment() {
+	const std::vector<uint16_t> x = make_fp16_input();
+	for (size_t n : lengths()) {
+		std::vector<uint16_t> y(x.begin(), x.begin() + n);
+		y.push_back(UINT16_C(0xDEAD));
+		fp16::fp16_array_view<uint16_t> view = fp16::fp16_array(y.data(), n);
+		view *= 2.0f;
+		view += fp16::fp16_array(x.data(), n);
+		view = view - 1.0f;
+		for (size_t i = 0; i < n; i++) {
+			const float f = fp16_ieee_to_fp32_value(x[i]);
+			const uint16_t expected = fp32_ieee_to_fp16_value(
+				fp16_ieee_to_fp32_value(fp32_ieee_to_fp16_value(fp16_ieee_to_fp32_value(fp32_ieee_to_fp16_value(f * 2.0f)) + f)) - 1.0f);
+			std::stringstream ss;
+			ss << "in-place y = (2 * x + x) - 1: N = " << n << ", I = " << i << std::hex << std::uppercase <<
+				", actual = 0x" << y[i] << ", expected = 0x" << expected;
+			std::string message = ss.str();
+			ASSERT_TRUE(same_fp16(y[i], expected), message);
+		}
+		const std::string guard_message = "in-place: guard element overwritten";
+		ASSERT_EQ(UINT16_C(0xDEAD), y[n], guard_message);
+	}
+}
+
+int main() {
+	printf("Running expression template tests (%u-lane packets)...\n", (unsigned) fp16::packet::width);
+
+	RUN_TEST(test_affine);
+	RUN_TEST(test_mixed_precision);
+	RUN_TEST(test_functions);
+	RUN_TEST(test_compound_assignment);
+
+	printf("All expression template tests passed!\n");
+	return 0;
+}
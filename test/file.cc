@@ -0,0 +1,158 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fp16.h>
+#include <fp16/file.h>
+#include "simple_test.h"
+#include "temp_file.h"
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <vector>
+
+/* Numbers with every byte pattern mix: normal, subnormal, infinite and NaN values for every kind of conversion */
+static std::vector<unsigned char> make_input(fp16_conversion_kind kind, size_t n) {
+	std::vector<unsigned char> bytes(n * fp16_conversion_input_size(kind));
+	uint32_t state = 12345;
+	for (size_t i = 0; i < bytes.size(); i++) {
+		state = state * 1664525u + 1013904223u;
+		bytes[i] = (unsigned char) (state >> 24);
+	}
+	return bytes;
+}
+
+static std::vector<unsigned char> expected_output(fp16_conversion_kind kind, const std::vector<unsigned char>& input) {
+	const size_t n = input.size() / fp16_conversion_input_size(kind);
+	std::vector<unsigned char> output(n * fp16_conversion_output_size(kind) + 1);
+	fp16_convert_strided(kind, input.data(), 1, output.data(), 1, n);
+	output.pop_back();
+	return output;
+}
+
+static void check_conversion(fp16_conversion_kind kind, size_t n, const fp16::file_conversion_options& options,
+	const std::string& name)
+{
+	const std::string input_path = temp_path("input"), output_path = temp_path("output");
+	const std::vector<unsigned char> input = make_input(kind, n);
+	write_bytes(input_path, input);
+	const fp16::file_conversion_stats stats = fp16::convert_file(kind, input_path.c_str(), output_path.c_str(), options);
+	const std::vector<unsigned char> output = read_bytes<std::vector<unsigned char>>(output_path);
+	remove(input_path.c_str());
+	remove(output_path.c_str());
+
+	std::string message = name + ": elements";
+	ASSERT_EQ(n, stats.elements, message);
+	message = name + ": bytes read";
+	ASSERT_EQ(input.size(), stats.bytes_read, message);
+	const std::vector<unsigned char> expected = expected_output(kind, input);
+	message = name + ": bytes written";
+	ASSERT_EQ(expected.size(), stats.bytes_written, message);
+	message = name + ": output file size";
+	ASSERT_EQ(expected.size(), output.size(), message);
+	message = name + ": output matches fp16_convert_strided";
+	ASSERT_TRUE(output == expected, message);
+	if (options.io == fp16::file_io::threads) {
+		message = name + ": threaded back end";
+		ASSERT_TRUE(stats.io == fp16::file_io::threads, message);
+	}
+}
+
+void test_buffering() {
+	const fp16::file_io backends[] = { fp16::file_io::threads, fp16::file_io::io_uring };
+	const size_t buffers[] = { 1, 2, 3, 8 };
+	const size_t chunks[] = { 1, 10000, fp16::file_conversion_options::default_chunk_elements };
+	for (fp16::file_io io : backends) {
+		for (size_t b : buffers) {
+			for (size_t chunk : chunks) {
+				fp16::file_conversion_options options;
+				options.io = io;
+				options.buffers = b;
+				options.chunk_elements = chunk;
+				std::stringstream ss;
+				ss << (io == fp16::file_io::threads ? "threads" : "io_uring") << ", " << b << " buffers, chunks of " << chunk;
+				check_conversion(FP16_CONVERSION_FP32_TO_IEEE, 100003, options, ss.str());
+			}
+		}
+	}
+}
+
+void test_kinds() {
+	static const fp16_conversion_kind kinds[] = {
+		FP16_CONVERSION_IEEE_TO_FP32, FP16_CONVERSION_FP32_TO_IEEE, FP16_CONVERSION_ALT_TO_FP32, FP16_CONVERSION_FP32_TO_ALT,
+	};
+	for (fp16_conversion_kind kind : kinds) {
+		fp16::file_conversion_options options;
+		options.chunk_elements = 8192;
+		check_conversion(kind, 3 * 8192 + 5, options, "kind " + std::to_string((int) kind));
+	}
+}
+
+void test_direct() {
+	/* File systems without O_DIRECT fall back to buffered I/O; either way the output is exact */
+	const fp16::file_io backends[] = { fp16::file_io::threads, fp16::file_io::automatic };
+	for (fp16::file_io io : backends) {
+		fp16::file_conversion_options options;
+		options.direct = true;
+		options.io = io;
+		options.chunk_elements = 4096;
+		check_conversion(FP16_CONVERSION_FP32_TO_IEEE, 5 * 4096 + 1, options, "O_DIRECT, FP32 to FP16");
+		check_conversion(FP16_CONVERSION_IEEE_TO_FP32, 2 * 4096 + 3, options, "O_DIRECT, FP16 to FP32");
+	}
+}
+
+void test_empty_file() {
+	const std::string input_path = temp_path("empty-input"), output_path = temp_path("empty-output");
+	write_bytes(input_path, std::vector<unsigned char>());
+	write_bytes(output_path, std::vector<unsigned char>(100, 1));
+	const fp16::file_conversion_stats stats =
+		fp16::convert_file(FP16_CONVERSION_FP32_TO_IEEE, input_path.c_str(), output_path.c_str());
+	const size_t output_size = read_bytes(output_path).size();
+	remove(input_path.c_str());
+	remove(output_path.c_str());
+	std::string message = "elements of an empty file";
+	ASSERT_EQ(0, stats.elements, message);
+	message = "output of an empty file";
+	ASSERT_EQ(0, output_size, message);
+}
+
+void test_errors() {
+	const std::string missing_path = temp_path("missing"), output_path = temp_path("error-output");
+	int error = 0;
+	try {
+		fp16::convert_file(FP16_CONVERSION_FP32_TO_IEEE, missing_path.c_str(), output_path.c_str());
+	} catch (const std::system_error& e) {
+		error = e.code().value();
+	}
+	std::string message = "missing input throws ENOENT";
+	ASSERT_EQ(ENOENT, error, message);
+
+	/* 7 bytes are not a whole number of single-precision numbers */
+	const std::string input_path = temp_path("odd-input");
+	write_bytes(input_path, std::vector<unsigned char>(7, 0));
+	bool thrown = false;
+	try {
+		fp16::convert_file(FP16_CONVERSION_FP32_TO_IEEE, input_path.c_str(), output_path.c_str());
+	} catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	remove(input_path.c_str());
+	remove(output_path.c_str());
+	message = "input size not a multiple of the number size";
+	ASSERT_TRUE(thrown, message);
+}
+
+int main() {
+	printf("Running file conversion tests...\n");
+
+	RUN_TEST(test_buffering);
+	RUN_TEST(test_kinds);
+	RUN_TEST(test_direct);
+	RUN_TEST(test_empty_file);
+	RUN_TEST(test_errors);
+
+	printf("All file conversion tests passed!\n");
+	return 0;
+}
@@ -0,0 +1,227 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <cfloat>
+#include <fp16.h>
+#include <fp16/fp64.h>
+#include "simple_test.h"
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+
+/*
+ * Reference decoding of finite half-precision magnitudes in double-precision arithmetic; 0x7C00 decodes to 65536,
+ * the number just past the largest finite one, which bounds the rounding interval of 65504.
+ */
+static double reference_magnitude(uint32_t code) {
+	const uint32_t exponent = code >> 10;
+	const uint32_t mantissa = code & 0x3FF;
+	if (exponent == 0) {
+		return std::ldexp((double) mantissa, -24);
+	}
+	return std::ldexp(1.0 + mantissa / 1024.0, (int) exponent - 15);
+}
+
+/*
+ * Reference encoding: the nearest half-precision number, the one with an even encoding on ties. The differences
+ * between the input and its neighbours are exact, as each neighbour is within a factor of two of the input.
+ */
+static uint16_t reference_encode(double value) {
+	const uint16_t sign = std::signbit(value) ? 0x8000 : 0;
+	if (std::isnan(value)) {
+		return sign | 0x7E00;
+	}
+	const double magnitude = std::fabs(value);
+	if (magnitude >= 65520.0) {
+		return sign | 0x7C00;
+	}
+	/* Largest code with reference_magnitude(code) <= magnitude */
+	uint32_t lo = 0, hi = 0x7C00;
+	while (hi - lo > 1) {
+		const uint32_t mid = (lo + hi) / 2;
+		if (reference_magnitude(mid) <= magnitude) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	const double below = magnitude - reference_magnitude(lo);
+	const double above = reference_magnitude(lo + 1) - magnitude;
+	const uint32_t code = below < above || (below == above && (lo & 1) == 0) ? lo : lo + 1;
+	return (uint16_t) (sign | code);
+}
+
+static bool fp16_is_nan(uint16_t h) {
+	return (h & 0x7FFF) > 0x7C00;
+}
+
+static bool fp64_is_nan(uint64_t w) {
+	return (w & UINT64_C(0x7FFFFFFFFFFFFFFF)) > UINT64_C(0x7FF0000000000000);
+}
+
+void test_fp16_ieee_to_fp64_bits() {
+	for (uint32_t h = 0; h <= 0xFFFF; h++) {
+		/* Single-precision widening is exact and keeps NaN payloads, so re-encode its fields in double-precision */
+		const uint32_t f = fp16_ieee_to_fp32_bits((uint16_t) h);
+		const uint32_t exponent = (f >> 23) & 0xFF;
+		const uint64_t expected = ((uint64_t) (f & UINT32_C(0x80000000)) << 32) |
+			((uint64_t) (exponent == 0 ? 0 : exponent == 0xFF ? 0x7FF : exponent + 896) << 52) |
+			((uint64_t) (f & UINT32_C(0x007FFFFF)) << 29);
+		const uint64_t actual = fp16_ieee_to_fp64_bits((uint16_t) h);
+		std::stringstream ss;
+		ss << "fp16_ieee_to_fp64_bits(0x" << std::hex << std::uppercase << h << ") = 0x" << actual <<
+			", expected 0x" << expected;
+		std::string message = ss.str();
+		ASSERT_TRUE(actual == expected, message);
+		if (!fp64_is_nan(expected)) {
+			message = "fp16_ieee_to_fp64_value: " + message;
+			ASSERT_TRUE(fp16_ieee_to_fp64_value((uint16_t) h) == (double) fp16_ieee_to_fp32_value((uint16_t) h), message);
+		}
+	}
+}
+
+static void check_encode(double value) {
+	const uint16_t expected = reference_encode(value);
+	const uint16_t actual = fp64_ieee_to_fp16_value(value);
+	std::stringstream ss;
+	ss << std::setprecision(17) << "fp64_ieee_to_fp16_value(" << value << ") = 0x" << std::hex << std::uppercase <<
+		actual << ", expected 0x" << expected;
+	std::string message = ss.str();
+	ASSERT_TRUE(actual == expected, message);
+}
+
+/*
+ * Numbers on and around every half-precision midpoint: the midpoints themselves, their double-precision
+ * neighbours, and numbers a quarter of a single-precision ulp away, which round to the midpoint in single-precision.
+ * Also every half-precision number and its neighbours.
+ */
+static std::vector<double> generate_midpoint_data() {
+	std::vector<double> data;
+	for (uint32_t code = 0; code < 0x7C00; code++) {
+		const double value = reference_magnitude(code);
+		const double midpoint = (value + reference_magnitude(code + 1)) / 2;
+		const int midpoint_exponent = std::ilogb(midpoint);
+		const double quarter_fp32_ulp = std::ldexp(1.0, (midpoint_exponent < -126 ? -126 : midpoint_exponent) - 25);
+		const double candidates[] = {
+			value, std::nextafter(value, 0.0), std::nextafter(value, INFINITY),
+			midpoint, std::nextafter(midpoint, 0.0), std::nextafter(midpoint, INFINITY),
+			midpoint - quarter_fp32_ulp, midpoint + quarter_fp32_ulp,
+		};
+		for (double candidate : candidates) {
+			data.push_back(candidate);
+			data.push_back(-candidate);
+		}
+	}
+	return data;
+}
+
+void test_fp64_ieee_to_fp16_value() {
+	const double specials[] = {
+		0.0, -0.0, INFINITY, -INFINITY, NAN, -NAN, DBL_MAX, -DBL_MAX, DBL_MIN, -DBL_MIN, fp64b_to_fp64v(1),
+		65504.0, 65519.99999999999, 65520.0, 65536.0, 1.0e10, std::ldexp(1.0, -25), std::ldexp(1.0, -26),
+		std::nextafter(std::ldexp(1.0, -25), 1.0), FLT_MAX, std::nextafter((double) FLT_MAX, INFINITY),
+	};
+	for (double value : specials) {
+		check_encode(value);
+	}
+
+	/* Every midpoint case that the single-precision path rounds twice must still round once */
+	size_t double_rounding_cases = 0;
+	for (double value : generate_midpoint_data()) {
+		check_encode(value);
+		if (fp32_ieee_to_fp16_value((float) value) != reference_encode(value)) {
+			double_rounding_cases++;
+		}
+	}
+	std::string message = "no double-rounding cases were exercised";
+	ASSERT_GT(double_rounding_cases, 0, message);
+
+	std::mt19937_64 rng(1);
+	std::uniform_int_distribution<uint64_t> bits;
+	for (size_t i = 0; i < 1000000; i++) {
+		const uint64_t w = bits(rng);
+		/* Exponents from 2**-30 to 2**17 cover denormal, normal, and overflowing results */
+		const uint64_t exponent = i % 8 == 0 ? (w >> 52) & 0x7FF : 993 + (w >> 12) % 48;
+		check_encode(fp64b_to_fp64v((w & UINT64_C(0x800FFFFFFFFFFFFF)) | (exponent << 52)));
+	}
+}
+
+/*
+ * Array results must equal the scalar results for every length, with no element written past the end.
+ * The vector kernels keep NaN payloads, so any NaN of the same sign matches an expected NaN.
+ */
+static const size_t kLengths[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 23, 24, 25, 31, 32, 33, 63, 64, 65, 10007 };
+
+template<typename Input, typename Output, typename ArrayFunc, typename ValueFunc, typename NanFunc>
+static void check_array(const std::vector<Input>& data, ArrayFunc convert_array, ValueFunc convert, NanFunc is_nan,
+	const std::string& name)
+{
+	for (size_t n : kLengths) {
+		std::vector<Output> output(n + 1, (Output) 0xA5);
+		convert_array(data.data(), output.data(), n);
+		for (size_t i = 0; i < n; i++) {
+			const Output expected = convert(data[i]);
+			const Output sign_mask = (Output) 1 << (sizeof(Output) * 8 - 1);
+			const bool matches = expected == output[i] ||
+				(is_nan(expected) && is_nan(output[i]) && (expected & sign_mask) == (output[i] & sign_mask));
+			std::stringstream ss;
+			ss << name << ": N = " << n << ", I = " << i << std::hex << std::uppercase <<
+				", actual = 0x" << (uint64_t) output[i] << ", expected = 0x" << (uint64_t) expected;
+			std::string message = ss.str();
+			ASSERT_TRUE(matches, message);
+		}
+		const std::string guard_message = name + ": guard element overwritten";
+		ASSERT_TRUE(output[n] == (Output) 0xA5, guard_message);
+	}
+}
+
+static void fp16_ieee_to_fp64_array_bits(const uint16_t* input, uint64_t* output, size_t n) {
+	fp16_ieee_to_fp64_array(input, (double*) output, n);
+}
+
+void test_fp16_ieee_to_fp64_array() {
+	std::vector<uint16_t> data(10007);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = (uint16_t) (i * 6553 + i / 10);
+	}
+	check_array<uint16_t, uint64_t>(data, fp16_ieee_to_fp64_array_bits, fp16_ieee_to_fp64_bits, fp64_is_nan,
+		"fp16_ieee_to_fp64_array");
+}
+
+void test_fp64_ieee_to_fp16_array() {
+	/* Interleave midpoint cases with arbitrary bit patterns, including NaN and infinity */
+	const std::vector<double> midpoints = generate_midpoint_data();
+	std::mt19937_64 rng(2);
+	std::uniform_int_distribution<uint64_t> bits;
+	std::vector<double> data(10007);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = i % 4 == 3 ? fp64b_to_fp64v(bits(rng)) : midpoints[(i * 7919) % midpoints.size()];
+	}
+	check_array<double, uint16_t>(data, fp64_ieee_to_fp16_array, fp64_ieee_to_fp16_value, fp16_is_nan,
+		"fp64_ieee_to_fp16_array");
+
+	/* Every midpoint case, in one call */
+	std::vector<uint16_t> output(midpoints.size());
+	fp64_ieee_to_fp16_array(midpoints.data(), output.data(), midpoints.size());
+	for (size_t i = 0; i < midpoints.size(); i++) {
+		std::stringstream ss;
+		ss << std::setprecision(17) << "fp64_ieee_to_fp16_array: value = " << midpoints[i] << std::hex << std::uppercase <<
+			", actual = 0x" << output[i] << ", expected = 0x" << reference_encode(midpoints[i]);
+		std::string message = ss.str();
+		ASSERT_TRUE(output[i] == reference_encode(midpoints[i]), message);
+	}
+}
+
+int main() {
+	printf("Running FP64 conversion tests...\n");
+
+	RUN_TEST(test_fp16_ieee_to_fp64_bits);
+	RUN_TEST(test_fp64_ieee_to_fp16_value);
+	RUN_TEST(test_fp16_ieee_to_fp64_array);
+	RUN_TEST(test_fp64_ieee_to_fp16_array);
+
+	printf("All FP64 conversion tests passed!\n");
+	return 0;
+}
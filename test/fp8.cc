@@ -0,0 +1,296 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/fp8.h>
+#include "simple_test.h"
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+
+/*
+ * Reference decoding in double-precision arithmetic from the format definitions; NaN encodings return NAN.
+ */
+static double reference_e4m3(uint32_t x) {
+	const uint32_t exponent = (x >> 3) & 0xF;
+	const uint32_t mantissa = x & 0x7;
+	double magnitude;
+	if (exponent == 0xF && mantissa == 0x7) {
+		magnitude = NAN;
+	} else if (exponent == 0) {
+		magnitude = std::ldexp((double) mantissa, -9);
+	} else {
+		magnitude = std::ldexp(1.0 + mantissa / 8.0, (int) exponent - 7);
+	}
+	return (x & 0x80) ? -magnitude : magnitude;
+}
+
+static double reference_e5m2(uint32_t x) {
+	const uint32_t exponent = (x >> 2) & 0x1F;
+	const uint32_t mantissa = x & 0x3;
+	double magnitude;
+	if (exponent == 0x1F) {
+		magnitude = mantissa == 0 ? INFINITY : NAN;
+	} else if (exponent == 0) {
+		magnitude = std::ldexp((double) mantissa, -16);
+	} else {
+		magnitude = std::ldexp(1.0 + mantissa / 4.0, (int) exponent - 15);
+	}
+	return (x & 0x80) ? -magnitude : magnitude;
+}
+
+struct Format {
+	const char* name;
+	double (*decode)(uint32_t);
+	uint32_t max_finite;      /* encoding of the largest finite number */
+	double overflow_bound;    /* magnitudes above this (or at it, if inclusive) overflow */
+	bool overflow_inclusive;
+	uint32_t infinity;        /* encoding produced by overflow without saturation */
+	uint32_t nan;
+};
+
+static const Format kE4M3 = { "E4M3", reference_e4m3, 0x7E, 464.0, false, 0x7F, 0x7F };
+static const Format kE5M2 = { "E5M2", reference_e5m2, 0x7B, 61440.0, true, 0x7C, 0x7E };
+
+/*
+ * Reference encoding: the nearest finite number, the one with an even encoding on ties, or the overflow result.
+ */
+static uint8_t reference_encode(const Format& format, double value, fp8_saturation saturation) {
+	const uint32_t sign = std::signbit(value) ? 0x80 : 0x00;
+	if (std::isnan(value)) {
+		return (uint8_t) (sign | format.nan);
+	}
+	const double magnitude = std::fabs(value);
+	if (magnitude > format.overflow_bound || (format.overflow_inclusive && magnitude == format.overflow_bound)) {
+		return (uint8_t) (sign | (saturation == FP8_SATURATE ? format.max_finite : format.infinity));
+	}
+	uint32_t best = 0;
+	double best_distance = INFINITY;
+	for (uint32_t x = 0; x <= format.max_finite; x++) {
+		const double distance = std::fabs(format.decode(x) - magnitude);
+		if (distance < best_distance || (distance == best_distance && (x & 1) == 0)) {
+			best = x;
+			best_distance = distance;
+		}
+	}
+	return (uint8_t) (sign | best);
+}
+
+void test_decode_tables() {
+	for (uint32_t x = 0; x < 256; x++) {
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << "F8 = 0x" << x;
+		std::string message = ss.str();
+
+		const double e4m3 = reference_e4m3(x);
+		const float e4m3_fp32 = fp8_e4m3_to_fp32_value((uint8_t) x);
+		const float e4m3_fp16 = fp16_ieee_to_fp32_value(fp8_e4m3_to_fp16_ieee_value((uint8_t) x));
+		if (std::isnan(e4m3)) {
+			ASSERT_TRUE(std::isnan(e4m3_fp32) && std::signbit(e4m3_fp32) == std::signbit(e4m3), message);
+			ASSERT_TRUE(std::isnan(e4m3_fp16) && std::signbit(e4m3_fp16) == std::signbit(e4m3), message);
+		} else {
+			ASSERT_EQ(e4m3, (double) e4m3_fp32, message);
+			ASSERT_EQ(e4m3, (double) e4m3_fp16, message);
+			ASSERT_TRUE(std::signbit(e4m3_fp32) == std::signbit(e4m3) && std::signbit(e4m3_fp16) == std::signbit(e4m3), message);
+		}
+
+		const double e5m2 = reference_e5m2(x);
+		const float e5m2_fp32 = fp8_e5m2_to_fp32_value((uint8_t) x);
+		const float e5m2_fp16 = fp16_ieee_to_fp32_value(fp8_e5m2_to_fp16_ieee_value((uint8_t) x));
+		if (std::isnan(e5m2)) {
+			ASSERT_TRUE(std::isnan(e5m2_fp32) && std::signbit(e5m2_fp32) == std::signbit(e5m2), message);
+			ASSERT_TRUE(std::isnan(e5m2_fp16) && std::signbit(e5m2_fp16) == std::signbit(e5m2), message);
+		} else {
+			ASSERT_EQ(e5m2, (double) e5m2_fp32, message);
+			ASSERT_EQ(e5m2, (double) e5m2_fp16, message);
+			ASSERT_TRUE(std::signbit(e5m2_fp32) == std::signbit(e5m2) && std::signbit(e5m2_fp16) == std::signbit(e5m2), message);
+		}
+	}
+}
+
+/*
+ * Single-precision inputs at, next to, and halfway between all pairs of neighbouring 8-bit numbers, the overflow
+ * boundaries, and a sweep over all bit patterns.
+ */
+static std::vector<float> generate_boundary_inputs(const Format& format) {
+	std::vector<float> inputs;
+	for (uint32_t x = 0; x <= format.max_finite; x++) {
+		const double lower = format.decode(x);
+		const double upper = x < format.max_finite ? format.decode(x + 1) : format.overflow_bound;
+		const float candidates[] = { (float) lower, (float) ((lower + upper) / 2.0) };
+		for (float candidate : candidates) {
+			inputs.push_back(candidate);
+			inputs.push_back(std::nextafter(candidate, 0.0f));
+			inputs.push_back(std::nextafter(candidate, INFINITY));
+		}
+	}
+	inputs.push_back((float) format.overflow_bound);
+	inputs.push_back(std::nextafter((float) format.overflow_bound, 0.0f));
+	inputs.push_back(std::nextafter((float) format.overflow_bound, INFINITY));
+	const size_t positive = inputs.size();
+	for (size_t i = 0; i < positive; i++) {
+		inputs.push_back(-inputs[i]);
+	}
+	for (uint64_t w = 0; w <= UINT64_C(0xFFFFFFFF); w += 0x10003) {
+		inputs.push_back(fp32b_to_fp32v((uint32_t) w));
+	}
+	return inputs;
+}
+
+static void check_fp32_encode(const Format& format, uint8_t (*convert)(float, fp8_saturation)) {
+	const std::vector<float> inputs = generate_boundary_inputs(format);
+	const fp8_saturation modes[] = { FP8_NO_SATURATION, FP8_SATURATE };
+	for (fp8_saturation saturation : modes) {
+		for (float f : inputs) {
+			const uint8_t expected = reference_encode(format, (double) f, saturation);
+			const uint8_t actual = convert(f, saturation);
+			std::stringstream ss;
+			ss << format.name << std::hex << std::uppercase << std::setfill('0') << ": saturation = " << saturation <<
+				", F32 = 0x" << std::setw(8) << fp32v_to_fp32b(f) << ", actual = 0x" << std::setw(2) << (uint32_t) actual <<
+				", expected = 0x" << std::setw(2) << (uint32_t) expected;
+			std::string message = ss.str();
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+void test_fp32_to_fp8_e4m3_value() {
+	check_fp32_encode(kE4M3, fp32_to_fp8_e4m3_value);
+}
+
+void test_fp32_to_fp8_e5m2_value() {
+	check_fp32_encode(kE5M2, fp32_to_fp8_e5m2_value);
+}
+
+static void check_fp16_encode(const Format& format, uint8_t (*convert)(uint16_t, fp8_saturation)) {
+	const fp8_saturation modes[] = { FP8_NO_SATURATION, FP8_SATURATE };
+	for (fp8_saturation saturation : modes) {
+		for (uint32_t h = 0; h < 0x10000; h++) {
+			const uint8_t expected = reference_encode(format, (double) fp16_ieee_to_fp32_value((uint16_t) h), saturation);
+			const uint8_t actual = convert((uint16_t) h, saturation);
+			std::stringstream ss;
+			ss << format.name << std::hex << std::uppercase << std::setfill('0') << ": saturation = " << saturation <<
+				", F16 = 0x" << std::setw(4) << h << ", actual = 0x" << std::setw(2) << (uint32_t) actual <<
+				", expected = 0x" << std::setw(2) << (uint32_t) expected;
+			std::string message = ss.str();
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+void test_fp16_ieee_to_fp8_e4m3_value() {
+	check_fp16_encode(kE4M3, fp16_ieee_to_fp8_e4m3_value);
+}
+
+void test_fp16_ieee_to_fp8_e5m2_value() {
+	check_fp16_encode(kE5M2, fp16_ieee_to_fp8_e5m2_value);
+}
+
+/*
+ * Array results must equal the scalar results for every length, with no element written past the end.
+ */
+static const size_t kLengths[] = { 0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 40, 47, 63, 64, 65, 10007 };
+
+template<typename Input, typename Output, typename ArrayFunc, typename ValueFunc>
+static void check_array(const std::vector<Input>& data, ArrayFunc convert_array, ValueFunc convert, const std::string& name) {
+	for (size_t n : kLengths) {
+		std::vector<Output> output(n + 1, (Output) 0xA5);
+		convert_array(data.data(), output.data(), n);
+		for (size_t i = 0; i < n; i++) {
+			const Output expected = convert(data[i]);
+			std::stringstream ss;
+			ss << name << ": N = " << n << ", I = " << i << std::hex << std::uppercase <<
+				", actual = 0x" << (uint64_t) output[i] << ", expected = 0x" << (uint64_t) expected;
+			std::string message = ss.str();
+			ASSERT_TRUE(expected == output[i], message);
+		}
+		const std::string guard_message = name + ": guard element overwritten";
+		ASSERT_TRUE(output[n] == (Output) 0xA5, guard_message);
+	}
+}
+
+static std::vector<uint8_t> generate_fp8_data() {
+	std::vector<uint8_t> data(10007);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = (uint8_t) (i * 37 + i / 256);
+	}
+	return data;
+}
+
+static std::vector<float> generate_fp32_data() {
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<uint32_t> bits;
+	std::vector<float> data(10007);
+	for (size_t i = 0; i < data.size(); i++) {
+		const uint32_t w = bits(rng);
+		/* Exponents from 2**-30 to 2**20 cover denormal, normal, and overflowing results of both formats */
+		const uint32_t exponent = i % 8 == 0 ? (w >> 23) & 0xFF : 97 + (w >> 8) % 51;
+		data[i] = fp32b_to_fp32v((w & UINT32_C(0x807FFFFF)) | (exponent << 23));
+	}
+	return data;
+}
+
+static std::vector<uint16_t> generate_fp16_data() {
+	std::vector<uint16_t> data(10007);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = (uint16_t) (i * 6553 + i / 10);
+	}
+	return data;
+}
+
+static uint32_t e4m3_to_fp32_bits(uint8_t x) { return fp8_e4m3_to_fp32_bits(x); }
+static uint32_t e5m2_to_fp32_bits(uint8_t x) { return fp8_e5m2_to_fp32_bits(x); }
+
+static void e4m3_to_fp32_array_bits(const uint8_t* input, uint32_t* output, size_t n) {
+	fp8_e4m3_to_fp32_array(input, (float*) output, n);
+}
+
+static void e5m2_to_fp32_array_bits(const uint8_t* input, uint32_t* output, size_t n) {
+	fp8_e5m2_to_fp32_array(input, (float*) output, n);
+}
+
+void test_decode_arrays() {
+	const std::vector<uint8_t> data = generate_fp8_data();
+	check_array<uint8_t, uint32_t>(data, e4m3_to_fp32_array_bits, e4m3_to_fp32_bits, "fp8_e4m3_to_fp32_array");
+	check_array<uint8_t, uint32_t>(data, e5m2_to_fp32_array_bits, e5m2_to_fp32_bits, "fp8_e5m2_to_fp32_array");
+	check_array<uint8_t, uint16_t>(data, fp8_e4m3_to_fp16_ieee_array, fp8_e4m3_to_fp16_ieee_value, "fp8_e4m3_to_fp16_ieee_array");
+	check_array<uint8_t, uint16_t>(data, fp8_e5m2_to_fp16_ieee_array, fp8_e5m2_to_fp16_ieee_value, "fp8_e5m2_to_fp16_ieee_array");
+}
+
+void test_encode_arrays() {
+	const std::vector<float> fp32 = generate_fp32_data();
+	const std::vector<uint16_t> fp16 = generate_fp16_data();
+	const fp8_saturation modes[] = { FP8_NO_SATURATION, FP8_SATURATE };
+	for (fp8_saturation saturation : modes) {
+		const std::string suffix = saturation == FP8_SATURATE ? " (saturate)" : "";
+		check_array<float, uint8_t>(fp32,
+			[=](const float* input, uint8_t* output, size_t n) { fp32_to_fp8_e4m3_array(input, output, n, saturation); },
+			[=](float f) { return fp32_to_fp8_e4m3_value(f, saturation); }, "fp32_to_fp8_e4m3_array" + suffix);
+		check_array<float, uint8_t>(fp32,
+			[=](const float* input, uint8_t* output, size_t n) { fp32_to_fp8_e5m2_array(input, output, n, saturation); },
+			[=](float f) { return fp32_to_fp8_e5m2_value(f, saturation); }, "fp32_to_fp8_e5m2_array" + suffix);
+		check_array<uint16_t, uint8_t>(fp16,
+			[=](const uint16_t* input, uint8_t* output, size_t n) { fp16_ieee_to_fp8_e4m3_array(input, output, n, saturation); },
+			[=](uint16_t h) { return fp16_ieee_to_fp8_e4m3_value(h, saturation); }, "fp16_ieee_to_fp8_e4m3_array" + suffix);
+		check_array<uint16_t, uint8_t>(fp16,
+			[=](const uint16_t* input, uint8_t* output, size_t n) { fp16_ieee_to_fp8_e5m2_array(input, output, n, saturation); },
+			[=](uint16_t h) { return fp16_ieee_to_fp8_e5m2_value(h, saturation); }, "fp16_ieee_to_fp8_e5m2_array" + suffix);
+	}
+}
+
+int main() {
+	printf("Running FP8 conversion tests...\n");
+
+	RUN_TEST(test_decode_tables);
+	RUN_TEST(test_fp32_to_fp8_e4m3_value);
+	RUN_TEST(test_fp32_to_fp8_e5m2_value);
+	RUN_TEST(test_fp16_ieee_to_fp8_e4m3_value);
+	RUN_TEST(test_fp16_ieee_to_fp8_e5m2_value);
+	RUN_TEST(test_decode_arrays);
+	RUN_TEST(test_encode_arrays);
+
+	printf("All FP8 conversion tests passed!\n");
+	return 0;
+}
@@ -0,0 +1,212 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/half.h>
+#include "simple_test.h"
+#include <limits>
+#include <random>
+#include <string>
+#include <sstream>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+static_assert(std::is_trivially_copyable<fp16::half>::value, "trivially copyable");
+static_assert(std::is_trivially_default_constructible<fp16::half>::value, "trivially default constructible");
+static_assert(std::is_standard_layout<fp16::half>::value, "standard layout");
+static_assert(sizeof(fp16::half) == sizeof(float16) && alignof(fp16::half) == alignof(float16), "layout of float16");
+static_assert(std::is_convertible<float, fp16::half>::value, "implicit conversion from float");
+static_assert(std::is_convertible<int, fp16::half>::value, "implicit conversion from int");
+static_assert(!std::is_convertible<float, fp16::strict_half>::value, "explicit conversion from float");
+static_assert(std::is_constructible<fp16::strict_half, double>::value, "explicit construction from double");
+static_assert(std::is_convertible<fp16::strict_half, fp16::half>::value, "conversion between policies");
+static_assert(std::is_same<decltype(fp16::half() * fp16::half()), float>::value, "promotion to float");
+static_assert(std::is_same<decltype(fp16::half() + 1.0), double>::value, "promotion to double");
+static_assert(std::is_same<decltype(-fp16::half()), fp16::half>::value, "negation returns half");
+static_assert(std::numeric_limits<fp16::half>::max().to_bits() == UINT16_C(0x7BFF), "constexpr limits");
+
+void test_conversions() {
+	for (uint32_t h = 0; h <= 0xFFFF; h++) {
+		const fp16::half x = fp16::half::from_bits((float16) h);
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << "F16 = 0x" << h;
+		std::string message = "half to float: " + ss.str();
+		const float f = x;
+		ASSERT_EQ(fp32v_to_fp32b(fp16_ieee_to_fp32_value((float16) h)), fp32v_to_fp32b(f), message);
+		message = "half to double: " + ss.str();
+		const double d = x;
+		ASSERT_EQ(fp64v_to_fp64b((double) fp16_ieee_to_fp32_value((float16) h)), fp64v_to_fp64b(d), message);
+		message = "negation: " + ss.str();
+		ASSERT_EQ(h ^ 0x8000, (-x).to_bits(), message);
+		message = "strict_half from half: " + ss.str();
+		ASSERT_EQ(h, fp16::strict_half(x).to_bits(), message);
+		if (!std::isnan(f)) {
+			message = "round trip through float: " + ss.str();
+			const fp16::half y = f;
+			ASSERT_EQ(h, y.to_bits(), message);
+			message = "round trip through double: " + ss.str();
+			const fp16::strict_half z(d);
+			ASSERT_EQ(h, z.to_bits(), message);
+		}
+	}
+
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<uint64_t> bits;
+	for (size_t i = 0; i < 1000000; i++) {
+		const uint64_t w = bits(rng);
+		const float f = fp32b_to_fp32v((uint32_t) w);
+		const double d = fp64b_to_fp64v((w & UINT64_C(0x800FFFFFFFFFFFFF)) | ((uint64_t) (993 + (w >> 52) % 48) << 52));
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << "F32 = 0x" << (uint32_t) w << ", F64 = 0x" << fp64v_to_fp64b(d);
+		std::string message = "half from float: " + ss.str();
+		const fp16::half x = f;
+		ASSERT_EQ(fp32_ieee_to_fp16_value(f), x.to_bits(), message);
+		message = "half from double: " + ss.str();
+		const fp16::half y = d;
+		ASSERT_EQ(fp64_ieee_to_fp16_value(d), y.to_bits(), message);
+	}
+
+	for (int32_t i = -70000; i <= 70000; i++) {
+		std::stringstream ss;
+		ss << "I = " << i;
+		std::string message = "half from int: " + ss.str();
+		const fp16::half x = i;
+		ASSERT_EQ(fp64_ieee_to_fp16_value((double) i), x.to_bits(), message);
+	}
+}
+
+void test_arithmetic() {
+	std::mt19937 rng(2);
+	std::uniform_int_distribution<uint32_t> bits(0, 0xFFFF);
+	for (size_t i = 0; i < 1000000; i++) {
+		const fp16::half a = fp16::half::from_bits((float16) bits(rng));
+		const fp16::half b = fp16::half::from_bits((float16) bits(rng));
+		const float fa = fp16_ieee_to_fp32_value(a.to_bits());
+		const float fb = fp16_ieee_to_fp32_value(b.to_bits());
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << "A = 0x" << a.to_bits() << ", B = 0x" << b.to_bits();
+		const std::string operands = ss.str();
+
+		const float sum = a + b;
+		std::string message = "a + b: " + operands;
+		ASSERT_TRUE(fp32v_to_fp32b(sum) == fp32v_to_fp32b(fa + fb) || (std::isnan(sum) && std::isnan(fa + fb)), message);
+
+		fp16::half c = a;
+		c *= b;
+		message = "c *= b: " + operands;
+		ASSERT_TRUE(c.to_bits() == fp32_ieee_to_fp16_value(fa * fb) || (std::isnan(c) && std::isnan(fa * fb)), message);
+
+		fp16::strict_half d(a);
+		d /= b;
+		message = "d /= b: " + operands;
+		ASSERT_TRUE(d.to_bits() == fp32_ieee_to_fp16_value(fa / fb) || (std::isnan(d) && std::isnan(fa / fb)), message);
+
+		message = "a < b: " + operands;
+		ASSERT_TRUE((a < b) == (fa < fb), message);
+		message = "a == b: " + operands;
+		ASSERT_TRUE((a == b) == (fa == fb), message);
+	}
+}
+
+void test_single_rounding() {
+	/*
+	 * 2048 + 1 is a half-precision midpoint and rounds to 2048 (even), so rounding after each addition never leaves
+	 * 2048, while rounding only the result gives 2050.
+	 */
+	const fp16::half x = 2048.0f;
+	const fp16::half one = 1.0f;
+	const fp16::half fused = x + one + one;
+	std::string message = "x + 1 + 1";
+	ASSERT_EQ(2050.0f, fused, message);
+
+	fp16::half stepwise = x;
+	stepwise += one;
+	stepwise += one;
+	message = "x += 1; x += 1";
+	ASSERT_EQ(2048.0f, stepwise, message);
+
+	/* 65504 * 2 / 2 overflows in half-precision but not in single-precision */
+	const fp16::half max = std::numeric_limits<fp16::half>::max();
+	const fp16::half result = max * 2.0f / 2.0f;
+	message = "65504 * 2 / 2";
+	ASSERT_EQ(UINT16_C(0x7BFF), result.to_bits(), message);
+
+	fp16::half counter = 2047.0f;
+	counter++;
+	message = "2047++";
+	ASSERT_EQ(2048.0f, counter, message);
+	++counter;
+	message = "++2048";
+	ASSERT_EQ(2048.0f, counter, message);
+}
+
+void test_numeric_limits() {
+	typedef std::numeric_limits<fp16::half> limits;
+	std::string message = "min";
+	ASSERT_EQ(6.103515625e-05f, limits::min(), message);
+	message = "lowest";
+	ASSERT_EQ(-65504.0f, limits::lowest(), message);
+	message = "max";
+	ASSERT_EQ(65504.0f, limits::max(), message);
+	message = "epsilon";
+	ASSERT_EQ((float) fp16::half::from_bits(UINT16_C(0x3C01)) - 1.0f, limits::epsilon(), message);
+	message = "denorm_min";
+	ASSERT_EQ(5.9604644775390625e-08f, limits::denorm_min(), message);
+	message = "infinity";
+	ASSERT_TRUE(std::isinf(limits::infinity()) && limits::infinity() > 0.0f, message);
+	message = "quiet_NaN";
+	ASSERT_TRUE(std::isnan(limits::quiet_NaN()), message);
+	message = "signaling_NaN";
+	ASSERT_TRUE(std::isnan(limits::signaling_NaN()), message);
+	message = "digits";
+	ASSERT_EQ(11, limits::digits, message);
+	message = "max_exponent";
+	ASSERT_EQ(limits::max(), std::ldexp(1.0f - std::ldexp(1.0f, -limits::digits), limits::max_exponent), message);
+	message = "min_exponent";
+	ASSERT_EQ(limits::min(), std::ldexp(0.5f, limits::min_exponent), message);
+	message = "digits10";
+	ASSERT_EQ(limits::digits10, (int) std::floor((limits::digits - 1) * std::log10(2.0)), message);
+	const int& digits = limits::digits;
+	message = "ODR-use of digits";
+	ASSERT_EQ(11, digits, message);
+}
+
+void test_hash() {
+	const std::hash<fp16::half> hash;
+	std::string message = "hash of +0 and -0";
+	ASSERT_TRUE(hash(fp16::half::from_bits(UINT16_C(0x0000))) == hash(fp16::half::from_bits(UINT16_C(0x8000))), message);
+
+	std::unordered_set<fp16::half> set;
+	for (uint32_t h = 0; h <= 0xFFFF; h++) {
+		const fp16::half x = fp16::half::from_bits((float16) h);
+		if (!std::isnan(x)) {
+			set.insert(x);
+		}
+	}
+	/* 63489 numbers: NaNs 0x7C01..0x7FFF and 0xFC01..0xFFFF excluded, -0 equal to +0 */
+	message = "distinct numbers";
+	ASSERT_EQ(65536 - 2 * 1023 - 1, (int) set.size(), message);
+}
+
+void test_stream() {
+	std::stringstream ss;
+	ss << fp16::half(0.5f) << " " << fp16::strict_half(-2.0f);
+	std::string message = "stream output: " + ss.str();
+	ASSERT_TRUE(ss.str() == "0.5 -2", message);
+}
+
+int main() {
+	printf("Running half value type tests...\n");
+
+	RUN_TEST(test_conversions);
+	RUN_TEST(test_arithmetic);
+	RUN_TEST(test_single_rounding);
+	RUN_TEST(test_numeric_limits);
+	RUN_TEST(test_hash);
+	RUN_TEST(test_stream);
+
+	printf("All half value type tests passed!\n");
+	return 0;
+}
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <fp16.h>
+#include "simple_test.h"
+#include "test_data.h"
+#include <string>
+#include <sstream>
+#include <vector>
+
+/* Guard bytes after the buffer to detect stores past its end */
+static const size_t kGuardBytes = 64;
+static const unsigned char kGuardByte = 0xA5;
+
+static void check_guard(const std::vector<unsigned char>& buffer, size_t n, const std::string& name) {
+	for (size_t i = 4 * n; i < buffer.size(); i++) {
+		std::stringstream ss;
+		ss << name << ": N = " << n << ", guard byte " << (i - 4 * n) << " overwritten";
+		std::string message = ss.str();
+		ASSERT_EQ(kGuardByte, buffer[i], message);
+	}
+}
+
+static void check_compaction(float16* (*convert_inplace)(void*, size_t), void (*convert)(const float*, float16*, size_t),
+	const std::string& name, size_t n)
+{
+	const std::vector<float> input = generate_fp32_data(n, (uint32_t) n);
+	std::vector<uint16_t> expected(n);
+	convert(input.data(), expected.data(), n);
+
+	std::vector<unsigned char> buffer(4 * n + kGuardBytes, kGuardByte);
+	if (n != 0) {
+		memcpy(buffer.data(), input.data(), 4 * n);
+	}
+	const float16* output = convert_inplace(buffer.data(), n);
+	ASSERT_TRUE((const void*) output == (const void*) buffer.data(), name);
+
+	for (size_t i = 0; i < n; i++) {
+		uint16_t actual;
+		memcpy(&actual, buffer.data() + 2 * i, sizeof(actual));
+		std::stringstream ss;
+		ss << name << ": N = " << n << ", I = " << i << std::hex << std::uppercase << std::setfill('0') <<
+			", F32 = 0x" << std::setw(8) << fp32v_to_fp32b(input[i]) <<
+			", F16(F32) = 0x" << std::setw(4) << actual << ", F16 = 0x" << std::setw(4) << expected[i];
+		std::string message = ss.str();
+		ASSERT_EQ(expected[i], actual, message);
+	}
+	check_guard(buffer, n, name);
+}
+
+static void check_expansion(float* (*convert_inplace)(void*, size_t), void (*convert)(const float16*, float*, size_t),
+	const std::string& name, size_t n)
+{
+	const std::vector<uint16_t> input = generate_fp16_data(n, (uint32_t) n);
+	std::vector<float> expected(n);
+	convert(input.data(), expected.data(), n);
+
+	std::vector<unsigned char> buffer(4 * n + kGuardBytes, kGuardByte);
+	if (n != 0) {
+		memcpy(buffer.data(), input.data(), 2 * n);
+	}
+	const float* output = convert_inplace(buffer.data(), n);
+	ASSERT_TRUE((const void*) output == (const void*) buffer.data(), name);
+
+	for (size_t i = 0; i < n; i++) {
+		uint32_t actual;
+		memcpy(&actual, buffer.data() + 4 * i, sizeof(actual));
+		std::stringstream ss;
+		ss << name << ": N = " << n << ", I = " << i << std::hex << std::uppercase << std::setfill('0') <<
+			", F16 = 0x" << std::setw(4) << input[i] <<
+			", F32(F16) = 0x" << std::setw(8) << actual << ", F32 = 0x" << std::setw(8) << fp32v_to_fp32b(expected[i]);
+		std::string message = ss.str();
+		ASSERT_EQ(fp32v_to_fp32b(expected[i]), actual, message);
+	}
+	check_guard(buffer, n, name);
+}
+
+static const size_t kMaxLength = 300;
+
+void test_fp32_ieee_to_fp16_array_inplace() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_compaction(fp32_ieee_to_fp16_array_inplace, fp32_ieee_to_fp16_array, "fp32_ieee_to_fp16_array_inplace", n);
+	}
+	check_compaction(fp32_ieee_to_fp16_array_inplace, fp32_ieee_to_fp16_array, "fp32_ieee_to_fp16_array_inplace", 100003);
+}
+
+void test_fp16_ieee_to_fp32_array_inplace() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_expansion(fp16_ieee_to_fp32_array_inplace, fp16_ieee_to_fp32_array, "fp16_ieee_to_fp32_array_inplace", n);
+	}
+	check_expansion(fp16_ieee_to_fp32_array_inplace, fp16_ieee_to_fp32_array, "fp16_ieee_to_fp32_array_inplace", 100003);
+}
+
+void test_fp32_alt_to_fp16_array_inplace() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_compaction(fp32_alt_to_fp16_array_inplace, fp32_alt_to_fp16_array, "fp32_alt_to_fp16_array_inplace", n);
+	}
+	check_compaction(fp32_alt_to_fp16_array_inplace, fp32_alt_to_fp16_array, "fp32_alt_to_fp16_array_inplace", 100003);
+}
+
+void test_fp16_alt_to_fp32_array_inplace() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_expansion(fp16_alt_to_fp32_array_inplace, fp16_alt_to_fp32_array, "fp16_alt_to_fp32_array_inplace", n);
+	}
+	check_expansion(fp16_alt_to_fp32_array_inplace, fp16_alt_to_fp32_array, "fp16_alt_to_fp32_array_inplace", 100003);
+}
+
+int main() {
+	printf("Running FP16 in-place conversion tests...\n");
+
+	RUN_TEST(test_fp32_ieee_to_fp16_array_inplace);
+	RUN_TEST(test_fp16_ieee_to_fp32_array_inplace);
+	RUN_TEST(test_fp32_alt_to_fp16_array_inplace);
+	RUN_TEST(test_fp16_alt_to_fp32_array_inplace);
+
+	printf("All in-place conversion tests passed!\n");
+	return 0;
+}
@@ -0,0 +1,300 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <cfloat>
+#include <fp16.h>
+#include <fp16/minifloat.h>
+#include "simple_test.h"
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+typedef minifloat<5, 6> minifloat_fp12;
+typedef minifloat<3, 4, 2, MINIFLOAT_FINITE> minifloat_e3m4_finite;
+
+/*
+ * Reference decoding in double-precision arithmetic from the format parameters; NaN encodings return NAN.
+ */
+template<typename Format>
+static double reference_decode(uint32_t x) {
+	const uint32_t mantissa_mask = (UINT32_C(1) << Format::mantissa_bits) - 1;
+	const uint32_t exponent_max = (UINT32_C(1) << Format::exponent_bits) - 1;
+	const uint32_t exponent = (x >> Format::mantissa_bits) & exponent_max;
+	const uint32_t mantissa = x & mantissa_mask;
+	double magnitude;
+	if (Format::specials == MINIFLOAT_IEEE && exponent == exponent_max) {
+		magnitude = mantissa == 0 ? INFINITY : NAN;
+	} else if (Format::specials == MINIFLOAT_NAN_ONLY && exponent == exponent_max && mantissa == mantissa_mask) {
+		magnitude = NAN;
+	} else if (exponent == 0) {
+		magnitude = std::ldexp((double) mantissa, 1 - Format::bias - (int) Format::mantissa_bits);
+	} else {
+		magnitude = std::ldexp((double) (mantissa | (mantissa_mask + 1)),
+			(int) exponent - Format::bias - (int) Format::mantissa_bits);
+	}
+	const uint32_t sign_mask = UINT32_C(1) << (Format::exponent_bits + Format::mantissa_bits);
+	return (x & sign_mask) ? -magnitude : magnitude;
+}
+
+template<typename Format>
+static uint32_t max_finite_code() {
+	const uint32_t nonsign_mask = (UINT32_C(1) << (Format::exponent_bits + Format::mantissa_bits)) - 1;
+	switch (Format::specials) {
+		case MINIFLOAT_IEEE:
+			return nonsign_mask - ((UINT32_C(1) << Format::mantissa_bits) - 1) - 1;
+		case MINIFLOAT_NAN_ONLY:
+			return nonsign_mask - 1;
+		default:
+			return nonsign_mask;
+	}
+}
+
+/*
+ * Reference encoding of a non-NaN input: round the magnitude to mantissa_bits bits (ties to even) at its exponent,
+ * clamped to the denormal exponent, then apply the overflow behavior of the format.
+ */
+template<typename Format>
+static uint32_t reference_encode(double value) {
+	const int mantissa_bits = (int) Format::mantissa_bits;
+	const uint32_t sign = std::signbit(value) ? UINT32_C(1) << (Format::exponent_bits + Format::mantissa_bits) : 0;
+	const uint32_t nonsign_mask = (UINT32_C(1) << (Format::exponent_bits + Format::mantissa_bits)) - 1;
+	const uint32_t max_code = max_finite_code<Format>();
+	const double max_value = reference_decode<Format>(max_code);
+	const int min_exponent = 1 - Format::bias;
+
+	const double magnitude = std::fabs(value);
+	double rounded = magnitude;
+	if (std::isfinite(magnitude) && magnitude != 0.0) {
+		int exponent;
+		std::frexp(magnitude, &exponent);
+		exponent = std::max(exponent - 1, min_exponent);
+		rounded = std::ldexp(std::nearbyint(std::ldexp(magnitude, mantissa_bits - exponent)), exponent - mantissa_bits);
+	}
+	if (rounded > max_value) {
+		switch (Format::specials) {
+			case MINIFLOAT_IEEE:
+				return sign | (max_code + 1);
+			case MINIFLOAT_NAN_ONLY:
+				return sign | nonsign_mask;
+			default:
+				return sign | max_code;
+		}
+	}
+	if (rounded == 0.0) {
+		return sign;
+	}
+	int exponent;
+	std::frexp(rounded, &exponent);
+	exponent -= 1;
+	if (exponent < min_exponent) {
+		return sign | (uint32_t) std::ldexp(rounded, mantissa_bits - min_exponent);
+	}
+	const uint32_t mantissa = (uint32_t) std::ldexp(rounded, mantissa_bits - exponent) - (UINT32_C(1) << mantissa_bits);
+	return sign | ((uint32_t) (exponent + Format::bias) << mantissa_bits) | mantissa;
+}
+
+/*
+ * Every code decodes to the reference value, and to_fp32_bits agrees with to_fp32_value.
+ */
+template<typename Format>
+static void check_decode(const std::string& name) {
+	const uint32_t bits = 1 + Format::exponent_bits + Format::mantissa_bits;
+	for (uint64_t x = 0; x < (UINT64_C(1) << bits); x++) {
+		const typename Format::storage code = (typename Format::storage) x;
+		const double expected = reference_decode<Format>((uint32_t) x);
+		const float value = Format::to_fp32_value(code);
+		const float bits_value = fp32b_to_fp32v(Format::to_fp32_bits(code));
+		std::stringstream ss;
+		ss << name << ": X = 0x" << std::hex << std::uppercase << x << ", value = " << std::scientific << value <<
+			", expected = " << expected;
+		std::string message = ss.str();
+		if (std::isnan(expected)) {
+			ASSERT_TRUE(std::isnan(value) && std::isnan(bits_value), message);
+			ASSERT_TRUE(std::signbit(value) == std::signbit(expected), message);
+		} else {
+			ASSERT_TRUE((double) value == expected && std::signbit(value) == std::signbit(expected), message);
+			ASSERT_TRUE(fp32v_to_fp32b(bits_value) == fp32v_to_fp32b(value), message);
+		}
+	}
+}
+
+/*
+ * Representable values, the midpoints between consecutive values and their neighbors, special values, and random inputs.
+ */
+template<typename Format>
+static std::vector<float> generate_encode_inputs() {
+	std::vector<float> inputs;
+	const uint32_t max_code = max_finite_code<Format>();
+	const uint32_t step = max_code >> 16 | 1;
+	for (uint32_t x = 0; x <= max_code; x += step) {
+		const double value = reference_decode<Format>(x);
+		const double next = x == max_code ?
+			value + std::ldexp(1.0, (int) (x >> Format::mantissa_bits) - Format::bias - (int) Format::mantissa_bits) :
+			reference_decode<Format>(x + 1);
+		const float midpoint = (float) ((value + next) / 2);
+		const float candidates[] = {
+			(float) value, midpoint, std::nextafter(midpoint, 0.0f), std::nextafter(midpoint, INFINITY)
+		};
+		for (float f : candidates) {
+			inputs.push_back(f);
+			inputs.push_back(-f);
+		}
+	}
+	const float specials[] = {
+		INFINITY, -INFINITY, NAN, -NAN, FLT_MAX, FLT_MIN, fp32b_to_fp32v(1), 1.0e-30f, 65504.0f, 65520.0f
+	};
+	inputs.insert(inputs.end(), specials, specials + sizeof(specials) / sizeof(specials[0]));
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<uint32_t> random_bits;
+	for (size_t i = 0; i < 100000; i++) {
+		inputs.push_back(fp32b_to_fp32v(random_bits(rng)));
+	}
+	return inputs;
+}
+
+template<typename Format>
+static void check_encode(const std::string& name) {
+	for (float f : generate_encode_inputs<Format>()) {
+		const uint32_t actual = Format::from_fp32_value(f);
+		std::stringstream ss;
+		ss << name << ": F = 0x" << std::hex << std::uppercase << fp32v_to_fp32b(f) << ", actual = 0x" << actual;
+		if (std::isnan(f) && Format::specials == MINIFLOAT_FINITE) {
+			const uint32_t sign = std::signbit(f) ? UINT32_C(1) << (Format::exponent_bits + Format::mantissa_bits) : 0;
+			std::string message = ss.str();
+			ASSERT_TRUE(actual == (sign | max_finite_code<Format>()), message);
+		} else if (std::isnan(f)) {
+			std::string message = ss.str();
+			ASSERT_TRUE(std::isnan(reference_decode<Format>(actual)), message);
+			ASSERT_TRUE(std::signbit(reference_decode<Format>(actual)) == std::signbit(f), message);
+		} else {
+			const uint32_t expected = reference_encode<Format>((double) f);
+			ss << ", expected = 0x" << expected;
+			std::string message = ss.str();
+			ASSERT_TRUE(actual == expected, message);
+		}
+	}
+}
+
+/*
+ * Array results must equal the scalar results for every length, with no element written past the end.
+ */
+static const size_t kLengths[] = { 0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 40, 47, 63, 64, 65, 10007 };
+
+template<typename Format>
+static void check_arrays(const std::string& name) {
+	typedef typename Format::storage storage;
+	const uint32_t code_mask = (uint32_t) ((UINT64_C(1) << (1 + Format::exponent_bits + Format::mantissa_bits)) - 1);
+	std::vector<storage> codes(10007);
+	std::vector<float> values(10007);
+	std::mt19937 rng(2);
+	std::uniform_int_distribution<uint32_t> random_bits;
+	for (size_t i = 0; i < codes.size(); i++) {
+		codes[i] = (storage) (random_bits(rng) & code_mask);
+		const uint32_t w = random_bits(rng);
+		/* Mostly exponents from 2**-40 to 2**70, which cover denormal, normal and overflowing results */
+		const uint32_t exponent = i % 8 == 0 ? (w >> 23) & 0xFF : 87 + (w >> 8) % 111;
+		values[i] = fp32b_to_fp32v((w & UINT32_C(0x807FFFFF)) | (exponent << 23));
+	}
+
+	for (size_t n : kLengths) {
+		std::vector<float> decoded(n + 1, 42.0f);
+		Format::to_fp32_array(codes.data(), decoded.data(), n);
+		std::vector<storage> encoded(n + 1, (storage) 0xA5);
+		Format::from_fp32_array(values.data(), encoded.data(), n);
+		for (size_t i = 0; i < n; i++) {
+			const uint32_t expected_value = fp32v_to_fp32b(Format::to_fp32_value(codes[i]));
+			const uint32_t expected_code = Format::from_fp32_value(values[i]);
+			std::stringstream ss;
+			ss << name << ": N = " << n << ", I = " << i << std::hex << std::uppercase <<
+				", decoded = 0x" << fp32v_to_fp32b(decoded[i]) << " (expected 0x" << expected_value <<
+				"), encoded = 0x" << (uint32_t) encoded[i] << " (expected 0x" << expected_code << ")";
+			std::string message = ss.str();
+			ASSERT_TRUE(fp32v_to_fp32b(decoded[i]) == expected_value, message);
+			if (std::isnan(reference_decode<Format>(expected_code))) {
+				/* The F16C kernels used for IEEE half-precision keep NaN payloads */
+				ASSERT_TRUE(std::isnan(reference_decode<Format>(encoded[i])), message);
+				ASSERT_TRUE(std::signbit(reference_decode<Format>(encoded[i])) == std::signbit(values[i]), message);
+			} else {
+				ASSERT_TRUE(encoded[i] == expected_code, message);
+			}
+		}
+		const std::string guard_message = name + ": guard element overwritten";
+		ASSERT_TRUE(decoded[n] == 42.0f && encoded[n] == (storage) 0xA5, guard_message);
+	}
+}
+
+template<typename Format>
+static void check_format(const std::string& name) {
+	check_decode<Format>(name);
+	check_encode<Format>(name);
+	check_arrays<Format>(name);
+}
+
+void test_fp16_ieee() { check_format<minifloat_fp16_ieee>("fp16 ieee"); }
+void test_fp16_alt() { check_format<minifloat_fp16_alt>("fp16 alt"); }
+void test_bf16() { check_format<minifloat_bf16>("bf16"); }
+void test_tf32() { check_format<minifloat_tf32>("tf32"); }
+void test_fp24() { check_format<minifloat_fp24>("fp24"); }
+void test_fp12() { check_format<minifloat_fp12>("fp12"); }
+void test_fp8_e4m3() { check_format<minifloat_fp8_e4m3>("fp8 e4m3"); }
+void test_fp8_e5m2() { check_format<minifloat_fp8_e5m2>("fp8 e5m2"); }
+void test_e3m4_finite() { check_format<minifloat_e3m4_finite>("e3m4 finite"); }
+
+/*
+ * Instantiations for the formats of fp16.h, bf16.h and fp8.h give the same results as the hand-written conversions.
+ */
+template<typename Format, typename Decode, typename DecodeBits, typename Encode>
+static void check_equivalence(const std::string& name, Decode decode, DecodeBits decode_bits, Encode encode) {
+	const uint32_t bits = 1 + Format::exponent_bits + Format::mantissa_bits;
+	for (uint32_t x = 0; x < (UINT32_C(1) << bits); x++) {
+		const typename Format::storage code = (typename Format::storage) x;
+		std::stringstream ss;
+		ss << name << ": X = 0x" << std::hex << std::uppercase << x;
+		std::string message = ss.str();
+		ASSERT_TRUE(fp32v_to_fp32b(Format::to_fp32_value(code)) == fp32v_to_fp32b(decode(code)), message);
+		ASSERT_TRUE(Format::to_fp32_bits(code) == decode_bits(code), message);
+	}
+	for (uint64_t w = 0; w <= UINT32_MAX; w += 0x1001) {
+		const float f = fp32b_to_fp32v((uint32_t) w);
+		std::stringstream ss;
+		ss << name << ": F = 0x" << std::hex << std::uppercase << w;
+		std::string message = ss.str();
+		ASSERT_TRUE(Format::from_fp32_value(f) == encode(f), message);
+	}
+}
+
+/* fp8.h quiets NaN payloads in its table, minifloat preserves them like fp16_ieee_to_fp32_bits */
+static uint32_t e5m2_to_fp32_bits(uint8_t x) {
+	return fp16_ieee_to_fp32_bits((uint16_t) (x << 8));
+}
+
+void test_equivalence() {
+	check_equivalence<minifloat_fp16_ieee>("fp16 ieee", fp16_ieee_to_fp32_value, fp16_ieee_to_fp32_bits, fp32_ieee_to_fp16_value);
+	check_equivalence<minifloat_fp16_alt>("fp16 alt", fp16_alt_to_fp32_value, fp16_alt_to_fp32_bits, fp32_alt_to_fp16_value);
+	check_equivalence<minifloat_bf16>("bf16", bf16_to_fp32_value, bf16_to_fp32_bits, fp32_to_bf16_value);
+	check_equivalence<minifloat_fp8_e4m3>("fp8 e4m3", fp8_e4m3_to_fp32_value, fp8_e4m3_to_fp32_bits,
+		[](float f) { return fp32_to_fp8_e4m3_value(f, FP8_NO_SATURATION); });
+	check_equivalence<minifloat_fp8_e5m2>("fp8 e5m2", fp8_e5m2_to_fp32_value, e5m2_to_fp32_bits,
+		[](float f) { return fp32_to_fp8_e5m2_value(f, FP8_NO_SATURATION); });
+}
+
+int main() {
+	printf("Running minifloat conversion tests...\n");
+
+	RUN_TEST(test_fp16_ieee);
+	RUN_TEST(test_fp16_alt);
+	RUN_TEST(test_bf16);
+	RUN_TEST(test_tf32);
+	RUN_TEST(test_fp24);
+	RUN_TEST(test_fp12);
+	RUN_TEST(test_fp8_e4m3);
+	RUN_TEST(test_fp8_e5m2);
+	RUN_TEST(test_e3m4_finite);
+	RUN_TEST(test_equivalence);
+
+	printf("All minifloat conversion tests passed!\n");
+	return 0;
+}
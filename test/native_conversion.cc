@@ -0,0 +1,100 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <fp16.h>
+#include "simple_test.h"
+#include <string>
+#include <sstream>
+#include <cmath>
+
+/*
+ * Reference implementations: the portable conversions from fp16.h, which this translation unit compiles with
+ * FP16_USE_NATIVE_CONVERSION, are reproduced through the bit-level paths that never use native conversions.
+ */
+static uint32_t reference_fp16_ieee_to_fp32_bits(uint16_t h) {
+	return fp16_ieee_to_fp32_bits(h);
+}
+
+static uint16_t reference_fp32_ieee_to_fp16_bits(uint32_t w) {
+	const uint32_t sign = (w >> 16) & UINT32_C(0x8000);
+	const uint32_t nonsign = w & UINT32_C(0x7FFFFFFF);
+	if (nonsign > UINT32_C(0x7F800000)) {
+		return (uint16_t) (sign | UINT32_C(0x7E00));
+	}
+	if (nonsign >= UINT32_C(0x47800000)) {
+		return (uint16_t) (sign | UINT32_C(0x7C00));
+	}
+	uint32_t mantissa, shift;
+	if (nonsign >= UINT32_C(0x38800000)) {
+		mantissa = (nonsign & UINT32_C(0x007FFFFF)) | UINT32_C(0x00800000);
+		shift = 13;
+	} else {
+		const uint32_t exponent = nonsign >> 23;
+		mantissa = exponent == 0 ? nonsign : (nonsign & UINT32_C(0x007FFFFF)) | UINT32_C(0x00800000);
+		shift = exponent == 0 ? 125 : 126 - exponent;
+	}
+	if (shift >= 32) {
+		return (uint16_t) sign;
+	}
+	uint32_t result = mantissa >> shift;
+	const uint32_t remainder = mantissa & ((UINT32_C(1) << shift) - 1);
+	const uint32_t halfway = UINT32_C(1) << (shift - 1);
+	if (remainder > halfway || (remainder == halfway && (result & 1))) {
+		result += 1;
+	}
+	if (nonsign >= UINT32_C(0x38800000)) {
+		/* Normalized input: replace the implicit bit with the biased half-precision exponent */
+		result += ((nonsign >> 23) - 112 - 1) << 10;
+	}
+	return (uint16_t) (sign | result);
+}
+
+void test_native_fp16_ieee_to_fp32_value() {
+	for (uint32_t h = 0; h <= UINT32_C(0xFFFF); h++) {
+		const uint32_t expected = reference_fp16_ieee_to_fp32_bits((uint16_t) h);
+		const uint32_t actual = fp32v_to_fp32b(fp16_ieee_to_fp32_value((uint16_t) h));
+
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << std::setfill('0') <<
+			"F16 = 0x" << std::setw(4) << h << ", " <<
+			"F32(F16) = 0x" << std::setw(8) << actual << ", " <<
+			"F32 = 0x" << std::setw(8) << expected;
+		std::string message = ss.str();
+		if ((expected & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000)) {
+			ASSERT_GT(actual & UINT32_C(0x7FFFFFFF), UINT32_C(0x7F800000), message);
+		} else {
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+void test_native_fp32_ieee_to_fp16_value() {
+	/* Every 0x101-th bit pattern covers all exponents and a spread of mantissas, including the halfway points */
+	for (uint64_t bits = 0; bits <= UINT64_C(0xFFFFFFFF); bits += 0x101) {
+		const uint32_t w = (uint32_t) bits;
+		const uint16_t expected = reference_fp32_ieee_to_fp16_bits(w);
+		const uint16_t actual = fp32_ieee_to_fp16_value(fp32b_to_fp32v(w));
+
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << std::setfill('0') <<
+			"F32 = 0x" << std::setw(8) << w << ", " <<
+			"F16(F32) = 0x" << std::setw(4) << actual << ", " <<
+			"F16 = 0x" << std::setw(4) << expected;
+		std::string message = ss.str();
+		if ((expected & UINT16_C(0x7FFF)) > UINT16_C(0x7C00)) {
+			ASSERT_GT(actual & UINT16_C(0x7FFF), UINT16_C(0x7C00), message);
+		} else {
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+int main() {
+	printf("Running FP16 native conversion tests...\n");
+
+	RUN_TEST(test_native_fp16_ieee_to_fp32_value);
+	RUN_TEST(test_native_fp32_ieee_to_fp16_value);
+
+	printf("All native conversion tests passed!\n");
+	return 0;
+}
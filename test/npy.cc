@@ -0,0 +1,400 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fp16.h>
+#include <fp16/npy.h>
+#include "simple_test.h"
+#include "temp_file.h"
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <vector>
+
+/* A .npy file with a hand-written header dictionary, as other writers produce them */
+static std::string make_npy(const std::string& dictionary, int major, size_t data_bytes) {
+	std::string result("\x93NUMPY", 6);
+	result += (char) major;
+	result += (char) 0;
+	const size_t length = dictionary.size();
+	result += (char) (length & 0xFF);
+	result += (char) (length >> 8);
+	if (major >= 2) {
+		result += (char) 0;
+		result += (char) 0;
+	}
+	result += dictionary;
+	result.append(data_bytes, '\x01');
+	return result;
+}
+
+static std::vector<uint16_t> make_fp16(size_t n) {
+	std::vector<uint16_t> data(n);
+	for (size_t i = 0; i < n; i++) {
+		data[i] = (uint16_t) (i * 40503);
+	}
+	return data;
+}
+
+static std::vector<float> make_fp32(size_t n) {
+	std::vector<float> data(n);
+	for (size_t i = 0; i < n; i++) {
+		data[i] = ((float) i - (float) n / 2.0f) / 64.0f;
+	}
+	return data;
+}
+
+static bool same_fp32(float a, float b) {
+	return a == b || (a != a && b != b);
+}
+
+void test_header() {
+	const std::vector<size_t> shapes[] = { {}, { 5 }, { 3, 4 }, { 2, 3, 4 }, { 0 } };
+	const fp16::npy_dtype dtypes[] = { fp16::npy_dtype::float16, fp16::npy_dtype::float32 };
+	for (const std::vector<size_t>& shape : shapes) {
+		for (fp16::npy_dtype dtype : dtypes) {
+			for (int fortran_order = 0; fortran_order < 2; fortran_order++) {
+				const std::string header = fp16::npy_format_header(dtype, shape, fortran_order != 0);
+				std::string message = "header size is a multiple of 64";
+				ASSERT_EQ(0, header.size() % 64, message);
+				message = "header ends with a newline";
+				ASSERT_TRUE(header[header.size() - 1] == '\n', message);
+				const fp16::npy_header parsed = fp16::npy_parse_header(header.data(), header.size());
+				message = "parsed dtype";
+				ASSERT_TRUE(parsed.dtype == dtype, message);
+				message = "parsed order";
+				ASSERT_EQ(fortran_order, parsed.fortran_order, message);
+				message = "parsed shape";
+				ASSERT_TRUE(parsed.shape == shape, message);
+				message = "data offset";
+				ASSERT_EQ(header.size(), parsed.data_offset, message);
+			}
+		}
+	}
+	std::string message = "numpy spelling of a 1-D shape";
+	ASSERT_TRUE(fp16::npy_format_header(fp16::npy_dtype::float16, { 5 }).find("'shape': (5,), }") != std::string::npos, message);
+	message = "numpy spelling of a 2-D shape";
+	ASSERT_TRUE(fp16::npy_format_header(fp16::npy_dtype::float32, { 3, 4 }).find("{'descr': '<f4', 'fortran_order': False, 'shape': (3, 4), }") != std::string::npos, message);
+
+	/* Headers of other writers: double quotes, Python 2 long integers, version 2, other key order */
+	const std::string variants[] = {
+		make_npy("{\"descr\": \"<f2\", \"fortran_order\": True, \"shape\": (3L, 4L)}\n", 1, 0),
+		make_npy("{'shape': (3,4),'fortran_order':True,'descr':'<f2'}\n", 2, 0),
+		make_npy("{'descr': '<f2', 'fortran_order': True, 'shape': ( 3 , 4 , ), }   \n", 3, 0),
+	};
+	for (const std::string& variant : variants) {
+		const fp16::npy_header parsed = fp16::npy_parse_header(variant.data(), variant.size());
+		message = "header variant: " + variant.substr(10);
+		ASSERT_TRUE(parsed.dtype == fp16::npy_dtype::float16 && parsed.fortran_order &&
+			parsed.shape == std::vector<size_t>({ 3, 4 }) && parsed.data_offset == variant.size(), message);
+	}
+
+	/* Unsupported and malformed headers */
+	const std::string invalid[] = {
+		make_npy("{'descr': '>f2', 'fortran_order': False, 'shape': (3,), }\n", 1, 0),
+		make_npy("{'descr': '<f8', 'fortran_order': False, 'shape': (3,), }\n", 1, 0),
+		make_npy("{'descr': '<f2', 'fortran_order': False, }\n", 1, 0),
+		make_npy("{'descr': '<f2', 'fortran_order': Maybe, 'shape': (3,), }\n", 1, 0),
+		make_npy("{'descr': '<f2', 'fortran_order': False, 'shape': (3, x), }\n", 1, 0),
+		make_npy("{'descr': '<f2', 'fortran_order': False, 'shape': (3,), }\n", 4, 0),
+		make_npy("{'descr': '<f2', 'fortran_order': False, 'shape': (3,), }\n", 1, 0).substr(0, 40),
+		std::string("\x93NUMPZ\x01\x00\x00\x00", 10),
+	};
+	for (const std::string& bytes : invalid) {
+		bool thrown = false;
+		try {
+			fp16::npy_parse_header(bytes.data(), bytes.size());
+		} catch (const std::runtime_error&) {
+			thrown = true;
+		}
+		message = "invalid header: " + bytes.substr(std::min<size_t>(10, bytes.size()));
+		ASSERT_TRUE(thrown, message);
+	}
+}
+
+void test_npy_files() {
+	const std::string path = temp_path("array.npy");
+	const std::vector<size_t> shape = { 10, 101 };
+	const size_t n = 1010;
+
+	/* float16 data, stored as float16 */
+	const std::vector<uint16_t> fp16_data = make_fp16(n);
+	fp16::npy_save(path.c_str(), fp16_data.data(), shape);
+	{
+		fp16::npy_file file(path.c_str());
+		const fp16::npy_array& array = file.array();
+		std::string message = "float16 dtype";
+		ASSERT_TRUE(array.dtype() == fp16::npy_dtype::float16, message);
+		message = "shape";
+		ASSERT_TRUE(array.shape() == shape, message);
+		message = "elements";
+		ASSERT_EQ(n, array.size(), message);
+		message = "data aligned to 64 bytes in the mapping";
+		ASSERT_EQ(0, (uintptr_t) array.data() % 64, message);
+		message = "zero-copy view";
+		ASSERT_TRUE(memcmp(array.fp16_data(), fp16_data.data(), n * sizeof(uint16_t)) == 0, message);
+
+		/* Lazy view, slice and whole decode agree with the scalar conversion */
+		const fp16::fp32_range view = array.fp32();
+		std::vector<float> slice(300);
+		array.decode(500, 300, slice.data());
+		const std::vector<float> whole = array.to_fp32();
+		size_t i = 0, mismatches = 0;
+		for (float value : view) {
+			const float expected = fp16_ieee_to_fp32_value(fp16_data[i]);
+			if (!same_fp32(expected, value) || !same_fp32(expected, whole[i]) ||
+				(i >= 500 && i < 800 && !same_fp32(expected, slice[i - 500])))
+			{
+				mismatches++;
+			}
+			i++;
+		}
+		message = "decoded values";
+		ASSERT_EQ(0, mismatches, message);
+		message = "lazy view length";
+		ASSERT_EQ(n, i, message);
+
+		array.advise(fp16::npy_advice::willneed, 100, 200);
+		array.advise(fp16::npy_advice::random);
+		bool thrown = false;
+		try {
+			array.decode(1000, 11, slice.data());
+		} catch (const std::out_of_range&) {
+			thrown = true;
+		}
+		message = "decode past the end";
+		ASSERT_TRUE(thrown, message);
+		thrown = false;
+		try {
+			array.fp32_data();
+		} catch (const std::logic_error&) {
+			thrown = true;
+		}
+		message = "float32 view of a float16 array";
+		ASSERT_TRUE(thrown, message);
+	}
+
+	/* float32 data, encoded to float16 while written, and float16 data widened to float32 */
+	const std::vector<float> fp32_data = make_fp32(n);
+	fp16::npy_save(path.c_str(), fp32_data.data(), shape, fp16::npy_dtype::float16);
+	{
+		fp16::npy_file file(path.c_str());
+		size_t mismatches = 0;
+		for (size_t i = 0; i < n; i++) {
+			mismatches += file.array().fp16_data()[i] != fp32_ieee_to_fp16_value(fp32_data[i]);
+		}
+		std::string message = "float32 data encoded to float16";
+		ASSERT_EQ(0, mismatches, message);
+	}
+	fp16::npy_save(path.c_str(), fp16_data.data(), shape, fp16::npy_dtype::float32);
+	{
+		fp16::npy_file file(path.c_str(), fp16::npy_advice::random);
+		const fp16::npy_array& array = file.array();
+		std::string message = "float32 dtype";
+		ASSERT_TRUE(array.dtype() == fp16::npy_dtype::float32, message);
+		size_t mismatches = 0;
+		std::vector<float> slice(10);
+		array.decode(1000, 10, slice.data());
+		for (size_t i = 0; i < n; i++) {
+			const float expected = fp16_ieee_to_fp32_value(fp16_data[i]);
+			mismatches += !same_fp32(expected, array.fp32_data()[i]) || (i >= 1000 && !same_fp32(expected, slice[i - 1000]));
+		}
+		message = "float16 data widened to float32";
+		ASSERT_EQ(0, mismatches, message);
+	}
+
+	/* Files with missing data are rejected */
+	write_bytes(path, make_npy("{'descr': '<f4', 'fortran_order': False, 'shape': (3,), }\n", 1, 11));
+	bool thrown = false;
+	try {
+		fp16::npy_file file(path.c_str());
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	std::string message = "truncated data";
+	ASSERT_TRUE(thrown, message);
+	remove(path.c_str());
+
+	int error = 0;
+	try {
+		fp16::npy_file file(path.c_str());
+	} catch (const std::system_error& e) {
+		error = e.code().value();
+	}
+	message = "missing file throws ENOENT";
+	ASSERT_EQ(ENOENT, error, message);
+}
+
+void test_crc32() {
+	std::string message = "CRC-32 check value";
+	ASSERT_EQ(0xCBF43926u, fp16::npy_crc32(0, "123456789", 9), message);
+	/* Slicing by 8 agrees with byte-wise updates, at every split point */
+	const std::vector<uint16_t> data = make_fp16(100);
+	const uint32_t whole = fp16::npy_crc32(0, data.data(), 200);
+	for (size_t split = 0; split <= 200; split++) {
+		const uint32_t parts = fp16::npy_crc32(fp16::npy_crc32(0, data.data(), split), (const unsigned char*) data.data() + split, 200 - split);
+		message = "CRC-32 split at " + std::to_string(split);
+		ASSERT_EQ(whole, parts, message);
+	}
+}
+
+void test_npz_files() {
+	const std::string path = temp_path("arrays.npz");
+	const std::vector<uint16_t> a = make_fp16(1000);
+	const std::vector<float> b = make_fp32(77);
+	{
+		fp16::npz_writer writer(path.c_str());
+		writer.add("a", a.data(), { 10, 100 });
+		writer.add("b", b.data(), { 7, 11 });
+		writer.add("b16", b.data(), { 77 }, fp16::npy_dtype::float16);
+		writer.add("scalar", a.data(), {});
+		writer.add("empty", b.data(), { 0, 3 });
+		writer.close();
+	}
+	fp16::npz_file file(path.c_str());
+	std::string message = "member count";
+	ASSERT_EQ(5, file.size(), message);
+	const char* names[] = { "a", "b", "b16", "scalar", "empty" };
+	for (size_t i = 0; i < 5; i++) {
+		message = std::string("member name ") + names[i];
+		ASSERT_TRUE(file.names()[i] == names[i] && file.contains(names[i]), message);
+		message = std::string("member data aligned to 64 bytes: ") + names[i];
+		ASSERT_EQ(0, (uintptr_t) file[names[i]].data() % 64, message);
+	}
+	message = "float16 member";
+	ASSERT_TRUE(file["a"].shape() == std::vector<size_t>({ 10, 100 }) &&
+		memcmp(file["a"].fp16_data(), a.data(), a.size() * sizeof(uint16_t)) == 0, message);
+	message = "float32 member";
+	ASSERT_TRUE(file["b"].dtype() == fp16::npy_dtype::float32 &&
+		memcmp(file["b"].fp32_data(), b.data(), b.size() * sizeof(float)) == 0, message);
+	size_t mismatches = 0;
+	for (size_t i = 0; i < b.size(); i++) {
+		mismatches += file["b16"].fp16_data()[i] != fp32_ieee_to_fp16_value(b[i]);
+	}
+	message = "float32 data encoded to a float16 member";
+	ASSERT_EQ(0, mismatches, message);
+	message = "scalar member";
+	ASSERT_TRUE(file["scalar"].size() == 1 && file["scalar"].fp16_data()[0] == a[0], message);
+	message = "empty member";
+	ASSERT_EQ(0, file["empty"].size(), message);
+	message = "missing member";
+	ASSERT_TRUE(!file.contains("c"), message);
+	bool thrown = false;
+	try {
+		file["c"];
+	} catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	ASSERT_TRUE(thrown, message);
+
+	remove(path.c_str());
+}
+
+void test_zip64() {
+	/* More than 65535 members need the Zip64 end of central directory record */
+	const std::string path = temp_path("many.npz");
+	const size_t members = 70000;
+	const std::vector<uint16_t> values = make_fp16(members);
+	{
+		fp16::npz_writer writer(path.c_str());
+		for (size_t i = 0; i < members; i++) {
+			writer.add("x" + std::to_string(i), &values[i], {});
+		}
+		writer.close();
+	}
+	fp16::npz_file file(path.c_str());
+	remove(path.c_str());
+	std::string message = "Zip64 member count";
+	ASSERT_EQ(members, file.size(), message);
+	size_t mismatches = 0;
+	for (size_t i = 0; i < members; i += 997) {
+		mismatches += file["x" + std::to_string(i)].fp16_data()[0] != values[i];
+	}
+	message = "Zip64 members";
+	ASSERT_EQ(0, mismatches, message);
+}
+
+/* An archive of other writers: no alignment padding, a name without .npy and a deflated member */
+static std::string make_zip(const std::vector<std::pair<std::string, std::string>>& members, const std::vector<int>& methods) {
+	std::string zip, directory;
+	for (size_t i = 0; i < members.size(); i++) {
+		const std::string& name = members[i].first;
+		const std::string& data = members[i].second;
+		unsigned char local[30] = { 0 };
+		fp16::npy_store_le32(local, 0x04034B50);
+		fp16::npy_store_le16(local + 4, 20);
+		fp16::npy_store_le16(local + 8, (uint16_t) methods[i]);
+		fp16::npy_store_le32(local + 14, fp16::npy_crc32(0, data.data(), data.size()));
+		fp16::npy_store_le32(local + 18, (uint32_t) data.size());
+		fp16::npy_store_le32(local + 22, (uint32_t) data.size());
+		fp16::npy_store_le16(local + 26, (uint16_t) name.size());
+		unsigned char central[46] = { 0 };
+		fp16::npy_store_le32(central, 0x02014B50);
+		fp16::npy_store_le16(central + 4, 20);
+		fp16::npy_store_le16(central + 6, 20);
+		fp16::npy_store_le16(central + 10, (uint16_t) methods[i]);
+		memcpy(central + 16, local + 14, 12);
+		fp16::npy_store_le16(central + 28, (uint16_t) name.size());
+		fp16::npy_store_le32(central + 42, (uint32_t) zip.size());
+		zip.append((const char*) local, 30);
+		zip += name + data;
+		directory.append((const char*) central, 46);
+		directory += name;
+	}
+	unsigned char end[22] = { 0 };
+	fp16::npy_store_le32(end, 0x06054B50);
+	fp16::npy_store_le16(end + 8, (uint16_t) members.size());
+	fp16::npy_store_le16(end + 10, (uint16_t) members.size());
+	fp16::npy_store_le32(end + 12, (uint32_t) directory.size());
+	fp16::npy_store_le32(end + 16, (uint32_t) zip.size());
+	return zip + directory + std::string((const char*) end, 22);
+}
+
+void test_foreign_npz() {
+	const std::string path = temp_path("foreign.npz");
+	std::string npy = fp16::npy_format_header(fp16::npy_dtype::float16, { 3 });
+	npy.append("\x00\x3C\x00\x40\x00\x42", 6);
+	write_bytes(path, make_zip({ { "ones.npy", npy }, { "raw", npy }, { "packed.npy", "xyz" } }, { 0, 0, 8 }));
+	fp16::npz_file file(path.c_str());
+	remove(path.c_str());
+	std::string message = "foreign member names";
+	ASSERT_TRUE(file.size() == 3 && file.contains("ones") && file.contains("raw") && file.contains("packed"), message);
+	const fp16::npy_array ones = file["ones"];
+	message = "foreign member values";
+	ASSERT_TRUE(ones.size() == 3 && ones.fp32()[0] == 1.0f && ones.fp32()[1] == 2.0f && ones.fp32()[2] == 3.0f, message);
+	bool thrown = false;
+	try {
+		file["packed"];
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	message = "compressed member";
+	ASSERT_TRUE(thrown, message);
+
+	write_bytes(path, "PK not really a zip archive");
+	thrown = false;
+	try {
+		fp16::npz_file bad(path.c_str());
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	remove(path.c_str());
+	message = "not an archive";
+	ASSERT_TRUE(thrown, message);
+}
+
+int main() {
+	printf("Running NPY tests...\n");
+
+	RUN_TEST(test_header);
+	RUN_TEST(test_npy_files);
+	RUN_TEST(test_crc32);
+	RUN_TEST(test_npz_files);
+	RUN_TEST(test_zip64);
+	RUN_TEST(test_foreign_npz);
+
+	printf("All NPY tests passed!\n");
+	return 0;
+}
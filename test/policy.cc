@@ -0,0 +1,206 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/policy.h>
+#include "simple_test.h"
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+
+static const unsigned kFlags[] = {
+	0,
+	FP16_ENCODE_SATURATE,
+	FP16_ENCODE_NAN_TO_VALUE,
+	FP16_ENCODE_FLUSH_DENORMALS,
+	FP16_ENCODE_SATURATE | FP16_ENCODE_NAN_TO_VALUE,
+	FP16_ENCODE_SATURATE | FP16_ENCODE_FLUSH_DENORMALS,
+	FP16_ENCODE_NAN_TO_VALUE | FP16_ENCODE_FLUSH_DENORMALS,
+	FP16_ENCODE_SATURATE | FP16_ENCODE_NAN_TO_VALUE | FP16_ENCODE_FLUSH_DENORMALS,
+};
+
+static const uint16_t kNanValues[] = { UINT16_C(0x0000), UINT16_C(0xBC00), UINT16_C(0x7E00) };
+
+/*
+ * Inputs covering every half-precision range: denormals and values that round into them, normals, overflow,
+ * infinities, and NaN with different payloads.
+ */
+static std::vector<float> generate_fp32_data(size_t n, uint32_t seed) {
+	static const uint32_t specials[] = {
+		UINT32_C(0x00000000), UINT32_C(0x80000000), UINT32_C(0x33000000), UINT32_C(0x33000001), UINT32_C(0xB3000001),
+		UINT32_C(0x387FC000), UINT32_C(0x387FE000), UINT32_C(0xB87FF000), UINT32_C(0x38800000), UINT32_C(0x477FE000),
+		UINT32_C(0x477FEFFF), UINT32_C(0x477FF000), UINT32_C(0xC77FF000), UINT32_C(0x47800000), UINT32_C(0x7F7FFFFF),
+		UINT32_C(0x7F800000), UINT32_C(0xFF800000), UINT32_C(0x7FC00000), UINT32_C(0xFFC00000), UINT32_C(0x7F800001),
+		UINT32_C(0xFFFFFFFF),
+	};
+	const size_t special_count = sizeof(specials) / sizeof(specials[0]);
+
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> bits;
+	std::vector<float> fp32(n);
+	for (size_t i = 0; i < n; i++) {
+		const uint32_t w = bits(rng);
+		if (w % 4 == 0) {
+			fp32[i] = fp32b_to_fp32v(specials[(w >> 2) % special_count]);
+		} else {
+			/* Exponents from 2**-40 to 2**20 */
+			const uint32_t exponent = 87 + (w >> 8) % 61;
+			fp32[i] = fp32b_to_fp32v((w & UINT32_C(0x807FFFFF)) | (exponent << 23));
+		}
+	}
+	return fp32;
+}
+
+/*
+ * Reference: the default conversion followed by the policies, one after another.
+ */
+static uint16_t reference(float f, bool alt, unsigned flags, uint16_t nan_value) {
+	uint16_t h = alt ? fp32_alt_to_fp16_value(f) : fp32_ieee_to_fp16_value(f);
+	if (std::isnan(f)) {
+		return (flags & FP16_ENCODE_NAN_TO_VALUE) ? nan_value : h;
+	}
+	if ((flags & FP16_ENCODE_SATURATE) && !alt && (h & 0x7FFF) == 0x7C00) {
+		h = (h & 0x8000) | 0x7BFF;
+	}
+	if ((flags & FP16_ENCODE_FLUSH_DENORMALS) && (h & 0x7C00) == 0) {
+		h &= 0x8000;
+	}
+	return h;
+}
+
+static bool is_ieee_nan(uint16_t h) {
+	return (h & 0x7FFF) > 0x7C00;
+}
+
+static void check_value(float16 (*convert)(float, unsigned, float16), bool alt, const std::string& name) {
+	const std::vector<float> input = generate_fp32_data(100000, 1);
+	for (unsigned flags : kFlags) {
+		for (uint16_t nan_value : kNanValues) {
+			for (size_t i = 0; i < input.size(); i++) {
+				const uint16_t expected = reference(input[i], alt, flags, nan_value);
+				const uint16_t actual = convert(input[i], flags, nan_value);
+				std::stringstream ss;
+				ss << name << std::hex << std::uppercase << std::setfill('0') <<
+					": flags = " << flags << ", NaN value = 0x" << std::setw(4) << nan_value <<
+					", F32 = 0x" << std::setw(8) << fp32v_to_fp32b(input[i]) <<
+					", actual = 0x" << std::setw(4) << actual << ", expected = 0x" << std::setw(4) << expected;
+				std::string message = ss.str();
+				ASSERT_EQ(expected, actual, message);
+			}
+		}
+	}
+}
+
+void test_fp32_ieee_to_fp16_value_policy() {
+	check_value(fp32_ieee_to_fp16_value_policy, false, "fp32_ieee_to_fp16_value_policy");
+}
+
+void test_fp32_alt_to_fp16_value_policy() {
+	check_value(fp32_alt_to_fp16_value_policy, true, "fp32_alt_to_fp16_value_policy");
+}
+
+/*
+ * Saturation keeps every result finite, and NaN sanitization with a finite value leaves no NaN.
+ */
+void test_finite_results() {
+	const std::vector<float> input = generate_fp32_data(100000, 2);
+	std::vector<uint16_t> output(input.size());
+	fp32_ieee_to_fp16_array_policy(input.data(), output.data(), input.size(),
+		FP16_ENCODE_SATURATE | FP16_ENCODE_NAN_TO_VALUE, 0);
+	for (size_t i = 0; i < input.size(); i++) {
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << std::setfill('0') <<
+			"F32 = 0x" << std::setw(8) << fp32v_to_fp32b(input[i]) << ", F16 = 0x" << std::setw(4) << output[i];
+		std::string message = ss.str();
+		ASSERT_TRUE((output[i] & 0x7C00) != 0x7C00, message);
+		if (std::isnan(input[i])) {
+			ASSERT_EQ(UINT16_C(0x0000), output[i], message);
+		} else if (std::fabs(input[i]) >= 65520.0f) {
+			ASSERT_EQ(std::signbit(input[i]) ? UINT16_C(0xFBFF) : UINT16_C(0x7BFF), output[i], message);
+		}
+	}
+}
+
+/*
+ * In the ARM alternative format 0x7C00 and above are finite numbers, which saturation leaves alone.
+ */
+void test_alt_saturate() {
+	const float input[] = { 65536.0f, 131008.0f, -65536.0f, -131008.0f, 1e10f };
+	const uint16_t expected[] = { 0x7C00, 0x7FFF, 0xFC00, 0xFFFF, 0x7FFF };
+	uint16_t output[5];
+	fp32_alt_to_fp16_array_policy(input, output, 5, FP16_ENCODE_SATURATE, 0);
+	for (size_t i = 0; i < 5; i++) {
+		std::stringstream ss;
+		ss << "F32 = " << input[i];
+		std::string message = ss.str() + ", scalar";
+		ASSERT_EQ(expected[i], fp32_alt_to_fp16_value_policy(input[i], FP16_ENCODE_SATURATE, 0), message);
+		message = ss.str() + ", array";
+		ASSERT_EQ(expected[i], output[i], message);
+	}
+}
+
+/*
+ * Array results must equal the scalar results for every length, with no element written past the end. Without
+ * NaN sanitization only the NaN-ness of IEEE results is compared, because NaN payloads depend on the hardware path.
+ */
+static void check_array(void (*convert_array)(const float*, float16*, size_t, unsigned, float16),
+	float16 (*convert)(float, unsigned, float16), bool alt, const std::string& name, size_t n)
+{
+	const std::vector<float> input = generate_fp32_data(n, (uint32_t) n);
+	for (unsigned flags : kFlags) {
+		for (uint16_t nan_value : kNanValues) {
+			std::vector<uint16_t> output(n + 1, UINT16_C(0xDEAD));
+			convert_array(input.data(), output.data(), n, flags, nan_value);
+			for (size_t i = 0; i < n; i++) {
+				const uint16_t expected = convert(input[i], flags, nan_value);
+				std::stringstream ss;
+				ss << name << ": N = " << n << ", I = " << i <<
+					std::hex << std::uppercase << std::setfill('0') << ", flags = " << flags <<
+					", F32 = 0x" << std::setw(8) << fp32v_to_fp32b(input[i]) <<
+					", actual = 0x" << std::setw(4) << output[i] << ", expected = 0x" << std::setw(4) << expected;
+				std::string message = ss.str();
+				if (!alt && !(flags & FP16_ENCODE_NAN_TO_VALUE) && is_ieee_nan(expected)) {
+					ASSERT_TRUE(is_ieee_nan(output[i]), message);
+				} else {
+					ASSERT_EQ(expected, output[i], message);
+				}
+			}
+			const std::string guard_message = name + ": guard element overwritten";
+			ASSERT_EQ(UINT16_C(0xDEAD), output[n], guard_message);
+		}
+	}
+}
+
+void test_fp32_ieee_to_fp16_array_policy() {
+	for (size_t n = 0; n <= 40; n++) {
+		check_array(fp32_ieee_to_fp16_array_policy, fp32_ieee_to_fp16_value_policy, false,
+			"fp32_ieee_to_fp16_array_policy", n);
+	}
+	check_array(fp32_ieee_to_fp16_array_policy, fp32_ieee_to_fp16_value_policy, false,
+		"fp32_ieee_to_fp16_array_policy", 10007);
+}
+
+void test_fp32_alt_to_fp16_array_policy() {
+	for (size_t n = 0; n <= 40; n++) {
+		check_array(fp32_alt_to_fp16_array_policy, fp32_alt_to_fp16_value_policy, true,
+			"fp32_alt_to_fp16_array_policy", n);
+	}
+	check_array(fp32_alt_to_fp16_array_policy, fp32_alt_to_fp16_value_policy, true,
+		"fp32_alt_to_fp16_array_policy", 10007);
+}
+
+int main() {
+	printf("Running FP16 encode policy tests...\n");
+
+	RUN_TEST(test_fp32_ieee_to_fp16_value_policy);
+	RUN_TEST(test_fp32_alt_to_fp16_value_policy);
+	RUN_TEST(test_finite_results);
+	RUN_TEST(test_alt_saturate);
+	RUN_TEST(test_fp32_ieee_to_fp16_array_policy);
+	RUN_TEST(test_fp32_alt_to_fp16_array_policy);
+
+	printf("All encode policy tests passed!\n");
+	return 0;
+}
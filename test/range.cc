@@ -0,0 +1,190 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/range.h>
+#include <fp16/half.h>
+#include "simple_test.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <string>
+#include <sstream>
+#include <vector>
+
+#if defined(__cpp_lib_ranges)
+static_assert(std::ranges::forward_range<fp16::fp32_range>, "forward range");
+static_assert(std::ranges::view<fp16::fp32_range>, "view");
+static_assert(std::ranges::borrowed_range<fp16::fp32_range>, "borrowed range");
+static_assert(std::ranges::sized_range<fp16::fp32_range>, "sized range");
+static_assert(std::output_iterator<fp16::fp16_output_iterator, float>, "output iterator");
+#endif
+
+/*
+ * The F16C kernels keep NaN payloads where the scalar conversions do not, so any NaN matches a NaN.
+ */
+static bool same_fp32(float actual, float expected) {
+	return fp32v_to_fp32b(actual) == fp32v_to_fp32b(expected) || (std::isnan(actual) && std::isnan(expected));
+}
+
+static std::vector<uint16_t> make_input(size_t n) {
+	std::vector<uint16_t> input(n);
+	for (size_t i = 0; i < n; i++) {
+		input[i] = (uint16_t) (i * 40503);
+	}
+	return input;
+}
+
+static std::vector<size_t> lengths() {
+	std::vector<size_t> result;
+	for (size_t n = 0; n <= 40; n++) {
+		result.push_back(n);
+	}
+	result.push_back(65536);
+	return result;
+}
+
+void test_iteration() {
+	for (size_t n : lengths()) {
+		const std::vector<uint16_t> input = make_input(n);
+		const fp16::fp32_range view = fp16::as_fp32(input);
+		std::string message = "size";
+		ASSERT_EQ(n, view.size(), message);
+		size_t i = 0;
+		for (float f : view) {
+			std::stringstream ss;
+			ss << "range-for: N = " << n << ", I = " << i << std::hex << std::uppercase << ", F16 = 0x" << input[i];
+			message = ss.str();
+			ASSERT_TRUE(same_fp32(f, fp16_ieee_to_fp32_value(input[i])), message);
+			i++;
+		}
+		message = "range-for: element count";
+		ASSERT_EQ(n, i, message);
+
+		/* Copies of an iterator decode on their own, and iterators compare by position */
+		const std::vector<float> copy(view.begin(), view.end());
+		fp16::fp32_range::iterator it = view.begin();
+		for (i = 0; i < n; i++) {
+			fp16::fp32_range::iterator saved = it++;
+			std::stringstream ss;
+			ss << "copy: N = " << n << ", I = " << i;
+			message = ss.str();
+			ASSERT_TRUE(same_fp32(copy[i], fp16_ieee_to_fp32_value(input[i])) && same_fp32(*saved, copy[i]), message);
+			ASSERT_TRUE(saved != it && saved.position() == i, message);
+		}
+		message = "end";
+		ASSERT_TRUE(it == view.end(), message);
+	}
+}
+
+void test_algorithms() {
+	const std::array<uint16_t, 5> input = {{ UINT16_C(0x3C00), UINT16_C(0x4000), UINT16_C(0xC200), UINT16_C(0x3800), UINT16_C(0x0000) }};
+	const fp16::fp32_range view = fp16::as_fp32(input);
+	std::string message = "accumulate";
+	ASSERT_EQ(0.5f, std::accumulate(view.begin(), view.end(), 0.0f), message);
+	message = "max_element";
+	ASSERT_EQ(1u, (unsigned) (std::max_element(view.begin(), view.end()).position()), message);
+	message = "count_if";
+	ASSERT_EQ(3, (int) std::count_if(view.begin(), view.end(), [](float f) { return f > 0.0f; }), message);
+	message = "operator[]";
+	ASSERT_EQ(-3.0f, view[2], message);
+
+	/* Every number times 2, encoded through the output iterator */
+	const std::vector<uint16_t> all = make_input(65536);
+	std::vector<uint16_t> output(all.size() + 1, UINT16_C(0xDEAD));
+	const fp16::fp16_output_iterator last = std::transform(fp16::as_fp32(all).begin(), fp16::as_fp32(all).end(),
+		fp16::fp16_encoder(output.data()), [](float f) { return f * 2.0f; });
+	message = "transform: end of output";
+	ASSERT_TRUE(last.base() == output.data() + all.size(), message);
+	for (size_t i = 0; i < all.size(); i++) {
+		const float f = fp16_ieee_to_fp32_value(all[i]) * 2.0f;
+		std::stringstream ss;
+		ss << "transform: I = " << i << std::hex << std::uppercase << ", F16 = 0x" << all[i] << ", actual = 0x" << output[i];
+		message = ss.str();
+		ASSERT_TRUE(same_fp32(fp16_ieee_to_fp32_value(output[i]), fp16_ieee_to_fp32_value(fp32_ieee_to_fp16_value(f))), message);
+	}
+	message = "transform: guard element overwritten";
+	ASSERT_EQ(UINT16_C(0xDEAD), output[all.size()], message);
+
+	/* The buffered writer, with the last chunk written by flush() or the destructor */
+	for (size_t n : lengths()) {
+		std::vector<uint16_t> flushed(n + 1, UINT16_C(0xDEAD));
+		std::vector<uint16_t> destroyed(n + 1, UINT16_C(0xDEAD));
+		{
+			fp16::fp16_writer writer(flushed.data());
+			std::copy(fp16::as_fp32(all.data(), n).begin(), fp16::as_fp32(all.data(), n).end(), writer.begin());
+			writer.flush();
+			message = "fp16_writer: base after flush";
+			ASSERT_TRUE(writer.base() == flushed.data() + n, message);
+			fp16::fp16_writer scoped(destroyed.data());
+			std::copy(fp16::as_fp32(all.data(), n).begin(), fp16::as_fp32(all.data(), n).end(), scoped.begin());
+		}
+		for (size_t i = 0; i < n; i++) {
+			std::stringstream ss;
+			ss << "fp16_writer: N = " << n << ", I = " << i << std::hex << std::uppercase << ", F16 = 0x" << all[i] <<
+				", flushed = 0x" << flushed[i] << ", destroyed = 0x" << destroyed[i];
+			message = ss.str();
+			const float f = fp16_ieee_to_fp32_value(all[i]);
+			ASSERT_TRUE(same_fp32(fp16_ieee_to_fp32_value(flushed[i]), f), message);
+			ASSERT_TRUE(same_fp32(fp16_ieee_to_fp32_value(destroyed[i]), f), message);
+		}
+		message = "fp16_writer: guard element overwritten";
+		ASSERT_TRUE(flushed[n] == UINT16_C(0xDEAD) && destroyed[n] == UINT16_C(0xDEAD), message);
+	}
+
+	/* Doubles round once, integers and fp16::half are exact */
+	std::vector<uint16_t> encoded(4);
+	fp16::fp16_output_iterator out = fp16::fp16_encoder(encoded.data());
+	*out++ = 0.1;
+	*out++ = 2049;
+	*out++ = fp16::half(-0.5f);
+	*out++ = 1.0f + 1.0f / 2048.0f + 1.0f / 1048576.0f;
+	message = "double";
+	ASSERT_EQ(fp64_ieee_to_fp16_value(0.1), encoded[0], message);
+	message = "int";
+	ASSERT_EQ(UINT16_C(0x6800), encoded[1], message);
+	message = "half";
+	ASSERT_EQ(UINT16_C(0xB800), encoded[2], message);
+	message = "float";
+	ASSERT_EQ(UINT16_C(0x3C01), encoded[3], message);
+}
+
+#if defined(__cpp_lib_ranges)
+void test_ranges() {
+	const std::vector<uint16_t> input = make_input(1000);
+	std::vector<float> expected;
+	for (uint16_t h : input) {
+		const float f = fp16_ieee_to_fp32_value(h);
+		if (f > 1.0f) {
+			expected.push_back(f);
+		}
+	}
+	std::vector<float> actual;
+	std::ranges::copy(fp16::as_fp32(input) | std::views::filter([](float f) { return f > 1.0f; }),
+		std::back_inserter(actual));
+	std::string message = "filter: size";
+	ASSERT_EQ(expected.size(), actual.size(), message);
+	message = "filter: elements";
+	ASSERT_TRUE(std::ranges::equal(expected, actual), message);
+
+	std::vector<uint16_t> output(10);
+	std::ranges::copy(fp16::as_fp32(input) | std::views::drop(100) | std::views::take(10), fp16::fp16_encoder(output.data()));
+	message = "drop | take";
+	ASSERT_TRUE(std::equal(output.begin(), output.end(), input.begin() + 100,
+		[](uint16_t a, uint16_t b) { return a == b || ((a & 0x7FFF) > 0x7C00 && (b & 0x7FFF) > 0x7C00); }), message);
+}
+#endif
+
+int main() {
+	printf("Running converting range tests...\n");
+
+	RUN_TEST(test_iteration);
+	RUN_TEST(test_algorithms);
+#if defined(__cpp_lib_ranges)
+	RUN_TEST(test_ranges);
+#endif
+
+	printf("All converting range tests passed!\n");
+	return 0;
+}
@@ -0,0 +1,253 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/rounding.h>
+#include "simple_test.h"
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+static const fp16_rounding_mode kModes[] = {
+	FP16_ROUND_NEAREST_EVEN, FP16_ROUND_TOWARD_ZERO, FP16_ROUND_UP, FP16_ROUND_DOWN, FP16_ROUND_NEAREST_AWAY,
+};
+static const char* const kModeNames[] = { "NEAREST_EVEN", "TOWARD_ZERO", "UP", "DOWN", "NEAREST_AWAY" };
+
+static double decode(uint16_t h, bool alt) {
+	return alt ? fp16_alt_to_fp32_value(h) : fp16_ieee_to_fp32_value(h);
+}
+
+/*
+ * Reference conversion: find the two half-precision neighbours of the input by binary search over the magnitudes,
+ * then pick one according to the rounding mode. All comparisons are exact in double precision.
+ */
+static uint16_t reference_rounded(float f, fp16_rounding_mode mode, bool alt) {
+	const uint16_t sign = (uint16_t) ((fp32v_to_fp32b(f) >> 16) & UINT32_C(0x8000));
+	const uint16_t max_finite = alt ? UINT16_C(0x7FFF) : UINT16_C(0x7BFF);
+	if (std::isnan(f)) {
+		return sign | (alt ? UINT16_C(0x7FFF) : UINT16_C(0x7E00));
+	}
+	if (std::isinf(f)) {
+		return sign | (alt ? UINT16_C(0x7FFF) : UINT16_C(0x7C00));
+	}
+
+	const double a = std::fabs((double) f);
+	uint16_t lo = 0, hi = max_finite;
+	while (lo < hi) {
+		const uint16_t mid = (uint16_t) ((lo + hi + 1) / 2);
+		if (decode(mid, alt) <= a) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	const double lo_value = decode(lo, alt);
+	if (lo_value == a) {
+		return sign | lo;
+	}
+	/* Above the largest finite number, the next magnitude is one ulp further */
+	const double hi_value = lo == max_finite ?
+		2.0 * decode(max_finite, alt) - decode(max_finite - 1, alt) : decode(lo + 1, alt);
+	const double midpoint = 0.5 * (lo_value + hi_value);
+
+	bool up;
+	switch (mode) {
+		case FP16_ROUND_NEAREST_EVEN:
+			up = a > midpoint || (a == midpoint && (lo & 1) != 0);
+			break;
+		case FP16_ROUND_NEAREST_AWAY:
+			up = a >= midpoint;
+			break;
+		case FP16_ROUND_UP:
+			up = sign == 0;
+			break;
+		case FP16_ROUND_DOWN:
+			up = sign != 0;
+			break;
+		default:
+			up = false;
+			break;
+	}
+	uint16_t h = up ? (uint16_t) (lo + 1) : lo;
+	if (alt && h > max_finite) {
+		h = max_finite;
+	}
+	return sign | h;
+}
+
+/*
+ * Single-precision inputs around every half-precision number: the number itself, the midpoint to the next number,
+ * and their single-precision neighbours, for both signs. Every 0x10003-th single-precision bit pattern is added too.
+ */
+static std::vector<uint32_t> generate_inputs(bool alt) {
+	const uint32_t max_finite = alt ? UINT32_C(0x7FFF) : UINT32_C(0x7BFF);
+	std::vector<uint32_t> inputs;
+	for (uint32_t h = 0; h <= max_finite; h++) {
+		const double value = decode((uint16_t) h, alt);
+		const double next = h == max_finite ?
+			2.0 * value - decode((uint16_t) (h - 1), alt) : decode((uint16_t) (h + 1), alt);
+		const uint32_t exact = fp32v_to_fp32b((float) value);
+		const uint32_t midpoint = fp32v_to_fp32b((float) (0.5 * (value + next)));
+		const uint32_t candidates[] = { exact, exact + 1, midpoint - 1, midpoint, midpoint + 1 };
+		for (uint32_t w : candidates) {
+			inputs.push_back(w);
+			inputs.push_back(w | UINT32_C(0x80000000));
+		}
+		if (h != 0) {
+			inputs.push_back(exact - 1);
+		}
+	}
+	const uint32_t specials[] = { UINT32_C(0x7F800000), UINT32_C(0xFF800000), UINT32_C(0x7FC00000), UINT32_C(0xFF800001) };
+	inputs.insert(inputs.end(), specials, specials + sizeof(specials) / sizeof(specials[0]));
+	for (uint64_t w = 0; w <= UINT64_C(0xFFFFFFFF); w += 0x10003) {
+		inputs.push_back((uint32_t) w);
+	}
+	return inputs;
+}
+
+static void check_value_rounded(float16 (*convert)(float, fp16_rounding_mode), bool alt, const std::string& name) {
+	const std::vector<uint32_t> inputs = generate_inputs(alt);
+	for (size_t m = 0; m < sizeof(kModes) / sizeof(kModes[0]); m++) {
+		for (uint32_t w : inputs) {
+			const float f = fp32b_to_fp32v(w);
+			const uint16_t expected = reference_rounded(f, kModes[m], alt);
+			const uint16_t actual = convert(f, kModes[m]);
+			std::stringstream ss;
+			ss << name << " (" << kModeNames[m] << ")" << std::hex << std::uppercase << std::setfill('0') <<
+				": F32 = 0x" << std::setw(8) << w <<
+				", actual = 0x" << std::setw(4) << actual << ", expected = 0x" << std::setw(4) << expected;
+			std::string message = ss.str();
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+void test_fp32_ieee_to_fp16_value_rounded() {
+	check_value_rounded(fp32_ieee_to_fp16_value_rounded, false, "fp32_ieee_to_fp16_value_rounded");
+}
+
+void test_fp32_alt_to_fp16_value_rounded() {
+	check_value_rounded(fp32_alt_to_fp16_value_rounded, true, "fp32_alt_to_fp16_value_rounded");
+}
+
+/*
+ * Round to nearest-even must reproduce the default conversions bit for bit.
+ */
+void test_nearest_even_matches_default() {
+	for (uint64_t w = 0; w <= UINT64_C(0xFFFFFFFF); w += 0x1001) {
+		const float f = fp32b_to_fp32v((uint32_t) w);
+		std::stringstream ss;
+		ss << std::hex << std::uppercase << std::setfill('0') << "F32 = 0x" << std::setw(8) << w;
+		const std::string ieee_message = "IEEE " + ss.str();
+		const std::string alt_message = "ALT " + ss.str();
+		ASSERT_EQ(fp32_ieee_to_fp16_value(f), fp32_ieee_to_fp16_value_rounded(f, FP16_ROUND_NEAREST_EVEN), ieee_message);
+		ASSERT_EQ(fp32_alt_to_fp16_value(f), fp32_alt_to_fp16_value_rounded(f, FP16_ROUND_NEAREST_EVEN), alt_message);
+	}
+}
+
+static std::vector<float> generate_array_data(size_t n, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> bits;
+	std::vector<float> fp32(n);
+	for (size_t i = 0; i < n; i++) {
+		/* Exponents from 2**-30 to 2**20 cover denormalized, normalized, and overflowing results */
+		const uint32_t w = bits(rng);
+		const uint32_t exponent = 97 + (w >> 8) % 51;
+		fp32[i] = fp32b_to_fp32v((w & UINT32_C(0x807FFFFF)) | (exponent << 23));
+	}
+	return fp32;
+}
+
+static void check_array_rounded(void (*convert)(const float*, float16*, size_t, fp16_rounding_mode),
+	float16 (*reference)(float, fp16_rounding_mode), const std::string& name, size_t n)
+{
+	const std::vector<float> input = generate_array_data(n, (uint32_t) n);
+	for (size_t m = 0; m < sizeof(kModes) / sizeof(kModes[0]); m++) {
+		std::vector<uint16_t> output(n + 1, UINT16_C(0xDEAD));
+		convert(input.data(), output.data(), n, kModes[m]);
+		for (size_t i = 0; i < n; i++) {
+			const uint16_t expected = reference(input[i], kModes[m]);
+			std::stringstream ss;
+			ss << name << " (" << kModeNames[m] << "): N = " << n << ", I = " << i <<
+				std::hex << std::uppercase << std::setfill('0') <<
+				", F32 = 0x" << std::setw(8) << fp32v_to_fp32b(input[i]) <<
+				", actual = 0x" << std::setw(4) << output[i] << ", expected = 0x" << std::setw(4) << expected;
+			std::string message = ss.str();
+			ASSERT_EQ(expected, output[i], message);
+		}
+		const std::string guard_message = name + ": guard element overwritten";
+		ASSERT_EQ(UINT16_C(0xDEAD), output[n], guard_message);
+	}
+}
+
+static const size_t kMaxLength = 100;
+
+void test_fp32_ieee_to_fp16_array_rounded() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_array_rounded(fp32_ieee_to_fp16_array_rounded, fp32_ieee_to_fp16_value_rounded, "fp32_ieee_to_fp16_array_rounded", n);
+	}
+	check_array_rounded(fp32_ieee_to_fp16_array_rounded, fp32_ieee_to_fp16_value_rounded, "fp32_ieee_to_fp16_array_rounded", 10007);
+}
+
+void test_fp32_alt_to_fp16_array_rounded() {
+	for (size_t n = 0; n <= kMaxLength; n++) {
+		check_array_rounded(fp32_alt_to_fp16_array_rounded, fp32_alt_to_fp16_value_rounded, "fp32_alt_to_fp16_array_rounded", n);
+	}
+	check_array_rounded(fp32_alt_to_fp16_array_rounded, fp32_alt_to_fp16_value_rounded, "fp32_alt_to_fp16_array_rounded", 10007);
+}
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+/*
+ * Round to nearest-even must not depend on the rounding mode in MXCSR, which the float-add rounding in the default
+ * conversions follows.
+ */
+void test_nearest_even_ignores_mxcsr() {
+	std::vector<float> input = generate_array_data(1003, 1003);
+	/* 1 + 1.75 * 2**-10 lies between 0x3C01 and 0x3C02, closer to 0x3C02 */
+	input[0] = 1.0f + 1.75f / 1024.0f;
+	input[1002] = -input[0];
+	const unsigned int modes[] = { _MM_ROUND_TOWARD_ZERO, _MM_ROUND_UP, _MM_ROUND_DOWN };
+	const unsigned int saved = _MM_GET_ROUNDING_MODE();
+	for (unsigned int mxcsr_mode : modes) {
+		std::vector<uint16_t> ieee(input.size()), alt(input.size());
+		_MM_SET_ROUNDING_MODE(mxcsr_mode);
+		fp32_ieee_to_fp16_array_rounded(input.data(), ieee.data(), input.size(), FP16_ROUND_NEAREST_EVEN);
+		fp32_alt_to_fp16_array_rounded(input.data(), alt.data(), input.size(), FP16_ROUND_NEAREST_EVEN);
+		_MM_SET_ROUNDING_MODE(saved);
+
+		std::string message = "MXCSR mode " + std::to_string(mxcsr_mode) + ": 1 + 1.75 * 2**-10 rounds to 0x3C02";
+		ASSERT_TRUE(ieee[0] == UINT16_C(0x3C02) && alt[0] == UINT16_C(0x3C02) &&
+			ieee[1002] == UINT16_C(0xBC02) && alt[1002] == UINT16_C(0xBC02), message);
+		for (size_t i = 0; i < input.size(); i++) {
+			std::stringstream ss;
+			ss << "MXCSR mode " << mxcsr_mode << ": I = " << i << std::hex << std::uppercase << std::setfill('0') <<
+				", F32 = 0x" << std::setw(8) << fp32v_to_fp32b(input[i]);
+			message = "IEEE " + ss.str();
+			ASSERT_EQ(fp32_ieee_to_fp16_value_rounded(input[i], FP16_ROUND_NEAREST_EVEN), ieee[i], message);
+			message = "ALT " + ss.str();
+			ASSERT_EQ(fp32_alt_to_fp16_value_rounded(input[i], FP16_ROUND_NEAREST_EVEN), alt[i], message);
+		}
+	}
+}
+#endif
+
+int main() {
+	printf("Running FP16 rounding mode tests...\n");
+
+	RUN_TEST(test_fp32_ieee_to_fp16_value_rounded);
+	RUN_TEST(test_fp32_alt_to_fp16_value_rounded);
+	RUN_TEST(test_nearest_even_matches_default);
+	RUN_TEST(test_fp32_ieee_to_fp16_array_rounded);
+	RUN_TEST(test_fp32_alt_to_fp16_array_rounded);
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+	RUN_TEST(test_nearest_even_ignores_mxcsr);
+#endif
+
+	printf("All rounding mode tests passed!\n");
+	return 0;
+}
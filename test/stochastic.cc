@@ -0,0 +1,198 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/rounding.h>
+#include <fp16/stochastic.h>
+#include "simple_test.h"
+#include <random>
+#include <string>
+#include <sstream>
+#include <vector>
+
+static const uint64_t kSeed = UINT64_C(0x0123456789ABCDEF);
+
+static std::vector<float> generate_fp32_data(size_t n, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> bits;
+	std::vector<float> fp32(n);
+	for (size_t i = 0; i < n; i++) {
+		/* Exponents from 2**-40 to 2**20 cover all half-precision ranges and overflow */
+		const uint32_t w = bits(rng);
+		const uint32_t exponent = 87 + (w >> 8) % 61;
+		fp32[i] = fp32b_to_fp32v((w & UINT32_C(0x807FFFFF)) | (exponent << 23));
+	}
+	return fp32;
+}
+
+/*
+ * Every result must be one of the two half-precision neighbours of the input: rounded toward zero or away from zero.
+ */
+static void check_neighbours(float16 (*convert)(float, uint64_t, uint64_t), bool alt, const std::string& name) {
+	const std::vector<float> input = generate_fp32_data(100000, 1);
+	for (size_t i = 0; i < input.size(); i++) {
+		const float f = input[i];
+		const fp16_rounding_mode away = std::signbit(f) ? FP16_ROUND_DOWN : FP16_ROUND_UP;
+		const uint16_t toward_zero = alt ?
+			fp32_alt_to_fp16_value_rounded(f, FP16_ROUND_TOWARD_ZERO) : fp32_ieee_to_fp16_value_rounded(f, FP16_ROUND_TOWARD_ZERO);
+		const uint16_t away_from_zero = alt ?
+			fp32_alt_to_fp16_value_rounded(f, away) : fp32_ieee_to_fp16_value_rounded(f, away);
+		const uint16_t actual = convert(f, kSeed, i);
+		std::stringstream ss;
+		ss << name << std::hex << std::uppercase << std::setfill('0') <<
+			": F32 = 0x" << std::setw(8) << fp32v_to_fp32b(f) << ", actual = 0x" << std::setw(4) << actual <<
+			", neighbours = 0x" << std::setw(4) << toward_zero << " and 0x" << std::setw(4) << away_from_zero;
+		std::string message = ss.str();
+		ASSERT_TRUE(actual == toward_zero || actual == away_from_zero, message);
+	}
+}
+
+void test_neighbours() {
+	check_neighbours(fp32_ieee_to_fp16_value_stochastic, false, "fp32_ieee_to_fp16_value_stochastic");
+	check_neighbours(fp32_alt_to_fp16_value_stochastic, true, "fp32_alt_to_fp16_value_stochastic");
+}
+
+/*
+ * Numbers representable in half-precision never change.
+ */
+void test_exact() {
+	for (uint32_t h = 0; h < 0x10000; h++) {
+		if ((h & 0x7C00) == 0x7C00) {
+			continue;
+		}
+		for (uint64_t index = 0; index < 4; index++) {
+			std::stringstream ss;
+			ss << std::hex << std::uppercase << std::setfill('0') << "F16 = 0x" << std::setw(4) << h;
+			std::string message = ss.str();
+			ASSERT_EQ(h, fp32_ieee_to_fp16_value_stochastic(fp16_ieee_to_fp32_value((uint16_t) h), kSeed, index), message);
+			ASSERT_EQ(h, fp32_alt_to_fp16_value_stochastic(fp16_alt_to_fp32_value((uint16_t) h), kSeed, index), message);
+		}
+	}
+}
+
+/*
+ * The fraction of elements rounded up must match the position of the input between its neighbours, within five
+ * standard deviations, for normalized, denormalized, and below-denormal results.
+ */
+static void check_probability(float value, float lower, float upper, const std::string& name) {
+	const size_t n = 1 << 20;
+	std::vector<float> input(n, value);
+	std::vector<uint16_t> output(n);
+	fp32_ieee_to_fp16_array_stochastic(input.data(), output.data(), n, kSeed, 0);
+
+	const uint16_t upper_bits = fp32_ieee_to_fp16_value(upper);
+	const uint16_t lower_bits = fp32_ieee_to_fp16_value(lower);
+	size_t rounded_up = 0;
+	for (size_t i = 0; i < n; i++) {
+		ASSERT_TRUE(output[i] == lower_bits || output[i] == upper_bits, name);
+		rounded_up += output[i] == upper_bits;
+	}
+	const double p = ((double) value - (double) lower) / ((double) upper - (double) lower);
+	const double sigma = std::sqrt(p * (1.0 - p) / (double) n);
+	const double deviation = std::fabs((double) rounded_up / (double) n - p);
+	std::stringstream ss;
+	ss << name << ": P = " << p << ", observed = " << (double) rounded_up / (double) n;
+	std::string message = ss.str();
+	ASSERT_GT(5.0 * sigma, deviation, message);
+}
+
+void test_probability() {
+	/* Half-precision spacing is 2**-10 at 1.0, 2**-24 for denormals */
+	check_probability(1.0f + 1.0f / 4096.0f, 1.0f, 1.0f + 1.0f / 1024.0f, "quarter ulp above 1");
+	check_probability(-(1.0f + 3.0f / 4096.0f), -1.0f, -(1.0f + 1.0f / 1024.0f), "three quarter ulp below -1");
+	check_probability(1000.3f, 1000.0f, 1000.5f, "1000.3");
+	check_probability(std::ldexp(1.1f, -24), std::ldexp(1.0f, -24), std::ldexp(1.0f, -23), "denormal");
+	check_probability(std::ldexp(1.0f, -26), 0.0f, std::ldexp(1.0f, -24), "quarter of the smallest denormal");
+	check_probability(std::ldexp(1.0f, -30), 0.0f, std::ldexp(1.0f, -24), "2**-30");
+}
+
+/*
+ * Array results must equal the scalar results for the same counters, wherever the array starts and however it is
+ * split, including across the 2**32 boundary of the counter.
+ */
+static void check_array(void (*convert_array)(const float*, float16*, size_t, uint64_t, uint64_t),
+	float16 (*convert)(float, uint64_t, uint64_t), const std::string& name, size_t n, uint64_t offset)
+{
+	const std::vector<float> input = generate_fp32_data(n, (uint32_t) n);
+	std::vector<uint16_t> output(n + 1, UINT16_C(0xDEAD));
+	convert_array(input.data(), output.data(), n, kSeed, offset);
+	for (size_t i = 0; i < n; i++) {
+		const uint16_t expected = convert(input[i], kSeed, offset + i);
+		std::stringstream ss;
+		ss << name << ": N = " << n << ", offset = " << offset << ", I = " << i <<
+			std::hex << std::uppercase << std::setfill('0') <<
+			", F32 = 0x" << std::setw(8) << fp32v_to_fp32b(input[i]) <<
+			", actual = 0x" << std::setw(4) << output[i] << ", expected = 0x" << std::setw(4) << expected;
+		std::string message = ss.str();
+		ASSERT_EQ(expected, output[i], message);
+	}
+	const std::string guard_message = name + ": guard element overwritten";
+	ASSERT_EQ(UINT16_C(0xDEAD), output[n], guard_message);
+
+	/* Converting in chunks of 7 gives the same result */
+	std::vector<uint16_t> chunked(n);
+	for (size_t i = 0; i < n; i += 7) {
+		const size_t chunk = n - i < 7 ? n - i : 7;
+		convert_array(input.data() + i, chunked.data() + i, chunk, kSeed, offset + i);
+	}
+	for (size_t i = 0; i < n; i++) {
+		const std::string chunk_message = name + ": chunked conversion differs";
+		ASSERT_EQ(output[i], chunked[i], chunk_message);
+	}
+}
+
+static const uint64_t kOffsets[] = { 0, 5, UINT64_C(0xFFFFFFFD), UINT64_C(0x1FFFFFFF9) };
+
+void test_fp32_ieee_to_fp16_array_stochastic() {
+	for (uint64_t offset : kOffsets) {
+		for (size_t n = 0; n <= 40; n++) {
+			check_array(fp32_ieee_to_fp16_array_stochastic, fp32_ieee_to_fp16_value_stochastic,
+				"fp32_ieee_to_fp16_array_stochastic", n, offset);
+		}
+		check_array(fp32_ieee_to_fp16_array_stochastic, fp32_ieee_to_fp16_value_stochastic,
+			"fp32_ieee_to_fp16_array_stochastic", 10007, offset);
+	}
+}
+
+void test_fp32_alt_to_fp16_array_stochastic() {
+	for (uint64_t offset : kOffsets) {
+		for (size_t n = 0; n <= 40; n++) {
+			check_array(fp32_alt_to_fp16_array_stochastic, fp32_alt_to_fp16_value_stochastic,
+				"fp32_alt_to_fp16_array_stochastic", n, offset);
+		}
+		check_array(fp32_alt_to_fp16_array_stochastic, fp32_alt_to_fp16_value_stochastic,
+			"fp32_alt_to_fp16_array_stochastic", 10007, offset);
+	}
+}
+
+/*
+ * Different seeds must give different rounding decisions.
+ */
+void test_seeds() {
+	const size_t n = 4096;
+	std::vector<float> input(n, 1.0f + 1.0f / 2048.0f);
+	std::vector<uint16_t> first(n), second(n);
+	fp32_ieee_to_fp16_array_stochastic(input.data(), first.data(), n, 1, 0);
+	fp32_ieee_to_fp16_array_stochastic(input.data(), second.data(), n, 2, 0);
+	size_t differences = 0;
+	for (size_t i = 0; i < n; i++) {
+		differences += first[i] != second[i];
+	}
+	const std::string message = "seeds 1 and 2 give nearly identical results";
+	ASSERT_GT(differences, n / 4, message);
+}
+
+int main() {
+	printf("Running FP16 stochastic rounding tests...\n");
+
+	RUN_TEST(test_neighbours);
+	RUN_TEST(test_exact);
+	RUN_TEST(test_probability);
+	RUN_TEST(test_fp32_ieee_to_fp16_array_stochastic);
+	RUN_TEST(test_fp32_alt_to_fp16_array_stochastic);
+	RUN_TEST(test_seeds);
+
+	printf("All stochastic rounding tests passed!\n");
+	return 0;
+}
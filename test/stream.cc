@@ -0,0 +1,265 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <fp16.h>
+#include <fp16/stream.h>
+#include "simple_test.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+void test_spsc_ring() {
+	fp16::spsc_ring<uint32_t> ring(5);
+	std::string message = "capacity rounded up to a power of two";
+	ASSERT_EQ(8, ring.capacity(), message);
+
+	/* Full and empty rings */
+	uint32_t value = 0;
+	for (uint32_t i = 0; i < 8; i++) {
+		message = "push into a ring that is not full";
+		ASSERT_TRUE(ring.try_push(i), message);
+	}
+	message = "push into a full ring";
+	ASSERT_TRUE(!ring.try_push(8), message);
+	for (uint32_t i = 0; i < 8; i++) {
+		message = "pop from a ring that is not empty";
+		ASSERT_TRUE(ring.try_pop(value), message);
+		message = "popped value";
+		ASSERT_EQ(i, value, message);
+	}
+	message = "pop from an empty ring";
+	ASSERT_TRUE(!ring.try_pop(value), message);
+
+	/* One producer and one consumer thread: every value arrives once, in order */
+	const uint32_t count = 1000000;
+	std::thread producer([&]() {
+		for (uint32_t i = 0; i < count; i++) {
+			while (!ring.try_push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	uint32_t expected = 0;
+	while (expected < count) {
+		if (ring.try_pop(value)) {
+			if (value != expected) {
+				break;
+			}
+			expected++;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+	message = "values from the producer thread in order";
+	ASSERT_EQ(count, expected, message);
+}
+
+void test_mpmc_ring() {
+	fp16::mpmc_ring<uint64_t> ring(64);
+	uint64_t value = 0;
+	for (uint64_t i = 0; i < 64; i++) {
+		std::string message = "push into a ring that is not full";
+		ASSERT_TRUE(ring.try_push(i), message);
+	}
+	std::string message = "push into a full ring";
+	ASSERT_TRUE(!ring.try_push(64), message);
+	for (uint64_t i = 0; i < 64; i++) {
+		message = "pop from a ring that is not empty";
+		ASSERT_TRUE(ring.try_pop(value), message);
+		message = "popped value";
+		ASSERT_EQ(i, value, message);
+	}
+	message = "pop from an empty ring";
+	ASSERT_TRUE(!ring.try_pop(value), message);
+
+	/* Several producers and one consumer: the values of each producer arrive once, in the order of that producer */
+	const uint64_t producers = 4, count = 250000;
+	std::vector<std::thread> threads;
+	for (uint64_t p = 0; p < producers; p++) {
+		threads.push_back(std::thread([&ring, p, count]() {
+			for (uint64_t i = 0; i < count; i++) {
+				while (!ring.try_push(p << 32 | i)) {
+					std::this_thread::yield();
+				}
+			}
+		}));
+	}
+	std::vector<uint64_t> next(producers, 0);
+	uint64_t received = 0, misordered = 0;
+	while (received < producers * count) {
+		if (ring.try_pop(value)) {
+			const uint64_t p = value >> 32;
+			if (p >= producers || (value & 0xFFFFFFFF) != next[p]) {
+				misordered++;
+			} else {
+				next[p]++;
+			}
+			received++;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	message = "values out of order per producer";
+	ASSERT_EQ(0, misordered, message);
+	message = "values left after every producer finished";
+	ASSERT_TRUE(!ring.try_pop(value), message);
+}
+
+/* Input numbers of chunk `index` of producer `producer`, as raw bytes for any kind of conversion */
+static void fill_chunk(fp16_conversion_kind kind, void* data, size_t count, size_t producer, size_t index) {
+	unsigned char* bytes = static_cast<unsigned char*>(data);
+	const size_t size = count * fp16_conversion_input_size(kind);
+	for (size_t i = 0; i < size; i++) {
+		bytes[i] = (unsigned char) ((producer * 7919 + index * 104729 + i) * 40503 >> 5);
+	}
+}
+
+struct chunk_record {
+	size_t producer;
+	size_t index;
+	size_t count;
+};
+
+/*
+ * Producers submit chunks of varying length, workers convert them, and consumers copy every popped chunk by its
+ * sequence number. The copies must match fp16_convert_strided of the chunks the producers submitted, bit for bit.
+ */
+static void check_stage(fp16_conversion_kind kind, size_t producers, size_t workers, size_t consumers, size_t slots,
+	const std::string& name)
+{
+	const size_t chunk_elements = 1000, chunks_per_producer = 500;
+	fp16::stream_converter stage(kind, chunk_elements, slots, workers);
+	std::string message = name + ": chunk elements";
+	ASSERT_EQ(chunk_elements, stage.chunk_elements(), message);
+
+	std::mutex mutex;
+	std::map<uint64_t, chunk_record> submitted;
+	std::map<uint64_t, std::vector<unsigned char>> popped;
+
+	std::vector<std::thread> producer_threads;
+	for (size_t p = 0; p < producers; p++) {
+		producer_threads.push_back(std::thread([&, p]() {
+			for (size_t i = 0; i < chunks_per_producer; i++) {
+				fp16::stream_converter::input_chunk chunk = stage.acquire();
+				const size_t count = (i % 5 == 4) ? (i * 37) % chunk_elements : chunk_elements;
+				fill_chunk(kind, chunk.data, count, p, i);
+				const uint64_t sequence = stage.submit(chunk, count);
+				const chunk_record record = { p, i, count };
+				std::lock_guard<std::mutex> lock(mutex);
+				submitted[sequence] = record;
+			}
+		}));
+	}
+	std::vector<std::thread> consumer_threads;
+	for (size_t c = 0; c < consumers; c++) {
+		consumer_threads.push_back(std::thread([&]() {
+			fp16::stream_converter::output_chunk chunk;
+			while (stage.pop(chunk)) {
+				const unsigned char* data = static_cast<const unsigned char*>(chunk.data);
+				std::vector<unsigned char> copy(data, data + chunk.count * fp16_conversion_output_size(kind));
+				stage.release(chunk);
+				std::lock_guard<std::mutex> lock(mutex);
+				popped[chunk.sequence].swap(copy);
+			}
+		}));
+	}
+	for (std::thread& thread : producer_threads) {
+		thread.join();
+	}
+	stage.close();
+	for (std::thread& thread : consumer_threads) {
+		thread.join();
+	}
+
+	message = name + ": submitted chunks";
+	ASSERT_EQ(producers * chunks_per_producer, submitted.size(), message);
+	message = name + ": popped chunks";
+	ASSERT_EQ(submitted.size(), popped.size(), message);
+	for (const std::pair<const uint64_t, chunk_record>& entry : submitted) {
+		const chunk_record& record = entry.second;
+		std::vector<unsigned char> input(record.count * fp16_conversion_input_size(kind) + 1);
+		fill_chunk(kind, input.data(), record.count, record.producer, record.index);
+		std::vector<unsigned char> expected(record.count * fp16_conversion_output_size(kind) + 1);
+		fp16_convert_strided(kind, input.data(), 1, expected.data(), 1, record.count);
+		expected.pop_back();
+
+		std::stringstream ss;
+		ss << name << ": chunk " << entry.first << " (producer " << record.producer << ", chunk " << record.index
+			<< ", N = " << record.count << ")";
+		message = ss.str();
+		ASSERT_TRUE(popped.count(entry.first) == 1 && popped[entry.first] == expected, message);
+	}
+}
+
+void test_stream_converter() {
+	static const fp16_conversion_kind kinds[] = {
+		FP16_CONVERSION_IEEE_TO_FP32, FP16_CONVERSION_FP32_TO_IEEE, FP16_CONVERSION_ALT_TO_FP32, FP16_CONVERSION_FP32_TO_ALT,
+	};
+	for (fp16_conversion_kind kind : kinds) {
+		const std::string name = "kind " + std::to_string((int) kind);
+		check_stage(kind, 1, 1, 1, 8, name + ", 1 producer, 1 worker, 1 consumer");
+	}
+	check_stage(FP16_CONVERSION_FP32_TO_IEEE, 4, 1, 1, 16, "4 producers, 1 worker, 1 consumer");
+	check_stage(FP16_CONVERSION_FP32_TO_IEEE, 3, 3, 2, 4, "3 producers, 3 workers, 2 consumers");
+	check_stage(FP16_CONVERSION_FP32_TO_IEEE, 2, 2, 2, 1, "a single slot");
+}
+
+void test_stream_close() {
+	/* A stage closed without chunks returns no chunk and stops its workers */
+	fp16::stream_converter stage(FP16_CONVERSION_FP32_TO_IEEE, 256, 4, 2);
+	fp16::stream_converter::output_chunk chunk;
+	std::string message = "pop from an open stage without chunks";
+	ASSERT_TRUE(!stage.try_pop(chunk), message);
+	stage.close();
+	message = "pop from a closed stage without chunks";
+	ASSERT_TRUE(!stage.pop(chunk), message);
+
+	/* Every slot can be held by producers at once */
+	fp16::stream_converter full(FP16_CONVERSION_FP32_TO_IEEE, 256, 4, 1);
+	std::vector<fp16::stream_converter::input_chunk> held(4);
+	for (fp16::stream_converter::input_chunk& in : held) {
+		message = "acquire a free slot";
+		ASSERT_TRUE(full.try_acquire(in), message);
+	}
+	fp16::stream_converter::input_chunk extra;
+	message = "acquire with every slot held";
+	ASSERT_TRUE(!full.try_acquire(extra), message);
+	for (fp16::stream_converter::input_chunk& in : held) {
+		float* data = static_cast<float*>(in.data);
+		for (size_t i = 0; i < in.capacity; i++) {
+			data[i] = 1.0f + (float) i / 256.0f;
+		}
+		full.submit(in, in.capacity);
+	}
+	full.close();
+	size_t chunks = 0;
+	while (full.pop(chunk)) {
+		const uint16_t* data = static_cast<const uint16_t*>(chunk.data);
+		message = "converted chunk";
+		ASSERT_EQ(fp32_ieee_to_fp16_value(1.0f + 255.0f / 256.0f), data[255], message);
+		full.release(chunk);
+		chunks++;
+	}
+	message = "chunks popped after close";
+	ASSERT_EQ(4, chunks, message);
+}
+
+int main() {
+	printf("Running streaming conversion tests...\n");
+
+	RUN_TEST(test_spsc_ring);
+	RUN_TEST(test_mpmc_ring);
+	RUN_TEST(test_stream_converter);
+	RUN_TEST(test_stream_close);
+
+	printf("All streaming conversion tests passed!\n");
+	return 0;
+}
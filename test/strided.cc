@@ -0,0 +1,148 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <fp16.h>
+#include <fp16/strided.h>
+#include "simple_test.h"
+#include "test_data.h"
+#include <string>
+#include <sstream>
+#include <vector>
+
+static const uint16_t kUntouchedBits16 = UINT16_C(0xDEAD);
+static const uint32_t kUntouchedBits32 = UINT32_C(0xDEADBEEF);
+
+/*
+ * A 3D view into a larger buffer: the offset of the first element, the shape, and the strides in elements.
+ */
+struct View {
+	ptrdiff_t offset;
+	size_t shape[3];
+	ptrdiff_t strides[3];
+
+	ptrdiff_t at(size_t i, size_t j, size_t k) const {
+		return offset + (ptrdiff_t) i * strides[0] + (ptrdiff_t) j * strides[1] + (ptrdiff_t) k * strides[2];
+	}
+};
+
+/*
+ * Convert a 3D view with fp16_convert_nd and compare every element of the output buffer with a scalar reference:
+ * elements inside the output view must hold the converted input, and all other elements must be untouched.
+ */
+static void check_nd(enum fp16_conversion_kind kind, const View& in, size_t input_size, const View& out, size_t output_size,
+	const std::string& name)
+{
+	const bool fp32_input = kind == FP16_CONVERSION_FP32_TO_IEEE || kind == FP16_CONVERSION_FP32_TO_ALT;
+	const std::vector<float> fp32_input_data = generate_fp32_data(input_size, (uint32_t) input_size);
+	const std::vector<uint16_t> fp16_input_data = generate_fp16_data(input_size, (uint32_t) input_size);
+	std::vector<float> fp32_output(output_size, fp32b_to_fp32v(kUntouchedBits32));
+	std::vector<uint16_t> fp16_output(output_size, kUntouchedBits16);
+	std::vector<float> fp32_expected(fp32_output);
+	std::vector<uint16_t> fp16_expected(fp16_output);
+
+	for (size_t i = 0; i < in.shape[0]; i++) {
+		for (size_t j = 0; j < in.shape[1]; j++) {
+			for (size_t k = 0; k < in.shape[2]; k++) {
+				const ptrdiff_t src = in.at(i, j, k);
+				const ptrdiff_t dst = out.at(i, j, k);
+				switch (kind) {
+					case FP16_CONVERSION_IEEE_TO_FP32:
+						fp32_expected[dst] = fp16_ieee_to_fp32_value(fp16_input_data[src]);
+						break;
+					case FP16_CONVERSION_FP32_TO_IEEE:
+						fp16_expected[dst] = fp32_ieee_to_fp16_value(fp32_input_data[src]);
+						break;
+					case FP16_CONVERSION_ALT_TO_FP32:
+						fp32_expected[dst] = fp16_alt_to_fp32_value(fp16_input_data[src]);
+						break;
+					case FP16_CONVERSION_FP32_TO_ALT:
+						fp16_expected[dst] = fp32_alt_to_fp16_value(fp32_input_data[src]);
+						break;
+				}
+			}
+		}
+	}
+
+	const void* input = fp32_input ? (const void*) (fp32_input_data.data() + in.offset) : (const void*) (fp16_input_data.data() + in.offset);
+	void* output = fp32_input ? (void*) (fp16_output.data() + out.offset) : (void*) (fp32_output.data() + out.offset);
+	fp16_convert_nd(kind, 3, in.shape, input, in.strides, output, out.strides);
+
+	for (size_t i = 0; i < output_size; i++) {
+		const uint32_t expected = fp32_input ? fp16_expected[i] : fp32v_to_fp32b(fp32_expected[i]);
+		const uint32_t actual = fp32_input ? fp16_output[i] : fp32v_to_fp32b(fp32_output[i]);
+		std::stringstream ss;
+		ss << name << ": element " << i << std::hex << std::uppercase << std::setfill('0') <<
+			", actual = 0x" << std::setw(8) << actual << ", expected = 0x" << std::setw(8) << expected;
+		std::string message = ss.str();
+		ASSERT_EQ(expected, actual, message);
+	}
+}
+
+static void check_all_kinds(const View& in, size_t input_size, const View& out, size_t output_size, const std::string& name) {
+	check_nd(FP16_CONVERSION_IEEE_TO_FP32, in, input_size, out, output_size, name + " (IEEE to FP32)");
+	check_nd(FP16_CONVERSION_FP32_TO_IEEE, in, input_size, out, output_size, name + " (FP32 to IEEE)");
+	check_nd(FP16_CONVERSION_ALT_TO_FP32, in, input_size, out, output_size, name + " (ALT to FP32)");
+	check_nd(FP16_CONVERSION_FP32_TO_ALT, in, input_size, out, output_size, name + " (FP32 to ALT)");
+}
+
+void test_contiguous() {
+	for (size_t n = 1; n <= 70; n++) {
+		const View view = { 0, { 2, 3, n }, { (ptrdiff_t) (3 * n), (ptrdiff_t) n, 1 } };
+		check_all_kinds(view, 6 * n, view, 6 * n, "contiguous");
+	}
+}
+
+void test_row_pitch() {
+	/* Rows of 37 elements with a pitch of 40 on input and 48 on output */
+	const View in = { 0, { 3, 5, 37 }, { 200, 40, 1 } };
+	const View out = { 0, { 3, 5, 37 }, { 240, 48, 1 } };
+	check_all_kinds(in, 600, out, 720, "row pitch");
+}
+
+void test_column_slice() {
+	/* Column 3 of a 4 x 50 x 7 tensor, written into a dense 4 x 50 output */
+	for (ptrdiff_t column = 0; column < 7; column++) {
+		const View in = { column, { 4, 50, 1 }, { 350, 7, 1 } };
+		const View out = { 0, { 4, 50, 1 }, { 50, 1, 1 } };
+		check_all_kinds(in, 1400, out, 200, "column slice");
+	}
+}
+
+void test_channel_strides() {
+	/* NHWC input converted into an NCHW output: every inner access is strided on one side */
+	const size_t height = 9, width = 11, channels = 5;
+	const View in = { 0, { channels, height, width },
+		{ 1, (ptrdiff_t) (width * channels), (ptrdiff_t) channels } };
+	const View out = { 0, { channels, height, width },
+		{ (ptrdiff_t) (height * width), (ptrdiff_t) width, 1 } };
+	check_all_kinds(in, height * width * channels, out, height * width * channels, "channel strides");
+	check_all_kinds(out, height * width * channels, in, height * width * channels, "channel strides (reverse)");
+}
+
+void test_negative_strides() {
+	/* Input traversed backwards along both inner dimensions, output with a gap between elements */
+	const View in = { 20 * 30 - 1, { 1, 20, 30 }, { 0, -30, -1 } };
+	const View out = { 0, { 1, 20, 30 }, { 0, 61, 2 } };
+	check_all_kinds(in, 20 * 30, out, 20 * 61, "negative strides");
+}
+
+void test_broadcast() {
+	/* Zero input stride broadcasts one element along the inner dimension */
+	const View in = { 0, { 1, 4, 33 }, { 0, 1, 0 } };
+	const View out = { 0, { 1, 4, 33 }, { 0, 33, 1 } };
+	check_all_kinds(in, 4, out, 4 * 33, "broadcast");
+}
+
+int main() {
+	printf("Running FP16 strided conversion tests...\n");
+
+	RUN_TEST(test_contiguous);
+	RUN_TEST(test_row_pitch);
+	RUN_TEST(test_column_slice);
+	RUN_TEST(test_channel_strides);
+	RUN_TEST(test_negative_strides);
+	RUN_TEST(test_broadcast);
+
+	printf("All strided conversion tests passed!\n");
+	return 0;
+}
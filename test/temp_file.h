@@ -0,0 +1,40 @@
+#ifndef TEMP_FILE_H
+#define TEMP_FILE_H
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/* A path in $TMPDIR (or /tmp) that is unique to the test process */
+static inline std::string temp_path(const std::string& name) {
+	const char* directory = getenv("TMPDIR");
+	return std::string(directory != NULL && directory[0] != '\0' ? directory : "/tmp") + "/fp16-test-" +
+		std::to_string((long) getpid()) + "-" + name;
+}
+
+/* Replace the contents of a file */
+static inline void write_bytes(const std::string& path, const char* data, size_t size) {
+	std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+	file.write(data, (std::streamsize) size);
+}
+
+static inline void write_bytes(const std::string& path, const std::string& bytes) {
+	write_bytes(path, bytes.data(), bytes.size());
+}
+
+static inline void write_bytes(const std::string& path, const std::vector<unsigned char>& bytes) {
+	write_bytes(path, (const char*) bytes.data(), bytes.size());
+}
+
+/* Read a whole file into a std::string, or a std::vector of bytes with read_bytes<std::vector<unsigned char>> */
+template <class Bytes = std::string>
+static inline Bytes read_bytes(const std::string& path) {
+	std::ifstream file(path.c_str(), std::ios::binary);
+	return Bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+#endif /* TEMP_FILE_H */
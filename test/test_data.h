@@ -0,0 +1,35 @@
+#ifndef TEST_DATA_H
+#define TEST_DATA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+/* Single-precision numbers in and beyond the half-precision range, with every other one scaled into denormals */
+static inline std::vector<float> generate_fp32_data(size_t n, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> values(-70000.0f, 70000.0f);
+	std::vector<float> fp32(n);
+	for (size_t i = 0; i < n; i++) {
+		fp32[i] = values(rng) * (i % 2 == 0 ? 1.0f : 1.0f / 65536.0f);
+	}
+	return fp32;
+}
+
+/* Half-precision bit patterns of every kind but NaN */
+static inline std::vector<uint16_t> generate_fp16_data(size_t n, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> bits(0, UINT32_C(0xFFFF));
+	std::vector<uint16_t> fp16(n);
+	for (size_t i = 0; i < n; i++) {
+		/* Exclude NaN, whose payload may differ between the vector and scalar kernels */
+		do {
+			fp16[i] = (uint16_t) bits(rng);
+		} while ((fp16[i] & UINT16_C(0x7FFF)) > UINT16_C(0x7C00));
+	}
+	return fp16;
+}
+
+#endif /* TEST_DATA_H */
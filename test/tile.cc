@@ -0,0 +1,241 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/tile.h>
+#include "simple_test.h"
+#include <string>
+#include <sstream>
+#include <vector>
+
+/*
+ * The F16C kernels keep NaN payloads where the scalar conversions do not, so any NaN matches a NaN.
+ */
+static bool same_fp32(float actual, float expected) {
+	return fp32v_to_fp32b(actual) == fp32v_to_fp32b(expected) || (std::isnan(actual) && std::isnan(expected));
+}
+
+static bool same_fp16(uint16_t actual, uint16_t expected) {
+	return actual == expected || ((actual & 0x7FFF) > 0x7C00 && (expected & 0x7FFF) > 0x7C00);
+}
+
+static std::vector<uint16_t> make_input(size_t n) {
+	std::vector<uint16_t> input(n);
+	for (size_t i = 0; i < n; i++) {
+		input[i] = (uint16_t) (i * 40503);
+	}
+	return input;
+}
+
+static std::vector<size_t> lengths() {
+	std::vector<size_t> result;
+	for (size_t n = 0; n <= 40; n++) {
+		result.push_back(n);
+	}
+	result.push_back(1000);
+	result.push_back(65536);
+	result.push_back(100003);
+	return result;
+}
+
+static std::vector<size_t> tiles() {
+	std::vector<size_t> result;
+	result.push_back(0);
+	result.push_back(1);
+	result.push_back(7);
+	result.push_back(64);
+	result.push_back(FP16_TILE_MAX_ELEMENTS);
+	result.push_back(3 * FP16_TILE_MAX_ELEMENTS);
+	return result;
+}
+
+/*
+ * Records every tile the conversion passes to the consumer, and checks that tiles are contiguous and never longer
+ * than the expected tile size.
+ */
+struct consumer_state {
+	std::vector<float> output;
+	size_t tile;
+	size_t calls;
+	size_t stop_after;
+	bool contiguous;
+};
+
+static int record_tile(float* tile, size_t offset, size_t count, void* context) {
+	consumer_state* state = (consumer_state*) context;
+	state->contiguous = state->contiguous && offset == state->output.size() && count != 0 && count <= state->tile;
+	state->output.insert(state->output.end(), tile, tile + count);
+	state->calls++;
+	return state->calls == state->stop_after;
+}
+
+/*
+ * Fills every tile with the single-precision numbers the test expects in the output, from a reference array.
+ */
+struct producer_state {
+	const std::vector<float>* input;
+	size_t tile;
+	size_t calls;
+	size_t stop_after;
+	bool contiguous;
+	size_t next;
+};
+
+static int fill_tile(float* tile, size_t offset, size_t count, void* context) {
+	producer_state* state = (producer_state*) context;
+	state->contiguous = state->contiguous && offset == state->next && count != 0 && count <= state->tile;
+	for (size_t i = 0; i < count; i++) {
+		tile[i] = (*state->input)[offset + i];
+	}
+	state->next = offset + count;
+	state->calls++;
+	return state->calls == state->stop_after;
+}
+
+static size_t expected_tile(size_t tile, bool stack) {
+	if (tile == 0) {
+		tile = fp16_tile_elements(fp16_cache_size(1));
+	}
+	return stack && tile > FP16_TILE_MAX_ELEMENTS ? FP16_TILE_MAX_ELEMENTS : tile;
+}
+
+void test_cache_size() {
+	const size_t l1 = fp16_cache_size(1), l2 = fp16_cache_size(2);
+	printf("L1 data cache: %u bytes, L2 cache: %u bytes, default tile: %u elements\n",
+		(unsigned) l1, (unsigned) l2, (unsigned) fp16_tile_elements(l1));
+	std::string message = "cache sizes";
+	ASSERT_TRUE(l1 >= 1024 && l2 >= l1, message);
+	message = "tile elements";
+	ASSERT_EQ(l1 / 8 / 64 * 64, fp16_tile_elements(l1), message);
+	ASSERT_EQ(64u, (unsigned) fp16_tile_elements(1000), message);
+	ASSERT_EQ(0u, (unsigned) (fp16_tile_elements(l2) % 64), message);
+}
+
+void test_decode() {
+	for (int alt = 0; alt <= 1; alt++) {
+		for (size_t n : lengths()) {
+			const std::vector<uint16_t> input = make_input(n);
+			for (size_t tile : tiles()) {
+				for (int stack = 0; stack <= 1; stack++) {
+					consumer_state state;
+					state.tile = expected_tile(tile, stack != 0);
+					state.calls = 0;
+					state.stop_after = 0;
+					state.contiguous = true;
+					std::vector<float> scratch(stack ? 0 : state.tile);
+					const size_t converted = alt ?
+						fp16_alt_to_fp32_tiled(input.data(), n, stack ? NULL : scratch.data(), tile, record_tile, &state) :
+						fp16_ieee_to_fp32_tiled(input.data(), n, stack ? NULL : scratch.data(), tile, record_tile, &state);
+
+					std::stringstream ss;
+					ss << (alt ? "alt" : "ieee") << ": N = " << n << ", tile = " << tile << (stack ? ", stack" : ", scratch");
+					std::string message = ss.str() + ": converted";
+					ASSERT_EQ(n, converted, message);
+					message = ss.str() + ": tiles";
+					ASSERT_TRUE(state.contiguous && state.output.size() == n, message);
+					ASSERT_EQ((n + state.tile - 1) / state.tile, state.calls, message);
+					for (size_t i = 0; i < n; i++) {
+						const float expected = alt ? fp16_alt_to_fp32_value(input[i]) : fp16_ieee_to_fp32_value(input[i]);
+						if (!same_fp32(state.output[i], expected)) {
+							std::stringstream es;
+							es << ss.str() << ", I = " << i << std::hex << std::uppercase << ", F16 = 0x" << input[i];
+							message = es.str();
+							ASSERT_TRUE(false, message);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void test_encode() {
+	std::vector<float> reference(100003);
+	for (size_t i = 0; i < reference.size(); i++) {
+		reference[i] = (float) (i * 2654435761u % 16777213u) / 256.0f - 32768.0f;
+	}
+	for (int alt = 0; alt <= 1; alt++) {
+		for (size_t n : lengths()) {
+			for (size_t tile : tiles()) {
+				for (int stack = 0; stack <= 1; stack++) {
+					producer_state state;
+					state.input = &reference;
+					state.tile = expected_tile(tile, stack != 0);
+					state.calls = 0;
+					state.stop_after = 0;
+					state.contiguous = true;
+					state.next = 0;
+					std::vector<float> scratch(stack ? 0 : state.tile);
+					std::vector<uint16_t> output(n + 1, UINT16_C(0xDEAD));
+					const size_t converted = alt ?
+						fp32_alt_to_fp16_tiled(output.data(), n, stack ? NULL : scratch.data(), tile, fill_tile, &state) :
+						fp32_ieee_to_fp16_tiled(output.data(), n, stack ? NULL : scratch.data(), tile, fill_tile, &state);
+
+					std::stringstream ss;
+					ss << (alt ? "alt" : "ieee") << ": N = " << n << ", tile = " << tile << (stack ? ", stack" : ", scratch");
+					std::string message = ss.str() + ": converted";
+					ASSERT_EQ(n, converted, message);
+					message = ss.str() + ": tiles";
+					ASSERT_TRUE(state.contiguous && state.next == n, message);
+					ASSERT_EQ((n + state.tile - 1) / state.tile, state.calls, message);
+					for (size_t i = 0; i < n; i++) {
+						const uint16_t expected = alt ? fp32_alt_to_fp16_value(reference[i]) : fp32_ieee_to_fp16_value(reference[i]);
+						if (!same_fp16(output[i], expected)) {
+							std::stringstream es;
+							es << ss.str() << ", I = " << i << std::hex << std::uppercase <<
+								", actual = 0x" << output[i] << ", expected = 0x" << expected;
+							message = es.str();
+							ASSERT_TRUE(false, message);
+						}
+					}
+					message = ss.str() + ": guard element overwritten";
+					ASSERT_EQ(UINT16_C(0xDEAD), output[n], message);
+				}
+			}
+		}
+	}
+}
+
+void test_early_stop() {
+	const size_t n = 1000, tile = 64;
+	const std::vector<uint16_t> input = make_input(n);
+	consumer_state consumer;
+	consumer.tile = tile;
+	consumer.calls = 0;
+	consumer.stop_after = 3;
+	consumer.contiguous = true;
+	std::string message = "consumer: elements converted before stopping";
+	ASSERT_EQ(3 * tile, fp16_ieee_to_fp32_tiled(input.data(), n, NULL, tile, record_tile, &consumer), message);
+	message = "consumer: tiles";
+	ASSERT_TRUE(consumer.contiguous && consumer.calls == 3 && consumer.output.size() == 3 * tile, message);
+
+	/* The tile on which the producer stops is still encoded, and nothing after it is written */
+	std::vector<float> reference(n, 1.5f);
+	producer_state producer;
+	producer.input = &reference;
+	producer.tile = tile;
+	producer.calls = 0;
+	producer.stop_after = 2;
+	producer.contiguous = true;
+	producer.next = 0;
+	std::vector<uint16_t> output(n, UINT16_C(0xDEAD));
+	message = "producer: elements converted before stopping";
+	ASSERT_EQ(2 * tile, fp32_ieee_to_fp16_tiled(output.data(), n, NULL, tile, fill_tile, &producer), message);
+	message = "producer: encoded tiles";
+	ASSERT_TRUE(output[0] == UINT16_C(0x3E00) && output[2 * tile - 1] == UINT16_C(0x3E00), message);
+	message = "producer: elements after the last tile";
+	ASSERT_TRUE(output[2 * tile] == UINT16_C(0xDEAD) && output[n - 1] == UINT16_C(0xDEAD), message);
+}
+
+int main() {
+	printf("Running tiled conversion tests...\n");
+
+	RUN_TEST(test_cache_size);
+	RUN_TEST(test_decode);
+	RUN_TEST(test_encode);
+	RUN_TEST(test_early_stop);
+
+	printf("All tiled conversion tests passed!\n");
+	return 0;
+}
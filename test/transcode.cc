@@ -0,0 +1,135 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cmath>
+#include <fp16.h>
+#include <fp16/transcode.h>
+#include "simple_test.h"
+#include <string>
+#include <sstream>
+#include <vector>
+
+static const unsigned kFlags[] = {
+	0,
+	FP16_ENCODE_SATURATE,
+	FP16_ENCODE_NAN_TO_VALUE,
+	FP16_ENCODE_FLUSH_DENORMALS,
+	FP16_ENCODE_SATURATE | FP16_ENCODE_NAN_TO_VALUE,
+	FP16_ENCODE_SATURATE | FP16_ENCODE_FLUSH_DENORMALS,
+	FP16_ENCODE_NAN_TO_VALUE | FP16_ENCODE_FLUSH_DENORMALS,
+	FP16_ENCODE_SATURATE | FP16_ENCODE_NAN_TO_VALUE | FP16_ENCODE_FLUSH_DENORMALS,
+};
+
+static const uint16_t kNanValues[] = { UINT16_C(0x0000), UINT16_C(0xBC00) };
+
+/*
+ * References: the two-step conversions through single-precision.
+ */
+static uint16_t reference_alt_to_ieee(uint16_t h, unsigned flags) {
+	return fp32_ieee_to_fp16_value_policy(fp16_alt_to_fp32_value(h), flags, 0);
+}
+
+static uint16_t reference_ieee_to_alt(uint16_t h, unsigned flags, uint16_t nan_value) {
+	return fp32_alt_to_fp16_value_policy(fp16_ieee_to_fp32_value(h), flags, nan_value);
+}
+
+void test_fp16_alt_to_fp16_ieee_value() {
+	for (unsigned flags : kFlags) {
+		for (uint32_t h = 0; h <= 0xFFFF; h++) {
+			const uint16_t expected = reference_alt_to_ieee((uint16_t) h, flags);
+			const uint16_t actual = fp16_alt_to_fp16_ieee_value((uint16_t) h, flags);
+			std::stringstream ss;
+			ss << "fp16_alt_to_fp16_ieee_value" << std::hex << std::uppercase << std::setfill('0') <<
+				": flags = " << flags << ", F16 = 0x" << std::setw(4) << h <<
+				", actual = 0x" << std::setw(4) << actual << ", expected = 0x" << std::setw(4) << expected;
+			std::string message = ss.str();
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+void test_fp16_ieee_to_fp16_alt_value() {
+	for (unsigned flags : kFlags) {
+		for (uint16_t nan_value : kNanValues) {
+			for (uint32_t h = 0; h <= 0xFFFF; h++) {
+				const uint16_t expected = reference_ieee_to_alt((uint16_t) h, flags, nan_value);
+				const uint16_t actual = fp16_ieee_to_fp16_alt_value((uint16_t) h, flags, nan_value);
+				std::stringstream ss;
+				ss << "fp16_ieee_to_fp16_alt_value" << std::hex << std::uppercase << std::setfill('0') <<
+					": flags = " << flags << ", NaN value = 0x" << std::setw(4) << nan_value <<
+					", F16 = 0x" << std::setw(4) << h <<
+					", actual = 0x" << std::setw(4) << actual << ", expected = 0x" << std::setw(4) << expected;
+				std::string message = ss.str();
+				ASSERT_EQ(expected, actual, message);
+			}
+		}
+	}
+}
+
+/*
+ * Array results must equal the scalar results for every length, with no element written past the end, and the
+ * conversions must also work in place. Every input is covered by the longest length.
+ */
+template<typename ArrayFunc, typename ValueFunc>
+static void check_array(ArrayFunc convert_array, ValueFunc convert, const std::string& name) {
+	std::vector<uint16_t> input(65536);
+	for (size_t i = 0; i < input.size(); i++) {
+		input[i] = (uint16_t) (i * 40503);
+	}
+	std::vector<size_t> lengths;
+	for (size_t n = 0; n <= 40; n++) {
+		lengths.push_back(n);
+	}
+	lengths.push_back(input.size());
+	for (size_t n : lengths) {
+		std::vector<uint16_t> output(n + 1, UINT16_C(0xDEAD));
+		convert_array(input.data(), output.data(), n);
+		std::vector<uint16_t> inplace(input.begin(), input.begin() + n);
+		convert_array(inplace.data(), inplace.data(), n);
+		for (size_t i = 0; i < n; i++) {
+			const uint16_t expected = convert(input[i]);
+			std::stringstream ss;
+			ss << name << ": N = " << n << ", I = " << i << std::hex << std::uppercase << std::setfill('0') <<
+				", F16 = 0x" << std::setw(4) << input[i] <<
+				", actual = 0x" << std::setw(4) << output[i] << ", expected = 0x" << std::setw(4) << expected;
+			std::string message = ss.str();
+			ASSERT_EQ(expected, output[i], message);
+			message = "in-place " + message;
+			ASSERT_EQ(expected, inplace[i], message);
+		}
+		const std::string guard_message = name + ": guard element overwritten";
+		ASSERT_EQ(UINT16_C(0xDEAD), output[n], guard_message);
+	}
+}
+
+void test_fp16_alt_to_fp16_ieee_array() {
+	for (unsigned flags : kFlags) {
+		check_array(
+			[=](const uint16_t* input, uint16_t* output, size_t n) { fp16_alt_to_fp16_ieee_array(input, output, n, flags); },
+			[=](uint16_t h) { return fp16_alt_to_fp16_ieee_value(h, flags); }, "fp16_alt_to_fp16_ieee_array");
+	}
+}
+
+void test_fp16_ieee_to_fp16_alt_array() {
+	for (unsigned flags : kFlags) {
+		for (uint16_t nan_value : kNanValues) {
+			check_array(
+				[=](const uint16_t* input, uint16_t* output, size_t n) {
+					fp16_ieee_to_fp16_alt_array(input, output, n, flags, nan_value);
+				},
+				[=](uint16_t h) { return fp16_ieee_to_fp16_alt_value(h, flags, nan_value); }, "fp16_ieee_to_fp16_alt_array");
+		}
+	}
+}
+
+int main() {
+	printf("Running IEEE/ARM alternative half-precision transcoding tests...\n");
+
+	RUN_TEST(test_fp16_alt_to_fp16_ieee_value);
+	RUN_TEST(test_fp16_ieee_to_fp16_alt_value);
+	RUN_TEST(test_fp16_alt_to_fp16_ieee_array);
+	RUN_TEST(test_fp16_ieee_to_fp16_alt_array);
+
+	printf("All transcoding tests passed!\n");
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <fp16.h>
+#include "simple_test.h"
+#include "test_data.h"
+#include <string>
+#include <sstream>
+#include <vector>
+
+static const uint16_t kUntouchedBits16 = UINT16_C(0xDEAD);
+static const uint32_t kUntouchedBits32 = UINT32_C(0xDEADBEEF);
+
+/* Extra elements at the end of every input and output row */
+static const size_t kRowPadding = 3;
+
+static void check_from_fp32(void (*transpose)(size_t, size_t, const float*, size_t, float16*, size_t),
+	float16 (*convert)(float), const std::string& name, size_t rows, size_t columns)
+{
+	const size_t input_stride = columns + kRowPadding;
+	const size_t output_stride = rows + kRowPadding;
+	const std::vector<float> input = generate_fp32_data(rows * input_stride, (uint32_t) (rows * 1000 + columns));
+	std::vector<uint16_t> output(columns * output_stride, kUntouchedBits16);
+	transpose(rows, columns, input.data(), input_stride, output.data(), output_stride);
+
+	for (size_t j = 0; j < columns; j++) {
+		for (size_t i = 0; i < output_stride; i++) {
+			const uint16_t expected = i < rows ? convert(input[i * input_stride + j]) : kUntouchedBits16;
+			const uint16_t actual = output[j * output_stride + i];
+			std::stringstream ss;
+			ss << name << ": " << rows << " x " << columns << ", output (" << j << ", " << i << ")" <<
+				std::hex << std::uppercase << std::setfill('0') <<
+				", actual = 0x" << std::setw(4) << actual << ", expected = 0x" << std::setw(4) << expected;
+			std::string message = ss.str();
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+static void check_to_fp32(void (*transpose)(size_t, size_t, const float16*, size_t, float*, size_t),
+	float (*convert)(float16), const std::string& name, size_t rows, size_t columns)
+{
+	const size_t input_stride = columns + kRowPadding;
+	const size_t output_stride = rows + kRowPadding;
+	const std::vector<uint16_t> input = generate_fp16_data(rows * input_stride, (uint32_t) (rows * 1000 + columns));
+	std::vector<float> output(columns * output_stride, fp32b_to_fp32v(kUntouchedBits32));
+	transpose(rows, columns, input.data(), input_stride, output.data(), output_stride);
+
+	for (size_t j = 0; j < columns; j++) {
+		for (size_t i = 0; i < output_stride; i++) {
+			const uint32_t expected = i < rows ? fp32v_to_fp32b(convert(input[i * input_stride + j])) : kUntouchedBits32;
+			const uint32_t actual = fp32v_to_fp32b(output[j * output_stride + i]);
+			std::stringstream ss;
+			ss << name << ": " << rows << " x " << columns << ", output (" << j << ", " << i << ")" <<
+				std::hex << std::uppercase << std::setfill('0') <<
+				", actual = 0x" << std::setw(8) << actual << ", expected = 0x" << std::setw(8) << expected;
+			std::string message = ss.str();
+			ASSERT_EQ(expected, actual, message);
+		}
+	}
+}
+
+/* Every shape up to 2 x 8 tiles in each dimension, and shapes spanning several cache blocks */
+static const size_t kMaxSmallDimension = 17;
+static const size_t kLargeShapes[][2] = { { 64, 64 }, { 129, 200 }, { 200, 67 }, { 1, 300 }, { 300, 1 } };
+
+void test_fp32_ieee_to_fp16_transpose() {
+	for (size_t rows = 1; rows <= kMaxSmallDimension; rows++) {
+		for (size_t columns = 1; columns <= kMaxSmallDimension; columns++) {
+			check_from_fp32(fp32_ieee_to_fp16_transpose, fp32_ieee_to_fp16_value, "fp32_ieee_to_fp16_transpose", rows, columns);
+		}
+	}
+	for (const auto& shape : kLargeShapes) {
+		check_from_fp32(fp32_ieee_to_fp16_transpose, fp32_ieee_to_fp16_value, "fp32_ieee_to_fp16_transpose", shape[0], shape[1]);
+	}
+}
+
+void test_fp16_ieee_to_fp32_transpose() {
+	for (size_t rows = 1; rows <= kMaxSmallDimension; rows++) {
+		for (size_t columns = 1; columns <= kMaxSmallDimension; columns++) {
+			check_to_fp32(fp16_ieee_to_fp32_transpose, fp16_ieee_to_fp32_value, "fp16_ieee_to_fp32_transpose", rows, columns);
+		}
+	}
+	for (const auto& shape : kLargeShapes) {
+		check_to_fp32(fp16_ieee_to_fp32_transpose, fp16_ieee_to_fp32_value, "fp16_ieee_to_fp32_transpose", shape[0], shape[1]);
+	}
+}
+
+void test_fp32_alt_to_fp16_transpose() {
+	for (size_t rows = 1; rows <= kMaxSmallDimension; rows++) {
+		for (size_t columns = 1; columns <= kMaxSmallDimension; columns++) {
+			check_from_fp32(fp32_alt_to_fp16_transpose, fp32_alt_to_fp16_value, "fp32_alt_to_fp16_transpose", rows, columns);
+		}
+	}
+	for (const auto& shape : kLargeShapes) {
+		check_from_fp32(fp32_alt_to_fp16_transpose, fp32_alt_to_fp16_value, "fp32_alt_to_fp16_transpose", shape[0], shape[1]);
+	}
+}
+
+void test_fp16_alt_to_fp32_transpose() {
+	for (size_t rows = 1; rows <= kMaxSmallDimension; rows++) {
+		for (size_t columns = 1; columns <= kMaxSmallDimension; columns++) {
+			check_to_fp32(fp16_alt_to_fp32_transpose, fp16_alt_to_fp32_value, "fp16_alt_to_fp32_transpose", rows, columns);
+		}
+	}
+	for (const auto& shape : kLargeShapes) {
+		check_to_fp32(fp16_alt_to_fp32_transpose, fp16_alt_to_fp32_value, "fp16_alt_to_fp32_transpose", shape[0], shape[1]);
+	}
+}
+
+int main() {
+	printf("Running FP16 transpose-and-convert tests...\n");
+
+	RUN_TEST(test_fp32_ieee_to_fp16_transpose);
+	RUN_TEST(test_fp16_ieee_to_fp32_transpose);
+	RUN_TEST(test_fp32_alt_to_fp16_transpose);
+	RUN_TEST(test_fp16_alt_to_fp32_transpose);
+
+	printf("All transpose-and-convert tests passed!\n");
+	return 0;
+}
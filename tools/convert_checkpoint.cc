@@ -0,0 +1,112 @@
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/checkpoint.h>
+
+// safetensors/GGUF 체크포인트의 부동소수점 텐서 정밀도를 바꾸는 명령행 도구
+static void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] <input> <output>" << std::endl
+              << "  --dtype f16|bf16|f32  precision of the floating-point tensors (default: f16)" << std::endl
+              << "  --format auto|safetensors|gguf  input format (default: auto)" << std::endl
+              << "  --threads N      conversion threads, 0 for all hardware threads (default: 0)" << std::endl
+              << "  --chunk N        numbers per task (default: " << (size_t) fp16::checkpoint_options::default_chunk_elements << ")" << std::endl
+              << "  --all            also narrow one-dimensional tensors (norms, biases)" << std::endl
+              << "  --list           list the tensors of <input> and exit" << std::endl;
+}
+
+static std::string shape_string(const std::vector<uint64_t>& shape) {
+    std::string result = "[";
+    for (size_t i = 0; i < shape.size(); i++) {
+        result += (i != 0 ? ", " : "") + std::to_string(shape[i]);
+    }
+    return result + "]";
+}
+
+int main(int argc, char** argv) {
+    fp16::checkpoint_options options;
+    fp16::checkpoint_format format = fp16::checkpoint_format::automatic;
+    bool list = false;
+    const char* paths[2] = { NULL, NULL };
+    int path_count = 0;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--dtype" && has_value) {
+            const std::string dtype = argv[++i];
+            if (dtype == "f16") {
+                options.dtype = fp16::checkpoint_dtype::float16;
+            } else if (dtype == "bf16") {
+                options.dtype = fp16::checkpoint_dtype::bfloat16;
+            } else if (dtype == "f32") {
+                options.dtype = fp16::checkpoint_dtype::float32;
+            } else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--format" && has_value) {
+            const std::string name = argv[++i];
+            if (name == "auto") {
+                format = fp16::checkpoint_format::automatic;
+            } else if (name == "safetensors") {
+                format = fp16::checkpoint_format::safetensors;
+            } else if (name == "gguf") {
+                format = fp16::checkpoint_format::gguf;
+            } else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--threads" && has_value) {
+            options.threads = (size_t) strtoull(argv[++i], NULL, 10);
+        } else if (arg == "--chunk" && has_value) {
+            options.chunk_elements = (size_t) strtoull(argv[++i], NULL, 10);
+        } else if (arg == "--all") {
+            options.keep_vectors = false;
+        } else if (arg == "--list") {
+            list = true;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg.compare(0, 2, "--") != 0 && path_count < 2) {
+            paths[path_count++] = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (path_count != (list ? 1 : 2)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        if (list) {
+            const fp16::checkpoint_file file(paths[0], format);
+            for (const fp16::checkpoint_tensor& tensor : file.tensors()) {
+                std::cout << std::left << std::setw(48) << tensor.name << " " << std::setw(8) << tensor.type
+                          << " " << shape_string(tensor.shape) << std::endl;
+            }
+            return 0;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const fp16::checkpoint_stats stats = fp16::convert_checkpoint(paths[0], paths[1], options, format);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << (stats.format == fp16::checkpoint_format::gguf ? "GGUF" : "safetensors") << ", "
+                  << stats.tensors << " tensors (" << stats.converted << " converted, " << stats.elements << " numbers), "
+                  << std::fixed << std::setprecision(1)
+                  << stats.bytes_read / 1048576.0 << " MiB -> " << stats.bytes_written / 1048576.0 << " MiB in "
+                  << std::setprecision(3) << seconds << " s ("
+                  << std::setprecision(2) << (seconds > 0.0 ? (stats.bytes_read + stats.bytes_written) / seconds / 1e9 : 0.0)
+                  << " GB/s read+write, " << stats.threads << " threads)" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
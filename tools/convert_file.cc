@@ -0,0 +1,100 @@
+#include <iostream>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// FP16 헤더 포함
+#include <fp16.h>
+#include <fp16/file.h>
+
+// 파일 전체를 읽기/변환/쓰기를 겹쳐서 변환하는 명령행 도구
+static void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] <input> <output>" << std::endl
+              << "  --kind fp32-to-fp16|fp16-to-fp32|fp32-to-alt|alt-to-fp32  (default: fp32-to-fp16)" << std::endl
+              << "  --buffers N      slots in flight: 2 double, 3 triple buffering (default: 3)" << std::endl
+              << "  --chunk N        numbers per chunk (default: " << (size_t) fp16::file_conversion_options::default_chunk_elements << ")" << std::endl
+              << "  --io auto|threads|uring  I/O back end (default: auto)" << std::endl
+              << "  --direct         open the files with O_DIRECT" << std::endl;
+}
+
+static bool parse_kind(const std::string& name, fp16_conversion_kind& kind) {
+    if (name == "fp32-to-fp16") {
+        kind = FP16_CONVERSION_FP32_TO_IEEE;
+    } else if (name == "fp16-to-fp32") {
+        kind = FP16_CONVERSION_IEEE_TO_FP32;
+    } else if (name == "fp32-to-alt") {
+        kind = FP16_CONVERSION_FP32_TO_ALT;
+    } else if (name == "alt-to-fp32") {
+        kind = FP16_CONVERSION_ALT_TO_FP32;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    fp16_conversion_kind kind = FP16_CONVERSION_FP32_TO_IEEE;
+    fp16::file_conversion_options options;
+    const char* paths[2] = { NULL, NULL };
+    int path_count = 0;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--kind" && has_value) {
+            if (!parse_kind(argv[++i], kind)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--buffers" && has_value) {
+            options.buffers = (size_t) strtoull(argv[++i], NULL, 10);
+        } else if (arg == "--chunk" && has_value) {
+            options.chunk_elements = (size_t) strtoull(argv[++i], NULL, 10);
+        } else if (arg == "--io" && has_value) {
+            const std::string io = argv[++i];
+            if (io == "auto") {
+                options.io = fp16::file_io::automatic;
+            } else if (io == "threads") {
+                options.io = fp16::file_io::threads;
+            } else if (io == "uring") {
+                options.io = fp16::file_io::io_uring;
+            } else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--direct") {
+            options.direct = true;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg.compare(0, 2, "--") != 0 && path_count < 2) {
+            paths[path_count++] = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (path_count != 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        const auto start = std::chrono::steady_clock::now();
+        const fp16::file_conversion_stats stats = fp16::convert_file(kind, paths[0], paths[1], options);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << stats.elements << " numbers, "
+                  << std::fixed << std::setprecision(1)
+                  << stats.bytes_read / 1048576.0 << " MiB -> " << stats.bytes_written / 1048576.0 << " MiB in "
+                  << std::setprecision(3) << seconds << " s ("
+                  << std::setprecision(2) << (seconds > 0.0 ? (stats.bytes_read + stats.bytes_written) / seconds / 1e9 : 0.0)
+                  << " GB/s read+write, " << (stats.io == fp16::file_io::io_uring ? "io_uring" : "threads")
+                  << (stats.direct ? ", O_DIRECT" : "") << ")" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}